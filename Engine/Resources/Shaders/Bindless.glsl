@@ -0,0 +1,44 @@
+// Bindless resources, see RHI::AddBindlessTexture and RHI::AddBindlessBuffer.
+//
+// Every registered texture and storage buffer lives in one descriptor set that is bound once per frame. Draws pick
+// their material by index instead of binding a set of their own: the material table is a bindless buffer, its index
+// and the material id come in through push constants.
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+#ifndef GAL_BINDLESS_SET
+#define GAL_BINDLESS_SET 0
+#endif
+
+struct BindlessMaterial
+{
+    vec4  BaseColorFactor;
+    vec4  EmissiveFactor;
+    float MetallicFactor;
+    float RoughnessFactor;
+    float NormalScale;
+    float OcclusionStrength;
+
+    // indices into g_BindlessTextures
+    uint BaseColorTexture;
+    uint MetallicRoughnessTexture;
+    uint NormalTexture;
+    uint OcclusionTexture;
+    uint EmissiveTexture;
+    uint Padding[3];
+};
+
+layout(set = GAL_BINDLESS_SET, binding = 0) uniform sampler2D g_BindlessTextures[];
+
+layout(set = GAL_BINDLESS_SET, binding = 1, std430) readonly buffer BindlessMaterialTable
+{
+    BindlessMaterial Materials[];
+} g_BindlessMaterialTables[];
+
+// index values that differ within a draw, e.g. per instance, need nonuniformEXT
+#define GAL_BINDLESS_TEXTURE(index) g_BindlessTextures[nonuniformEXT(index)]
+
+BindlessMaterial LoadBindlessMaterial(uint materialTable, uint materialId)
+{
+    return g_BindlessMaterialTables[nonuniformEXT(materialTable)].Materials[materialId];
+}
@@ -0,0 +1,44 @@
+//
+// BenchmarkUtil.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 11:02.
+//
+
+#pragma once
+
+#include <GalaxyEngine/Core/Time/Timer.h>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace GalaxyBenchmark
+{
+    // Keeps results alive so the optimizer cannot drop the measured work
+    inline volatile uint64_t g_Sink = 0;
+
+    template<typename Func>
+    double MeasureNanosecondsPerCall(uint32_t iterations, Func&& func)
+    {
+        // warm up caches and the scratch arena
+        for (uint32_t i = 0; i < iterations / 10 + 1; ++i)
+        {
+            g_Sink = g_Sink + func();
+        }
+
+        Galaxy::Timer timer;
+        uint64_t      sink = 0;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            sink += func();
+        }
+        double seconds = timer.Elapsed();
+        g_Sink         = g_Sink + sink;
+
+        return seconds * 1e9 / iterations;
+    }
+
+    inline void PrintComparison(const char* name, double beforeNs, double afterNs)
+    {
+        std::printf("%-32s %10.1f ns %10.1f ns %8.2fx\n", name, beforeNs, afterNs, beforeNs / afterNs);
+    }
+} // namespace GalaxyBenchmark
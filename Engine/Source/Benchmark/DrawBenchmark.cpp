@@ -0,0 +1,115 @@
+//
+// DrawBenchmark.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 14:20.
+//
+
+#include "DrawBenchmark.h"
+#include "BenchmarkUtil.h"
+
+#include <GalaxyEngine/Function/Renderer/RHI/RHICommandEncoder.h>
+
+using namespace Galaxy;
+
+namespace GalaxyBenchmark
+{
+    namespace
+    {
+        uint64_t g_RecordedCommands = 0;
+
+        VKAPI_ATTR void VKAPI_CALL StubBindPipeline(VkCommandBuffer, VkPipelineBindPoint, VkPipeline)
+        {
+            ++g_RecordedCommands;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL StubBindDescriptorSets(VkCommandBuffer,
+                                                          VkPipelineBindPoint,
+                                                          VkPipelineLayout,
+                                                          uint32_t,
+                                                          uint32_t,
+                                                          const VkDescriptorSet*,
+                                                          uint32_t,
+                                                          const uint32_t*)
+        {
+            ++g_RecordedCommands;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL StubDrawIndexed(VkCommandBuffer, uint32_t, uint32_t, uint32_t, int32_t, uint32_t)
+        {
+            ++g_RecordedCommands;
+        }
+
+        template<typename VkHandle>
+        VkHandle FakeHandle(uint64_t value)
+        {
+            return reinterpret_cast<VkHandle>(static_cast<uintptr_t>(value * 16 + 16));
+        }
+
+        // Hides the dynamic type so the compiler cannot devirtualize the RHI path
+        RHI* volatile g_RHI = nullptr;
+    } // namespace
+
+    void RunDrawBenchmarks()
+    {
+        constexpr uint32_t drawCount        = 50000;
+        constexpr uint32_t drawsPerMaterial = 8;
+        constexpr uint32_t iterations       = 50;
+
+        Scope<VulkanRHI> vulkanRHI = CreateScope<VulkanRHI>();
+
+        vulkanRHI->DeviceTable.vkCmdBindPipeline       = &StubBindPipeline;
+        vulkanRHI->DeviceTable.vkCmdBindDescriptorSets = &StubBindDescriptorSets;
+        vulkanRHI->DeviceTable.vkCmdDrawIndexed        = &StubDrawIndexed;
+        g_RHI                                          = vulkanRHI.get();
+
+        VulkanResources&  resources     = vulkanRHI->Resources;
+        RHICommandBuffer  commandBuffer = resources.Create<RHICommandBuffer>(FakeHandle<VkCommandBuffer>(1));
+        RHIPipeline       pipeline      = resources.Create<RHIPipeline>(FakeHandle<VkPipeline>(2));
+        RHIPipelineLayout layout        = resources.Create<RHIPipelineLayout>(FakeHandle<VkPipelineLayout>(3));
+        RHIDescriptorSet  materialSet   = resources.Create<RHIDescriptorSet>(FakeHandle<VkDescriptorSet>(4));
+
+        PrintComparison(
+            "Record 50k draws",
+            MeasureNanosecondsPerCall(iterations,
+                                      [&]() {
+                                          RHI* rhi = g_RHI;
+                                          for (uint32_t i = 0; i < drawCount; ++i)
+                                          {
+                                              if (i % drawsPerMaterial == 0)
+                                              {
+                                                  rhi->CmdBindPipelinePfn(
+                                                      commandBuffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                                                  rhi->CmdBindDescriptorSetsPfn(commandBuffer,
+                                                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                                layout,
+                                                                                1,
+                                                                                1,
+                                                                                &materialSet,
+                                                                                0,
+                                                                                nullptr);
+                                              }
+                                              rhi->CmdDrawIndexedPfn(commandBuffer, 36, 1, 0, 0, i);
+                                          }
+                                          return g_RecordedCommands;
+                                      }),
+            MeasureNanosecondsPerCall(iterations, [&]() {
+                RHICommandEncoder encoder = CreateCommandEncoder(*g_RHI, commandBuffer);
+                for (uint32_t i = 0; i < drawCount; ++i)
+                {
+                    if (i % drawsPerMaterial == 0)
+                    {
+                        encoder.CmdBindPipelinePfn(RHI_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                        encoder.CmdBindDescriptorSetsPfn(
+                            RHI_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &materialSet, 0, nullptr);
+                    }
+                    encoder.CmdDrawIndexedPfn(36, 1, 0, 0, i);
+                }
+                return g_RecordedCommands;
+            }));
+
+        resources.Destroy(commandBuffer);
+        resources.Destroy(pipeline);
+        resources.Destroy(layout);
+        resources.Destroy(materialSet);
+    }
+} // namespace GalaxyBenchmark
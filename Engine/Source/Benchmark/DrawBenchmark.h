@@ -0,0 +1,14 @@
+//
+// DrawBenchmark.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 14:20.
+//
+
+#pragma once
+
+namespace GalaxyBenchmark
+{
+    // ns per 50k draw scene recorded through the virtual RHI vs the compile-time RHICommandEncoder. The Vulkan entry
+    // points are replaced by empty stubs, so only the engine side of draw submission is measured.
+    void RunDrawBenchmarks();
+} // namespace GalaxyBenchmark
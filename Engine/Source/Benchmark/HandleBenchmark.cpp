@@ -0,0 +1,134 @@
+//
+// HandleBenchmark.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 10:12.
+//
+
+#include "HandleBenchmark.h"
+#include "BenchmarkUtil.h"
+
+#include <GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanResources.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Galaxy;
+
+namespace GalaxyBenchmark
+{
+    namespace
+    {
+        // What an RHIBuffer used to be: an empty base with the Vulkan object in a heap allocated subclass
+        class LegacyRHIBuffer
+        {
+        public:
+            virtual ~LegacyRHIBuffer() = default;
+        };
+
+        class LegacyVulkanBuffer : public LegacyRHIBuffer
+        {
+        public:
+            void     SetResource(VkBuffer res) { m_Resource = res; }
+            VkBuffer GetResource() const { return m_Resource; }
+
+        private:
+            VkBuffer m_Resource {VK_NULL_HANDLE};
+        };
+
+        VkBuffer FakeBuffer(uint64_t value)
+        {
+            return reinterpret_cast<VkBuffer>(static_cast<uintptr_t>(value * 16 + 16));
+        }
+
+        uint64_t BufferBits(VkBuffer buffer) { return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(buffer)); }
+    } // namespace
+
+    void RunHandleBenchmarks()
+    {
+        constexpr uint32_t objectCount = 4096;
+        constexpr uint32_t iterations  = 2000;
+
+        // Resolve every live object in a shuffled order, as a frame touching scattered resources would
+        std::vector<uint32_t> order(objectCount);
+        for (uint32_t i = 0; i < objectCount; ++i)
+        {
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+        // Wrappers are created over the lifetime of the engine, in between unrelated allocations
+        std::vector<std::unique_ptr<LegacyRHIBuffer>> legacyBuffers;
+        std::vector<std::unique_ptr<std::byte[]>>     unrelated;
+        VulkanResources                               resources;
+        std::vector<RHIBuffer>                        handles;
+        std::mt19937                                  random(7);
+        for (uint32_t i = 0; i < objectCount; ++i)
+        {
+            unrelated.emplace_back(new std::byte[64 + random() % 512]);
+            auto buffer = std::make_unique<LegacyVulkanBuffer>();
+            buffer->SetResource(FakeBuffer(i));
+            legacyBuffers.emplace_back(std::move(buffer));
+            handles.push_back(resources.Create<RHIBuffer>(FakeBuffer(i)));
+        }
+
+        PrintComparison("Resolve 4096 buffers",
+                        MeasureNanosecondsPerCall(iterations,
+                                                  [&]() {
+                                                      uint64_t sum = 0;
+                                                      for (uint32_t index : order)
+                                                      {
+                                                          LegacyRHIBuffer* buffer = legacyBuffers[index].get();
+                                                          sum += BufferBits(
+                                                              static_cast<LegacyVulkanBuffer*>(buffer)->GetResource());
+                                                      }
+                                                      return sum;
+                                                  }),
+                        MeasureNanosecondsPerCall(iterations, [&]() {
+                            uint64_t sum = 0;
+                            for (uint32_t index : order)
+                            {
+                                sum += BufferBits(resources.Get(handles[index]));
+                            }
+                            return sum;
+                        }));
+
+        // Create and destroy 256 transient objects, e.g. per frame staging buffers
+        constexpr uint32_t transientCount = 256;
+        LegacyRHIBuffer*   legacyTransient[transientCount];
+        RHIBuffer          transient[transientCount];
+
+        PrintComparison("Create/destroy 256 buffers",
+                        MeasureNanosecondsPerCall(iterations,
+                                                  [&]() {
+                                                      for (uint32_t i = 0; i < transientCount; ++i)
+                                                      {
+                                                          auto* buffer = new LegacyVulkanBuffer();
+                                                          buffer->SetResource(FakeBuffer(i));
+                                                          legacyTransient[i] = buffer;
+                                                      }
+                                                      uint64_t sum = 0;
+                                                      for (uint32_t i = 0; i < transientCount; ++i)
+                                                      {
+                                                          sum += reinterpret_cast<uintptr_t>(legacyTransient[i]) & 1;
+                                                          delete legacyTransient[i];
+                                                      }
+                                                      return sum;
+                                                  }),
+                        MeasureNanosecondsPerCall(iterations, [&]() {
+                            for (uint32_t i = 0; i < transientCount; ++i)
+                            {
+                                transient[i] = resources.Create<RHIBuffer>(FakeBuffer(i));
+                            }
+                            uint64_t sum = 0;
+                            for (uint32_t i = 0; i < transientCount; ++i)
+                            {
+                                sum += transient[i].GetIndex() & 1;
+                                resources.Destroy(transient[i]);
+                            }
+                            return sum;
+                        }));
+    }
+} // namespace GalaxyBenchmark
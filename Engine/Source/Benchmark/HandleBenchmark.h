@@ -0,0 +1,13 @@
+//
+// HandleBenchmark.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 10:12.
+//
+
+#pragma once
+
+namespace GalaxyBenchmark
+{
+    // ns per operation of resolving and churning RHI objects, heap allocated wrappers vs generational handles
+    void RunHandleBenchmarks();
+} // namespace GalaxyBenchmark
@@ -0,0 +1,244 @@
+//
+// TranslationBenchmark.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 11:02.
+//
+
+#include "TranslationBenchmark.h"
+#include "BenchmarkUtil.h"
+
+#include <GalaxyEngine/Core/Memory/ScratchArray.h>
+#include <GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanResources.h>
+
+namespace GalaxyBenchmark
+{
+    using namespace Galaxy;
+
+    // Old path: one heap allocation per temporary list
+    template<typename T, size_t N>
+    using HeapArray = std::vector<T>;
+
+    template<typename VkHandle>
+    VkHandle FakeHandle(uint64_t value)
+    {
+        return reinterpret_cast<VkHandle>(static_cast<uintptr_t>(value * 16 + 16));
+    }
+
+    template<typename VkHandle>
+    uint64_t HandleBits(VkHandle handle)
+    {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+    }
+
+    // Stands in for VulkanRHI::Resources
+    static VulkanResources s_Resources;
+
+    // Mirrors VulkanRHI::CmdBindDescriptorSetsPfn
+    template<template<typename, size_t> class Array>
+    uint64_t TranslateBindDescriptorSets(uint32_t                descriptorSetCount,
+                                         const RHIDescriptorSet* pDescriptorSets,
+                                         uint32_t                dynamicOffsetCount,
+                                         const uint32_t*         pDynamicOffsets)
+    {
+        Array<VkDescriptorSet, 8> vkDescriptorSetList(descriptorSetCount);
+        for (uint32_t i = 0; i < descriptorSetCount; ++i)
+        {
+            vkDescriptorSetList[i] = s_Resources.Get(pDescriptorSets[i]);
+        }
+
+        Array<uint32_t, 8> vkOffsetList(dynamicOffsetCount);
+        for (uint32_t i = 0; i < dynamicOffsetCount; ++i)
+        {
+            vkOffsetList[i] = pDynamicOffsets[i];
+        }
+
+        return HandleBits(vkDescriptorSetList[descriptorSetCount - 1]) + vkOffsetList[dynamicOffsetCount - 1];
+    }
+
+    // Mirrors VulkanRHI::WaitForFencesPfn
+    template<template<typename, size_t> class Array>
+    uint64_t TranslateWaitForFences(uint32_t fenceCount, const RHIFence* pFences)
+    {
+        Array<VkFence, 8> vkFenceList(fenceCount);
+        for (uint32_t i = 0; i < fenceCount; ++i)
+        {
+            vkFenceList[i] = s_Resources.Get(pFences[i]);
+        }
+        return HandleBits(vkFenceList[fenceCount - 1]);
+    }
+
+    // Mirrors VulkanRHI::UpdateDescriptorSets
+    template<template<typename, size_t> class Array>
+    uint64_t TranslateUpdateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites)
+    {
+        uint32_t imageInfoCount  = 0;
+        uint32_t bufferInfoCount = 0;
+        for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+        {
+            imageInfoCount += pDescriptorWrites[i].pImageInfo != nullptr;
+            bufferInfoCount += pDescriptorWrites[i].pBufferInfo != nullptr;
+        }
+
+        Array<VkWriteDescriptorSet, 16>   vkWriteDescriptorSetList(descriptorWriteCount);
+        Array<VkDescriptorImageInfo, 16>  vkDescriptorImageInfoList(imageInfoCount);
+        Array<VkDescriptorBufferInfo, 16> vkDescriptorBufferInfoList(bufferInfoCount);
+        Array<VkCopyDescriptorSet, 4>     vkCopyDescriptorSetList(0);
+
+        uint32_t imageInfoCurrent  = 0;
+        uint32_t bufferInfoCurrent = 0;
+        for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+        {
+            const auto& rhiWrite = pDescriptorWrites[i];
+            auto&       vkWrite  = vkWriteDescriptorSetList[i];
+
+            if (rhiWrite.pImageInfo != nullptr)
+            {
+                auto& vkImageInfo       = vkDescriptorImageInfoList[imageInfoCurrent++];
+                vkImageInfo.sampler     = s_Resources.Get(rhiWrite.pImageInfo->sampler);
+                vkImageInfo.imageView   = s_Resources.Get(rhiWrite.pImageInfo->imageView);
+                vkImageInfo.imageLayout = (VkImageLayout)rhiWrite.pImageInfo->imageLayout;
+                vkWrite.pImageInfo      = &vkImageInfo;
+            }
+            if (rhiWrite.pBufferInfo != nullptr)
+            {
+                auto& vkBufferInfo  = vkDescriptorBufferInfoList[bufferInfoCurrent++];
+                vkBufferInfo.buffer = s_Resources.Get(rhiWrite.pBufferInfo->buffer);
+                vkBufferInfo.offset = rhiWrite.pBufferInfo->offset;
+                vkBufferInfo.range  = rhiWrite.pBufferInfo->range;
+                vkWrite.pBufferInfo = &vkBufferInfo;
+            }
+
+            vkWrite.sType           = (VkStructureType)rhiWrite.sType;
+            vkWrite.dstSet          = s_Resources.Get(rhiWrite.dstSet);
+            vkWrite.dstBinding      = rhiWrite.dstBinding;
+            vkWrite.descriptorCount = rhiWrite.descriptorCount;
+            vkWrite.descriptorType  = (VkDescriptorType)rhiWrite.descriptorType;
+        }
+
+        return HandleBits(vkWriteDescriptorSetList[descriptorWriteCount - 1].dstSet) + vkCopyDescriptorSetList.size();
+    }
+
+    // Mirrors VulkanRHI::QueueSubmit for a single submit
+    template<template<typename, size_t> class Array>
+    uint64_t TranslateQueueSubmit(const RHISubmitInfo& submit)
+    {
+        Array<VkCommandBuffer, 8>      vkCommandBufferList(submit.commandBufferCount);
+        Array<VkSemaphore, 4>          vkSemaphoreList(submit.waitSemaphoreCount);
+        Array<VkSemaphore, 4>          vkSignalSemaphoreList(submit.signalSemaphoreCount);
+        Array<VkPipelineStageFlags, 4> vkPipelineStageFlagsList(submit.waitSemaphoreCount);
+        Array<VkSubmitInfo, 4>         vkSubmitInfoList(1);
+
+        for (uint32_t i = 0; i < submit.commandBufferCount; ++i)
+        {
+            vkCommandBufferList[i] = s_Resources.Get(submit.pCommandBuffers[i]);
+        }
+        for (uint32_t i = 0; i < submit.waitSemaphoreCount; ++i)
+        {
+            vkSemaphoreList[i]          = s_Resources.Get(submit.pWaitSemaphores[i]);
+            vkPipelineStageFlagsList[i] = (VkPipelineStageFlags)submit.pWaitDstStageMask[i];
+        }
+        for (uint32_t i = 0; i < submit.signalSemaphoreCount; ++i)
+        {
+            vkSignalSemaphoreList[i] = s_Resources.Get(submit.pSignalSemaphores[i]);
+        }
+
+        auto& vkSubmit                = vkSubmitInfoList[0];
+        vkSubmit.commandBufferCount   = submit.commandBufferCount;
+        vkSubmit.pCommandBuffers      = vkCommandBufferList.data();
+        vkSubmit.waitSemaphoreCount   = submit.waitSemaphoreCount;
+        vkSubmit.pWaitSemaphores      = vkSemaphoreList.data();
+        vkSubmit.pWaitDstStageMask    = vkPipelineStageFlagsList.data();
+        vkSubmit.signalSemaphoreCount = submit.signalSemaphoreCount;
+        vkSubmit.pSignalSemaphores    = vkSignalSemaphoreList.data();
+
+        return HandleBits(vkSubmit.pCommandBuffers[0]) + vkSubmit.waitSemaphoreCount;
+    }
+
+    void RunTranslationBenchmarks()
+    {
+        constexpr uint32_t iterations = 2000000;
+
+        // CmdBindDescriptorSetsPfn: 4 sets, 2 dynamic offsets
+        RHIDescriptorSet rhiDescriptorSets[4];
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            rhiDescriptorSets[i] = s_Resources.Create<RHIDescriptorSet>(FakeHandle<VkDescriptorSet>(i));
+        }
+        uint32_t dynamicOffsets[2] = {256, 512};
+
+        PrintComparison(
+            "CmdBindDescriptorSetsPfn",
+            MeasureNanosecondsPerCall(
+                iterations, [&]() { return TranslateBindDescriptorSets<HeapArray>(4, rhiDescriptorSets, 2, dynamicOffsets); }),
+            MeasureNanosecondsPerCall(iterations, [&]() {
+                return TranslateBindDescriptorSets<ScratchArray>(4, rhiDescriptorSets, 2, dynamicOffsets);
+            }));
+
+        // WaitForFencesPfn: 2 fences
+        RHIFence rhiFences[2];
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            rhiFences[i] = s_Resources.Create<RHIFence>(FakeHandle<VkFence>(i));
+        }
+
+        PrintComparison(
+            "WaitForFencesPfn",
+            MeasureNanosecondsPerCall(iterations, [&]() { return TranslateWaitForFences<HeapArray>(2, rhiFences); }),
+            MeasureNanosecondsPerCall(iterations, [&]() { return TranslateWaitForFences<ScratchArray>(2, rhiFences); }));
+
+        // UpdateDescriptorSets: 8 writes, half images and half buffers
+        RHIDescriptorImageInfo  imageInfo {};
+        RHIDescriptorBufferInfo bufferInfo {};
+        imageInfo.sampler   = s_Resources.Create<RHISampler>(FakeHandle<VkSampler>(1));
+        imageInfo.imageView = s_Resources.Create<RHIImageView>(FakeHandle<VkImageView>(2));
+        bufferInfo.buffer   = s_Resources.Create<RHIBuffer>(FakeHandle<VkBuffer>(3));
+        bufferInfo.range    = 256;
+
+        RHIWriteDescriptorSet writes[8] {};
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            writes[i].dstSet          = rhiDescriptorSets[i % 4];
+            writes[i].dstBinding      = i;
+            writes[i].descriptorCount = 1;
+            if (i % 2 == 0)
+            {
+                writes[i].pImageInfo = &imageInfo;
+            }
+            else
+            {
+                writes[i].pBufferInfo = &bufferInfo;
+            }
+        }
+
+        PrintComparison(
+            "UpdateDescriptorSets",
+            MeasureNanosecondsPerCall(iterations, [&]() { return TranslateUpdateDescriptorSets<HeapArray>(8, writes); }),
+            MeasureNanosecondsPerCall(iterations,
+                                      [&]() { return TranslateUpdateDescriptorSets<ScratchArray>(8, writes); }));
+
+        // QueueSubmit: 1 command buffer, 2 wait semaphores, 1 signal semaphore
+        RHICommandBuffer      rhiCommandBuffers[1];
+        RHISemaphore          rhiWaitSemaphores[2];
+        RHISemaphore          rhiSignalSemaphores[1];
+        RHIPipelineStageFlags waitStages[2] = {0x00000400, 0x00000001};
+        rhiCommandBuffers[0] = s_Resources.Create<RHICommandBuffer>(FakeHandle<VkCommandBuffer>(7));
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            rhiWaitSemaphores[i] = s_Resources.Create<RHISemaphore>(FakeHandle<VkSemaphore>(i));
+        }
+        rhiSignalSemaphores[0] = s_Resources.Create<RHISemaphore>(FakeHandle<VkSemaphore>(2));
+
+        RHISubmitInfo submit {};
+        submit.commandBufferCount   = 1;
+        submit.pCommandBuffers      = rhiCommandBuffers;
+        submit.waitSemaphoreCount   = 2;
+        submit.pWaitSemaphores      = rhiWaitSemaphores;
+        submit.pWaitDstStageMask    = waitStages;
+        submit.signalSemaphoreCount = 1;
+        submit.pSignalSemaphores    = rhiSignalSemaphores;
+
+        PrintComparison("QueueSubmit",
+                        MeasureNanosecondsPerCall(iterations, [&]() { return TranslateQueueSubmit<HeapArray>(submit); }),
+                        MeasureNanosecondsPerCall(iterations, [&]() { return TranslateQueueSubmit<ScratchArray>(submit); }));
+    }
+} // namespace GalaxyBenchmark
@@ -0,0 +1,14 @@
+//
+// TranslationBenchmark.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 11:02.
+//
+
+#pragma once
+
+namespace GalaxyBenchmark
+{
+    // ns per call of the RHI -> Vulkan struct translation in VulkanRHI, std::vector temporaries vs ScratchArray.
+    // Only the translation is measured, no device is created and no Vulkan command is recorded.
+    void RunTranslationBenchmarks();
+} // namespace GalaxyBenchmark
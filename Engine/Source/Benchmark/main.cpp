@@ -0,0 +1,22 @@
+//
+// main.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 11:02.
+//
+
+#include "DrawBenchmark.h"
+#include "HandleBenchmark.h"
+#include "TranslationBenchmark.h"
+
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+    std::printf("%-32s %13s %13s %9s\n", "Benchmark", "Before", "After", "Speedup");
+
+    GalaxyBenchmark::RunTranslationBenchmarks();
+    GalaxyBenchmark::RunHandleBenchmarks();
+    GalaxyBenchmark::RunDrawBenchmarks();
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 #include "GalaxyEngine/Core/Base.h"
 #include "GalaxyEngine/Core/Event/ApplicationEvent.h"
+#include "GalaxyEngine/Core/Event/KeyEvent.h"
 #include "GalaxyEngine/Core/Layer/LayerStack.h"
 #include "GalaxyEngine/Core/Macro.h"
 
@@ -46,6 +47,7 @@ namespace Galaxy
     private:
         bool OnWindowClose(WindowCloseEvent& e);
         bool OnWindowResize(WindowResizeEvent& e);
+        bool OnKeyPressed(KeyPressedEvent& e);
 
     private:
         ApplicationSpecification m_Specification;
@@ -0,0 +1,67 @@
+//
+// Handle.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 10:20.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace Galaxy
+{
+    template<typename T, typename Tag>
+    class HandlePool;
+
+    // 64 bit reference into a HandlePool: a slot index plus the generation the slot had when the handle was issued.
+    // Generation 0 is never handed out, so a default constructed handle is the null handle. Tag only exists to make
+    // handles of different kinds distinct types.
+    template<typename Tag>
+    class Handle
+    {
+    public:
+        using TagType = Tag;
+
+        constexpr Handle() noexcept = default;
+        constexpr Handle(std::nullptr_t) noexcept {}
+
+        constexpr bool IsValid() const noexcept { return m_Generation != 0; }
+        constexpr explicit operator bool() const noexcept { return IsValid(); }
+
+        constexpr uint32_t GetIndex() const noexcept { return m_Index; }
+        constexpr uint32_t GetGeneration() const noexcept { return m_Generation; }
+        constexpr uint64_t GetValue() const noexcept
+        {
+            return (static_cast<uint64_t>(m_Generation) << 32) | static_cast<uint64_t>(m_Index);
+        }
+
+        constexpr bool operator==(const Handle& other) const noexcept { return GetValue() == other.GetValue(); }
+        constexpr bool operator!=(const Handle& other) const noexcept { return GetValue() != other.GetValue(); }
+        constexpr bool operator==(std::nullptr_t) const noexcept { return !IsValid(); }
+        constexpr bool operator!=(std::nullptr_t) const noexcept { return IsValid(); }
+
+    private:
+        constexpr Handle(uint32_t index, uint32_t generation) noexcept : m_Index(index), m_Generation(generation) {}
+
+        template<typename, typename>
+        friend class HandlePool;
+
+    private:
+        uint32_t m_Index      = 0;
+        uint32_t m_Generation = 0;
+    };
+} // namespace Galaxy
+
+namespace std
+{
+    template<typename Tag>
+    struct hash<Galaxy::Handle<Tag>>
+    {
+        size_t operator()(const Galaxy::Handle<Tag>& handle) const noexcept
+        {
+            return std::hash<uint64_t>()(handle.GetValue());
+        }
+    };
+} // namespace std
@@ -0,0 +1,153 @@
+//
+// HandlePool.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 10:20.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Container/Handle.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#include <utility>
+#include <vector>
+
+namespace Galaxy
+{
+    // Dense storage addressed through generational handles. Live values are packed at the front of one array, so
+    // iterating them is a linear walk, and a sparse slot array maps handle indices to their dense position. Destroying
+    // a value swaps the last one into its place and bumps the slot generation, which turns every outstanding copy of
+    // the handle stale instead of letting it alias whatever is created next. Not thread safe.
+    template<typename T, typename Tag>
+    class HandlePool
+    {
+    public:
+        using HandleType    = Handle<Tag>;
+        using Iterator      = typename std::vector<T>::iterator;
+        using ConstIterator = typename std::vector<T>::const_iterator;
+
+        template<typename... Args>
+        HandleType Create(Args&&... args)
+        {
+            uint32_t slotIndex;
+            if (m_FreeHead != s_InvalidIndex)
+            {
+                slotIndex  = m_FreeHead;
+                m_FreeHead = m_Slots[slotIndex].DenseIndex;
+            }
+            else
+            {
+                GAL_CORE_ASSERT(m_Slots.size() < s_InvalidIndex, "[HandlePool] Out of handle slots");
+                slotIndex = static_cast<uint32_t>(m_Slots.size());
+                m_Slots.emplace_back();
+            }
+
+            Slot& slot      = m_Slots[slotIndex];
+            slot.DenseIndex = static_cast<uint32_t>(m_Dense.size());
+            m_Dense.emplace_back(std::forward<Args>(args)...);
+            m_DenseToSlot.push_back(slotIndex);
+
+            return HandleType(slotIndex, slot.Generation);
+        }
+
+        // Returns false for null or stale handles
+        bool Destroy(HandleType handle)
+        {
+            if (!IsAlive(handle))
+            {
+                return false;
+            }
+
+            uint32_t slotIndex = handle.GetIndex();
+            uint32_t dense     = m_Slots[slotIndex].DenseIndex;
+            uint32_t last      = static_cast<uint32_t>(m_Dense.size()) - 1;
+            if (dense != last)
+            {
+                m_Dense[dense]                           = std::move(m_Dense[last]);
+                m_DenseToSlot[dense]                     = m_DenseToSlot[last];
+                m_Slots[m_DenseToSlot[dense]].DenseIndex = dense;
+            }
+            m_Dense.pop_back();
+            m_DenseToSlot.pop_back();
+
+            Release(slotIndex);
+            return true;
+        }
+
+        bool IsAlive(HandleType handle) const
+        {
+            return handle.IsValid() && handle.GetIndex() < m_Slots.size() &&
+                   m_Slots[handle.GetIndex()].Generation == handle.GetGeneration();
+        }
+
+        // nullptr for null or stale handles
+        T* Get(HandleType handle)
+        {
+            return IsAlive(handle) ? &m_Dense[m_Slots[handle.GetIndex()].DenseIndex] : nullptr;
+        }
+
+        const T* Get(HandleType handle) const
+        {
+            return IsAlive(handle) ? &m_Dense[m_Slots[handle.GetIndex()].DenseIndex] : nullptr;
+        }
+
+        // Handle of the value at a dense position, for walks that need to hand handles back out
+        HandleType GetHandle(size_t denseIndex) const
+        {
+            uint32_t slotIndex = m_DenseToSlot[denseIndex];
+            return HandleType(slotIndex, m_Slots[slotIndex].Generation);
+        }
+
+        void Reserve(size_t count)
+        {
+            m_Dense.reserve(count);
+            m_DenseToSlot.reserve(count);
+            m_Slots.reserve(count);
+        }
+
+        void Clear()
+        {
+            for (uint32_t slotIndex : m_DenseToSlot)
+            {
+                Release(slotIndex);
+            }
+            m_Dense.clear();
+            m_DenseToSlot.clear();
+        }
+
+        size_t GetSize() const { return m_Dense.size(); }
+        bool   IsEmpty() const { return m_Dense.empty(); }
+
+        Iterator      begin() { return m_Dense.begin(); }
+        Iterator      end() { return m_Dense.end(); }
+        ConstIterator begin() const { return m_Dense.begin(); }
+        ConstIterator end() const { return m_Dense.end(); }
+
+    private:
+        // A free slot reuses DenseIndex as the link of the free list
+        struct Slot
+        {
+            uint32_t DenseIndex = 0;
+            uint32_t Generation = 1;
+        };
+
+        void Release(uint32_t slotIndex)
+        {
+            Slot& slot = m_Slots[slotIndex];
+            if (++slot.Generation == 0)
+            {
+                slot.Generation = 1;
+            }
+            slot.DenseIndex = m_FreeHead;
+            m_FreeHead      = slotIndex;
+        }
+
+    private:
+        static constexpr uint32_t s_InvalidIndex = ~0U;
+
+        std::vector<T>        m_Dense;
+        std::vector<uint32_t> m_DenseToSlot;
+        std::vector<Slot>     m_Slots;
+        uint32_t              m_FreeHead = s_InvalidIndex;
+    };
+} // namespace Galaxy
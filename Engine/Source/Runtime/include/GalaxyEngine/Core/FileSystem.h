@@ -12,6 +12,10 @@ namespace Galaxy
 
         virtual std::vector<char> ReadFileAllText(const std::string& fileName) = 0;
 
+        // Writes to a sibling temporary file and renames it over fileName, so readers never see a partial file. Each
+        // call has a temporary file of its own, concurrent writers of the same file are safe and the last rename wins.
+        virtual bool WriteFileAtomically(const std::string& fileName, const std::vector<char>& data) = 0;
+
         virtual void InitExecutableDirectory(const char* executableFilePath)
         {
             std::filesystem::path exe_path(executableFilePath);
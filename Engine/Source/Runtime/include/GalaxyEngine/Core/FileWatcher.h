@@ -0,0 +1,34 @@
+//
+// FileWatcher.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 10:41.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+
+namespace Galaxy
+{
+    using FileWatchId         = uint32_t;
+    using FileChangedCallback = std::function<void(const std::filesystem::path& filePath)>;
+
+    // Reports files written, created or renamed into watched directories. Changes pile up in the background and are
+    // delivered by Poll on the calling thread, several writes to one file between two polls are reported once.
+    class FileWatcher
+    {
+    public:
+        FileWatcher()          = default;
+        virtual ~FileWatcher() = default;
+
+        virtual void Init()     = 0;
+        virtual void Shutdown() = 0;
+
+        // Only files directly inside directory are reported, not those in subdirectories. 0 on failure.
+        virtual FileWatchId WatchDirectory(const std::filesystem::path& directory, FileChangedCallback callback) = 0;
+        virtual void        Unwatch(FileWatchId watchId)                                                        = 0;
+
+        // Call once per frame, callbacks run inside
+        virtual void Poll() = 0;
+    };
+} // namespace Galaxy
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 
 template<typename T>
@@ -16,11 +17,24 @@ inline void hash_combine(std::size_t& seed, const T& v)
 }
 
 template<typename T, typename... Ts>
-inline void hash_combine(std::size_t& seed, const T& v, Ts... rest)
+inline void hash_combine(std::size_t& seed, const T& v, const Ts&... rest)
 {
     hash_combine(seed, v);
-    if constexpr (sizeof...(Ts) > 1)
+    if constexpr (sizeof...(Ts) > 0)
     {
         hash_combine(seed, rest...);
     }
 }
+
+// FNV-1a. Unlike std::hash it gives the same value on every platform and standard library, use it for anything
+// that is written to disk.
+inline uint64_t hash_fnv1a(const void* data, std::size_t size, uint64_t seed = 0xcbf29ce484222325ull)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        seed ^= bytes[i];
+        seed *= 0x100000001b3ull;
+    }
+    return seed;
+}
@@ -0,0 +1,123 @@
+//
+// JobSystem.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/24 10:12.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Galaxy
+{
+    using JobFunction = std::function<void()>;
+
+    // Tracks a group of in-flight jobs. A counter reaches zero when every job that was scheduled against it has
+    // finished, at which point jobs that depend on it are released to the workers.
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+
+        bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+        uint32_t GetPending() const { return m_Pending.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_Pending {0};
+
+        std::mutex               m_ContinuationMutex;
+        std::vector<JobFunction> m_Continuations;
+    };
+
+    struct JobSystemInitInfo
+    {
+        // 0 means "one worker per hardware thread, minus the main thread"
+        uint32_t    WorkerCount      = 0;
+        bool        PinWorkers       = false;
+        std::string WorkerNamePrefix = "GalaxyWorker";
+    };
+
+    class JobSystem
+    {
+    public:
+        JobSystem() = default;
+        ~JobSystem();
+
+        JobSystem(const JobSystem&)            = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void Init(const JobSystemInitInfo& initInfo = {});
+
+        void Shutdown();
+
+        // Schedule a job. When counter is given it is incremented now and decremented when the job finishes.
+        void Run(JobFunction job, const Ref<JobCounter>& counter = nullptr);
+
+        // Schedule a long running job, e.g. a pipeline compile, that only workers pick up once they are out of other
+        // work. The main thread never runs it, not even while it waits on the counter. Without workers it runs inline
+        // since nobody else would.
+        void RunBackground(JobFunction job, const Ref<JobCounter>& counter = nullptr);
+
+        // Schedule a job that will not start before dependency reaches zero.
+        void RunAfter(const Ref<JobCounter>& dependency, JobFunction job, const Ref<JobCounter>& counter = nullptr);
+
+        // Blocks until counter reaches zero. The calling thread executes pending jobs while it waits, so waiting from
+        // inside a job never deadlocks the pool.
+        void Wait(const Ref<JobCounter>& counter);
+
+        // Splits [0, count) into batches of batchSize and runs func(begin, end) for each batch, then waits.
+        void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& func);
+
+        // Number of threads able to run jobs, including the main thread.
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Queues.size()); }
+
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+        // 0 on the main thread (or any non-worker thread), 1..N on workers.
+        static uint32_t GetCurrentThreadIndex();
+
+        static void SetCurrentThreadName(const std::string& name);
+
+        static bool PinCurrentThreadToCore(uint32_t coreIndex);
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex              Mutex;
+            std::deque<JobFunction> Jobs;
+        };
+
+        void WorkerLoop(uint32_t threadIndex);
+
+        void Push(JobFunction job);
+
+        bool TryPop(uint32_t threadIndex, JobFunction& job);
+
+        bool TrySteal(uint32_t thiefIndex, JobFunction& job);
+
+        bool RunOne(uint32_t threadIndex);
+
+        bool RunOneBackground();
+
+        void Finish(const Ref<JobCounter>& counter);
+
+    private:
+        std::vector<Scope<WorkQueue>> m_Queues;
+        WorkQueue                     m_BackgroundQueue; // workers only
+        std::vector<std::thread>      m_Workers;
+
+        std::mutex              m_WakeMutex;
+        std::condition_variable m_WakeCondition;
+        std::atomic<uint32_t>   m_QueuedJobs {0};
+        std::atomic<bool>       m_Running {false};
+    };
+} // namespace Galaxy
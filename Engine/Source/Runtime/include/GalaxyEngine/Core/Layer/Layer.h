@@ -23,7 +23,32 @@ namespace Galaxy
 
         inline const std::string& GetName() const { return m_DebugName; }
 
+        // Whether this layer's OnUpdate may run on a job worker next to other parallel layers.
+        // Layers that do not opt in are update barriers and always run on the main thread.
+        inline bool IsParallelUpdate() const { return m_ParallelUpdate; }
+
+        inline const std::vector<std::string>& GetReads() const { return m_Reads; }
+
+        inline const std::vector<std::string>& GetWrites() const { return m_Writes; }
+
+        // True when the declared reads / writes of both layers overlap with at least one writer
+        bool ConflictsWith(const Layer& other) const;
+
+    protected:
+        // Opt into the parallel update phase. Declare every shared resource touched in OnUpdate with
+        // DeclareRead / DeclareWrite, the LayerStack orders conflicting layers by their stack position.
+        void SetParallelUpdate(bool parallel) { m_ParallelUpdate = parallel; }
+
+        void DeclareRead(const std::string& resource) { m_Reads.emplace_back(resource); }
+
+        void DeclareWrite(const std::string& resource) { m_Writes.emplace_back(resource); }
+
     protected:
         std::string m_DebugName;
+
+    private:
+        bool                     m_ParallelUpdate = false;
+        std::vector<std::string> m_Reads;
+        std::vector<std::string> m_Writes;
     };
 } // namespace Galaxy
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 namespace Galaxy
 {
+    class JobSystem;
+
     class LayerStack
     {
     public:
@@ -20,6 +22,11 @@ namespace Galaxy
 
         void PopOverlay(Ref<Layer> overlay);
 
+        // Updates every layer for this frame. Layers are grouped into waves by their declared reads / writes, layers
+        // inside a wave run concurrently on the job system and waves run in stack order. Barrier (non-parallel)
+        // layers get a wave of their own on the calling thread, and overlays never start before all layers finished.
+        void OnUpdate(TimeStep ts, JobSystem& jobSystem);
+
         std::vector<Ref<Layer>>::
 
             iterator
@@ -84,8 +91,15 @@ namespace Galaxy
             return m_Layers.rend();
         }
 
+    private:
+        void BuildUpdateWaves();
+
     private:
         std::vector<Ref<Layer>> m_Layers;
         unsigned int            m_LayerInsertIndex = 0;
+
+        // Per-frame scratch for the update graph, kept around to avoid reallocating every frame
+        std::vector<uint32_t> m_UpdateWaves;
+        std::vector<uint32_t> m_UpdateOrder;
     };
 } // namespace Galaxy
\ No newline at end of file
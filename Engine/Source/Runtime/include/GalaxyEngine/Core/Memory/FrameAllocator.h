@@ -0,0 +1,178 @@
+//
+// FrameAllocator.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/24 15:40.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace Galaxy
+{
+    // Bump allocator over a list of blocks. Allocations are never freed one by one, the whole arena is rewound with
+    // Reset() or back to a Marker. Not thread safe, every thread gets its own arena.
+    class LinearArena
+    {
+    public:
+        struct Marker
+        {
+            size_t Block  = 0;
+            size_t Offset = 0;
+            size_t Used   = 0;
+        };
+
+        explicit LinearArena(size_t blockSize = 64 * 1024);
+
+        LinearArena(const LinearArena&)            = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        template<typename T>
+        T* AllocateArray(size_t count)
+        {
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        Marker GetMarker() const { return {m_CurrentBlock, m_Offset, m_UsedBytes}; }
+
+        void ResetToMarker(const Marker& marker);
+
+        // Rewinds the arena. If the last cycle spilled into several blocks they are merged into one, so a steady
+        // workload ends up with a single block and no heap traffic at all.
+        void Reset();
+
+        size_t GetUsedBytes() const { return m_UsedBytes; }
+
+        size_t GetCapacity() const;
+
+    private:
+        struct Block
+        {
+            Scope<std::byte[]> Memory;
+            size_t             Size = 0;
+        };
+
+        void AddBlock(size_t minSize, size_t index);
+
+    private:
+        std::vector<Block> m_Blocks;
+        size_t             m_BlockSize;
+        size_t             m_CurrentBlock = 0;
+        size_t             m_Offset       = 0;
+        size_t             m_UsedBytes    = 0;
+    };
+
+    // Rewinds an arena to where it was on construction, for scratch memory inside a single function.
+    class ScopedArenaMarker
+    {
+    public:
+        explicit ScopedArenaMarker(LinearArena& arena) : m_Arena(arena), m_Marker(arena.GetMarker()) {}
+        ~ScopedArenaMarker() { m_Arena.ResetToMarker(m_Marker); }
+
+        ScopedArenaMarker(const ScopedArenaMarker&)            = delete;
+        ScopedArenaMarker& operator=(const ScopedArenaMarker&) = delete;
+
+    private:
+        LinearArena&        m_Arena;
+        LinearArena::Marker m_Marker;
+    };
+
+    // STL allocator adapter. deallocate() is a no-op, memory comes back when the arena is rewound, so containers
+    // using it must not outlive the arena cycle they were created in.
+    template<typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(LinearArena* arena) noexcept : m_Arena(arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_Arena(other.GetArena())
+        {}
+
+        T* allocate(size_t count) { return m_Arena->AllocateArray<T>(count); }
+
+        void deallocate(T*, size_t) noexcept {}
+
+        LinearArena* GetArena() const noexcept { return m_Arena; }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept
+        {
+            return m_Arena == other.GetArena();
+        }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const noexcept
+        {
+            return m_Arena != other.GetArena();
+        }
+
+    private:
+        LinearArena* m_Arena;
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    struct FrameAllocatorInitInfo
+    {
+        uint32_t FramesInFlight = 1;
+        uint32_t ThreadCount    = 1;
+        size_t   BlockSize      = 256 * 1024;
+    };
+
+    // Frame scoped scratch memory. There is one ring slot per frame in flight and one sub-arena per job system thread
+    // inside every slot. A slot is only recycled by BeginFrame(), which the renderer calls once the fence of that
+    // frame has signaled, so memory handed out during frame N stays valid until the GPU is done with frame N.
+    //
+    // Only the thread that called Init (the main thread) and job system workers may allocate. Every other thread
+    // reports job thread index 0 as well and would share the main thread's arena, that asserts.
+    class FrameAllocator
+    {
+    public:
+        FrameAllocator() = default;
+
+        void Init(const FrameAllocatorInitInfo& initInfo);
+
+        void BeginFrame(uint32_t frameIndex);
+
+        // Arena of the current frame for the calling thread, which must be the main thread or a job worker
+        LinearArena& GetThreadArena();
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+        {
+            return GetThreadArena().Allocate(size, alignment);
+        }
+
+        template<typename T>
+        T* AllocateArray(size_t count)
+        {
+            return GetThreadArena().AllocateArray<T>(count);
+        }
+
+        template<typename T>
+        ArenaAllocator<T> GetStlAllocator()
+        {
+            return ArenaAllocator<T>(&GetThreadArena());
+        }
+
+        uint32_t GetCurrentFrameIndex() const { return m_CurrentFrame.load(std::memory_order_acquire); }
+
+        uint32_t GetFramesInFlight() const { return static_cast<uint32_t>(m_Slots.size()); }
+
+        size_t GetUsedBytes(uint32_t frameIndex) const;
+
+    private:
+        std::vector<std::vector<Scope<LinearArena>>> m_Slots;
+        std::atomic<uint32_t>                        m_CurrentFrame {0};
+        std::thread::id                              m_MainThreadId; // owns arena 0 of every slot
+    };
+} // namespace Galaxy
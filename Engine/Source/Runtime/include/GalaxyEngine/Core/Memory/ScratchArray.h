@@ -0,0 +1,82 @@
+//
+// ScratchArray.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 09:30.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Memory/FrameAllocator.h"
+
+#include <new>
+#include <type_traits>
+
+namespace Galaxy
+{
+    // Per-thread arena backing ScratchArray overflow. Rewound in LIFO order by the arrays that use it.
+    LinearArena& GetThreadScratchArena();
+
+    // Fixed size, value-initialized array for short-lived temporaries such as RHI -> Vulkan struct translation.
+    // Up to InlineCount elements live inside the object itself, larger counts are carved out of the thread's scratch
+    // arena and given back when the array goes out of scope. Never touches the heap in steady state.
+    template<typename T, size_t InlineCount>
+    class ScratchArray
+    {
+        static_assert(InlineCount > 0, "ScratchArray needs inline storage");
+        static_assert(std::is_trivially_destructible_v<T>, "ScratchArray only holds trivially destructible types");
+
+    public:
+        explicit ScratchArray(size_t count) : m_Size(count)
+        {
+            if (count <= InlineCount)
+            {
+                m_Data = reinterpret_cast<T*>(m_Inline);
+            }
+            else
+            {
+                m_Arena  = &GetThreadScratchArena();
+                m_Marker = m_Arena->GetMarker();
+                m_Data   = m_Arena->AllocateArray<T>(count);
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                new (&m_Data[i]) T {};
+            }
+        }
+
+        ~ScratchArray()
+        {
+            if (m_Arena != nullptr)
+            {
+                m_Arena->ResetToMarker(m_Marker);
+            }
+        }
+
+        ScratchArray(const ScratchArray&)            = delete;
+        ScratchArray& operator=(const ScratchArray&) = delete;
+
+        T*       data() { return m_Data; }
+        const T* data() const { return m_Data; }
+
+        size_t size() const { return m_Size; }
+        bool   empty() const { return m_Size == 0; }
+
+        T&       operator[](size_t index) { return m_Data[index]; }
+        const T& operator[](size_t index) const { return m_Data[index]; }
+
+        T*       begin() { return m_Data; }
+        T*       end() { return m_Data + m_Size; }
+        const T* begin() const { return m_Data; }
+        const T* end() const { return m_Data + m_Size; }
+
+        bool IsInline() const { return m_Arena == nullptr; }
+
+    private:
+        alignas(T) std::byte m_Inline[sizeof(T) * InlineCount];
+        T*                   m_Data  = nullptr;
+        size_t               m_Size  = 0;
+        LinearArena*         m_Arena = nullptr;
+        LinearArena::Marker  m_Marker;
+    };
+} // namespace Galaxy
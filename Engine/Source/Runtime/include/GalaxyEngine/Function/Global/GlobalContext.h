@@ -11,21 +11,28 @@
 namespace Galaxy
 {
     class LoggerSystem;
+    class JobSystem;
+    class FrameAllocator;
     class FileSystem;
+    class FileWatcher;
     class WindowSystem;
     class RenderSystem;
 
     struct RuntimeGlobalContextInitInfo
     {
-        std::string AppName = "Galaxy Application";
+        std::string AppName        = "Galaxy Application";
+        const char* ExecutablePath = nullptr;
     };
 
     struct RuntimeGlobalContext
     {
-        Ref<LoggerSystem> LoggerSys;
-        Ref<FileSystem>   FileSys;
-        Ref<WindowSystem> WindowSys;
-        Ref<RenderSystem> RenderSys;
+        Ref<LoggerSystem>   LoggerSys;
+        Ref<JobSystem>      JobSys;
+        Ref<FrameAllocator> FrameAllocSys;
+        Ref<FileSystem>     FileSys;
+        Ref<FileWatcher>    FileWatcherSys;
+        Ref<WindowSystem>   WindowSys;
+        Ref<RenderSystem>   RenderSys;
 
     public:
         void StartSystems(RuntimeGlobalContextInitInfo initInfo);
@@ -0,0 +1,78 @@
+//
+// PipelineLayoutCache.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/29 14:05.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+#include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
+#include "GalaxyEngine/Function/Renderer/ShaderReflection.h"
+
+#include <mutex>
+#include <string>
+
+namespace Galaxy
+{
+    struct PipelineLayoutCacheInitInfo
+    {
+        Ref<RHI> Rhi;
+    };
+
+    // Layouts for one pipeline, SetLayouts and UpdateTemplates are indexed by set number
+    struct ShaderPipelineLayout
+    {
+        RHIPipelineLayout                        PipelineLayout;
+        std::vector<RHIDescriptorSetLayout>      SetLayouts;
+        std::vector<RHIDescriptorUpdateTemplate> UpdateTemplates; // see GetUpdateTemplate
+    };
+
+    // Deduplicates descriptor set layouts and pipeline layouts by content, so passes declaring the same bindings
+    // share one layout and sets allocated for one are compatible with all of them. Layouts are small and few, they
+    // live until Shutdown.
+    //
+    // Keys hold the full layout description like in PipelineStateCache, so a hash collision never shares a layout.
+    // Binding order is part of the key, GetLayouts always passes them sorted.
+    class PipelineLayoutCache
+    {
+    public:
+        void Init(PipelineLayoutCacheInitInfo initInfo);
+        void Shutdown();
+
+        // Builds every layout a pipeline with these shaders needs, reflection should be merged over all its stages.
+        // Sets the shaders skip get an empty layout, sets with runtime sized arrays the RHI's bindless layout. The
+        // update template of every other set is built as well, and new set layouts register their descriptor counts
+        // with RHI::RegisterDescriptorSetSizes.
+        bool GetLayouts(const ShaderReflection& reflection, ShaderPipelineLayout& outLayout);
+
+        // Template writing every binding of set from one packed struct: the descriptors of each binding in binding
+        // order, as RHIDescriptorImageInfo, RHIDescriptorBufferInfo or RHIBufferView aligned like C++ struct members.
+        // Null for sets the shaders skip and for the bindless set.
+        RHIDescriptorUpdateTemplate GetUpdateTemplate(const ShaderReflection& reflection, uint32_t set);
+
+        RHIDescriptorSetLayout GetSetLayout(const RHIDescriptorSetLayoutBinding* pBindings, uint32_t bindingCount);
+        RHIPipelineLayout      GetPipelineLayout(const RHIDescriptorSetLayout* pSetLayouts,
+                                                 uint32_t                      setLayoutCount,
+                                                 const RHIPushConstantRange*   pPushConstantRanges,
+                                                 uint32_t                      pushConstantRangeCount);
+
+        size_t GetSetLayoutCount() const;
+        size_t GetPipelineLayoutCount() const;
+        size_t GetUpdateTemplateCount() const;
+
+    private:
+        RHIDescriptorSetLayout
+        GetSetLayout(const RHIDescriptorSetLayoutBinding* pBindings, uint32_t bindingCount, bool& outIsNew);
+
+    private:
+        Ref<RHI> m_RHI;
+
+        mutable std::mutex                                      m_Mutex;
+        std::unordered_map<std::string, RHIDescriptorSetLayout> m_SetLayouts;
+        std::unordered_map<std::string, RHIPipelineLayout>      m_PipelineLayouts;
+
+        // the entries follow from the bindings, so the deduplicated set layout is key enough
+        std::unordered_map<RHIDescriptorSetLayout, RHIDescriptorUpdateTemplate> m_UpdateTemplates;
+    };
+} // namespace Galaxy
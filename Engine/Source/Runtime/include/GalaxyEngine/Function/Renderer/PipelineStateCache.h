@@ -0,0 +1,114 @@
+//
+// PipelineStateCache.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/27 14:36.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+#include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
+
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Galaxy
+{
+    struct PipelineStateCacheInitInfo
+    {
+        Ref<RHI> Rhi;
+
+        // unreferenced pipelines kept around in case the same state is requested again
+        uint32_t MaxIdlePipelines = 256;
+    };
+
+    // Deduplicates pipeline creation. Descriptions are matched by content, so materials asking for the same state get
+    // the same RHIPipeline back. Pipelines are reference counted. Once nothing references one it becomes idle and
+    // is destroyed in least recently used order when there are more than MaxIdlePipelines idle ones.
+    //
+    // Keys are the serialized descriptions and a hit compares them in full, so a hash collision never returns the
+    // wrong pipeline. pNext chains are opaque and only match when the very same chain pointer is passed again.
+    //
+    // Pipelines are created and destroyed on the thread that called Init. Acquire from another thread blocks until
+    // that thread serves the request in BeginFrame, so it must not come from a job the render thread waits for.
+    class PipelineStateCache
+    {
+    public:
+        void Init(PipelineStateCacheInitInfo initInfo);
+
+        // Destroys every pipeline, referenced or not
+        void Shutdown();
+
+        // Returns the pipeline for this description, creating it on the first request. Every successful Acquire
+        // needs a matching Release. Returns a null handle when creation failed. Waits if the same state is still
+        // being compiled by an earlier AcquireAsync.
+        RHIPipeline Acquire(const RHIGraphicsPipelineCreateInfo& createInfo);
+        RHIPipeline Acquire(const RHIComputePipelineCreateInfo& createInfo);
+
+        // Same as Acquire, but a new pipeline is compiled on a job system worker and the handle is returned right
+        // away. Needs a matching Release as well, whether the compile succeeds or not.
+        RHIPipeline AcquireAsync(const RHIGraphicsPipelineCreateInfo& createInfo);
+        RHIPipeline AcquireAsync(const RHIComputePipelineCreateInfo& createInfo);
+
+        // The pipeline to bind this frame: pipeline once it is ready, fallback until then. A null fallback means the
+        // draw should be skipped.
+        RHIPipeline Resolve(RHIPipeline pipeline, RHIPipeline fallback = nullptr) const;
+
+        void Release(RHIPipeline pipeline);
+
+        // Call once per frame after RHI::WaitForFences. Serves pipelines requested from other threads, then destroys
+        // the oldest idle pipelines over the limit once every frame in flight that could still use them has retired.
+        void BeginFrame();
+
+        static size_t Hash(const RHIGraphicsPipelineCreateInfo& createInfo);
+        static size_t Hash(const RHIComputePipelineCreateInfo& createInfo);
+
+        size_t GetPipelineCount() const;
+        size_t GetIdlePipelineCount() const;
+
+    private:
+        struct Entry
+        {
+            RHIPipeline                             Pipeline;
+            uint32_t                                RefCount      = 0;
+            uint64_t                                ReleasedFrame = 0;
+            std::list<const std::string*>::iterator IdleIterator;
+        };
+
+        struct PendingRequest
+        {
+            std::function<RHIPipeline()> Request;
+            std::promise<RHIPipeline>    Result;
+        };
+
+        static std::string MakeKey(const RHIGraphicsPipelineCreateInfo& createInfo);
+        static std::string MakeKey(const RHIComputePipelineCreateInfo& createInfo);
+
+        template<typename CreateFunction>
+        RHIPipeline AcquireOrCreate(std::string&& key, CreateFunction&& create);
+
+        bool        IsRenderThread() const;
+        RHIPipeline RunOnRenderThread(const std::function<RHIPipeline()>& request);
+
+        void AddReference(Entry& entry);
+
+        RHIPipeline WaitUntilReady(RHIPipeline pipeline);
+
+    private:
+        Ref<RHI> m_RHI;
+        uint32_t m_MaxIdlePipelines = 256;
+        uint64_t m_FrameNumber      = 0;
+
+        std::thread::id m_RenderThreadId;
+
+        mutable std::mutex                                  m_Mutex;
+        std::unordered_map<std::string, Entry>              m_Entries;
+        std::unordered_map<RHIPipeline, const std::string*> m_PipelineKeys; // points at the key inside m_Entries
+        std::list<const std::string*>                       m_IdleKeys;     // least recently released first
+        std::vector<PendingRequest*>                        m_Requests;     // from other threads, served in BeginFrame
+    };
+} // namespace Galaxy
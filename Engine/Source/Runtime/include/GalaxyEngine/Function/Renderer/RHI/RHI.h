@@ -31,43 +31,55 @@ namespace Galaxy
         virtual bool IsPointLightShadowEnabled() = 0;
         // allocate and create
         virtual bool        AllocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo,
-                                                   RHICommandBuffer*&                  pCommandBuffers)                             = 0;
+                                                   RHICommandBuffer&                   pCommandBuffers)                             = 0;
+        // pDescriptorSets receives descriptorSetCount handles. A null descriptorPool allocates from pools the
+        // backend adds as needed, the sets live until FreeDescriptorSets or shutdown.
         virtual bool        AllocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo,
-                                                   RHIDescriptorSet*&                  pDescriptorSets)                             = 0;
+                                                   RHIDescriptorSet*                   pDescriptorSets)                             = 0;
+        // Sets for the current frame only, recycled all at once when its fence signals. descriptorPool is ignored.
+        virtual bool        AllocateFrameDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo,
+                                                        RHIDescriptorSet*                   pDescriptorSets)                        = 0;
+        // Descriptors one set allocated with a null descriptorPool needs, as ShaderReflection::AccumulatePoolSizes
+        // reports them. Pools added afterwards are sized for the average of every set registered so far.
+        virtual void        RegisterDescriptorSetSizes(const RHIDescriptorPoolSize* pPoolSizes,
+                                                       uint32_t                     poolSizeCount)                 = 0;
         virtual void        CreateSwapchain()                                                                      = 0;
         virtual void        RecreateSwapchain()                                                                    = 0;
         virtual void        CreateSwapchainImageViews()                                                            = 0;
         virtual void        CreateFramebufferImageAndView()                                                        = 0;
-        virtual RHISampler* GetOrCreateDefaultSampler(RHIDefaultSamplerType type)                                  = 0;
-        virtual RHISampler* GetOrCreateMipmapSampler(uint32_t width, uint32_t height)                              = 0;
-        virtual RHIShader*  CreateShaderModule(const std::vector<unsigned char>& shaderCode)                       = 0;
+        virtual RHISampler  GetOrCreateDefaultSampler(RHIDefaultSamplerType type)                                  = 0;
+        virtual RHISampler  GetOrCreateMipmapSampler(uint32_t width, uint32_t height)                              = 0;
+        virtual RHIShader   CreateShaderModule(const std::vector<unsigned char>& shaderCode)                       = 0;
         virtual void        CreateBuffer(RHIDeviceSize          size,
                                          RHIBufferUsageFlags    usage,
                                          RHIMemoryPropertyFlags properties,
-                                         RHIBuffer*&            buffer,
-                                         RHIDeviceMemory*&      bufferMemory)                                           = 0;
+                                         RHIBuffer&             buffer,
+                                         RHIDeviceMemory&       bufferMemory)                                           = 0;
         virtual void        CreateBufferAndInitialize(RHIBufferUsageFlags    usage,
                                                       RHIMemoryPropertyFlags properties,
-                                                      RHIBuffer*&            buffer,
-                                                      RHIDeviceMemory*&      bufferMemory,
+                                                      RHIBuffer&             buffer,
+                                                      RHIDeviceMemory&       bufferMemory,
                                                       RHIDeviceSize          size,
                                                       void*                  data     = nullptr,
                                                       int                    datasize = 0)                                            = 0;
         virtual bool        CreateBufferVma(VmaAllocator                   allocator,
                                             const RHIBufferCreateInfo*     pBufferCreateInfo,
                                             const VmaAllocationCreateInfo* pAllocationCreateInfo,
-                                            RHIBuffer*&                    pBuffer,
+                                            RHIBuffer&                     pBuffer,
                                             VmaAllocation*                 pAllocation,
                                             VmaAllocationInfo*             pAllocationInfo)                                    = 0;
         virtual bool        CreateBufferWithAlignmentVma(VmaAllocator                   allocator,
                                                          const RHIBufferCreateInfo*     pBufferCreateInfo,
                                                          const VmaAllocationCreateInfo* pAllocationCreateInfo,
                                                          RHIDeviceSize                  minAlignment,
-                                                         RHIBuffer*&                    pBuffer,
+                                                         RHIBuffer&                     pBuffer,
                                                          VmaAllocation*                 pAllocation,
                                                          VmaAllocationInfo*             pAllocationInfo)                       = 0;
-        virtual void        CopyBuffer(RHIBuffer*    srcBuffer,
-                                       RHIBuffer*    dstBuffer,
+        // Asynchronous: returns before the copy has run, it is submitted ahead of the current frame. Vertex, index,
+        // uniform and shader reads recorded for that frame or later see the data, the host only once the frame's
+        // fence has signaled. Both buffers must outlive that frame.
+        virtual void        CopyBuffer(RHIBuffer     srcBuffer,
+                                       RHIBuffer     dstBuffer,
                                        RHIDeviceSize srcOffset,
                                        RHIDeviceSize dstOffset,
                                        RHIDeviceSize size)                                                         = 0;
@@ -77,28 +89,28 @@ namespace Galaxy
                                         RHIImageTiling         imageTiling,
                                         RHIImageUsageFlags     imageUsageFlags,
                                         RHIMemoryPropertyFlags memoryPropertyFlags,
-                                        RHIImage*&             image,
-                                        RHIDeviceMemory*&      memory,
+                                        RHIImage&              image,
+                                        RHIDeviceMemory&       memory,
                                         RHIImageCreateFlags    imageCreateFlags,
                                         uint32_t               arrayLayers,
                                         uint32_t               miplevels)                                                        = 0;
-        virtual void        CreateImageView(RHIImage*           image,
+        virtual void        CreateImageView(RHIImage            image,
                                             RHIFormat           format,
                                             RHIImageAspectFlags imageAspectFlags,
                                             RHIImageViewType    viewType,
                                             uint32_t            layoutCount,
                                             uint32_t            miplevels,
-                                            RHIImageView*&      imageView)                                              = 0;
-        virtual void        CreateGlobalImage(RHIImage*&     image,
-                                              RHIImageView*& imageView,
+                                            RHIImageView&       imageView)                                              = 0;
+        virtual void        CreateGlobalImage(RHIImage&      image,
+                                              RHIImageView&  imageView,
                                               VmaAllocation& imageAllocation,
                                               uint32_t       textureImageWidth,
                                               uint32_t       textureImageHeight,
                                               void*          textureImagePixels,
                                               RHIFormat      textureImageFormat,
                                               uint32_t       miplevels = 0)                                              = 0;
-        virtual void        CreateCubeMap(RHIImage*&           image,
-                                          RHIImageView*&       imageView,
+        virtual void        CreateCubeMap(RHIImage&            image,
+                                          RHIImageView&        imageView,
                                           VmaAllocation&       imageAllocation,
                                           uint32_t             textureImageWidth,
                                           uint32_t             textureImageHeight,
@@ -106,111 +118,114 @@ namespace Galaxy
                                           RHIFormat            textureImageFormat,
                                           uint32_t             miplevels)                                                      = 0;
         virtual void        CreateCommandPool()                                                                    = 0;
-        virtual bool CreateCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool*& pCommandPool) = 0;
+        virtual bool CreateCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool& pCommandPool)  = 0;
         virtual bool CreateDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo,
-                                          RHIDescriptorPool*&                pDescriptorPool)                                     = 0;
+                                          RHIDescriptorPool&                 pDescriptorPool)                                     = 0;
         virtual bool CreateDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo,
-                                               RHIDescriptorSetLayout*&                pSetLayout)                                = 0;
-        virtual bool CreateFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence*& pFence)                         = 0;
-        virtual bool CreateFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer*& pFramebuffer) = 0;
-        virtual bool CreateGraphicsPipelines(RHIPipelineCache*                    pipelineCache,
+                                               RHIDescriptorSetLayout&                 pSetLayout)                                = 0;
+        // Writes whole sets of the layout from packed data, see UpdateDescriptorSetWithTemplate
+        virtual bool CreateDescriptorUpdateTemplate(const RHIDescriptorUpdateTemplateCreateInfo* pCreateInfo,
+                                                    RHIDescriptorUpdateTemplate&                 pUpdateTemplate)  = 0;
+        virtual bool CreateFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence& pFence)                          = 0;
+        virtual bool CreateFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer& pFramebuffer)  = 0;
+        virtual bool CreateGraphicsPipelines(RHIPipelineCache                     pipelineCache,
                                              uint32_t                             createInfoCount,
                                              const RHIGraphicsPipelineCreateInfo* pCreateInfos,
-                                             RHIPipeline*&                        pPipelines)                                             = 0;
-        virtual bool CreateComputePipelines(RHIPipelineCache*                   pipelineCache,
+                                             RHIPipeline*                         pPipelines)                                             = 0;
+        virtual bool CreateComputePipelines(RHIPipelineCache                    pipelineCache,
                                             uint32_t                            createInfoCount,
                                             const RHIComputePipelineCreateInfo* pCreateInfos,
-                                            RHIPipeline*&                       pPipelines)                                              = 0;
+                                            RHIPipeline*                        pPipelines)                                              = 0;
         virtual bool CreatePipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo,
-                                          RHIPipelineLayout*&                pPipelineLayout)                                     = 0;
-        virtual bool CreateRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass*& pRenderPass)     = 0;
-        virtual bool CreateSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler*& pSampler)                 = 0;
-        virtual bool CreateSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore*& pSemaphore)         = 0;
+                                          RHIPipelineLayout&                 pPipelineLayout)                                     = 0;
+        virtual bool CreateRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass& pRenderPass)      = 0;
+        virtual bool CreateSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler& pSampler)                  = 0;
+        virtual bool CreateSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore& pSemaphore)          = 0;
 
         // command and command write
         virtual bool
-        WaitForFencesPfn(uint32_t fenceCount, RHIFence* const* pFence, RHIBool32 waitAll, uint64_t timeout) = 0;
-        virtual bool ResetFencesPfn(uint32_t fenceCount, RHIFence* const* pFences)                          = 0;
-        virtual bool ResetCommandPoolPfn(RHICommandPool* commandPool, RHICommandPoolResetFlags flags)       = 0;
-        virtual bool BeginCommandBufferPfn(RHICommandBuffer*                commandBuffer,
+        WaitForFencesPfn(uint32_t fenceCount, const RHIFence* pFence, RHIBool32 waitAll, uint64_t timeout) = 0;
+        virtual bool ResetFencesPfn(uint32_t fenceCount, const RHIFence* pFences)                           = 0;
+        virtual bool ResetCommandPoolPfn(RHICommandPool commandPool, RHICommandPoolResetFlags flags)        = 0;
+        virtual bool BeginCommandBufferPfn(RHICommandBuffer                 commandBuffer,
                                            const RHICommandBufferBeginInfo* pBeginInfo)                     = 0;
-        virtual bool EndCommandBufferPfn(RHICommandBuffer* commandBuffer)                                   = 0;
-        virtual void CmdBeginRenderPassPfn(RHICommandBuffer*             commandBuffer,
+        virtual bool EndCommandBufferPfn(RHICommandBuffer commandBuffer)                                    = 0;
+        virtual void CmdBeginRenderPassPfn(RHICommandBuffer              commandBuffer,
                                            const RHIRenderPassBeginInfo* pRenderPassBegin,
                                            RHISubpassContents            contents)                                     = 0;
-        virtual void CmdNextSubpassPfn(RHICommandBuffer* commandBuffer, RHISubpassContents contents)        = 0;
-        virtual void CmdEndRenderPassPfn(RHICommandBuffer* commandBuffer)                                   = 0;
-        virtual void CmdBindPipelinePfn(RHICommandBuffer*    commandBuffer,
+        virtual void CmdNextSubpassPfn(RHICommandBuffer commandBuffer, RHISubpassContents contents)         = 0;
+        virtual void CmdEndRenderPassPfn(RHICommandBuffer commandBuffer)                                    = 0;
+        virtual void CmdBindPipelinePfn(RHICommandBuffer     commandBuffer,
                                         RHIPipelineBindPoint pipelineBindPoint,
-                                        RHIPipeline*         pipeline)                                              = 0;
-        virtual void CmdSetViewportPfn(RHICommandBuffer*  commandBuffer,
+                                        RHIPipeline          pipeline)                                              = 0;
+        virtual void CmdSetViewportPfn(RHICommandBuffer   commandBuffer,
                                        uint32_t           firstViewport,
                                        uint32_t           viewportCount,
                                        const RHIViewport* pViewports)                                       = 0;
-        virtual void CmdSetScissorPfn(RHICommandBuffer* commandBuffer,
-                                      uint32_t          firstScissor,
-                                      uint32_t          scissorCount,
-                                      const RHIRect2D*  pScissors)                                           = 0;
-        virtual void CmdBindVertexBuffersPfn(RHICommandBuffer*    commandBuffer,
+        virtual void CmdSetScissorPfn(RHICommandBuffer commandBuffer,
+                                      uint32_t         firstScissor,
+                                      uint32_t         scissorCount,
+                                      const RHIRect2D* pScissors)                                            = 0;
+        virtual void CmdBindVertexBuffersPfn(RHICommandBuffer     commandBuffer,
                                              uint32_t             firstBinding,
                                              uint32_t             bindingCount,
-                                             RHIBuffer* const*    pBuffers,
+                                             const RHIBuffer*     pBuffers,
                                              const RHIDeviceSize* pOffsets)                                 = 0;
-        virtual void CmdBindIndexBufferPfn(RHICommandBuffer* commandBuffer,
-                                           RHIBuffer*        buffer,
-                                           RHIDeviceSize     offset,
-                                           RHIIndexType      indexType)                                          = 0;
-        virtual void CmdBindDescriptorSetsPfn(RHICommandBuffer*              commandBuffer,
-                                              RHIPipelineBindPoint           pipelineBindPoint,
-                                              RHIPipelineLayout*             layout,
-                                              uint32_t                       firstSet,
-                                              uint32_t                       descriptorSetCount,
-                                              const RHIDescriptorSet* const* pDescriptorSets,
-                                              uint32_t                       dynamicOffsetCount,
-                                              const uint32_t*                pDynamicOffsets)                              = 0;
-        virtual void CmdDrawIndexedPfn(RHICommandBuffer* commandBuffer,
-                                       uint32_t          indexCount,
-                                       uint32_t          instanceCount,
-                                       uint32_t          firstIndex,
-                                       int32_t           vertexOffset,
-                                       uint32_t          firstInstance)                                              = 0;
-        virtual void CmdClearAttachmentsPfn(RHICommandBuffer*         commandBuffer,
+        virtual void CmdBindIndexBufferPfn(RHICommandBuffer commandBuffer,
+                                           RHIBuffer        buffer,
+                                           RHIDeviceSize    offset,
+                                           RHIIndexType     indexType)                                           = 0;
+        virtual void CmdBindDescriptorSetsPfn(RHICommandBuffer        commandBuffer,
+                                              RHIPipelineBindPoint    pipelineBindPoint,
+                                              RHIPipelineLayout       layout,
+                                              uint32_t                firstSet,
+                                              uint32_t                descriptorSetCount,
+                                              const RHIDescriptorSet* pDescriptorSets,
+                                              uint32_t                dynamicOffsetCount,
+                                              const uint32_t*         pDynamicOffsets)                                     = 0;
+        virtual void CmdDrawIndexedPfn(RHICommandBuffer commandBuffer,
+                                       uint32_t         indexCount,
+                                       uint32_t         instanceCount,
+                                       uint32_t         firstIndex,
+                                       int32_t          vertexOffset,
+                                       uint32_t         firstInstance)                                               = 0;
+        virtual void CmdClearAttachmentsPfn(RHICommandBuffer          commandBuffer,
                                             uint32_t                  attachmentCount,
                                             const RHIClearAttachment* pAttachments,
                                             uint32_t                  rectCount,
                                             const RHIClearRect*       pRects)                                     = 0;
 
-        virtual bool BeginCommandBuffer(RHICommandBuffer*                commandBuffer,
+        virtual bool BeginCommandBuffer(RHICommandBuffer                 commandBuffer,
                                         const RHICommandBufferBeginInfo* pBeginInfo)                               = 0;
-        virtual void CmdCopyImageToBuffer(RHICommandBuffer*         commandBuffer,
-                                          RHIImage*                 srcImage,
+        virtual void CmdCopyImageToBuffer(RHICommandBuffer          commandBuffer,
+                                          RHIImage                  srcImage,
                                           RHIImageLayout            srcImageLayout,
-                                          RHIBuffer*                dstBuffer,
+                                          RHIBuffer                 dstBuffer,
                                           uint32_t                  regionCount,
                                           const RHIBufferImageCopy* pRegions)                                      = 0;
-        virtual void CmdCopyImageToImage(RHICommandBuffer*      commandBuffer,
-                                         RHIImage*              srcImage,
+        virtual void CmdCopyImageToImage(RHICommandBuffer       commandBuffer,
+                                         RHIImage               srcImage,
                                          RHIImageAspectFlagBits srcFlag,
-                                         RHIImage*              dstImage,
+                                         RHIImage               dstImage,
                                          RHIImageAspectFlagBits dstFlag,
                                          uint32_t               width,
                                          uint32_t               height)                                                          = 0;
-        virtual void CmdCopyBuffer(RHICommandBuffer* commandBuffer,
-                                   RHIBuffer*        srcBuffer,
-                                   RHIBuffer*        dstBuffer,
-                                   uint32_t          regionCount,
-                                   RHIBufferCopy*    pRegions)                                                        = 0;
-        virtual void CmdDraw(RHICommandBuffer* commandBuffer,
-                             uint32_t          vertexCount,
-                             uint32_t          instanceCount,
-                             uint32_t          firstVertex,
-                             uint32_t          firstInstance)                                                               = 0;
-        virtual void CmdDispatch(RHICommandBuffer* commandBuffer,
-                                 uint32_t          groupCountX,
-                                 uint32_t          groupCountY,
-                                 uint32_t          groupCountZ)                                                             = 0;
-        virtual void CmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) = 0;
-        virtual void CmdPipelineBarrier(RHICommandBuffer*             commandBuffer,
+        virtual void CmdCopyBuffer(RHICommandBuffer commandBuffer,
+                                   RHIBuffer        srcBuffer,
+                                   RHIBuffer        dstBuffer,
+                                   uint32_t         regionCount,
+                                   RHIBufferCopy*   pRegions)                                                         = 0;
+        virtual void CmdDraw(RHICommandBuffer commandBuffer,
+                             uint32_t         vertexCount,
+                             uint32_t         instanceCount,
+                             uint32_t         firstVertex,
+                             uint32_t         firstInstance)                                                                = 0;
+        virtual void CmdDispatch(RHICommandBuffer commandBuffer,
+                                 uint32_t         groupCountX,
+                                 uint32_t         groupCountY,
+                                 uint32_t         groupCountZ)                                                              = 0;
+        virtual void CmdDispatchIndirect(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset)   = 0;
+        virtual void CmdPipelineBarrier(RHICommandBuffer              commandBuffer,
                                         RHIPipelineStageFlags         srcStageMask,
                                         RHIPipelineStageFlags         dstStageMask,
                                         RHIDependencyFlags            dependencyFlags,
@@ -220,27 +235,39 @@ namespace Galaxy
                                         const RHIBufferMemoryBarrier* pBufferMemoryBarriers,
                                         uint32_t                      imageMemoryBarrierCount,
                                         const RHIImageMemoryBarrier*  pImageMemoryBarriers)                         = 0;
-        virtual bool EndCommandBuffer(RHICommandBuffer* commandBuffer)                                             = 0;
+        virtual bool EndCommandBuffer(RHICommandBuffer commandBuffer)                                              = 0;
         virtual void UpdateDescriptorSets(uint32_t                     descriptorWriteCount,
                                           const RHIWriteDescriptorSet* pDescriptorWrites,
                                           uint32_t                     descriptorCopyCount,
                                           const RHICopyDescriptorSet*  pDescriptorCopies)                           = 0;
+        // One call for the whole set. pData holds an RHIDescriptorImageInfo, RHIDescriptorBufferInfo or RHIBufferView
+        // per descriptor at the offsets and strides of the template entries.
+        virtual void UpdateDescriptorSetWithTemplate(RHIDescriptorSet            descriptorSet,
+                                                     RHIDescriptorUpdateTemplate updateTemplate,
+                                                     const void*                 pData)                             = 0;
+        // Copies the writes, including what their info pointers point to, and leaves them for FlushDescriptorWrites.
+        // Any job system thread may queue, pNext is dropped. Everything queued goes to the driver in a single call.
+        virtual void QueueDescriptorWrites(uint32_t                     descriptorWriteCount,
+                                           const RHIWriteDescriptorSet* pDescriptorWrites)                          = 0;
+        // Render thread while no job queues writes. PrepareBeforePass flushes too, before any pass records.
+        virtual void FlushDescriptorWrites()                                                                       = 0;
         virtual bool
-        QueueSubmit(RHIQueue* queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence* fence) = 0;
-        virtual bool QueueWaitIdle(RHIQueue* queue)                                                        = 0;
+        QueueSubmit(RHIQueue queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence fence)   = 0;
+        virtual bool QueueWaitIdle(RHIQueue queue)                                                         = 0;
         virtual void ResetCommandPool()                                                                    = 0;
         virtual void WaitForFences()                                                                       = 0;
 
         // query
         virtual void                     GetPhysicalDeviceProperties(RHIPhysicalDeviceProperties* pProperties) = 0;
-        virtual RHICommandBuffer*        GetCurrentCommandBuffer() const                                       = 0;
-        virtual RHICommandBuffer* const* GetCommandBufferList() const                                          = 0;
-        virtual RHICommandPool*          GetCommandPool() const                                                = 0;
-        virtual RHIDescriptorPool*       GetDescriptorPool() const                                             = 0;
-        virtual RHIFence* const*         GetFenceList() const                                                  = 0;
+        virtual RHICommandBuffer         GetCurrentCommandBuffer() const                                       = 0;
+        virtual const RHICommandBuffer*  GetCommandBufferList() const                                          = 0;
+        virtual RHICommandPool           GetCommandPool() const                                                = 0;
+        virtual RHIDescriptorPool        GetDescriptorPool() const                                             = 0; // null, see AllocateDescriptorSets
+        virtual const RHIFence*          GetFenceList() const                                                  = 0;
         virtual QueueFamilyIndices       GetQueueFamilyIndices() const                                         = 0;
-        virtual RHIQueue*                GetGraphicsQueue() const                                              = 0;
-        virtual RHIQueue*                GetComputeQueue() const                                               = 0;
+        virtual RHIQueue                 GetGraphicsQueue() const                                              = 0;
+        virtual RHIQueue                 GetComputeQueue() const                                               = 0;
+        virtual RHIQueue                 GetTransferQueue() const                                              = 0; // null without a dedicated one
         virtual RHISwapChainDesc         GetSwapchainInfo()                                                    = 0;
         virtual RHIDepthImageDesc        GetDepthImageInfo() const                                             = 0;
         virtual uint8_t                  GetMaxFramesInFlight() const                                          = 0;
@@ -248,50 +275,128 @@ namespace Galaxy
         virtual void                     SetCurrentFrameIndex(uint8_t index)                                   = 0;
 
         // command write
-        virtual RHICommandBuffer* BeginSingleTimeCommands()                                                        = 0;
-        virtual void              EndSingleTimeCommands(RHICommandBuffer* commandBuffer)                           = 0;
+        virtual RHICommandBuffer  BeginSingleTimeCommands()                                                        = 0;
+        virtual void              EndSingleTimeCommands(RHICommandBuffer commandBuffer)                            = 0;
         virtual bool              PrepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)        = 0;
         virtual void              SubmitRendering(std::function<void()> passUpdateAfterRecreateSwapchain)          = 0;
-        virtual void              PushEvent(RHICommandBuffer* commondBuffer, const char* name, const float* color) = 0;
-        virtual void              PopEvent(RHICommandBuffer* commondBuffer)                                        = 0;
+        virtual void              PushEvent(RHICommandBuffer commondBuffer, const char* name, const float* color)  = 0;
+        virtual void              PopEvent(RHICommandBuffer commondBuffer)                                         = 0;
 
-        // destory
-        virtual void Clear()                                               = 0;
-        virtual void ClearSwapchain()                                      = 0;
-        virtual void DestroyDefaultSampler(RHIDefaultSamplerType type)     = 0;
-        virtual void DestroyMipmappedSampler()                             = 0;
-        virtual void DestroyShaderModule(RHIShader* shader)                = 0;
-        virtual void DestroySemaphore(RHISemaphore* semaphore)             = 0;
-        virtual void DestroySampler(RHISampler* sampler)                   = 0;
-        virtual void DestroyInstance(RHIInstance* instance)                = 0;
-        virtual void DestroyImageView(RHIImageView* imageView)             = 0;
-        virtual void DestroyImage(RHIImage* image)                         = 0;
-        virtual void DestroyFramebuffer(RHIFramebuffer* framebuffer)       = 0;
-        virtual void DestroyFence(RHIFence* fence)                         = 0;
-        virtual void DestroyDevice()                                       = 0;
-        virtual void DestroyCommandPool(RHICommandPool* commandPool)       = 0;
-        virtual void DestroyBuffer(RHIBuffer*& buffer)                     = 0;
-        virtual void FreeCommandBuffers(RHICommandPool*   commandPool,
-                                        uint32_t          commandBufferCount,
-                                        RHICommandBuffer* pCommandBuffers) = 0;
+        // pipeline cache, pipelines created with a null cache go through the backend's own persistent one. Every
+        // pipeline created while recording is added to a manifest, replaying it compiles them all up front, e.g.
+        // behind a loading screen.
+        virtual void     SavePipelineCache()                          = 0;
+        virtual void     SetPipelineManifestRecording(bool recording) = 0;
+        virtual uint32_t ReplayPipelineManifest()                     = 0;
+
+        // async pipelines, handles are returned right away and become usable once GetPipelineStatus reports ready.
+        // Create infos and everything they point to only need to live until the call returns. pNext chains are not
+        // accepted, the returned handles report Pipeline_Status_Failed. Pipelines compile on worker threads, without
+        // workers the call compiles them before it returns.
+        virtual void CreateGraphicsPipelinesAsync(uint32_t                             createInfoCount,
+                                                  const RHIGraphicsPipelineCreateInfo* pCreateInfos,
+                                                  RHIPipeline*                         pPipelines)  = 0;
+        virtual void CreateComputePipelinesAsync(uint32_t                            createInfoCount,
+                                                 const RHIComputePipelineCreateInfo* pCreateInfos,
+                                                 RHIPipeline*                        pPipelines)    = 0;
+        virtual RHIPipelineStatus GetPipelineStatus(RHIPipeline pipeline)                           = 0;
+        virtual bool              WaitForPipeline(RHIPipeline pipeline)                             = 0;
+
+        // bindless, one descriptor set holding every registered texture (binding 0) and storage buffer (binding 1) in
+        // large arrays. Shaders index them with the ids returned here, see Bindless.glsl, so the set is bound once
+        // instead of one set per material. Ids of removed resources are reused once no frame in flight can use them.
+        // Only available when IsBindlessSupported, the Add functions return InvalidBindlessIndex otherwise.
+        static constexpr uint32_t InvalidBindlessIndex = ~0u;
+
+        virtual bool                   IsBindlessSupported() const  = 0;
+        virtual RHIDescriptorSetLayout GetBindlessSetLayout() const = 0;
+        virtual RHIDescriptorSet       GetBindlessSet() const       = 0;
+
+        virtual uint32_t AddBindlessTexture(RHIImageView imageView, RHISampler sampler)                 = 0;
+        virtual uint32_t AddBindlessBuffer(RHIBuffer buffer, RHIDeviceSize offset, RHIDeviceSize range) = 0;
+        virtual void     RemoveBindlessTexture(uint32_t index)                                          = 0;
+        virtual void     RemoveBindlessBuffer(uint32_t index)                                           = 0;
+
+        // async uploads, recorded on a dedicated transfer queue when there is one so streaming does not hold up the
+        // frame. The data is copied before returning and the destination must not be in use by the GPU. A completed
+        // upload is visible to every frame submitted afterwards. Images get their mip chain generated and end up in
+        // shader read only layout, pData holds mip 0 of every layer. A failed upload returns RHI_INVALID_UPLOAD_TICKET,
+        // which never reports complete and which WaitForUpload returns on right away.
+        virtual bool            HasDedicatedTransferQueue() const              = 0;
+        virtual RHIUploadTicket UploadBufferAsync(RHIBuffer     dstBuffer,
+                                                  RHIDeviceSize dstOffset,
+                                                  const void*   pData,
+                                                  RHIDeviceSize size)          = 0;
+        virtual RHIUploadTicket UploadImageAsync(RHIImage      dstImage,
+                                                 RHIFormat     format,
+                                                 uint32_t      width,
+                                                 uint32_t      height,
+                                                 uint32_t      layerCount,
+                                                 uint32_t      mipLevels,
+                                                 const void*   pData,
+                                                 RHIDeviceSize size)           = 0;
+        virtual bool            IsUploadComplete(RHIUploadTicket ticket) const = 0;
+        virtual void            WaitForUpload(RHIUploadTicket ticket)          = 0;
+
+        // memory statistics. Allocations are put in a category from their usage when created, vertex and index
+        // buffers count as meshes and attachments as render targets, SetMemoryCategory moves one to another. The dump
+        // is the allocator's JSON statistics with every allocation listed, the format GpuMemDumpVis reads.
+        virtual void GetMemoryStats(RHIMemoryStats& outStats) const                        = 0;
+        virtual void SetMemoryCategory(RHIDeviceMemory memory, RHIMemoryCategory category) = 0;
+        virtual bool DumpMemoryStats(const std::string& path) const                        = 0;
+
+        // defragmentation. Once device local memory is fragmented, buffers and sampled images created with an
+        // RHIDeviceMemory may be moved between frames, only while a callback is set. Their handles stay valid, every
+        // descriptor set referencing one has to be written again when the callback runs, before recording. Frames in
+        // flight keep the sets they were recorded with, so write new sets and free the old ones. Resources with a
+        // bindless slot and images no UploadImageAsync has completed for are never moved.
+        virtual void SetMemoryMovedCallback(std::function<void()> callback) = 0;
+
+        // destory. Image views, images, framebuffers, pipelines, samplers, buffers, memory and descriptor sets are
+        // only released here, they are destroyed once every frame submitted so far is done with them. Those calls may
+        // come from any thread, the handle must not be used afterwards.
+        virtual void Clear()                                                   = 0;
+        virtual void ClearSwapchain()                                          = 0;
+        virtual void DestroyDefaultSampler(RHIDefaultSamplerType type)         = 0;
+        virtual void DestroyMipmappedSampler()                                 = 0;
+        virtual void DestroyShaderModule(RHIShader shader)                     = 0;
+        virtual void DestroySemaphore(RHISemaphore semaphore)                  = 0;
+        virtual void DestroySampler(RHISampler sampler)                        = 0;
+        virtual void DestroyInstance(RHIInstance instance)                     = 0;
+        virtual void DestroyImageView(RHIImageView imageView)                  = 0;
+        virtual void DestroyImage(RHIImage image)                              = 0;
+        virtual void DestroyFramebuffer(RHIFramebuffer framebuffer)            = 0;
+        virtual void DestroyPipeline(RHIPipeline pipeline)                     = 0;
+        virtual void DestroyPipelineLayout(RHIPipelineLayout layout)           = 0;
+        virtual void DestroyDescriptorSetLayout(RHIDescriptorSetLayout layout) = 0;
+        virtual void DestroyDescriptorUpdateTemplate(RHIDescriptorUpdateTemplate updateTemplate) = 0;
+        // only sets from AllocateDescriptorSets with a null descriptorPool
+        virtual void FreeDescriptorSets(uint32_t descriptorSetCount, const RHIDescriptorSet* pDescriptorSets) = 0;
+        virtual void DestroyFence(RHIFence fence)                              = 0;
+        virtual void DestroyDevice()                                           = 0;
+        virtual void DestroyCommandPool(RHICommandPool commandPool)            = 0;
+        virtual void DestroyBuffer(RHIBuffer& buffer)                          = 0;
+        virtual void FreeCommandBuffers(RHICommandPool   commandPool,
+                                        uint32_t         commandBufferCount,
+                                        RHICommandBuffer pCommandBuffers)      = 0;
 
         // memory
-        virtual void FreeMemory(RHIDeviceMemory*& memory)             = 0;
-        virtual bool MapMemory(RHIDeviceMemory*  memory,
+        virtual void FreeMemory(RHIDeviceMemory& memory)              = 0;
+        virtual bool MapMemory(RHIDeviceMemory   memory,
                                RHIDeviceSize     offset,
                                RHIDeviceSize     size,
                                RHIMemoryMapFlags flags,
                                void**            ppData)                         = 0;
-        virtual void UnmapMemory(RHIDeviceMemory* memory)             = 0;
-        virtual void InvalidateMappedMemoryRanges(void*            pNext,
-                                                  RHIDeviceMemory* memory,
-                                                  RHIDeviceSize    offset,
-                                                  RHIDeviceSize    size) = 0;
+        virtual void UnmapMemory(RHIDeviceMemory memory)              = 0;
+        virtual void InvalidateMappedMemoryRanges(void*           pNext,
+                                                  RHIDeviceMemory memory,
+                                                  RHIDeviceSize   offset,
+                                                  RHIDeviceSize   size)  = 0;
         virtual void
-        FlushMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) = 0;
+        FlushMappedMemoryRanges(void* pNext, RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size)  = 0;
 
         // semaphores
-        virtual RHISemaphore*& GetTextureCopySemaphore(uint32_t index) = 0;
+        virtual RHISemaphore& GetTextureCopySemaphore(uint32_t index) = 0;
 
     private:
     };
@@ -0,0 +1,27 @@
+//
+// RHICommandEncoder.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 14:20.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanCommandEncoder.h"
+
+namespace Galaxy
+{
+    // Only one backend is compiled into a binary, so the hot recording path is bound at compile time. RHI stays
+    // virtual for setup and tooling.
+    using RHIBackend        = VulkanRHI;
+    using RHICommandEncoder = VulkanCommandEncoder;
+
+    inline RHICommandEncoder CreateCommandEncoder(RHI& rhi, RHICommandBuffer commandBuffer)
+    {
+        return RHICommandEncoder(static_cast<RHIBackend&>(rhi), commandBuffer);
+    }
+
+    inline RHICommandEncoder CreateCommandEncoder(RHI& rhi)
+    {
+        return RHICommandEncoder(static_cast<RHIBackend&>(rhi));
+    }
+} // namespace Galaxy
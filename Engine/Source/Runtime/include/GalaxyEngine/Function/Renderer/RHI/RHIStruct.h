@@ -6,66 +6,53 @@
 
 #pragma once
 
+#include "GalaxyEngine/Core/Container/Handle.h"
 #include "GalaxyEngine/Function/Renderer/RenderType.h"
 
 #include <optional>
 
 namespace Galaxy
 {
-    /////////////////////////////////////////////////
-    #define RHI_DELETE_PTR(x) \
-        delete x; \
-        x = nullptr;
-
-    ////////////////////class////////////////////////
-    class RHIBuffer
-    {};
-    class RHIBufferView
-    {};
-    class RHICommandBuffer
-    {};
-    class RHICommandPool
-    {};
-    class RHIDescriptorPool
-    {};
-    class RHIDescriptorSet
-    {};
-    class RHIDescriptorSetLayout
-    {};
-    class RHIDevice
-    {};
-    class RHIDeviceMemory
-    {};
-    class RHIEvent
-    {};
-    class RHIFence
-    {};
-    class RHIFramebuffer
-    {};
-    class RHIImage
-    {};
-    class RHIImageView
-    {};
-    class RHIInstance
-    {};
-    class RHIQueue
-    {};
-    class RHIPhysicalDevice
-    {};
-    class RHIPipeline
-    {};
-    class RHIPipelineCache
-    {};
-    class RHIPipelineLayout
-    {};
-    class RHIRenderPass
-    {};
-    class RHISampler
-    {};
-    class RHISemaphore
-    {};
-    class RHIShader
-    {};
+    ////////////////////handle//////////////////////
+    // RHI objects are generational handles into per-type pools owned by the backend. They are plain values: copy
+    // them freely, a default constructed one is RHI_NULL_HANDLE and a destroyed one is detected as stale.
+#define RHI_DEFINE_HANDLE(name) \
+    struct name##Tag; \
+    using name = Handle<name##Tag>;
+
+    RHI_DEFINE_HANDLE(RHIBuffer)
+    RHI_DEFINE_HANDLE(RHIBufferView)
+    RHI_DEFINE_HANDLE(RHICommandBuffer)
+    RHI_DEFINE_HANDLE(RHICommandPool)
+    RHI_DEFINE_HANDLE(RHIDescriptorPool)
+    RHI_DEFINE_HANDLE(RHIDescriptorSet)
+    RHI_DEFINE_HANDLE(RHIDescriptorSetLayout)
+    RHI_DEFINE_HANDLE(RHIDescriptorUpdateTemplate)
+    RHI_DEFINE_HANDLE(RHIDevice)
+    RHI_DEFINE_HANDLE(RHIDeviceMemory)
+    RHI_DEFINE_HANDLE(RHIEvent)
+    RHI_DEFINE_HANDLE(RHIFence)
+    RHI_DEFINE_HANDLE(RHIFramebuffer)
+    RHI_DEFINE_HANDLE(RHIImage)
+    RHI_DEFINE_HANDLE(RHIImageView)
+    RHI_DEFINE_HANDLE(RHIInstance)
+    RHI_DEFINE_HANDLE(RHIQueue)
+    RHI_DEFINE_HANDLE(RHIPhysicalDevice)
+    RHI_DEFINE_HANDLE(RHIPipeline)
+    RHI_DEFINE_HANDLE(RHIPipelineCache)
+    RHI_DEFINE_HANDLE(RHIPipelineLayout)
+    RHI_DEFINE_HANDLE(RHIRenderPass)
+    RHI_DEFINE_HANDLE(RHISampler)
+    RHI_DEFINE_HANDLE(RHISemaphore)
+    RHI_DEFINE_HANDLE(RHIShader)
+
+#undef RHI_DEFINE_HANDLE
+
+    // one async upload, tickets increase in submission order
+    using RHIUploadTicket = uint64_t;
+
+    // what a failed upload returns, it never reports complete
+    constexpr RHIUploadTicket RHI_INVALID_UPLOAD_TICKET = 0;
 
     ////////////////////struct//////////////////////////
     struct RHIMemoryBarrier;
@@ -93,6 +80,8 @@ namespace Galaxy
     struct RHIDescriptorSetAllocateInfo;
     struct RHIDescriptorSetLayoutBinding;
     struct RHIDescriptorSetLayoutCreateInfo;
+    struct RHIDescriptorUpdateTemplateEntry;
+    struct RHIDescriptorUpdateTemplateCreateInfo;
     struct RHIDeviceCreateInfo;
     struct RHIDeviceQueueCreateInfo;
     struct RHIExtensionProperties;
@@ -166,10 +155,10 @@ namespace Galaxy
     {
         RHIStructureType  sType;
         const void*       pNext;
-        RHIDescriptorSet* srcSet;
+        RHIDescriptorSet  srcSet;
         uint32_t          srcBinding;
         uint32_t          srcArrayElement;
-        RHIDescriptorSet* dstSet;
+        RHIDescriptorSet  dstSet;
         uint32_t          dstBinding;
         uint32_t          dstArrayElement;
         uint32_t          descriptorCount;
@@ -177,14 +166,14 @@ namespace Galaxy
 
     struct RHIDescriptorImageInfo
     {
-        RHISampler*    sampler;
-        RHIImageView*  imageView;
+        RHISampler     sampler;
+        RHIImageView   imageView;
         RHIImageLayout imageLayout;
     };
 
     struct RHIDescriptorBufferInfo
     {
-        RHIBuffer*    buffer;
+        RHIBuffer     buffer;
         RHIDeviceSize offset;
         RHIDeviceSize range;
     };
@@ -210,7 +199,7 @@ namespace Galaxy
         RHIAccessFlags   dstAccessMask;
         uint32_t         srcQueueFamilyIndex;
         uint32_t         dstQueueFamilyIndex;
-        RHIBuffer*       buffer;
+        RHIBuffer        buffer;
         RHIDeviceSize    offset;
         RHIDeviceSize    size;
     };
@@ -234,7 +223,7 @@ namespace Galaxy
         RHIImageLayout           newLayout;
         uint32_t                 srcQueueFamilyIndex;
         uint32_t                 dstQueueFamilyIndex;
-        RHIImage*                image;
+        RHIImage                 image;
         RHIImageSubresourceRange subresourceRange;
     };
 
@@ -323,7 +312,7 @@ namespace Galaxy
     {
         RHIStructureType      sType;
         const void*           pNext;
-        RHICommandPool*       commandPool;
+        RHICommandPool        commandPool;
         RHICommandBufferLevel level;
         uint32_t              commandBufferCount;
     };
@@ -340,9 +329,9 @@ namespace Galaxy
     {
         RHIStructureType               sType;
         const void*                    pNext;
-        RHIRenderPass*                 renderPass;
+        RHIRenderPass                  renderPass;
         uint32_t                       subpass;
-        RHIFramebuffer*                framebuffer;
+        RHIFramebuffer                 framebuffer;
         RHIBool32                      occlusionQueryEnable;
         RHIQueryControlFlags           queryFlags;
         RHIQueryPipelineStatisticFlags pipelineStatistics;
@@ -376,9 +365,9 @@ namespace Galaxy
     {
         RHIStructureType                     sType;
         const void*                          pNext;
-        RHIDescriptorPool*                   descriptorPool;
+        RHIDescriptorPool                    descriptorPool;
         uint32_t                             descriptorSetCount;
-        const RHIDescriptorSetLayout* const* pSetLayouts;
+        const RHIDescriptorSetLayout*        pSetLayouts;
     };
 
     struct RHIDescriptorSetLayoutBinding
@@ -387,7 +376,7 @@ namespace Galaxy
         RHIDescriptorType   descriptorType;
         uint32_t            descriptorCount;
         RHIShaderStageFlags stageFlags;
-        RHISampler* const*  pImmutableSamplers = nullptr;
+        const RHISampler*   pImmutableSamplers = nullptr;
     };
 
     struct RHIDescriptorSetLayoutCreateInfo
@@ -399,6 +388,25 @@ namespace Galaxy
         const RHIDescriptorSetLayoutBinding* pBindings;
     };
 
+    // offset and stride into the packed data, it holds an RHIDescriptorImageInfo, RHIDescriptorBufferInfo or
+    // RHIBufferView per descriptor depending on descriptorType
+    struct RHIDescriptorUpdateTemplateEntry
+    {
+        uint32_t          dstBinding;
+        uint32_t          dstArrayElement;
+        uint32_t          descriptorCount;
+        RHIDescriptorType descriptorType;
+        size_t            offset;
+        size_t            stride;
+    };
+
+    struct RHIDescriptorUpdateTemplateCreateInfo
+    {
+        uint32_t                                descriptorUpdateEntryCount;
+        const RHIDescriptorUpdateTemplateEntry* pDescriptorUpdateEntries;
+        RHIDescriptorSetLayout                  descriptorSetLayout;
+    };
+
     struct RHIDeviceCreateInfo
     {
         RHIStructureType                  sType;
@@ -448,9 +456,9 @@ namespace Galaxy
         RHIStructureType          sType;
         const void*               pNext;
         RHIFramebufferCreateFlags flags;
-        RHIRenderPass*            renderPass;
+        RHIRenderPass             renderPass;
         uint32_t                  attachmentCount;
-        RHIImageView* const*      pAttachments;
+        const RHIImageView*       pAttachments;
         uint32_t                  width;
         uint32_t                  height;
         uint32_t                  layers;
@@ -472,10 +480,10 @@ namespace Galaxy
         const RHIPipelineDepthStencilStateCreateInfo*  pDepthStencilState;
         const RHIPipelineColorBlendStateCreateInfo*    pColorBlendState;
         const RHIPipelineDynamicStateCreateInfo*       pDynamicState;
-        RHIPipelineLayout*                             layout;
-        RHIRenderPass*                                 renderPass;
+        RHIPipelineLayout                              layout;
+        RHIRenderPass                                  renderPass;
         uint32_t                                       subpass;
-        RHIPipeline*                                   basePipelineHandle;
+        RHIPipeline                                    basePipelineHandle;
         int32_t                                        basePipelineIndex;
     };
 
@@ -485,8 +493,8 @@ namespace Galaxy
         const void*                       pNext;
         RHIPipelineCreateFlags            flags;
         RHIPipelineShaderStageCreateInfo* pStages;
-        RHIPipelineLayout*                layout;
-        RHIPipeline*                      basePipelineHandle;
+        RHIPipelineLayout                 layout;
+        RHIPipeline                       basePipelineHandle;
         int32_t                           basePipelineIndex;
     };
 
@@ -539,7 +547,7 @@ namespace Galaxy
         RHIStructureType         sType;
         const void*              pNext;
         RHIImageViewCreateFlags  flags;
-        RHIImage*                image;
+        RHIImage                 image;
         RHIImageViewType         viewType;
         RHIFormat                format;
         RHIComponentMapping      components;
@@ -855,7 +863,7 @@ namespace Galaxy
         const void*                    pNext;
         RHIPipelineLayoutCreateFlags   flags;
         uint32_t                       setLayoutCount;
-        RHIDescriptorSetLayout* const* pSetLayouts;
+        const RHIDescriptorSetLayout*  pSetLayouts;
         uint32_t                       pushConstantRangeCount;
         const RHIPushConstantRange*    pPushConstantRanges;
     };
@@ -896,7 +904,7 @@ namespace Galaxy
         const void*                       pNext;
         RHIPipelineShaderStageCreateFlags flags;
         RHIShaderStageFlagBits            stage;
-        RHIShader*                        module;
+        RHIShader                         module;
         const char*                       pName;
         const RHISpecializationInfo*      pSpecializationInfo;
     };
@@ -1002,12 +1010,12 @@ namespace Galaxy
         RHIStructureType             sType;
         const void*                  pNext;
         uint32_t                     waitSemaphoreCount;
-        RHISemaphore**               pWaitSemaphores;
+        const RHISemaphore*          pWaitSemaphores;
         const RHIPipelineStageFlags* pWaitDstStageMask;
         uint32_t                     commandBufferCount;
-        RHICommandBuffer* const*     pCommandBuffers;
+        const RHICommandBuffer*      pCommandBuffers;
         uint32_t                     signalSemaphoreCount;
-        const RHISemaphore**         pSignalSemaphores;
+        const RHISemaphore*          pSignalSemaphores;
     };
 
     struct RHISubpassDependency
@@ -1039,14 +1047,14 @@ namespace Galaxy
     {
         RHIStructureType         sType;
         const void*              pNext;
-        RHIDescriptorSet*        dstSet;
+        RHIDescriptorSet         dstSet;
         uint32_t                 dstBinding;
         uint32_t                 dstArrayElement;
         uint32_t                 descriptorCount;
         RHIDescriptorType        descriptorType;
         RHIDescriptorImageInfo*  pImageInfo       = nullptr;
         RHIDescriptorBufferInfo* pBufferInfo      = nullptr;
-        RHIBufferView*           pTexelBufferView = nullptr;
+        const RHIBufferView*     pTexelBufferView = nullptr;
     };
 
     struct RHIAttachmentReference
@@ -1110,8 +1118,8 @@ namespace Galaxy
     {
         RHIStructureType     sType;
         const void*          pNext;
-        RHIRenderPass*       renderPass;
-        RHIFramebuffer*      framebuffer;
+        RHIRenderPass        renderPass;
+        RHIFramebuffer       framebuffer;
         RHIRect2D            renderArea;
         uint32_t             clearValueCount;
         const RHIClearValue* pClearValues;
@@ -1152,18 +1160,18 @@ namespace Galaxy
 
     struct RHISwapChainDesc
     {
-        RHIExtent2D                extent;
-        RHIFormat                  imageFormat;
-        RHIViewport*               viewport;
-        RHIRect2D*                 scissor;
-        std::vector<RHIImageView*> imageViews;
+        RHIExtent2D               extent;
+        RHIFormat                 imageFormat;
+        RHIViewport*              viewport;
+        RHIRect2D*                scissor;
+        std::vector<RHIImageView> imageViews;
     };
 
     struct RHIDepthImageDesc
     {
-        RHIImage*     depthImage     = RHI_NULL_HANDLE;
-        RHIImageView* depthImageView = RHI_NULL_HANDLE;
-        RHIFormat     depthImageFormat;
+        RHIImage     depthImage     = RHI_NULL_HANDLE;
+        RHIImageView depthImageView = RHI_NULL_HANDLE;
+        RHIFormat    depthImageFormat;
     };
 
     struct QueueFamilyIndices
@@ -1171,6 +1179,7 @@ namespace Galaxy
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
         std::optional<uint32_t> computeFamily;
+        std::optional<uint32_t> transferFamily; // dedicated, without graphics support, not required
 
         bool isComplete()
         {
@@ -1178,4 +1187,20 @@ namespace Galaxy
             ;
         }
     };
+
+    struct RHIMemoryHeapStats
+    {
+        RHIDeviceSize budget          = 0; // what the process may use before the OS starts evicting or failing
+        RHIDeviceSize usage           = 0; // by the whole process, not only the RHI, when the budget is known
+        RHIDeviceSize blockBytes      = 0; // device memory allocated by the RHI
+        RHIDeviceSize allocationBytes = 0; // part of blockBytes handed out to resources
+        bool          isDeviceLocal   = false;
+    };
+
+    struct RHIMemoryStats
+    {
+        bool                            hasBudget = false; // otherwise budget and usage are estimates
+        std::vector<RHIMemoryHeapStats> heaps;
+        RHIDeviceSize                   categoryBytes[Memory_Category_Count] = {};
+    };
 } // namespace Galaxy
\ No newline at end of file
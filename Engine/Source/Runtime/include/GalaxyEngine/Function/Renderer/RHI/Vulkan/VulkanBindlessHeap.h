@@ -0,0 +1,83 @@
+//
+// VulkanBindlessHeap.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/31 10:26.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+
+#include <vector>
+
+namespace Galaxy
+{
+    // One update-after-bind descriptor set with a combined image sampler array at binding 0 and a storage buffer
+    // array at binding 1. Resources get a stable index into their array, shaders pick what they need by index, so the
+    // set is bound once per frame instead of one set per material and draw.
+    //
+    // Slots are partially bound and only written while unused, so adding a resource never waits for the GPU. A removed
+    // index is reused once the frame slot it was removed in comes around again.
+    class VulkanBindlessHeap
+    {
+    public:
+        static constexpr uint32_t InvalidIndex = ~0u;
+
+        bool Initialize(const VulkanDeviceTable& device,
+                        uint32_t                 textureCapacity,
+                        uint32_t                 bufferCapacity,
+                        uint32_t                 framesInFlight);
+        void Destroy();
+
+        VkDescriptorSetLayout GetSetLayout() const { return m_SetLayout; }
+        VkDescriptorSet       GetSet() const { return m_Set; }
+
+        // InvalidIndex when the array is full
+        uint32_t AddTexture(VkImageView imageView, VkSampler sampler);
+        uint32_t AddBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
+        // Command buffers of frameIndex may still read the slot, it is not handed out again before that frame is over
+        void RemoveTexture(uint32_t index, uint32_t frameIndex);
+        void RemoveBuffer(uint32_t index, uint32_t frameIndex);
+
+        // Whether a slot was written with the view or buffer, removed slots included until they are reused
+        bool References(VkImageView imageView) const;
+        bool References(VkBuffer buffer) const;
+
+        // Call once the fence of frameIndex has signaled
+        void BeginFrame(uint32_t frameIndex);
+
+        uint32_t GetTextureCount() const { return m_Textures.GetUsedCount(); }
+        uint32_t GetBufferCount() const { return m_Buffers.GetUsedCount(); }
+
+    private:
+        class IndexAllocator
+        {
+        public:
+            void     Initialize(uint32_t capacity, uint32_t framesInFlight);
+            uint32_t Allocate();
+            void     Retire(uint32_t index, uint32_t frameIndex);
+            void     Recycle(uint32_t frameIndex);
+            uint32_t GetUsedCount() const;
+
+        private:
+            uint32_t                           m_Capacity  = 0;
+            uint32_t                           m_NextIndex = 0; // never handed out at or above this one
+            std::vector<uint32_t>              m_FreeIndices;
+            std::vector<std::vector<uint32_t>> m_RetiredIndices; // per frame slot
+        };
+
+    private:
+        const VulkanDeviceTable* m_Device {nullptr};
+        VkDescriptorSetLayout    m_SetLayout {VK_NULL_HANDLE};
+        VkDescriptorPool         m_Pool {VK_NULL_HANDLE};
+        VkDescriptorSet          m_Set {VK_NULL_HANDLE};
+
+        IndexAllocator m_Textures;
+        IndexAllocator m_Buffers;
+
+        // what each slot was last written with, removed slots included until they are reused
+        std::vector<VkDescriptorImageInfo>  m_TextureInfos;
+        std::vector<VkDescriptorBufferInfo> m_BufferInfos;
+    };
+} // namespace Galaxy
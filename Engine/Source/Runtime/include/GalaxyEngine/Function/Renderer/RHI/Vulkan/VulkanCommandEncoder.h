@@ -0,0 +1,152 @@
+//
+// VulkanCommandEncoder.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 14:20.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Memory/ScratchArray.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanRHI.h"
+
+namespace Galaxy
+{
+    // Records into one command buffer without going through the RHI vtable. Same commands and parameters as the
+    // RHI::Cmd* functions minus the command buffer, which is resolved once on construction. Everything but render
+    // pass begin is defined here so draw loops inline straight into the Vulkan calls.
+    class VulkanCommandEncoder
+    {
+    public:
+        VulkanCommandEncoder(VulkanRHI& rhi, RHICommandBuffer commandBuffer) :
+            m_RHI(&rhi), m_CommandBuffer(rhi.Resources.Get(commandBuffer))
+        {}
+
+        // Records into the command buffer of the current frame
+        explicit VulkanCommandEncoder(VulkanRHI& rhi) : VulkanCommandEncoder(rhi, rhi.CurrentCommandBuffer) {}
+
+        VkCommandBuffer GetCommandBuffer() const { return m_CommandBuffer; }
+
+        void CmdBeginRenderPassPfn(const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents);
+
+        void CmdNextSubpassPfn(RHISubpassContents contents)
+        {
+            m_RHI->DeviceTable.vkCmdNextSubpass(m_CommandBuffer, static_cast<VkSubpassContents>(contents));
+        }
+
+        void CmdEndRenderPassPfn() { m_RHI->DeviceTable.vkCmdEndRenderPass(m_CommandBuffer); }
+
+        void CmdBindPipelinePfn(RHIPipelineBindPoint pipelineBindPoint, RHIPipeline pipeline)
+        {
+            m_RHI->DeviceTable.vkCmdBindPipeline(m_CommandBuffer,
+                                                 static_cast<VkPipelineBindPoint>(pipelineBindPoint),
+                                                 m_RHI->Resources.Get(pipeline));
+        }
+
+        void CmdSetViewportPfn(uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports)
+        {
+            ScratchArray<VkViewport, 4> vkViewports(viewportCount);
+            for (uint32_t i = 0; i < viewportCount; ++i)
+            {
+                vkViewports[i].x        = pViewports[i].x;
+                vkViewports[i].y        = pViewports[i].y;
+                vkViewports[i].width    = pViewports[i].width;
+                vkViewports[i].height   = pViewports[i].height;
+                vkViewports[i].minDepth = pViewports[i].minDepth;
+                vkViewports[i].maxDepth = pViewports[i].maxDepth;
+            }
+
+            m_RHI->DeviceTable.vkCmdSetViewport(m_CommandBuffer, firstViewport, viewportCount, vkViewports.data());
+        }
+
+        void CmdSetScissorPfn(uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
+        {
+            ScratchArray<VkRect2D, 4> vkScissors(scissorCount);
+            for (uint32_t i = 0; i < scissorCount; ++i)
+            {
+                vkScissors[i].offset.x      = pScissors[i].offset.x;
+                vkScissors[i].offset.y      = pScissors[i].offset.y;
+                vkScissors[i].extent.width  = pScissors[i].extent.width;
+                vkScissors[i].extent.height = pScissors[i].extent.height;
+            }
+
+            m_RHI->DeviceTable.vkCmdSetScissor(m_CommandBuffer, firstScissor, scissorCount, vkScissors.data());
+        }
+
+        void CmdBindVertexBuffersPfn(uint32_t             firstBinding,
+                                     uint32_t             bindingCount,
+                                     const RHIBuffer*     pBuffers,
+                                     const RHIDeviceSize* pOffsets)
+        {
+            ScratchArray<VkBuffer, 8> vkBuffers(bindingCount);
+            for (uint32_t i = 0; i < bindingCount; ++i)
+            {
+                vkBuffers[i] = m_RHI->Resources.Get(pBuffers[i]);
+            }
+
+            static_assert(std::is_same_v<RHIDeviceSize, VkDeviceSize>);
+            m_RHI->DeviceTable.vkCmdBindVertexBuffers(
+                m_CommandBuffer, firstBinding, bindingCount, vkBuffers.data(), pOffsets);
+        }
+
+        void CmdBindIndexBufferPfn(RHIBuffer buffer, RHIDeviceSize offset, RHIIndexType indexType)
+        {
+            m_RHI->DeviceTable.vkCmdBindIndexBuffer(m_CommandBuffer,
+                                                    m_RHI->Resources.Get(buffer),
+                                                    static_cast<VkDeviceSize>(offset),
+                                                    static_cast<VkIndexType>(indexType));
+        }
+
+        void CmdBindDescriptorSetsPfn(RHIPipelineBindPoint    pipelineBindPoint,
+                                      RHIPipelineLayout       layout,
+                                      uint32_t                firstSet,
+                                      uint32_t                descriptorSetCount,
+                                      const RHIDescriptorSet* pDescriptorSets,
+                                      uint32_t                dynamicOffsetCount,
+                                      const uint32_t*         pDynamicOffsets)
+        {
+            ScratchArray<VkDescriptorSet, 8> vkDescriptorSets(descriptorSetCount);
+            for (uint32_t i = 0; i < descriptorSetCount; ++i)
+            {
+                vkDescriptorSets[i] = m_RHI->Resources.Get(pDescriptorSets[i]);
+            }
+
+            m_RHI->DeviceTable.vkCmdBindDescriptorSets(m_CommandBuffer,
+                                                       static_cast<VkPipelineBindPoint>(pipelineBindPoint),
+                                                       m_RHI->Resources.Get(layout),
+                                                       firstSet,
+                                                       descriptorSetCount,
+                                                       vkDescriptorSets.data(),
+                                                       dynamicOffsetCount,
+                                                       pDynamicOffsets);
+        }
+
+        void CmdDrawIndexedPfn(uint32_t indexCount,
+                               uint32_t instanceCount,
+                               uint32_t firstIndex,
+                               int32_t  vertexOffset,
+                               uint32_t firstInstance)
+        {
+            m_RHI->DeviceTable.vkCmdDrawIndexed(
+                m_CommandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+        }
+
+        void CmdDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+        {
+            m_RHI->DeviceTable.vkCmdDraw(m_CommandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+        }
+
+        void CmdDispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+        {
+            m_RHI->DeviceTable.vkCmdDispatch(m_CommandBuffer, groupCountX, groupCountY, groupCountZ);
+        }
+
+        void CmdDispatchIndirect(RHIBuffer buffer, RHIDeviceSize offset)
+        {
+            m_RHI->DeviceTable.vkCmdDispatchIndirect(m_CommandBuffer, m_RHI->Resources.Get(buffer), offset);
+        }
+
+    private:
+        VulkanRHI*      m_RHI;
+        VkCommandBuffer m_CommandBuffer;
+    };
+} // namespace Galaxy
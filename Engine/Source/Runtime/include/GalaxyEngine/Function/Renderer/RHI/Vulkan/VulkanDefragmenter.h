@@ -0,0 +1,153 @@
+//
+// VulkanDefragmenter.h
+//
+// Created or modified by Kexuan Zhang on 2023/11/03 15:10.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/RHIStruct.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+
+namespace Galaxy
+{
+    class VulkanRHI;
+    class VulkanBindlessHeap;
+
+    struct VulkanDefragmenterStats
+    {
+        uint64_t     Runs             = 0;
+        uint64_t     Passes           = 0;
+        uint64_t     AllocationsMoved = 0;
+        VkDeviceSize BytesMoved       = 0;
+        VkDeviceSize BytesFreed       = 0; // device memory blocks handed back to the driver
+    };
+
+    // Compacts the VMA blocks of device local memory once streaming has fragmented them.
+    //
+    // Every few hundred frames the heap statistics are checked, a run starts once enough of the blocks is free space
+    // between allocations. A run is split into passes of a bounded number of moves. A pass records the copies into
+    // new buffers and images into a staging batch ahead of the frame, points the RHI handles at the copies and calls
+    // the moved callback, so the frame and everything after it uses them. The originals go to the deletion queue,
+    // frames still in flight keep reading them. The pass ends once its staging batch has retired, the next one starts
+    // in the same frame. Nothing waits for the GPU.
+    //
+    // Nothing is moved without a moved callback, every descriptor set referencing a moved resource has to be written
+    // again in it. Resources with a bindless slot stay where they are, the slot cannot be rewritten while frames in
+    // flight may read it. Only resources created through the RHI with an RHIDeviceMemory are moved, and only from
+    // memory the host cannot see, nobody holds a mapped pointer into them. Images only move once an upload into them
+    // has completed and left them in shader read only layout, so attachments and storage images stay where they are.
+    // Render thread only.
+    class VulkanDefragmenter
+    {
+    public:
+        // pBindlessHeap is null when bindless is not supported
+        void Initialize(VulkanRHI& rhi, VulkanBindlessHeap* pBindlessHeap);
+
+        // Finishes the pass in progress and drops the registrations
+        void Destroy();
+
+        void RegisterBuffer(VmaAllocation allocation, RHIBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+        void RegisterImage(VmaAllocation allocation, RHIImage image, const VkImageCreateInfo& createInfo);
+        void RegisterImageView(RHIImageView       imageView,
+                               RHIImage           image,
+                               VkFormat           format,
+                               VkImageAspectFlags aspectFlags,
+                               VkImageViewType    viewType,
+                               uint32_t           layerCount,
+                               uint32_t           mipLevels);
+        void UnregisterImageView(RHIImageView imageView);
+
+        // The upload leaves every level of the image in shader read only layout once the ticket is complete
+        void MarkUploaded(RHIImage image, RHIUploadTicket ticket);
+
+        // Before the allocation is freed. Returns true when the pass in progress is moving it, the pass frees it then
+        // and the caller must not.
+        bool Unregister(VmaAllocation allocation);
+
+        // Called after a pass moved anything, before the frame is recorded. The RHI handles stay the same but the
+        // Vulkan objects behind them changed. Frames in flight still use the sets they were recorded with, write new
+        // sets instead of rewriting those, FreeDescriptorSets retires the old ones.
+        void SetMovedCallback(std::function<void()> callback) { m_MovedCallback = std::move(callback); }
+
+        // Once per frame, after the fence of the frame slot has been waited for, the staging ring has been retired and
+        // while no upload is in flight. Checks the thresholds, ends the pass whose copies are done or starts the next.
+        void Update();
+
+        bool IsRunning() const { return m_Context != VK_NULL_HANDLE; }
+
+        const VulkanDefragmenterStats& GetStats() const { return m_Stats; }
+
+    private:
+        struct MovableResource
+        {
+            RHIBuffer          Buffer;
+            VkBufferCreateInfo BufferCreateInfo {};
+            RHIImage           Image;
+            VkImageCreateInfo  ImageCreateInfo {};
+            RHIUploadTicket    UploadTicket {RHI_INVALID_UPLOAD_TICKET}; // of the last upload into the image
+        };
+
+        struct ImageViewDesc
+        {
+            RHIImage           Image;
+            VkFormat           Format {VK_FORMAT_UNDEFINED};
+            VkImageAspectFlags AspectFlags {0};
+            VkImageViewType    ViewType {VK_IMAGE_VIEW_TYPE_2D};
+            uint32_t           LayerCount {1};
+            uint32_t           MipLevels {1};
+        };
+
+        // a move whose copy has been recorded, the handles are pointed at the copy right away
+        struct PendingMove
+        {
+            RHIBuffer Buffer;
+            VkBuffer  OldBuffer {VK_NULL_HANDLE};
+            VkBuffer  NewBuffer {VK_NULL_HANDLE};
+            RHIImage  Image;
+            VkImage   OldImage {VK_NULL_HANDLE};
+            VkImage   NewImage {VK_NULL_HANDLE};
+        };
+
+        bool IsFragmented() const;
+        void Begin();
+        void End();
+        void RunPass();
+        void EndPass();
+
+        // null when the allocation has to stay where it is
+        const MovableResource* FindMovable(VmaAllocation allocation) const;
+        bool                   IsInBindlessHeap(const MovableResource& resource) const;
+
+        // creates the copy on the new memory of the move and records the copy into it
+        bool RecordMove(VkCommandBuffer               commandBuffer,
+                        const VmaDefragmentationMove& move,
+                        const MovableResource&        resource,
+                        PendingMove&                  outMove);
+
+        // points the handles at the copy and hands the original to the deletion queue
+        void FinishMove(const PendingMove& move);
+
+    private:
+        VulkanRHI*          m_RHI {nullptr};
+        VulkanBindlessHeap* m_pBindlessHeap {nullptr};
+
+        std::unordered_map<VmaAllocation, MovableResource> m_Movables;
+        std::unordered_map<RHIImage, VmaAllocation>        m_MovableImages;
+        std::unordered_map<RHIImageView, ImageViewDesc>    m_ImageViews;
+
+        VmaDefragmentationContext      m_Context {VK_NULL_HANDLE};
+        VmaDefragmentationPassMoveInfo m_PassInfo {};
+        uint64_t                       m_PassBatchSerial {0}; // staging batch of the copies, 0 without a pass
+        uint32_t                       m_RunPasses {0};
+        uint32_t                       m_FramesUntilCheck {0};
+
+        std::function<void()>   m_MovedCallback;
+        VulkanDefragmenterStats m_Stats;
+    };
+} // namespace Galaxy
@@ -0,0 +1,76 @@
+//
+// VulkanDeletionQueue.h
+//
+// Created or modified by Kexuan Zhang on 2023/11/04 10:05.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/RHIStruct.h"
+
+#include <mutex>
+#include <vector>
+
+namespace Galaxy
+{
+    // RHI objects released by the application, destroyed once the GPU can no longer be using them.
+    //
+    // Releases collect in a pending batch until the next frame is submitted, the batch then belongs to that frame
+    // slot. Every command buffer that could reference one of them was submitted with that frame or before it, so the
+    // batch is handed back for destruction once the in flight fence of the slot has signaled, MaxFramesInFlight frames
+    // later at most. Nothing waits for the GPU.
+    //
+    // Only handles are stored, they stay alive until the batch is destroyed and must not be used after the release.
+    // Enqueue may be called from any thread, the rest from the render thread.
+    class VulkanDeletionQueue
+    {
+    public:
+        // Destruction order within a batch is descriptor sets, framebuffers, views, buffers and images, pipelines,
+        // samplers, memory
+        struct Batch
+        {
+            std::vector<RHIDescriptorSet> DescriptorSets;
+            std::vector<RHIFramebuffer>   Framebuffers;
+            std::vector<RHIImageView>     ImageViews;
+            std::vector<RHIBuffer>        Buffers;
+            std::vector<RHIImage>         Images;
+            std::vector<RHIPipeline>      Pipelines;
+            std::vector<RHISampler>       Samplers;
+            std::vector<RHIDeviceMemory>  Memories;
+
+            bool IsEmpty() const;
+            void Clear();
+            void Append(Batch& other);
+        };
+
+        void Initialize(uint32_t framesInFlight);
+
+        void Enqueue(RHIDescriptorSet descriptorSet);
+        void Enqueue(RHIFramebuffer framebuffer);
+        void Enqueue(RHIImageView imageView);
+        void Enqueue(RHIBuffer buffer);
+        void Enqueue(RHIImage image);
+        void Enqueue(RHIPipeline pipeline);
+        void Enqueue(RHISampler sampler);
+        void Enqueue(RHIDeviceMemory memory);
+
+        // Right before the frame of frameIndex is submitted, everything released so far goes with it
+        void Submit(uint32_t frameIndex);
+
+        // Once the fence of frameIndex has signaled. The batch of that slot is swapped into outBatch, which has to be
+        // empty, so the vectors keep their capacity from one round to the next.
+        void Retire(uint32_t frameIndex, Batch& outBatch);
+
+        // Every batch, the pending one included. Only when the GPU is idle.
+        void RetireAll(Batch& outBatch);
+
+    private:
+        template<typename THandle>
+        void Push(std::vector<THandle> Batch::*list, THandle handle);
+
+    private:
+        std::mutex         m_Mutex; // guards m_Pending
+        Batch              m_Pending;
+        std::vector<Batch> m_Submitted; // per frame slot
+    };
+} // namespace Galaxy
@@ -0,0 +1,108 @@
+//
+// VulkanDescriptorAllocator.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 17:05.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Galaxy
+{
+    struct VulkanDescriptorAllocatorStats
+    {
+        uint32_t PersistentPools = 0;
+        uint32_t FramePools      = 0; // over every frame slot and thread
+        uint64_t PersistentSets  = 0;
+        uint64_t FrameSets       = 0; // allocated in the frame slots not recycled yet
+        uint64_t PoolGrowths     = 0; // pools created because every existing one was full
+    };
+
+    // Descriptor sets from chains of pools that grow on demand, so no scene ever runs into a fixed cap.
+    //
+    // Persistent sets live until FreePersistent or Destroy and come from a shared chain guarded by a mutex. Frame
+    // sets come from pools owned by one frame slot and one job system thread, allocating them takes no lock.
+    // BeginFrame resets all pools of a slot wholesale once its fence has signaled, every frame set allocated in it
+    // becomes invalid.
+    //
+    // Pools are sized from the sets registered through RegisterSetSizes, which come from shader reflection: a pool
+    // for maxSets sets holds maxSets times the average descriptor count of each type over every registered set.
+    class VulkanDescriptorAllocator
+    {
+    public:
+        void Initialize(const VulkanDeviceTable& device, uint32_t framesInFlight, uint32_t threadCount);
+
+        // Destroys every pool, the device must be idle
+        void Destroy();
+
+        VkResult AllocatePersistent(const VkDescriptorSetLayout* pSetLayouts,
+                                    uint32_t                     setCount,
+                                    const void*                  pNext,
+                                    VkDescriptorSet*             pDescriptorSets);
+
+        // Only sets from AllocatePersistent, once the GPU is done with them. Their space is reused by later
+        // allocations.
+        void FreePersistent(const VkDescriptorSet* pDescriptorSets, uint32_t setCount);
+
+        // Valid until frameIndex comes around again, from the calling thread's pools
+        VkResult AllocateFrame(uint32_t                     frameIndex,
+                               const VkDescriptorSetLayout* pSetLayouts,
+                               uint32_t                     setCount,
+                               const void*                  pNext,
+                               VkDescriptorSet*             pDescriptorSets);
+
+        // Call once the fence of frameIndex has signaled and before anything allocates into it again
+        void BeginFrame(uint32_t frameIndex);
+
+        // Descriptors one set needs, any thread. Pools created before keep their sizes.
+        void RegisterSetSizes(const VkDescriptorPoolSize* pPoolSizes, uint32_t poolSizeCount);
+
+        // Frame chains are read without a lock, call from the render thread while no job allocates frame sets
+        VulkanDescriptorAllocatorStats GetStats() const;
+        void                           LogStats() const;
+
+    private:
+        // pools used by one thread in one frame slot, Current is the one being allocated from
+        struct PoolChain
+        {
+            std::vector<VkDescriptorPool> Pools;
+            size_t                        Current  = 0;
+            uint64_t                      SetCount = 0;
+        };
+
+        static constexpr uint32_t s_MinSetsPerPool = 64;
+        static constexpr uint32_t s_MaxSetsPerPool = 4096;
+
+        VkResult Allocate(PoolChain&                   chain,
+                          const VkDescriptorSetLayout* pSetLayouts,
+                          uint32_t                     setCount,
+                          const void*                  pNext,
+                          VkDescriptorSet*             pDescriptorSets);
+
+        VkDescriptorPool CreatePool(uint32_t maxSets, VkDescriptorPoolCreateFlags flags);
+
+    private:
+        const VulkanDeviceTable* m_Device {nullptr};
+
+        mutable std::mutex m_PersistentMutex;
+        PoolChain          m_Persistent;
+
+        // which pool of m_Persistent each set came from, to free it there
+        std::unordered_map<VkDescriptorSet, size_t> m_PersistentSetPools;
+
+        // indexed by frame slot, then job system thread
+        std::vector<std::vector<PoolChain>> m_FrameChains;
+
+        std::atomic<uint64_t> m_PoolGrowths {0};
+
+        std::mutex                        m_SizesMutex;
+        std::vector<VkDescriptorPoolSize> m_RegisteredSizes; // summed over every registered set
+        uint32_t                          m_RegisteredSetCount = 0;
+    };
+} // namespace Galaxy
@@ -0,0 +1,96 @@
+//
+// VulkanDescriptorUpdater.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/31 15:40.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanResources.h"
+
+#include <vector>
+
+namespace Galaxy
+{
+    // Turns RHI descriptor writes into Vulkan ones, immediately, batched or through update templates.
+    //
+    // A template writes a whole set from one packed struct in a single call. The RHI infos in it are translated into
+    // a tightly packed Vulkan copy whose layout is fixed when the template is created, no per write structs involved.
+    //
+    // Queued writes are deep copied into the calling job system thread's batch without taking a lock. Handles are
+    // resolved on Flush, which hands every batch to the driver in one vkUpdateDescriptorSets call.
+    class VulkanDescriptorUpdater
+    {
+    public:
+        void Initialize(const VulkanDeviceTable& device, VulkanResources& resources, uint32_t threadCount);
+
+        // Templates are owned by their creator, ones still alive show up in VulkanResources::ReportLiveObjects
+        void Destroy();
+
+        bool CreateTemplate(const RHIDescriptorUpdateTemplateCreateInfo& createInfo,
+                            RHIDescriptorUpdateTemplate&                 outTemplate);
+        void DestroyTemplate(RHIDescriptorUpdateTemplate updateTemplate);
+
+        // render thread only, like every call resolving handles
+        void Update(uint32_t                     writeCount,
+                    const RHIWriteDescriptorSet* pWrites,
+                    uint32_t                     copyCount,
+                    const RHICopyDescriptorSet*  pCopies);
+        void UpdateWithTemplate(RHIDescriptorSet set, RHIDescriptorUpdateTemplate updateTemplate, const void* pData);
+
+        // Any job system thread, pNext of the writes is not kept
+        void Queue(uint32_t writeCount, const RHIWriteDescriptorSet* pWrites);
+
+        // Render thread, while no job queues writes. Returns the number of writes flushed.
+        uint32_t Flush();
+
+    private:
+        struct TemplateInfo
+        {
+            std::vector<RHIDescriptorUpdateTemplateEntry> Entries;
+            std::vector<size_t>                           VkOffsets; // per entry, into the translated data
+            size_t                                        VkDataSize = 0;
+        };
+
+        // where the copies of one write's info arrays start, each array the write points to is copied
+        struct FirstInfo
+        {
+            uint32_t Image       = 0;
+            uint32_t Buffer      = 0;
+            uint32_t TexelBuffer = 0;
+        };
+
+        // writes of one thread, their info pointers are set on Flush once the info arrays stopped growing
+        struct WriteBatch
+        {
+            std::vector<RHIWriteDescriptorSet>   Writes;
+            std::vector<FirstInfo>               FirstInfos; // per write
+            std::vector<RHIDescriptorImageInfo>  ImageInfos;
+            std::vector<RHIDescriptorBufferInfo> BufferInfos;
+            std::vector<RHIBufferView>           TexelBufferViews;
+        };
+
+        // fills the Vulkan scratch arrays, they stay valid until the next conversion
+        void ConvertWrites(uint32_t writeCount, const RHIWriteDescriptorSet* pWrites);
+
+    private:
+        const VulkanDeviceTable* m_Device {nullptr};
+        VulkanResources*         m_Resources {nullptr};
+
+        // indexed by handle slot, slots are reused so this stays as large as the most templates alive at once
+        std::vector<TemplateInfo> m_Templates;
+
+        // indexed by job system thread
+        std::vector<WriteBatch> m_Batches;
+
+        // render thread scratch, kept around so steady state updates do not allocate
+        std::vector<RHIWriteDescriptorSet>  m_FlushWrites;
+        std::vector<VkWriteDescriptorSet>   m_VkWrites;
+        std::vector<VkDescriptorImageInfo>  m_VkImageInfos;
+        std::vector<VkDescriptorBufferInfo> m_VkBufferInfos;
+        std::vector<VkBufferView>           m_VkTexelBufferViews;
+        std::vector<VkCopyDescriptorSet>    m_VkCopies;
+        std::vector<unsigned char>          m_TemplateData;
+    };
+} // namespace Galaxy
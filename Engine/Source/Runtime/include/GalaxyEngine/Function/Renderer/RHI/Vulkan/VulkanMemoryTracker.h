@@ -0,0 +1,67 @@
+//
+// VulkanMemoryTracker.h
+//
+// Created or modified by Kexuan Zhang on 2023/11/03 09:40.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/RHIStruct.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+
+namespace Galaxy
+{
+    // Heap budgets and per category totals of everything allocated through the VMA allocator.
+    //
+    // With VK_EXT_memory_budget the budget and usage of each heap come from the driver and include what other
+    // processes allocated, without it VMA estimates them from its own blocks. BeginFrame refreshes them and warns once
+    // when a heap gets close to its budget and once when it goes over, not every frame it stays there.
+    //
+    // Allocations are tagged with a category, kept in their user data, and named after it so they can be told apart in
+    // the JSON dump. Track and Untrack may be called from any thread.
+    class VulkanMemoryTracker
+    {
+    public:
+        void Initialize(VmaAllocator allocator, bool hasBudgetExtension);
+
+        // Once per frame, after the fence of the frame slot has been waited for
+        void BeginFrame();
+
+        void Track(VmaAllocation allocation, RHIMemoryCategory category);
+
+        // Before the allocation is freed, allocations that were never tracked are ignored. Freeing a tracked one
+        // without it leaves its bytes in the category totals.
+        void Untrack(VmaAllocation allocation);
+
+        static RHIMemoryCategory GetBufferCategory(VkBufferUsageFlags usage);
+        static RHIMemoryCategory GetImageCategory(VkImageUsageFlags usage);
+
+        void GetStats(RHIMemoryStats& outStats) const;
+
+        // Writes the detailed vmaBuildStatsString JSON, every block and allocation included, as GpuMemDumpVis reads it
+        bool DumpStats(const std::string& path) const;
+
+    private:
+        enum class BudgetState : uint8_t
+        {
+            Normal,
+            Near,
+            Over
+        };
+
+    private:
+        VmaAllocator m_Allocator {VK_NULL_HANDLE};
+        bool         m_HasBudgetExtension {false};
+        uint32_t     m_FrameNumber {0};
+        uint32_t     m_HeapCount {0};
+
+        std::vector<BudgetState> m_BudgetStates; // per heap, as of the last BeginFrame
+
+        std::atomic<VkDeviceSize> m_CategoryBytes[Memory_Category_Count] {};
+    };
+} // namespace Galaxy
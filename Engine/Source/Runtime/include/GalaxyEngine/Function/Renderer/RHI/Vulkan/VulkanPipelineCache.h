@@ -0,0 +1,68 @@
+//
+// VulkanPipelineCache.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/27 10:12.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace Galaxy
+{
+    // Driver pipeline cache persisted between runs. The file is only used when it was written by the same vendor,
+    // device, driver version and pipelineCacheUUID, anything else starts from an empty cache.
+    //
+    // Every job system thread compiles into its own cache so workers never contend on the main one. They are merged
+    // back on Save(), which must not overlap with pipeline creation on other threads.
+    class VulkanPipelineCache
+    {
+    public:
+        void Initialize(const VulkanDeviceTable&          device,
+                        const VkPhysicalDeviceProperties& properties,
+                        const std::filesystem::path&      filePath);
+
+        // Destroys the main and thread caches without writing the file
+        void Destroy();
+
+        // Cache to pass to vkCreate*Pipelines on the calling thread, created on first use by each worker
+        VkPipelineCache GetThreadCache();
+
+        VkPipelineCache GetMainCache() const { return m_MainCache; }
+
+        // Folds the thread caches into the main one
+        void MergeThreadCaches();
+
+        // Merges and writes the file, skipped when nothing changed since the last load or save
+        bool Save();
+
+    private:
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t VendorID;
+            uint32_t DeviceID;
+            uint32_t DriverVersion;
+            uint8_t  PipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t DataSize;
+            uint64_t DataHash;
+        };
+
+        static constexpr uint32_t s_FileMagic   = 0x43505347; // "GSPC"
+        static constexpr uint32_t s_FileVersion = 1;
+
+        bool LoadFile(std::vector<char>& outData) const;
+        bool IsCompatible(const FileHeader& header) const;
+
+        const VulkanDeviceTable*     m_Device {nullptr};
+        VkPhysicalDeviceProperties   m_Properties {};
+        std::filesystem::path        m_FilePath;
+        VkPipelineCache              m_MainCache {VK_NULL_HANDLE};
+        uint64_t                     m_SavedHash {0};
+        std::vector<VkPipelineCache> m_ThreadCaches;
+    };
+} // namespace Galaxy
@@ -0,0 +1,104 @@
+//
+// VulkanPipelineManifest.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/28 09:47.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Galaxy
+{
+    class VulkanPipelineCache;
+
+    // List of every pipeline the backend was asked to create, together with the shader modules, samplers, descriptor
+    // set layouts, pipeline layouts and render passes they depend on. Replaying it compiles all of them on the job
+    // system so the driver pipeline cache is warm before the first frame needs them. Replayed pipelines are thrown
+    // away right after compiling, only the cache entries are kept.
+    //
+    // Descriptions are stored at the Vulkan level, one blob per object, deduplicated by content. pNext chains are
+    // not recorded. A pipeline that references an object created before recording started is skipped.
+    class VulkanPipelineManifest
+    {
+    public:
+        void Initialize(const VulkanDeviceTable& device, const std::filesystem::path& filePath);
+
+        // Loads the file written by a previous run, new records are added on top of it
+        bool Load();
+
+        // Writes the file, skipped when nothing was recorded since the last load or save
+        bool Save();
+
+        // Compiles every loaded pipeline into the thread caches of pipelineCache and returns how many succeeded.
+        // Blocks until done, the calling thread helps the job system with the compiles.
+        uint32_t Replay(VulkanPipelineCache& pipelineCache);
+
+        void SetRecording(bool recording) { m_Recording = recording; }
+        bool IsRecording() const { return m_Recording; }
+
+        void RecordShaderModule(VkShaderModule shaderModule, const std::vector<unsigned char>& code);
+        void RecordSampler(VkSampler sampler, const VkSamplerCreateInfo& createInfo);
+        void RecordDescriptorSetLayout(VkDescriptorSetLayout                  setLayout,
+                                       const VkDescriptorSetLayoutCreateInfo& createInfo);
+        void RecordPipelineLayout(VkPipelineLayout pipelineLayout, const VkPipelineLayoutCreateInfo& createInfo);
+        void RecordRenderPass(VkRenderPass renderPass, const VkRenderPassCreateInfo& createInfo);
+        void RecordGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo);
+        void RecordComputePipeline(const VkComputePipelineCreateInfo& createInfo);
+
+        // Drops the handle so a new object reusing it is not mistaken for the old one, its description stays
+        void ForgetShaderModule(VkShaderModule shaderModule);
+        void ForgetSampler(VkSampler sampler);
+
+        size_t GetPipelineCount() const;
+
+    private:
+        enum ObjectType : uint32_t
+        {
+            Object_Shader_Module,
+            Object_Sampler,
+            Object_Descriptor_Set_Layout,
+            Object_Pipeline_Layout,
+            Object_Render_Pass,
+            Object_Graphics_Pipeline,
+            Object_Compute_Pipeline,
+            Object_Type_Count
+        };
+
+        struct ObjectTable
+        {
+            std::vector<std::vector<char>>         Blobs;
+            std::unordered_map<size_t, uint32_t>   BlobIndices;   // content hash -> blob
+            std::unordered_map<uint64_t, uint32_t> HandleIndices; // live Vulkan handle -> blob
+        };
+
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t ObjectCounts[Object_Type_Count];
+        };
+
+        static constexpr uint32_t s_FileMagic   = 0x4D505347; // "GSPM"
+        static constexpr uint32_t s_FileVersion = 1;
+
+        static constexpr uint32_t s_InvalidIndex = ~0u;
+
+        uint32_t AddObject(ObjectType type, std::vector<char>&& blob);
+        void     MapHandle(ObjectType type, uint64_t handle, uint32_t index);
+        uint32_t FindIndex(ObjectType type, uint64_t handle) const;
+
+        const VulkanDeviceTable* m_Device {nullptr};
+        std::filesystem::path    m_FilePath;
+        bool                     m_Recording {false};
+        bool                     m_Dirty {false};
+
+        mutable std::mutex m_Mutex;
+        ObjectTable        m_Tables[Object_Type_Count];
+    };
+} // namespace Galaxy
@@ -6,11 +6,26 @@
 
 #pragma once
 
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Memory/FrameAllocator.h"
 #include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanBindlessHeap.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDefragmenter.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeletionQueue.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDescriptorAllocator.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDescriptorUpdater.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanMemoryTracker.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanPipelineCache.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanPipelineManifest.h"
 #include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanResources.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanSamplerCache.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanStagingRing.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanUploadQueue.h"
 
 #include <functional>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include <vulkan/vulkan.h>
@@ -34,21 +49,23 @@ namespace Galaxy
         virtual void PrepareContext() override final;
 
         // allocate and create
-        bool AllocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers) override;
-        bool AllocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) override;
+        bool AllocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer& pCommandBuffers) override;
+        bool AllocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* pDescriptorSets) override;
+        bool AllocateFrameDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* pDescriptorSets) override;
+        void RegisterDescriptorSetSizes(const RHIDescriptorPoolSize* pPoolSizes, uint32_t poolSizeCount) override;
         void CreateSwapchain() override;
         void RecreateSwapchain() override;
         void CreateSwapchainImageViews() override;
         void CreateFramebufferImageAndView() override;
-        RHISampler* GetOrCreateDefaultSampler(RHIDefaultSamplerType type) override;
-        RHISampler* GetOrCreateMipmapSampler(uint32_t width, uint32_t height) override;
-        RHIShader* CreateShaderModule(const std::vector<unsigned char>& shaderCode) override;
-        void CreateBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer* &buffer, RHIDeviceMemory* &bufferMemory) override;
-        void CreateBufferAndInitialize(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer*& buffer, RHIDeviceMemory*& bufferMemory, RHIDeviceSize size, void* data = nullptr, int                    dataSize = 0) override;
+        RHISampler GetOrCreateDefaultSampler(RHIDefaultSamplerType type) override;
+        RHISampler GetOrCreateMipmapSampler(uint32_t width, uint32_t height) override;
+        RHIShader CreateShaderModule(const std::vector<unsigned char>& shaderCode) override;
+        void CreateBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer& buffer, RHIDeviceMemory& bufferMemory) override;
+        void CreateBufferAndInitialize(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer& buffer, RHIDeviceMemory& bufferMemory, RHIDeviceSize size, void* data = nullptr, int                    dataSize = 0) override;
         bool CreateBufferVma(VmaAllocator allocator,
                                     const RHIBufferCreateInfo* pBufferCreateInfo,
                                     const VmaAllocationCreateInfo* pAllocationCreateInfo,
-                                    RHIBuffer* &pBuffer,
+                                    RHIBuffer& pBuffer,
                                     VmaAllocation* pAllocation,
                                     VmaAllocationInfo* pAllocationInfo) override;
         bool CreateBufferWithAlignmentVma(
@@ -56,85 +73,90 @@ namespace Galaxy
                    const RHIBufferCreateInfo* pBufferCreateInfo,
                    const VmaAllocationCreateInfo* pAllocationCreateInfo,
                    RHIDeviceSize minAlignment,
-                   RHIBuffer* &pBuffer,
+                   RHIBuffer& pBuffer,
                    VmaAllocation* pAllocation,
                    VmaAllocationInfo* pAllocationInfo) override;
-        void CopyBuffer(RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size) override;
+        void CopyBuffer(RHIBuffer srcBuffer, RHIBuffer dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size) override;
         void CreateImage(uint32_t imageWidth, uint32_t imageHeight, RHIFormat format, RHIImageTiling imageTiling, RHIImageUsageFlags imageUsageFlags, RHIMemoryPropertyFlags memoryPropertyFlags,
-                         RHIImage* &image, RHIDeviceMemory* &memory, RHIImageCreateFlags imageCreateFlags, uint32_t arrayLayers, uint32_t miplevels) override;
-        void CreateImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags imageAspectFlags, RHIImageViewType viewType, uint32_t layoutCount, uint32_t miplevels,
-                             RHIImageView* &imageView) override;
-        void CreateGlobalImage(RHIImage* &image, RHIImageView* &imageView, VmaAllocation& imageAllocation, uint32_t textureImageWidth, uint32_t textureImageHeight, void* textureImagePixels, RHIFormat textureImageFormat, uint32_t miplevels = 0) override;
-        void CreateCubeMap(RHIImage* &image, RHIImageView* &imageView, VmaAllocation& imageAllocation, uint32_t textureImageWidth, uint32_t textureImageHeight, std::array<void*, 6> textureImagePixels, RHIFormat textureImageFormat, uint32_t miplevels) override;
-        bool CreateCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool* &pCommandPool) override;
-        bool CreateDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool* &pDescriptorPool) override;
-        bool CreateDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout) override;
-        bool CreateFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence* &pFence) override;
-        bool CreateFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer) override;
-        bool CreateGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline* &pPipelines) override;
-        bool CreateComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines) override;
-        bool CreatePipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout* &pPipelineLayout) override;
-        bool CreateRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass* &pRenderPass) override;
-        bool CreateSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler* &pSampler) override;
-        bool CreateSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore* &pSemaphore) override;
+                         RHIImage& image, RHIDeviceMemory& memory, RHIImageCreateFlags imageCreateFlags, uint32_t arrayLayers, uint32_t miplevels) override;
+        void CreateImageView(RHIImage image, RHIFormat format, RHIImageAspectFlags imageAspectFlags, RHIImageViewType viewType, uint32_t layoutCount, uint32_t miplevels,
+                             RHIImageView& imageView) override;
+        void CreateGlobalImage(RHIImage& image, RHIImageView& imageView, VmaAllocation& imageAllocation, uint32_t textureImageWidth, uint32_t textureImageHeight, void* textureImagePixels, RHIFormat textureImageFormat, uint32_t miplevels = 0) override;
+        void CreateCubeMap(RHIImage& image, RHIImageView& imageView, VmaAllocation& imageAllocation, uint32_t textureImageWidth, uint32_t textureImageHeight, std::array<void*, 6> textureImagePixels, RHIFormat textureImageFormat, uint32_t miplevels) override;
+        bool CreateCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool& pCommandPool) override;
+        bool CreateDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool& pDescriptorPool) override;
+        bool CreateDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout& pSetLayout) override;
+        bool CreateDescriptorUpdateTemplate(const RHIDescriptorUpdateTemplateCreateInfo* pCreateInfo, RHIDescriptorUpdateTemplate& pUpdateTemplate) override;
+        bool CreateFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence& pFence) override;
+        bool CreateFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer& pFramebuffer) override;
+        bool CreateGraphicsPipelines(RHIPipelineCache pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline* pPipelines) override;
+        bool CreateComputePipelines(RHIPipelineCache pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline* pPipelines) override;
+        bool CreatePipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout& pPipelineLayout) override;
+        bool CreateRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass& pRenderPass) override;
+        bool CreateSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler& pSampler) override;
+        bool CreateSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore& pSemaphore) override;
 
         // command and command write
-        bool WaitForFencesPfn(uint32_t fenceCount, RHIFence* const* pFence, RHIBool32 waitAll, uint64_t timeout) override;
-        bool ResetFencesPfn(uint32_t fenceCount, RHIFence* const* pFences) override;
-        bool ResetCommandPoolPfn(RHICommandPool* commandPool, RHICommandPoolResetFlags flags) override;
-        bool BeginCommandBufferPfn(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
-        bool EndCommandBufferPfn(RHICommandBuffer* commandBuffer) override;
-        void CmdBeginRenderPassPfn(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) override;
-        void CmdNextSubpassPfn(RHICommandBuffer* commandBuffer, RHISubpassContents contents) override;
-        void CmdEndRenderPassPfn(RHICommandBuffer* commandBuffer) override;
-        void CmdBindPipelinePfn(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline* pipeline) override;
-        void CmdSetViewportPfn(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) override;
-        void CmdSetScissorPfn(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors) override;
+        bool WaitForFencesPfn(uint32_t fenceCount, const RHIFence* pFence, RHIBool32 waitAll, uint64_t timeout) override;
+        bool ResetFencesPfn(uint32_t fenceCount, const RHIFence* pFences) override;
+        bool ResetCommandPoolPfn(RHICommandPool commandPool, RHICommandPoolResetFlags flags) override;
+        bool BeginCommandBufferPfn(RHICommandBuffer commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
+        bool EndCommandBufferPfn(RHICommandBuffer commandBuffer) override;
+        void CmdBeginRenderPassPfn(RHICommandBuffer commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) override;
+        void CmdNextSubpassPfn(RHICommandBuffer commandBuffer, RHISubpassContents contents) override;
+        void CmdEndRenderPassPfn(RHICommandBuffer commandBuffer) override;
+        void CmdBindPipelinePfn(RHICommandBuffer commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline pipeline) override;
+        void CmdSetViewportPfn(RHICommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) override;
+        void CmdSetScissorPfn(RHICommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors) override;
         void CmdBindVertexBuffersPfn(
-            RHICommandBuffer* commandBuffer,
+            RHICommandBuffer commandBuffer,
             uint32_t firstBinding,
             uint32_t bindingCount,
-            RHIBuffer* const* pBuffers,
+            const RHIBuffer* pBuffers,
             const RHIDeviceSize* pOffsets) override;
-        void CmdBindIndexBufferPfn(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType) override;
+        void CmdBindIndexBufferPfn(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset, RHIIndexType indexType) override;
         void CmdBindDescriptorSetsPfn(
-            RHICommandBuffer* commandBuffer,
+            RHICommandBuffer commandBuffer,
             RHIPipelineBindPoint pipelineBindPoint,
-            RHIPipelineLayout* layout,
+            RHIPipelineLayout layout,
             uint32_t firstSet,
             uint32_t descriptorSetCount,
-            const RHIDescriptorSet* const* pDescriptorSets,
+            const RHIDescriptorSet* pDescriptorSets,
             uint32_t dynamicOffsetCount,
             const uint32_t* pDynamicOffsets) override;
-        void CmdDrawIndexedPfn(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) override;
-        void CmdClearAttachmentsPfn(RHICommandBuffer* commandBuffer, uint32_t attachmentCount, const RHIClearAttachment* pAttachments, uint32_t rectCount, const RHIClearRect* pRects) override;
-
-        bool BeginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
-        void CmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) override;
-        void CmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) override;
-        void CmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) override;
-        void CmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
-        void CmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
-        void CmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) override;
-        void CmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
-        bool EndCommandBuffer(RHICommandBuffer* commandBuffer) override;
+        void CmdDrawIndexedPfn(RHICommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) override;
+        void CmdClearAttachmentsPfn(RHICommandBuffer commandBuffer, uint32_t attachmentCount, const RHIClearAttachment* pAttachments, uint32_t rectCount, const RHIClearRect* pRects) override;
+
+        bool BeginCommandBuffer(RHICommandBuffer commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
+        void CmdCopyImageToBuffer(RHICommandBuffer commandBuffer, RHIImage srcImage, RHIImageLayout srcImageLayout, RHIBuffer dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) override;
+        void CmdCopyImageToImage(RHICommandBuffer commandBuffer, RHIImage srcImage, RHIImageAspectFlagBits srcFlag, RHIImage dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) override;
+        void CmdCopyBuffer(RHICommandBuffer commandBuffer, RHIBuffer srcBuffer, RHIBuffer dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) override;
+        void CmdDraw(RHICommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
+        void CmdDispatch(RHICommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void CmdDispatchIndirect(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset) override;
+        void CmdPipelineBarrier(RHICommandBuffer commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
+        bool EndCommandBuffer(RHICommandBuffer commandBuffer) override;
         void UpdateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) override;
-        bool QueueSubmit(RHIQueue* queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence* fence) override;
-        bool QueueWaitIdle(RHIQueue* queue) override;
+        void UpdateDescriptorSetWithTemplate(RHIDescriptorSet descriptorSet, RHIDescriptorUpdateTemplate updateTemplate, const void* pData) override;
+        void QueueDescriptorWrites(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites) override;
+        void FlushDescriptorWrites() override;
+        bool QueueSubmit(RHIQueue queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence fence) override;
+        bool QueueWaitIdle(RHIQueue queue) override;
         void ResetCommandPool() override;
         void WaitForFences() override;
-        bool WaitForFences(uint32_t fenceCount, const RHIFence* const* pFences, RHIBool32 waitAll, uint64_t timeout);
+        bool WaitForFences(uint32_t fenceCount, const RHIFence* pFences, RHIBool32 waitAll, uint64_t timeout);
 
         // query
         void GetPhysicalDeviceProperties(RHIPhysicalDeviceProperties* pProperties) override;
-        RHICommandBuffer* GetCurrentCommandBuffer() const override;
-        RHICommandBuffer* const* GetCommandBufferList() const override;
-        RHICommandPool*          GetCommandPool() const override;
-        RHIDescriptorPool*       GetDescriptorPool()const override;
-        RHIFence* const* GetFenceList() const override;
+        RHICommandBuffer GetCurrentCommandBuffer() const override;
+        const RHICommandBuffer* GetCommandBufferList() const override;
+        RHICommandPool           GetCommandPool() const override;
+        RHIDescriptorPool        GetDescriptorPool()const override;
+        const RHIFence* GetFenceList() const override;
         QueueFamilyIndices GetQueueFamilyIndices() const override;
-        RHIQueue* GetGraphicsQueue() const override;
-        RHIQueue* GetComputeQueue() const override;
+        RHIQueue GetGraphicsQueue() const override;
+        RHIQueue GetComputeQueue() const override;
+        RHIQueue GetTransferQueue() const override;
         RHISwapChainDesc GetSwapchainInfo() override;
         RHIDepthImageDesc GetDepthImageInfo() const override;
         uint8_t GetMaxFramesInFlight() const override;
@@ -142,12 +164,45 @@ namespace Galaxy
         void SetCurrentFrameIndex(uint8_t index) override;
 
         // command write
-        RHICommandBuffer* BeginSingleTimeCommands() override;
-        void            EndSingleTimeCommands(RHICommandBuffer* commandBuffer) override;
+        RHICommandBuffer BeginSingleTimeCommands() override;
+        void            EndSingleTimeCommands(RHICommandBuffer commandBuffer) override;
         bool PrepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) override;
         void SubmitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) override;
-        void PushEvent(RHICommandBuffer* commondBuffer, const char* name, const float* color) override;
-        void PopEvent(RHICommandBuffer* commondBuffer) override;
+        void PushEvent(RHICommandBuffer commondBuffer, const char* name, const float* color) override;
+        void PopEvent(RHICommandBuffer commondBuffer) override;
+
+        // pipeline cache
+        void SavePipelineCache() override;
+        void SetPipelineManifestRecording(bool recording) override;
+        uint32_t ReplayPipelineManifest() override;
+
+        // async pipelines
+        void CreateGraphicsPipelinesAsync(uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline* pPipelines) override;
+        void CreateComputePipelinesAsync(uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline* pPipelines) override;
+        RHIPipelineStatus GetPipelineStatus(RHIPipeline pipeline) override;
+        bool WaitForPipeline(RHIPipeline pipeline) override;
+
+        // bindless
+        bool                   IsBindlessSupported() const override;
+        RHIDescriptorSetLayout GetBindlessSetLayout() const override;
+        RHIDescriptorSet       GetBindlessSet() const override;
+        uint32_t               AddBindlessTexture(RHIImageView imageView, RHISampler sampler) override;
+        uint32_t               AddBindlessBuffer(RHIBuffer buffer, RHIDeviceSize offset, RHIDeviceSize range) override;
+        void                   RemoveBindlessTexture(uint32_t index) override;
+        void                   RemoveBindlessBuffer(uint32_t index) override;
+
+        // async uploads
+        bool            HasDedicatedTransferQueue() const override;
+        RHIUploadTicket UploadBufferAsync(RHIBuffer dstBuffer, RHIDeviceSize dstOffset, const void* pData, RHIDeviceSize size) override;
+        RHIUploadTicket UploadImageAsync(RHIImage dstImage, RHIFormat format, uint32_t width, uint32_t height, uint32_t layerCount, uint32_t mipLevels, const void* pData, RHIDeviceSize size) override;
+        bool            IsUploadComplete(RHIUploadTicket ticket) const override;
+        void            WaitForUpload(RHIUploadTicket ticket) override;
+
+        // memory statistics
+        void GetMemoryStats(RHIMemoryStats& outStats) const override;
+        void SetMemoryCategory(RHIDeviceMemory memory, RHIMemoryCategory category) override;
+        bool DumpMemoryStats(const std::string& path) const override;
+        void SetMemoryMovedCallback(std::function<void()> callback) override;
 
         // destory
         virtual ~VulkanRHI() override final;
@@ -155,52 +210,58 @@ namespace Galaxy
         void ClearSwapchain() override;
         void DestroyDefaultSampler(RHIDefaultSamplerType type) override;
         void DestroyMipmappedSampler() override;
-        void DestroyShaderModule(RHIShader* shader) override;
-        void DestroySemaphore(RHISemaphore* semaphore) override;
-        void DestroySampler(RHISampler* sampler) override;
-        void DestroyInstance(RHIInstance* instance) override;
-        void DestroyImageView(RHIImageView* imageView) override;
-        void DestroyImage(RHIImage* image) override;
-        void DestroyFramebuffer(RHIFramebuffer* framebuffer) override;
-        void DestroyFence(RHIFence* fence) override;
+        void DestroyShaderModule(RHIShader shader) override;
+        void DestroySemaphore(RHISemaphore semaphore) override;
+        void DestroySampler(RHISampler sampler) override;
+        void DestroyInstance(RHIInstance instance) override;
+        void DestroyImageView(RHIImageView imageView) override;
+        void DestroyImage(RHIImage image) override;
+        void DestroyFramebuffer(RHIFramebuffer framebuffer) override;
+        void DestroyPipeline(RHIPipeline pipeline) override;
+        void DestroyPipelineLayout(RHIPipelineLayout layout) override;
+        void DestroyDescriptorSetLayout(RHIDescriptorSetLayout layout) override;
+        void DestroyDescriptorUpdateTemplate(RHIDescriptorUpdateTemplate updateTemplate) override;
+        void FreeDescriptorSets(uint32_t descriptorSetCount, const RHIDescriptorSet* pDescriptorSets) override;
+        void DestroyFence(RHIFence fence) override;
         void DestroyDevice() override;
-        void DestroyCommandPool(RHICommandPool* commandPool) override;
-        void DestroyBuffer(RHIBuffer* &buffer) override;
-        void FreeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) override;
+        void DestroyCommandPool(RHICommandPool commandPool) override;
+        void DestroyBuffer(RHIBuffer& buffer) override;
+        void FreeCommandBuffers(RHICommandPool commandPool, uint32_t commandBufferCount, RHICommandBuffer pCommandBuffers) override;
 
         // memory
-        void FreeMemory(RHIDeviceMemory* &memory) override;
-        bool MapMemory(RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size, RHIMemoryMapFlags flags, void** ppData) override;
-        void UnmapMemory(RHIDeviceMemory* memory) override;
-        void InvalidateMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) override;
-        void FlushMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) override;
+        void FreeMemory(RHIDeviceMemory& memory) override;
+        bool MapMemory(RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size, RHIMemoryMapFlags flags, void** ppData) override;
+        void UnmapMemory(RHIDeviceMemory memory) override;
+        void InvalidateMappedMemoryRanges(void* pNext, RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size) override;
+        void FlushMappedMemoryRanges(void* pNext, RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size) override;
 
         //semaphores
-        RHISemaphore* &GetTextureCopySemaphore(uint32_t index) override;
+        RHISemaphore& GetTextureCopySemaphore(uint32_t index) override;
     public:
         static uint8_t const MaxFramesInFlight {3};
 
+        // every RHI handle handed out by this backend resolves through here
+        VulkanResources Resources;
 
-        RHIQueue* GraphicsQueue{ nullptr };
-        RHIQueue* ComputeQueue{ nullptr };
+        RHIQueue GraphicsQueue{ nullptr };
+        RHIQueue ComputeQueue{ nullptr };
+        RHIQueue TransferQueue{ nullptr }; // null without a dedicated transfer family
 
         RHIFormat SwapchainImageFormat{ RHI_FORMAT_UNDEFINED };
-        std::vector<RHIImageView*> SwapchainImageviews;
+        std::vector<RHIImageView> SwapchainImageviews;
         RHIExtent2D SwapchainExtent;
         RHIViewport Viewport;
         RHIRect2D Scissor;
 
         RHIFormat DepthImageFormat{ RHI_FORMAT_UNDEFINED };
-        RHIImageView* DepthImageView = new VulkanImageView();
+        RHIImageView DepthImageView;
 
-        RHIFence* RhiIsFrameInFlightFences[MaxFramesInFlight];
+        RHIFence RhiIsFrameInFlightFences[MaxFramesInFlight];
 
-        RHIDescriptorPool* DescriptorPool = new VulkanDescriptorPool();
+        RHICommandPool RhiCommandPool;
 
-        RHICommandPool* RhiCommandPool;
-
-        RHICommandBuffer* CommandBuffers[MaxFramesInFlight];
-        RHICommandBuffer* CurrentCommandBuffer = new VulkanCommandBuffer();
+        RHICommandBuffer CommandBuffers[MaxFramesInFlight];
+        RHICommandBuffer CurrentCommandBuffer;
 
         QueueFamilyIndices QueueIndices;
 
@@ -214,37 +275,20 @@ namespace Galaxy
         VkSwapchainKHR           Swapchain {nullptr};
         std::vector<VkImage>     SwapchainImages;
 
-        RHIImage*        DepthImage = new VulkanImage();
-        VkDeviceMemory DepthImageMemory {nullptr};
+        RHIImage       DepthImage;
+        VmaAllocation  DepthImageAllocation {nullptr};
 
         std::vector<VkFramebuffer> SwapchainFramebuffers;
 
         // asset allocator use VMA library
         VmaAllocator AssetsAllocator;
 
-        // function pointers
-        // function pointers
+        // device level entry points, loaded once the logical device exists
+        VulkanDeviceTable DeviceTable;
+
+        // debug label entry points, only loaded when the debug utils extension is enabled
         PFN_vkCmdBeginDebugUtilsLabelEXT _vkCmdBeginDebugUtilsLabelEXT;
         PFN_vkCmdEndDebugUtilsLabelEXT   _vkCmdEndDebugUtilsLabelEXT;
-        PFN_vkWaitForFences         _vkWaitForFences;
-        PFN_vkResetFences           _vkResetFences;
-        PFN_vkResetCommandPool      _vkResetCommandPool;
-        PFN_vkBeginCommandBuffer    _vkBeginCommandBuffer;
-        PFN_vkEndCommandBuffer      _vkEndCommandBuffer;
-        PFN_vkCmdBeginRenderPass    _vkCmdBeginRenderPass;
-        PFN_vkCmdNextSubpass        _vkCmdNextSubpass;
-        PFN_vkCmdEndRenderPass      _vkCmdEndRenderPass;
-        PFN_vkCmdBindPipeline       _vkCmdBindPipeline;
-        PFN_vkCmdSetViewport        _vkCmdSetViewport;
-        PFN_vkCmdSetScissor         _vkCmdSetScissor;
-        PFN_vkCmdBindVertexBuffers  _vkCmdBindVertexBuffers;
-        PFN_vkCmdBindIndexBuffer    _vkCmdBindIndexBuffer;
-        PFN_vkCmdBindDescriptorSets _vkCmdBindDescriptorSets;
-        PFN_vkCmdDrawIndexed        _vkCmdDrawIndexed;
-        PFN_vkCmdClearAttachments   _vkCmdClearAttachments;
-
-        // global descriptor pool
-        VkDescriptorPool GlobalVkDescriptorPool;
 
         // command pool and buffers
         uint8_t              CurrentFrameIndex {0};
@@ -252,7 +296,7 @@ namespace Galaxy
         VkCommandBuffer      VkCommandBuffers[MaxFramesInFlight];
         VkSemaphore          ImageAvailableForRenderSemaphores[MaxFramesInFlight];
         VkSemaphore          ImageFinishedForPresentationSemaphores[MaxFramesInFlight];
-        RHISemaphore*        ImageAvailableForTexturescopySemaphores[MaxFramesInFlight];
+        RHISemaphore         ImageAvailableForTexturescopySemaphores[MaxFramesInFlight];
         VkFence              IsFrameInFlightFences[MaxFramesInFlight];
 
         // TODO: set
@@ -260,16 +304,90 @@ namespace Galaxy
 
         uint32_t CurrentSwapchainImageIndex;
 
+        // frame sets for Vulkan level code recording on job system workers, which cannot create RHI handles
+        VulkanDescriptorAllocator& GetDescriptorAllocator() { return m_DescriptorAllocator; }
+
+        // upload memory and the command buffer copies out of it are recorded into, submitted ahead of the frame
+        VulkanStagingRing& GetStagingRing() { return m_StagingRing; }
+
     private:
         const std::vector<char const*> m_ValidationLayers {"VK_LAYER_KHRONOS_validation"};
         uint32_t                       m_VulkanApiVersion {VK_API_VERSION_1_0};
 
         std::vector<char const*> m_DeviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
-        // default sampler cache
-        RHISampler* m_LinearSampler = nullptr;
-        RHISampler* m_NearestSampler = nullptr;
-        std::map<uint32_t, RHISampler*> m_MipmapSamplerMap;
+        // heap budgets and category totals of AssetsAllocator, budgets come from the driver when it has memory_budget
+        bool                m_IsMemoryBudgetSupported {false};
+        VulkanMemoryTracker m_MemoryTracker;
+
+        // every sampler shared by description. The common ones are created with the device and hold a reference
+        // of their own until they are destroyed explicitly or on Clear.
+        VulkanSamplerCache m_SamplerCache;
+        RHISampler         m_LinearSampler;
+        RHISampler         m_NearestSampler;
+        float              m_MaxSamplerAnisotropy {1.0f};
+
+        // mipmap samplers by mip count, each holds a reference into the sampler cache
+        std::map<uint32_t, RHISampler> m_MipmapSamplerMap;
+
+        // backs every descriptor set allocated without an explicit pool. Frame sets get an RHI handle each, those are
+        // released together with the pools of their frame slot.
+        VulkanDescriptorAllocator     m_DescriptorAllocator;
+        std::vector<RHIDescriptorSet> m_FrameDescriptorSets[MaxFramesInFlight];
+
+        // translates descriptor writes, owns the packed data layouts of update templates and the queued writes
+        VulkanDescriptorUpdater m_DescriptorUpdater;
+
+        // update-after-bind arrays of every texture and buffer registered for bindless access, only when the device
+        // supports descriptor indexing
+        bool                   m_IsBindlessSupported {false};
+        VulkanBindlessHeap     m_BindlessHeap;
+        RHIDescriptorSetLayout m_BindlessSetLayout;
+        RHIDescriptorSet       m_BindlessSet;
+
+        // every buffer and image upload is staged here
+        VulkanStagingRing m_StagingRing;
+
+        // async uploads, staged in m_TransferRing when the device has a dedicated transfer queue
+        VulkanStagingRing m_TransferRing;
+        VulkanUploadQueue m_UploadQueue;
+
+        // compacts device local memory once it is fragmented, one bounded pass per frame
+        VulkanDefragmenter m_Defragmenter;
+
+        // released buffers, images, views, framebuffers, pipelines, samplers and memory wait here for their frame's
+        // fence. m_RetiredResources is the batch being destroyed, kept around for its capacity.
+        VulkanDeletionQueue        m_DeletionQueue;
+        VulkanDeletionQueue::Batch m_RetiredResources;
+
+        // backs every pipeline created without an explicit cache, persisted next to the executable
+        VulkanPipelineCache m_PipelineCache;
+
+        // Shader modules shared by every RHIShader created from identical bytecode, keyed by a hash of the code. The
+        // code is kept to rule out hash collisions, a module is destroyed once its last RHIShader is.
+        struct SharedShaderModule
+        {
+            VkShaderModule             Module {nullptr};
+            uint32_t                   RefCount {0};
+            std::vector<unsigned char> Code;
+        };
+        std::unordered_map<uint64_t, SharedShaderModule> m_ShaderModules;
+        std::unordered_map<VkShaderModule, uint64_t>     m_ShaderModuleKeys;
+
+        // every pipeline description seen, replayed at startup to warm m_PipelineCache
+        VulkanPipelineManifest m_PipelineManifest;
+
+        // One async creation call. The create infos are translated on the calling thread into Arena, the worker only
+        // runs vkCreate*Pipelines and fills VkPipelines. Handles are published back on the owner thread.
+        struct PipelineBatch
+        {
+            LinearArena              Arena {4 * 1024};
+            std::vector<RHIPipeline> Pipelines;
+            std::vector<VkPipeline>  VkPipelines;
+            Ref<JobCounter>          Counter;
+            VkResult                 Result = VK_SUCCESS;
+        };
+        std::vector<Scope<PipelineBatch>> m_PipelineBatches;
 
     private:
         void CreateInstance();
@@ -279,9 +397,31 @@ namespace Galaxy
         void CreateLogicalDevice();
         void CreateCommandPool() override;;
         void CreateCommandBuffers();
-        void CreateDescriptorPool();
+        void CreateDescriptorAllocator();
+        void CreateBindlessHeap();
         void CreateSyncPrimitives();
         void CreateAssetAllocator();
+        void CreateStagingRing();
+        void CreateUploadQueue();
+        void CreateDefragmenter();
+        void CreateSamplerCache();
+        void CreatePipelineCache();
+        void CreatePipelineManifest();
+
+        // the shared sampler for the description, null when it could not be created
+        RHISampler AcquireSampler(const VkSamplerCreateInfo& createInfo);
+
+        // for objects the GPU is known to be done with, everything else goes through m_DeletionQueue
+        void DestroyImageViewImmediately(RHIImageView imageView);
+        void DestroyImageImmediately(RHIImage image);
+        void DestroyRetiredResources(VulkanDeletionQueue::Batch& batch);
+
+        static VkBufferUsageFlags GetMovableBufferUsage(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties);
+
+        PipelineBatch& BeginPipelineBatch(uint32_t createInfoCount, RHIPipeline* pPipelines);
+        PipelineBatch* FindPipelineBatch(RHIPipeline pipeline);
+        void           PollPipelineBatches();
+        void           WaitForPipelineBatches();
 
     public:
         bool IsPointLightShadowEnabled() override;
@@ -291,11 +431,9 @@ namespace Galaxy
         bool m_EnableDebugUtilsLabel{ true };
         bool m_EnablePointLightShadow{ true };
 
-        // used in descriptor pool creation
-        uint32_t m_MaxVertexBlendingMeshCount{ 256 };
-        uint32_t m_MaxMaterialCount{ 256 };
-
         bool                     CheckValidationLayerSupport();
+        bool                     IsDeviceExtensionAvailable(const char* extensionName);
+        bool                     CheckBindlessSupport(VkPhysicalDeviceDescriptorIndexingFeatures& outFeatures);
         std::vector<const char*> GetRequiredExtensions();
         void                     PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
 
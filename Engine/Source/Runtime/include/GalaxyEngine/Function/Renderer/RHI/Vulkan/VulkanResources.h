@@ -6,227 +6,175 @@
 
 #pragma once
 
+#include "GalaxyEngine/Core/Container/HandlePool.h"
+#include "GalaxyEngine/Core/Macro.h"
 #include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
 
+#include <tuple>
 #include <vulkan/vulkan.h>
-#include <optional>
 
 namespace Galaxy
 {
-    class VulkanBuffer : public RHIBuffer
-    {
-    public:
-        void     SetResource(VkBuffer res) { m_Resource = res; }
-        VkBuffer GetResource() const { return m_Resource; }
-
-    private:
-        VkBuffer m_Resource;
-    };
-    class VulkanBufferView : public RHIBufferView
-    {
-    public:
-        void         SetResource(VkBufferView res) { m_Resource = res; }
-        VkBufferView GetResource() const { return m_Resource; }
-
-    private:
-        VkBufferView m_Resource;
-    };
-    class VulkanCommandBuffer : public RHICommandBuffer
-    {
-    public:
-        void                  SetResource(VkCommandBuffer res) { m_Resource = res; }
-        VkCommandBuffer GetResource() const { return m_Resource; }
-
-    private:
-        VkCommandBuffer m_Resource;
-    };
-    class VulkanCommandPool : public RHICommandPool
-    {
-    public:
-        void          SetResource(VkCommandPool res) { m_Resource = res; }
-        VkCommandPool GetResource() const { return m_Resource; }
-
-    private:
-        VkCommandPool m_Resource;
-    };
-    class VulkanDescriptorPool : public RHIDescriptorPool
-    {
-    public:
-        void             SetResource(VkDescriptorPool res) { m_Resource = res; }
-        VkDescriptorPool GetResource() const { return m_Resource; }
-
-    private:
-        VkDescriptorPool m_Resource;
-    };
-    class VulkanDescriptorSet : public RHIDescriptorSet
-    {
-    public:
-        void            SetResource(VkDescriptorSet res) { m_Resource = res; }
-        VkDescriptorSet GetResource() const { return m_Resource; }
-
-    private:
-        VkDescriptorSet m_Resource;
-    };
-    class VulkanDescriptorSetLayout : public RHIDescriptorSetLayout
-    {
-    public:
-        void                  SetResource(VkDescriptorSetLayout res) { m_Resource = res; }
-        VkDescriptorSetLayout GetResource() const { return m_Resource; }
-
-    private:
-        VkDescriptorSetLayout m_Resource;
-    };
-    class VulkanDevice : public RHIDevice
-    {
-    public:
-        void     SetResource(VkDevice res) { m_Resource = res; }
-        VkDevice GetResource() const { return m_Resource; }
-
-    private:
-        VkDevice m_Resource;
-    };
-    class VulkanDeviceMemory : public RHIDeviceMemory
-    {
-    public:
-        void           SetResource(VkDeviceMemory res) { m_Resource = res; }
-        VkDeviceMemory GetResource() const { return m_Resource; }
-
-    private:
-        VkDeviceMemory m_Resource;
-    };
-    class VulkanEvent : public RHIEvent
-    {
-    public:
-        void    SetResource(VkEvent res) { m_Resource = res; }
-        VkEvent GetResource() const { return m_Resource; }
-
-    private:
-        VkEvent m_Resource;
-    };
-    class VulkanFence : public RHIFence
-    {
-    public:
-        void    SetResource(VkFence res) { m_Resource = res; }
-        VkFence GetResource() const { return m_Resource; }
-
-    private:
-        VkFence m_Resource;
-    };
-    class VulkanFramebuffer : public RHIFramebuffer
-    {
-    public:
-        void          SetResource(VkFramebuffer res) { m_Resource = res; }
-        VkFramebuffer GetResource() const { return m_Resource; }
-
-    private:
-        VkFramebuffer m_Resource;
-    };
-    class VulkanImage : public RHIImage
-    {
-    public:
-        void     SetResource(VkImage res) { m_Resource = res; }
-        VkImage& GetResource() { return m_Resource; }
-
-    private:
-        VkImage m_Resource;
-    };
-    class VulkanImageView : public RHIImageView
-    {
-    public:
-        void        SetResource(VkImageView res) { m_Resource = res; }
-        VkImageView GetResource() const { return m_Resource; }
-
-    private:
-        VkImageView m_Resource;
-    };
-    class VulkanInstance : public RHIInstance
-    {
-    public:
-        void       SetResource(VkInstance res) { m_Resource = res; }
-        VkInstance GetResource() const { return m_Resource; }
-
-    private:
-        VkInstance m_Resource;
-    };
-    class VulkanQueue : public RHIQueue
-    {
-    public:
-        void    SetResource(VkQueue res) { m_Resource = res; }
-        VkQueue GetResource() const { return m_Resource; }
-
-    private:
-        VkQueue m_Resource;
-    };
-    class VulkanPhysicalDevice : public RHIPhysicalDevice
-    {
-    public:
-        void             SetResource(VkPhysicalDevice res) { m_Resource = res; }
-        VkPhysicalDevice GetResource() const { return m_Resource; }
-
-    private:
-        VkPhysicalDevice m_Resource;
-    };
-    class VulkanPipeline : public RHIPipeline
-    {
-    public:
-        void       SetResource(VkPipeline res) { m_Resource = res; }
-        VkPipeline GetResource() const { return m_Resource; }
-
-    private:
-        VkPipeline m_Resource;
-    };
-    class VulkanPipelineCache : public RHIPipelineCache
-    {
-    public:
-        void            SetResource(VkPipelineCache res) { m_Resource = res; }
-        VkPipelineCache GetResource() const { return m_Resource; }
-
-    private:
-        VkPipelineCache m_Resource;
-    };
-    class VulkanPipelineLayout : public RHIPipelineLayout
-    {
-    public:
-        void             SetResource(VkPipelineLayout res) { m_Resource = res; }
-        VkPipelineLayout GetResource() const { return m_Resource; }
-
-    private:
-        VkPipelineLayout m_Resource;
-    };
-    class VulkanRenderPass : public RHIRenderPass
-    {
-    public:
-        void         SetResource(VkRenderPass res) { m_Resource = res; }
-        VkRenderPass GetResource() const { return m_Resource; }
-
-    private:
-        VkRenderPass m_Resource;
-    };
-    class VulkanSampler : public RHISampler
-    {
-    public:
-        void      SetResource(VkSampler res) { m_Resource = res; }
-        VkSampler GetResource() const { return m_Resource; }
-
-    private:
-        VkSampler m_Resource;
-    };
-    class VulkanSemaphore : public RHISemaphore
-    {
-    public:
-        void         SetResource(VkSemaphore res) { m_Resource = res; }
-        VkSemaphore& GetResource() { return m_Resource; }
-
-    private:
-        VkSemaphore m_Resource;
-    };
-    class VulkanShader : public RHIShader
-    {
-    public:
-        void           SetResource(VkShaderModule res) { m_Resource = res; }
-        VkShaderModule GetResource() const { return m_Resource; }
-
-    private:
-        VkShaderModule m_Resource;
-    };
-} // namespace Galaxy
\ No newline at end of file
+    // Vulkan object behind every RHI handle type
+    template<typename THandle>
+    struct VulkanResourceTraits;
+
+#define VULKAN_RESOURCE_TRAITS(rhiType, vkType) \
+    template<> \
+    struct VulkanResourceTraits<rhiType> \
+    { \
+        using Type                        = vkType; \
+        static constexpr const char* Name = #rhiType; \
+    };
+
+    VULKAN_RESOURCE_TRAITS(RHIBuffer, VkBuffer)
+    VULKAN_RESOURCE_TRAITS(RHIBufferView, VkBufferView)
+    VULKAN_RESOURCE_TRAITS(RHICommandBuffer, VkCommandBuffer)
+    VULKAN_RESOURCE_TRAITS(RHICommandPool, VkCommandPool)
+    VULKAN_RESOURCE_TRAITS(RHIDescriptorPool, VkDescriptorPool)
+    VULKAN_RESOURCE_TRAITS(RHIDescriptorSet, VkDescriptorSet)
+    VULKAN_RESOURCE_TRAITS(RHIDescriptorSetLayout, VkDescriptorSetLayout)
+    VULKAN_RESOURCE_TRAITS(RHIDescriptorUpdateTemplate, VkDescriptorUpdateTemplate)
+    VULKAN_RESOURCE_TRAITS(RHIDevice, VkDevice)
+    VULKAN_RESOURCE_TRAITS(RHIDeviceMemory, VmaAllocation) // sub-allocated, never a VkDeviceMemory of its own
+    VULKAN_RESOURCE_TRAITS(RHIEvent, VkEvent)
+    VULKAN_RESOURCE_TRAITS(RHIFence, VkFence)
+    VULKAN_RESOURCE_TRAITS(RHIFramebuffer, VkFramebuffer)
+    VULKAN_RESOURCE_TRAITS(RHIImage, VkImage)
+    VULKAN_RESOURCE_TRAITS(RHIImageView, VkImageView)
+    VULKAN_RESOURCE_TRAITS(RHIInstance, VkInstance)
+    VULKAN_RESOURCE_TRAITS(RHIQueue, VkQueue)
+    VULKAN_RESOURCE_TRAITS(RHIPhysicalDevice, VkPhysicalDevice)
+    VULKAN_RESOURCE_TRAITS(RHIPipeline, VkPipeline)
+    VULKAN_RESOURCE_TRAITS(RHIPipelineCache, VkPipelineCache)
+    VULKAN_RESOURCE_TRAITS(RHIPipelineLayout, VkPipelineLayout)
+    VULKAN_RESOURCE_TRAITS(RHIRenderPass, VkRenderPass)
+    VULKAN_RESOURCE_TRAITS(RHISampler, VkSampler)
+    VULKAN_RESOURCE_TRAITS(RHISemaphore, VkSemaphore)
+    VULKAN_RESOURCE_TRAITS(RHIShader, VkShaderModule)
+
+#undef VULKAN_RESOURCE_TRAITS
+
+    // One dense pool per RHI object type. Resolving a handle is two array loads instead of a pointer chase into a
+    // separately heap allocated wrapper, and destroying an object makes every copy of its handle stale. Only the
+    // render thread creates and destroys handles.
+    class VulkanResources
+    {
+    public:
+        template<typename THandle>
+        using VkType = typename VulkanResourceTraits<THandle>::Type;
+
+        template<typename THandle>
+        using Pool = HandlePool<VkType<THandle>, typename THandle::TagType>;
+
+        template<typename THandle>
+        THandle Create(VkType<THandle> resource)
+        {
+            return GetPool<THandle>().Create(resource);
+        }
+
+        // VK_NULL_HANDLE for a null handle. A stale handle is a use after destroy and asserts.
+        template<typename THandle>
+        VkType<THandle> Get(THandle handle) const
+        {
+            if (!handle)
+            {
+                return VK_NULL_HANDLE;
+            }
+
+            const VkType<THandle>* resource = GetPool<THandle>().Get(handle);
+            GAL_CORE_ASSERT(resource != nullptr, "[VulkanResources] Stale RHI handle");
+            return resource != nullptr ? *resource : VK_NULL_HANDLE;
+        }
+
+        // Points the handle at a new Vulkan object, e.g. after the swapchain was recreated
+        template<typename THandle>
+        void Set(THandle handle, VkType<THandle> resource)
+        {
+            VkType<THandle>* slot = GetPool<THandle>().Get(handle);
+            GAL_CORE_ASSERT(slot != nullptr, "[VulkanResources] Stale RHI handle");
+            *slot = resource;
+        }
+
+        // Releases the handle only, the Vulkan object has to be destroyed by the caller
+        template<typename THandle>
+        bool Destroy(THandle handle)
+        {
+            return GetPool<THandle>().Destroy(handle);
+        }
+
+        template<typename THandle>
+        bool IsAlive(THandle handle) const
+        {
+            return GetPool<THandle>().IsAlive(handle);
+        }
+
+        template<typename THandle>
+        size_t GetLiveCount() const
+        {
+            return GetPool<THandle>().GetSize();
+        }
+
+        // Live Vulkan objects of one type, packed
+        template<typename THandle>
+        const Pool<THandle>& GetPool() const
+        {
+            return std::get<Pool<THandle>>(m_Pools);
+        }
+
+        // Logs every type that still has live handles and returns the total
+        size_t ReportLiveObjects() const
+        {
+            size_t total = 0;
+            std::apply([&total](const auto&... pools) { ((total += ReportPool(pools)), ...); }, m_Pools);
+            return total;
+        }
+
+    private:
+        template<typename THandle>
+        Pool<THandle>& GetPool()
+        {
+            return std::get<Pool<THandle>>(m_Pools);
+        }
+
+        template<typename T, typename Tag>
+        static size_t ReportPool(const HandlePool<T, Tag>& pool)
+        {
+            if (!pool.IsEmpty())
+            {
+                GAL_CORE_WARN("[VulkanResources] {0} live {1}",
+                              pool.GetSize(),
+                              VulkanResourceTraits<Handle<Tag>>::Name);
+            }
+            return pool.GetSize();
+        }
+
+    private:
+        std::tuple<Pool<RHIBuffer>,
+                   Pool<RHIBufferView>,
+                   Pool<RHICommandBuffer>,
+                   Pool<RHICommandPool>,
+                   Pool<RHIDescriptorPool>,
+                   Pool<RHIDescriptorSet>,
+                   Pool<RHIDescriptorSetLayout>,
+                   Pool<RHIDescriptorUpdateTemplate>,
+                   Pool<RHIDevice>,
+                   Pool<RHIDeviceMemory>,
+                   Pool<RHIEvent>,
+                   Pool<RHIFence>,
+                   Pool<RHIFramebuffer>,
+                   Pool<RHIImage>,
+                   Pool<RHIImageView>,
+                   Pool<RHIInstance>,
+                   Pool<RHIQueue>,
+                   Pool<RHIPhysicalDevice>,
+                   Pool<RHIPipeline>,
+                   Pool<RHIPipelineCache>,
+                   Pool<RHIPipelineLayout>,
+                   Pool<RHIRenderPass>,
+                   Pool<RHISampler>,
+                   Pool<RHISemaphore>,
+                   Pool<RHIShader>>
+            m_Pools;
+    };
+} // namespace Galaxy
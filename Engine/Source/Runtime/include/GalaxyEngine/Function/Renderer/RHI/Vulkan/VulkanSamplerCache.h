@@ -0,0 +1,74 @@
+//
+// VulkanSamplerCache.h
+//
+// Created or modified by Kexuan Zhang on 2023/11/04 14:30.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/RHIStruct.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace Galaxy
+{
+    // Every sampler created through the RHI, shared between all requests with an equal description.
+    //
+    // Descriptions are compared field by field, filters, address modes, anisotropy, LOD range, compare op and border
+    // included, after the fields the device ignores were normalized away. A request for an existing description gets
+    // the same RHISampler with one more reference, the sampler is destroyed with its last reference. Samplers with a
+    // pNext chain are never shared.
+    //
+    // Only keeps the books, the RHI creates and destroys the Vulkan objects. The number of live samplers is checked
+    // against maxSamplerAllocationCount before creating one. Release may be called from any thread.
+    class VulkanSamplerCache
+    {
+    public:
+        void Initialize(uint32_t maxSamplerCount);
+
+        // Forgets every sampler, they have to be destroyed by the caller
+        void Destroy();
+
+        // Clears the fields the device ignores for this description, so equal samplers compare equal
+        static VkSamplerCreateInfo Normalize(const VkSamplerCreateInfo& createInfo);
+
+        // The shared sampler for a normalized description with one more reference, null when there is none yet
+        RHISampler Acquire(const VkSamplerCreateInfo& createInfo);
+
+        // false once maxSamplerAllocationCount samplers are alive
+        bool CanCreate() const;
+
+        // A sampler just created from a normalized description, with one reference
+        void Insert(const VkSamplerCreateInfo& createInfo, RHISampler sampler);
+
+        // Drops a reference, true when it was the last one and the sampler has to be destroyed. Samplers the cache
+        // never saw are destroyed right away.
+        bool Release(RHISampler sampler);
+
+        static size_t Hash(const VkSamplerCreateInfo& createInfo);
+
+        size_t   GetSamplerCount() const;
+        uint32_t GetMaxSamplerCount() const { return m_MaxSamplerCount; }
+
+    private:
+        struct Entry
+        {
+            VkSamplerCreateInfo CreateInfo {};
+            size_t              Key {0};
+            uint32_t            RefCount {0};
+            bool                IsShared {false};
+        };
+
+        static bool IsEqual(const VkSamplerCreateInfo& lhs, const VkSamplerCreateInfo& rhs);
+
+    private:
+        mutable std::mutex m_Mutex;
+        uint32_t           m_MaxSamplerCount {0};
+
+        std::unordered_map<RHISampler, Entry>       m_Samplers;
+        std::unordered_multimap<size_t, RHISampler> m_SharedSamplers; // by description hash
+    };
+} // namespace Galaxy
@@ -0,0 +1,119 @@
+//
+// VulkanStagingRing.h
+//
+// Created or modified by Kexuan Zhang on 2023/11/01 10:15.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanMemoryTracker.h"
+
+#include <vector>
+
+namespace Galaxy
+{
+    struct VulkanStagingAllocation
+    {
+        VkBuffer     Buffer {VK_NULL_HANDLE};
+        VkDeviceSize Offset {0};
+        void*        pMapped {nullptr}; // already offset, write the upload here
+    };
+
+    struct VulkanStagingRingStats
+    {
+        VkDeviceSize Capacity         = 0;
+        VkDeviceSize UsedSize         = 0; // written but not retired yet
+        uint32_t     BatchesInFlight  = 0;
+        uint64_t     Submits          = 0;
+        uint64_t     Stalls           = 0; // times the ring was full and had to wait for the oldest batch
+        uint64_t     DedicatedBuffers = 0; // uploads too large for the ring
+    };
+
+    // Every upload goes through one persistently mapped buffer used as a ring, instead of a staging buffer and a
+    // vkAllocateMemory per upload. Copies out of it are recorded into the command buffer of the open batch. Submit
+    // sends the batch to the queue with a fence of its own, and Retire hands its ring space back once that fence has
+    // signaled. Nothing ever waits for the whole queue.
+    //
+    // Batches go to the same queue as the frame, before it, so its commands see the uploads without a semaphore.
+    // Render thread only.
+    class VulkanStagingRing
+    {
+    public:
+        bool Initialize(const VulkanDeviceTable& device,
+                        VmaAllocator             allocator,
+                        VulkanMemoryTracker&     tracker,
+                        VkQueue                  queue,
+                        uint32_t                 queueFamilyIndex,
+                        VkDeviceSize             capacity);
+
+        // Waits for the batches still in flight
+        void Destroy();
+
+        // Space for size bytes, valid until the batch it is used in retires. Uploads larger than the ring get a
+        // dedicated buffer that goes away with the batch. A full ring waits for its oldest batch only.
+        bool Allocate(VkDeviceSize size, VkDeviceSize alignment, VulkanStagingAllocation& outAllocation);
+
+        // Command buffer of the open batch, begun on first use
+        VkCommandBuffer GetCommandBuffer();
+
+        // Submits the open batch if anything was recorded into it
+        void Submit();
+
+        // Reclaims the space of every batch whose fence has signaled, never blocks
+        void Retire();
+
+        // Submits the open batch and blocks until all batches are done
+        void WaitIdle();
+
+        VulkanStagingRingStats GetStats() const;
+
+        // batches are numbered from 1 in submission order, the open one gets the next number
+        uint64_t GetOpenBatchSerial() const { return m_Submits + 1; }
+        uint64_t GetRetiredBatchSerial() const { return m_RetiredBatches; }
+
+    private:
+        struct Batch
+        {
+            VkCommandBuffer CommandBuffer {VK_NULL_HANDLE};
+            VkFence         Fence {VK_NULL_HANDLE};
+            VkDeviceSize    Begin {0}; // ring range written by the batch, Begin > End when it wrapped around
+            VkDeviceSize    End {0};
+            bool            IsRecording {false};
+            bool            HasAllocations {false};
+
+            std::vector<std::pair<VkBuffer, VmaAllocation>> DedicatedBuffers;
+        };
+
+        bool TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset);
+        bool AllocateDedicated(VkDeviceSize size, VulkanStagingAllocation& outAllocation);
+        void FlushBatchRange(const Batch& batch);
+        void RetireBatch(Batch& batch);
+        bool IsEmpty() const { return m_InFlight.empty() && !m_Open.HasAllocations; }
+
+    private:
+        const VulkanDeviceTable* m_Device {nullptr};
+        VmaAllocator             m_Allocator {VK_NULL_HANDLE};
+        VulkanMemoryTracker*     m_Tracker {nullptr};
+        VkQueue                  m_Queue {VK_NULL_HANDLE};
+        VkCommandPool            m_CommandPool {VK_NULL_HANDLE};
+
+        VkBuffer       m_Buffer {VK_NULL_HANDLE};
+        VmaAllocation  m_Allocation {VK_NULL_HANDLE};
+        unsigned char* m_pMapped {nullptr};
+        VkDeviceSize   m_Capacity {0};
+
+        // live data is [m_Tail, m_Head), wrapping around at m_Capacity. m_Head == m_Tail only when the ring is empty.
+        VkDeviceSize m_Head {0};
+        VkDeviceSize m_Tail {0};
+
+        Batch              m_Open;
+        std::vector<Batch> m_InFlight; // oldest first
+        std::vector<Batch> m_FreeBatches;
+
+        uint64_t m_Submits {0};
+        uint64_t m_RetiredBatches {0};
+        uint64_t m_Stalls {0};
+        uint64_t m_DedicatedBuffers {0};
+    };
+} // namespace Galaxy
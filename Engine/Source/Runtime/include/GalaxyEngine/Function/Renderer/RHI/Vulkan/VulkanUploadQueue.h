@@ -0,0 +1,106 @@
+//
+// VulkanUploadQueue.h
+//
+// Created or modified by Kexuan Zhang on 2023/11/02 14:20.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/RHIStruct.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanStagingRing.h"
+
+#include <deque>
+
+namespace Galaxy
+{
+    class VulkanRHI;
+
+    // Streams buffer and image data in on the dedicated transfer queue, next to the frame instead of ahead of it.
+    //
+    // Copies are recorded into the transfer ring together with a release of the resource to the graphics family.
+    // Once the fence of that batch has signaled, Poll records the matching acquire into the graphics staging ring,
+    // which is submitted before the next frame. Mip chains are generated there as well, a transfer queue cannot blit.
+    // The ticket of an upload completes with its acquire, every frame submitted afterwards sees the data.
+    //
+    // Without a dedicated transfer family the uploads are recorded into the graphics staging ring right away and
+    // complete immediately. Render thread only.
+    class VulkanUploadQueue
+    {
+    public:
+        // pTransferRing is null when the device has no dedicated transfer family
+        void Initialize(VulkanRHI& rhi, VulkanStagingRing* pTransferRing, uint32_t transferFamily);
+        void Destroy();
+
+        bool IsDedicated() const { return m_pTransferRing != nullptr; }
+
+        // The data is copied before returning. The destination must not be in use by the GPU, its previous contents
+        // are discarded.
+        RHIUploadTicket UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size);
+
+        // pData holds mip 0 of every layer, tightly packed. The image has to be created with transfer src and dst
+        // usage and ends up in shader read only layout with its mip chain generated.
+        RHIUploadTicket UploadImage(VkImage      dstImage,
+                                    VkFormat     format,
+                                    uint32_t     width,
+                                    uint32_t     height,
+                                    uint32_t     layerCount,
+                                    uint32_t     mipLevels,
+                                    const void*  pData,
+                                    VkDeviceSize size);
+
+        // Submits the transfer batch, once per frame or whenever uploads should get going right away
+        void Submit();
+
+        // Hands finished transfer batches over to the graphics queue, never blocks
+        void Poll();
+
+        // false for RHI_INVALID_UPLOAD_TICKET, a failed upload never completes
+        bool IsComplete(RHIUploadTicket ticket) const
+        {
+            return ticket != RHI_INVALID_UPLOAD_TICKET && ticket <= m_CompletedTicket;
+        }
+        bool IsIdle() const { return m_CompletedTicket == m_LastTicket; }
+
+        // Blocks until the transfer queue is done with the ticket and records its acquire, returns right away for
+        // RHI_INVALID_UPLOAD_TICKET
+        void Wait(RHIUploadTicket ticket);
+
+    private:
+        struct PendingUpload
+        {
+            RHIUploadTicket Ticket {RHI_INVALID_UPLOAD_TICKET};
+            uint64_t        BatchSerial {0}; // transfer ring batch the copy went out with
+
+            VkBuffer     Buffer {VK_NULL_HANDLE};
+            VkDeviceSize Offset {0};
+            VkDeviceSize Size {0};
+
+            VkImage  Image {VK_NULL_HANDLE};
+            VkFormat Format {VK_FORMAT_UNDEFINED};
+            uint32_t Width {0};
+            uint32_t Height {0};
+            uint32_t LayerCount {0};
+            uint32_t MipLevels {0};
+        };
+
+        // after the copy was recorded, releases the upload or finishes it right away without a transfer family
+        RHIUploadTicket Track(VkCommandBuffer commandBuffer, PendingUpload& upload);
+
+        // Release on the transfer queue and acquire on the graphics queue record the same barrier, only the side
+        // it runs on gets its access mask and stage. Without a transfer family it is a plain barrier.
+        void RecordBarrier(VkCommandBuffer commandBuffer, const PendingUpload& upload, bool isRelease);
+
+        // acquire and mip chain, on the graphics queue
+        void RecordAcquire(VkCommandBuffer commandBuffer, const PendingUpload& upload);
+
+    private:
+        VulkanRHI*         m_RHI {nullptr};
+        VulkanStagingRing* m_pTransferRing {nullptr};
+        uint32_t           m_SrcQueueFamily {VK_QUEUE_FAMILY_IGNORED};
+        uint32_t           m_DstQueueFamily {VK_QUEUE_FAMILY_IGNORED};
+
+        std::deque<PendingUpload> m_Pending; // oldest first
+        RHIUploadTicket           m_LastTicket {0};
+        RHIUploadTicket           m_CompletedTicket {0};
+    };
+} // namespace Galaxy
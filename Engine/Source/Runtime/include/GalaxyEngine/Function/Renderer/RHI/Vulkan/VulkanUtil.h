@@ -7,12 +7,12 @@
 #pragma once
 
 #include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
 #include <array>
-#include <unordered_map>
 #include <vector>
 
 namespace Galaxy
@@ -22,31 +22,44 @@ namespace Galaxy
     public:
         static uint32_t
         FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags propertiesFlag);
-        static VkShaderModule CreateShaderModule(VkDevice device, const std::vector<unsigned char>& shaderCode);
-        static void           CreateBuffer(VkPhysicalDevice      physicalDevice,
-                                           VkDevice              device,
-                                           VkDeviceSize          size,
-                                           VkBufferUsageFlags    usage,
-                                           VkMemoryPropertyFlags properties,
-                                           VkBuffer&             buffer,
-                                           VkDeviceMemory&       bufferMemory);
-        static void           CreateBufferAndInitialize(VkDevice              device,
-                                                        VkPhysicalDevice      physicalDevice,
-                                                        VkBufferUsageFlags    usageFlags,
-                                                        VkMemoryPropertyFlags memoryPropertyFlags,
-                                                        VkBuffer*             buffer,
-                                                        VkDeviceMemory*       memory,
-                                                        VkDeviceSize          size,
-                                                        void*                 data     = nullptr,
-                                                        int                   datasize = 0);
+        static VkShaderModule CreateShaderModule(const VulkanDeviceTable&          device,
+                                                 const std::vector<unsigned char>& shaderCode);
+
+        // Buffers and images are sub-allocated through VMA, the property flags are what the memory has to provide.
+        // Host visible memory is mapped with vmaMapMemory, the allocation is what RHIDeviceMemory stands for.
+        static VmaAllocationCreateInfo GetAllocationCreateInfo(VkMemoryPropertyFlags properties);
+        static void                    CreateBuffer(VmaAllocator          allocator,
+                                                    VkDeviceSize          size,
+                                                    VkBufferUsageFlags    usage,
+                                                    VkMemoryPropertyFlags properties,
+                                                    VkBuffer&             buffer,
+                                                    VmaAllocation&        allocation);
+        static void                    CreateBufferAndInitialize(VmaAllocator          allocator,
+                                                                 VkBufferUsageFlags    usageFlags,
+                                                                 VkMemoryPropertyFlags memoryPropertyFlags,
+                                                                 VkBuffer*             buffer,
+                                                                 VmaAllocation*        allocation,
+                                                                 VkDeviceSize          size,
+                                                                 void*                 data     = nullptr,
+                                                                 int                   datasize = 0);
+        // recorded into the open upload batch followed by a barrier for the reads of later frames, both buffers have
+        // to outlive the frame that submits it
         static void           CopyBuffer(RHI*         rhi,
                                          VkBuffer     srcBuffer,
                                          VkBuffer     dstBuffer,
                                          VkDeviceSize srcOffset,
                                          VkDeviceSize dstOffset,
                                          VkDeviceSize size);
-        static void           CreateImage(VkPhysicalDevice      physicalDevice,
-                                          VkDevice              device,
+        static VkImageCreateInfo GetImageCreateInfo(uint32_t           imageWidth,
+                                                    uint32_t           imageHeight,
+                                                    VkFormat           format,
+                                                    VkImageTiling      imageTiling,
+                                                    VkImageUsageFlags  imageUsageFlags,
+                                                    VkImageCreateFlags imageCreateFlags,
+                                                    uint32_t           arrayLayers,
+                                                    uint32_t           miplevels);
+        // color and depth attachments get a dedicated allocation
+        static void           CreateImage(VmaAllocator          allocator,
                                           uint32_t              imageWidth,
                                           uint32_t              imageHeight,
                                           VkFormat              format,
@@ -54,17 +67,17 @@ namespace Galaxy
                                           VkImageUsageFlags     imageUsageFlags,
                                           VkMemoryPropertyFlags memoryPropertyFlags,
                                           VkImage&              image,
-                                          VkDeviceMemory&       memory,
+                                          VmaAllocation&        allocation,
                                           VkImageCreateFlags    imageCreateFlags,
                                           uint32_t              arrayLayers,
                                           uint32_t              miplevels);
-        static VkImageView    CreateImageView(VkDevice           device,
-                                              VkImage&           image,
-                                              VkFormat           format,
-                                              VkImageAspectFlags imageAspectFlags,
-                                              VkImageViewType    viewType,
-                                              uint32_t           layoutCount,
-                                              uint32_t           miplevels);
+        static VkImageView    CreateImageView(const VulkanDeviceTable& device,
+                                              VkImage&                 image,
+                                              VkFormat                 format,
+                                              VkImageAspectFlags       imageAspectFlags,
+                                              VkImageViewType          viewType,
+                                              uint32_t                 layoutCount,
+                                              uint32_t                 miplevels);
         static void           CreateGlobalImage(RHI*               rhi,
                                                 VkImage&           image,
                                                 VkImageView&       imageView,
@@ -83,39 +96,45 @@ namespace Galaxy
                                             std::array<void*, 6> textureImagePixels,
                                             RHIFormat   textureImageFormat,
                                             uint32_t             miplevels);
-        static void           GenerateTextureMipMaps(RHI*     rhi,
-                                                     VkImage  image,
-                                                     VkFormat imageFormat,
-                                                     uint32_t textureWidth,
-                                                     uint32_t textureHeight,
-                                                     uint32_t layers,
-                                                     uint32_t miplevels);
+
+        // the helpers below only record into commandBuffer, submitting it is up to the caller
+        static void           GenerateTextureMipMaps(RHI*            rhi,
+                                                     VkCommandBuffer commandBuffer,
+                                                     VkImage         image,
+                                                     VkFormat        imageFormat,
+                                                     uint32_t        textureWidth,
+                                                     uint32_t        textureHeight,
+                                                     uint32_t        layers,
+                                                     uint32_t        miplevels);
         static void           TransitionImageLayout(RHI*               rhi,
+                                                    VkCommandBuffer    commandBuffer,
                                                     VkImage            image,
                                                     VkImageLayout      oldLayout,
                                                     VkImageLayout      newLayout,
                                                     uint32_t           layerCount,
                                                     uint32_t           miplevels,
                                                     VkImageAspectFlags aspectMaskBits);
-        static void           CopyBufferToImage(RHI*     rhi,
-                                                VkBuffer buffer,
-                                                VkImage  image,
-                                                uint32_t width,
-                                                uint32_t height,
-                                                uint32_t layerCount);
-        static void GenMipmappedImage(RHI* rhi, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels);
+        static void           CopyBufferToImage(RHI*            rhi,
+                                                VkCommandBuffer commandBuffer,
+                                                VkBuffer        buffer,
+                                                VkDeviceSize    bufferOffset,
+                                                VkImage         image,
+                                                uint32_t        width,
+                                                uint32_t        height,
+                                                uint32_t        layerCount);
+        static void           GenMipmappedImage(RHI*            rhi,
+                                                VkCommandBuffer commandBuffer,
+                                                VkImage         image,
+                                                uint32_t        width,
+                                                uint32_t        height,
+                                                uint32_t        mipLevels);
 
-        static VkSampler
-        GetOrCreateMipmapSampler(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t width, uint32_t height);
-        static void      DestroyMipmappedSampler(VkDevice device);
-        static VkSampler GetOrCreateNearestSampler(VkPhysicalDevice physicalDevice, VkDevice device);
-        static VkSampler GetOrCreateLinearSampler(VkPhysicalDevice physicalDevice, VkDevice device);
-        static void      DestroyNearestSampler(VkDevice device);
-        static void      DestroyLinearSampler(VkDevice device);
+        // bufferOffset of a buffer to image copy has to be a multiple of both the texel size and 4
+        static VkDeviceSize GetCopyOffsetAlignment(VkDeviceSize texelSize);
 
-    private:
-        static std::unordered_map<uint32_t, VkSampler> s_mipmap_sampler_map;
-        static VkSampler                               s_nearest_sampler;
-        static VkSampler                               s_linear_sampler;
+        // Descriptions of the samplers every renderer asks for, created once through the sampler cache. The mipmap
+        // sampler clamps maxLod to the last of mipLevels, so there is one per mip count.
+        static VkSamplerCreateInfo GetDefaultSamplerCreateInfo(RHIDefaultSamplerType type);
+        static VkSamplerCreateInfo GetMipmapSamplerCreateInfo(float maxAnisotropy, uint32_t mipLevels);
     };
 } // namespace Galaxy
\ No newline at end of file
@@ -7,7 +7,12 @@
 #pragma once
 
 #include "GalaxyEngine/Core/Base.h"
+#include "GalaxyEngine/Function/Renderer/PipelineLayoutCache.h"
+#include "GalaxyEngine/Function/Renderer/PipelineStateCache.h"
 #include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
+#include "GalaxyEngine/Function/Renderer/ShaderCompiler.h"
+#include "GalaxyEngine/Function/Renderer/ShaderHotReloader.h"
+#include "GalaxyEngine/Function/Renderer/ShaderVariantLibrary.h"
 
 namespace Galaxy
 {
@@ -21,9 +26,14 @@ namespace Galaxy
     class RenderSystem
     {
     public:
-        virtual void     Init(RenderSystemInitInfo) = 0;
-        virtual void     Release()                  = 0;
-        virtual Ref<RHI> GetRHI()                   = 0;
+        virtual void                      Init(RenderSystemInitInfo) = 0;
+        virtual void                      Release()                  = 0;
+        virtual Ref<RHI>                  GetRHI()                   = 0;
+        virtual Ref<PipelineStateCache>   GetPipelineStateCache()    = 0;
+        virtual Ref<PipelineLayoutCache>  GetPipelineLayoutCache()   = 0;
+        virtual Ref<ShaderCompiler>       GetShaderCompiler()        = 0;
+        virtual Ref<ShaderVariantLibrary> GetShaderVariantLibrary()  = 0;
+        virtual Ref<ShaderHotReloader>    GetShaderHotReloader()     = 0;
 
         virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
     };
@@ -1698,6 +1698,23 @@ namespace Galaxy
         Default_Sampler_Nearest
     };
 
+    enum RHIPipelineStatus
+    {
+        Pipeline_Status_Pending,
+        Pipeline_Status_Ready,
+        Pipeline_Status_Failed
+    };
+
+    enum RHIMemoryCategory
+    {
+        Memory_Category_Other,
+        Memory_Category_Texture,
+        Memory_Category_Mesh,
+        Memory_Category_RenderTarget,
+        Memory_Category_Staging,
+        Memory_Category_Count
+    };
+
     enum RHIDependencyFlagBits
     {
         RHI_DEPENDENCY_BY_REGION_BIT        = 0x00000001,
@@ -0,0 +1,102 @@
+//
+// ShaderCompiler.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/28 15:20.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Function/Renderer/RenderType.h"
+
+#include <filesystem>
+
+namespace Galaxy
+{
+    struct ShaderCompilerInitInfo
+    {
+        // compiled SPIR-V, one file per cache key
+        std::filesystem::path CacheDirectory;
+
+        // searched for #include <...>, and for #include "..." after the including file's own directory
+        std::vector<std::filesystem::path> IncludeDirectories;
+    };
+
+    struct ShaderDefine
+    {
+        std::string Name;
+        std::string Value;
+    };
+
+    struct ShaderCompileRequest
+    {
+        std::filesystem::path     SourcePath;
+        RHIShaderStageFlagBits    Stage = static_cast<RHIShaderStageFlagBits>(0); // 0 picks it from the extension
+        std::vector<ShaderDefine> Defines;
+        std::string               EntryPoint = "main";
+    };
+
+    struct ShaderCompileResult
+    {
+        bool                       Success   = false;
+        bool                       FromCache = false;
+        uint64_t                   Key       = 0;
+        std::vector<unsigned char> SpirV;
+        std::string                Log;
+
+        // the source file followed by everything it includes, directly or not
+        std::vector<std::filesystem::path> Dependencies;
+    };
+
+    struct ShaderCompileTask
+    {
+        Ref<JobCounter>     Counter;
+        ShaderCompileResult Result;
+
+        bool IsDone() const { return Counter->IsDone(); }
+    };
+
+    // Compiles GLSL to SPIR-V with glslang. Results are cached on disk under a key hashed from the source, every file
+    // it includes, the defines, stage, entry point and compiler version, so a cache hit is always up to date and an
+    // edited include invalidates every shader using it.
+    //
+    // Without GAL_ENABLE_RUNTIME_SHADER_COMPILER only the cache and the SPIR-V prebuilt by CMake next to the sources
+    // (spv/<name>.spv) are available.
+    //
+    // Compile and CompileAsync may be called from any thread.
+    class ShaderCompiler
+    {
+    public:
+        void Init(ShaderCompilerInitInfo initInfo);
+        void Shutdown();
+
+        ShaderCompileResult Compile(const ShaderCompileRequest& request) const;
+
+        // Runs Compile on the job system, wait on the task's counter before reading the result
+        Ref<ShaderCompileTask> CompileAsync(ShaderCompileRequest request) const;
+
+        // 0 when the source cannot be read
+        uint64_t ComputeKey(const ShaderCompileRequest& request) const;
+
+        static const char* GetCompilerVersion();
+
+    private:
+        struct SourceFile
+        {
+            std::filesystem::path Path;
+            std::vector<char>     Content;
+        };
+
+        bool     CollectSources(const std::filesystem::path& path, std::vector<SourceFile>& sources) const;
+        uint64_t HashSources(const ShaderCompileRequest&    request,
+                             RHIShaderStageFlagBits         stage,
+                             const std::vector<SourceFile>& sources) const;
+
+        bool LoadCachedSpirV(const std::filesystem::path& path, std::vector<unsigned char>& outSpirV) const;
+
+    private:
+        std::filesystem::path              m_CacheDirectory;
+        std::vector<std::filesystem::path> m_IncludeDirectories;
+    };
+} // namespace Galaxy
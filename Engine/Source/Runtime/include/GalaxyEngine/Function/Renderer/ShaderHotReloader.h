@@ -0,0 +1,105 @@
+//
+// ShaderHotReloader.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 14:18.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+#include "GalaxyEngine/Core/FileWatcher.h"
+#include "GalaxyEngine/Function/Renderer/PipelineLayoutCache.h"
+#include "GalaxyEngine/Function/Renderer/PipelineStateCache.h"
+#include "GalaxyEngine/Function/Renderer/ShaderVariantLibrary.h"
+
+#include <unordered_set>
+
+namespace Galaxy
+{
+    struct ShaderHotReloaderInitInfo
+    {
+        Ref<RHI>                  Rhi;
+        Ref<PipelineStateCache>   PipelineCache;
+        Ref<PipelineLayoutCache>  LayoutCache;
+        Ref<ShaderVariantLibrary> VariantLibrary;
+        Ref<FileWatcher>          Watcher; // null disables watching, pipelines are then built once
+    };
+
+    struct HotReloadStage
+    {
+        uint32_t         Shader;
+        ShaderVariantKey Key;
+    };
+
+    // Reflected from the stages on every build, so a reload that changes bindings or vertex inputs gets new layouts
+    struct HotReloadPipelineInputs
+    {
+        std::vector<const ShaderVariant*> Stages; // in the order they were added
+        ShaderPipelineLayout              Layout;
+
+        // the vertex shader's inputs tightly packed into vertex buffer binding 0
+        std::vector<RHIVertexInputAttributeDescription> VertexAttributes;
+        uint32_t                                        VertexStride = 0;
+    };
+
+    // Returns a pipeline acquired from the PipelineStateCache, preferably with AcquireAsync. The reloader releases it
+    // once it is replaced or removed.
+    using HotReloadPipelineBuilder = std::function<RHIPipeline(const HotReloadPipelineInputs& inputs)>;
+
+    // Rebuilds pipelines when a shader source or any file it includes is saved. The variant library recompiles the
+    // affected shaders on the job system, then only the pipelines using them are rebuilt, asynchronously as well.
+    // The previous pipeline stays bound until the new one is ready and is swapped at the next BeginFrame. The old one
+    // goes back to the PipelineStateCache, which destroys it once no frame in flight can use it anymore, so nothing
+    // ever waits for the device to idle.
+    //
+    // Not thread safe, call from the thread owning the RHI.
+    class ShaderHotReloader
+    {
+    public:
+        void Init(ShaderHotReloaderInitInfo initInfo);
+        void Shutdown();
+
+        // Builds the pipeline right away. Returns the id the other calls take, pipelines of shaders that failed to
+        // compile are built on their first successful reload.
+        uint32_t AddPipeline(std::vector<HotReloadStage> stages, HotReloadPipelineBuilder builder);
+        void     RemovePipeline(uint32_t pipelineId);
+
+        // The pipeline to bind this frame, pass it to PipelineStateCache::Resolve like any other async pipeline.
+        // Stays the previous version while a rebuild compiles.
+        RHIPipeline GetPipeline(uint32_t pipelineId) const;
+
+        // Call once per frame after FileWatcher::Poll, before recording. Starts the recompiles of changed shaders,
+        // rebuilds the pipelines of finished ones and swaps in the rebuilt pipelines that are ready.
+        void BeginFrame();
+
+        uint32_t GetReloadCount() const { return m_ReloadCount; }
+
+    private:
+        struct PipelineEntry
+        {
+            std::vector<HotReloadStage> Stages;
+            HotReloadPipelineBuilder    Builder;
+            RHIPipeline                 Current;
+            RHIPipeline                 Pending; // rebuilt, waiting for its compile to finish
+        };
+
+        RHIPipeline BuildPipeline(const PipelineEntry& entry);
+        void        WatchShaderDirectories();
+
+    private:
+        Ref<RHI>                  m_RHI;
+        Ref<PipelineStateCache>   m_PipelineCache;
+        Ref<PipelineLayoutCache>  m_LayoutCache;
+        Ref<ShaderVariantLibrary> m_VariantLibrary;
+        Ref<FileWatcher>          m_Watcher;
+
+        std::unordered_map<uint32_t, PipelineEntry> m_Pipelines;
+        uint32_t                                    m_NextPipelineId = 1;
+        uint32_t                                    m_ReloadCount    = 0;
+
+        std::unordered_set<std::string>    m_WatchedDirectories;
+        std::vector<FileWatchId>           m_WatchIds;
+        std::vector<std::filesystem::path> m_ChangedFiles; // filled by the watcher callbacks
+        bool                               m_DependenciesChanged = false;
+    };
+} // namespace Galaxy
@@ -0,0 +1,97 @@
+//
+// ShaderReflection.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/29 10:12.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Function/Renderer/RHI/RHIStruct.h"
+
+#include <string>
+#include <vector>
+
+namespace Galaxy
+{
+    struct ShaderResourceBinding
+    {
+        uint32_t            Set;
+        uint32_t            Binding;
+        RHIDescriptorType   DescriptorType;
+        uint32_t            DescriptorCount; // 0 for a runtime sized array
+        RHIShaderStageFlags StageFlags;
+        uint32_t            BlockSize; // uniform and storage buffers, size of the block without its runtime array
+        std::string         Name;
+    };
+
+    struct ShaderVertexInput
+    {
+        uint32_t    Location;
+        RHIFormat   Format;
+        uint32_t    Size;
+        std::string Name;
+    };
+
+    struct ShaderSpecializationConstant
+    {
+        uint32_t    ConstantId;
+        uint32_t    Size;
+        std::string Name;
+    };
+
+    // What a SPIR-V module expects to be bound: descriptors, push constants, specialization constants and, for vertex
+    // shaders, vertex inputs. Parsed straight from the binary, no external library involved.
+    //
+    // SPIR-V cannot tell a dynamic buffer from a plain one, change DescriptorType of those bindings before the
+    // layouts are built.
+    class ShaderReflection
+    {
+    public:
+        // Fails on anything that is not a valid SPIR-V module with a single entry point
+        bool Reflect(const std::vector<unsigned char>& spirV);
+
+        // Combines the stages of one pipeline. Bindings and identical push constant ranges used by several stages get
+        // their stage flags merged. Fails when two stages disagree on a binding.
+        bool Merge(const ShaderReflection& other);
+
+        // Adds what setCount copies of set need to poolSizes, entries of the same type are summed up. Pass the
+        // result of all sets a pool serves to RHIDescriptorPoolCreateInfo for an exactly sized pool.
+        void AccumulatePoolSizes(uint32_t set, uint32_t setCount, std::vector<RHIDescriptorPoolSize>& poolSizes) const;
+
+        // Vertex inputs tightly packed into a single buffer binding, in location order
+        uint32_t GetVertexAttributes(uint32_t                                         binding,
+                                     std::vector<RHIVertexInputAttributeDescription>& attributes) const;
+
+        // Number of descriptor sets the pipeline layout needs, highest set index plus one
+        uint32_t GetSetCount() const;
+
+        RHIShaderStageFlags GetStageFlags() const { return m_StageFlags; }
+        const std::string&  GetEntryPoint() const { return m_EntryPoint; }
+
+        // sorted by set, then binding
+        const std::vector<ShaderResourceBinding>& GetBindings() const { return m_Bindings; }
+        std::vector<ShaderResourceBinding>&       GetBindings() { return m_Bindings; }
+
+        const std::vector<RHIPushConstantRange>& GetPushConstantRanges() const { return m_PushConstantRanges; }
+        const std::vector<ShaderVertexInput>&    GetVertexInputs() const { return m_VertexInputs; }
+
+        const std::vector<ShaderSpecializationConstant>& GetSpecializationConstants() const
+        {
+            return m_SpecializationConstants;
+        }
+        const ShaderSpecializationConstant* FindSpecializationConstant(const std::string& name) const;
+
+        // compute shaders only
+        const uint32_t* GetLocalSize() const { return m_LocalSize; }
+
+    private:
+        RHIShaderStageFlags                m_StageFlags {0};
+        std::string                        m_EntryPoint;
+        std::vector<ShaderResourceBinding> m_Bindings;
+        std::vector<RHIPushConstantRange>  m_PushConstantRanges;
+        std::vector<ShaderVertexInput>     m_VertexInputs;
+        uint32_t                           m_LocalSize[3] {1, 1, 1};
+
+        std::vector<ShaderSpecializationConstant> m_SpecializationConstants;
+    };
+} // namespace Galaxy
@@ -0,0 +1,159 @@
+//
+// ShaderVariantLibrary.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/29 17:32.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/Base.h"
+#include "GalaxyEngine/Function/Renderer/RHI/RHI.h"
+#include "GalaxyEngine/Function/Renderer/ShaderCompiler.h"
+#include "GalaxyEngine/Function/Renderer/ShaderReflection.h"
+
+#include <unordered_map>
+
+namespace Galaxy
+{
+    // One bit per feature of a shader, in the order the features were registered
+    using ShaderVariantKey = uint64_t;
+
+    enum ShaderFeatureMode
+    {
+        // specialization constant when the shader declares one named after the feature, preprocessor otherwise
+        Shader_Feature_Mode_Auto,
+        // one SPIR-V module for both values, the feature is set per pipeline
+        Shader_Feature_Mode_Specialization,
+        // #define'd when enabled, each value compiles its own module
+        Shader_Feature_Mode_Preprocessor
+    };
+
+    struct ShaderFeature
+    {
+        std::string       Name;
+        ShaderFeatureMode Mode = Shader_Feature_Mode_Auto;
+    };
+
+    struct ShaderVariantLibraryInitInfo
+    {
+        Ref<RHI>            Rhi;
+        Ref<ShaderCompiler> Compiler;
+    };
+
+    struct ShaderVariantStats
+    {
+        uint64_t PossibleVariants   = 0; // every combination of every registered feature
+        uint32_t ReferencedVariants = 0; // combinations some material asked for
+        uint32_t BuiltVariants      = 0;
+        uint32_t CompiledModules    = 0; // less than BuiltVariants when specialization constants share a module
+        size_t   SpirVBytes         = 0;
+    };
+
+    // A ready to use shader stage. pSpecializationInfo points into the variant, which stays valid until it is pruned.
+    struct ShaderVariant
+    {
+        ShaderVariantKey                 Key;
+        RHIShader                        Module;
+        const ShaderReflection*          Reflection;
+        RHIPipelineShaderStageCreateInfo StageCreateInfo;
+
+        std::vector<RHISpecializationMapEntry>        MapEntries;
+        std::vector<const RHISpecializationMapEntry*> MapEntryPointers;
+        std::vector<uint32_t>                         SpecializationData;
+        RHISpecializationInfo                         SpecializationInfo;
+    };
+
+    // Manages the permutations of feature toggled shaders. Each feature is either compiled in through a #define or
+    // switched through a specialization constant, in which case all values share one SPIR-V module and only the
+    // pipelines differ. Nothing is compiled for a combination until a material references it, so the variants that
+    // exist are exactly the ones in use instead of every possible permutation.
+    //
+    // Not thread safe, call from the thread owning the RHI. Compiles themselves run on the job system.
+    class ShaderVariantLibrary
+    {
+    public:
+        void Init(ShaderVariantLibraryInitInfo initInfo);
+        void Shutdown();
+
+        // At most 64 features. Returns the id used by every other call.
+        uint32_t RegisterShader(const std::filesystem::path& sourcePath, std::vector<ShaderFeature> features);
+
+        // 0 when the shader has no such feature
+        ShaderVariantKey GetFeatureBit(uint32_t shader, const std::string& featureName) const;
+
+        // Materials declare the combinations they use. Each AddVariantReference needs a matching ReleaseVariant.
+        void AddVariantReference(uint32_t shader, ShaderVariantKey key);
+        void ReleaseVariant(uint32_t shader, ShaderVariantKey key);
+
+        // Builds every referenced variant that does not exist yet, the compiles run in parallel. Call after loading.
+        void BuildReferencedVariants();
+
+        // Builds the variant on the spot if needed. Null when compiling failed.
+        const ShaderVariant* GetVariant(uint32_t shader, ShaderVariantKey key);
+
+        // Destroys variants nobody references anymore, and modules no variant uses. Returns how many variants went.
+        // Pipelines created from them have to be gone already.
+        uint32_t PruneUnreferenced();
+
+        // Recompiles every module of the shaders built from filePath or including it, on the job system. Returns
+        // how many shaders are affected.
+        uint32_t ReloadDependents(const std::filesystem::path& filePath);
+
+        // Swaps in the modules of finished reloads and refills the variants in place, appending the shaders that
+        // changed to outReloadedShaders. The old modules are destroyed, rebuild the pipelines using these shaders.
+        // A reload that fails to compile keeps the old modules.
+        void Update(std::vector<uint32_t>& outReloadedShaders);
+
+        uint32_t GetShaderCount() const { return static_cast<uint32_t>(m_Shaders.size()); }
+
+        // The source file followed by everything it includes, empty until the shader was compiled once
+        const std::vector<std::filesystem::path>& GetDependencies(uint32_t shader) const
+        {
+            return m_Shaders[shader].Dependencies;
+        }
+
+        ShaderVariantStats GetStats() const;
+        void               LogStats() const;
+
+    private:
+        struct ModuleEntry
+        {
+            RHIShader        Module;
+            ShaderReflection Reflection;
+            size_t           SpirVSize    = 0;
+            uint32_t         VariantCount = 0;
+        };
+
+        struct ShaderEntry
+        {
+            std::filesystem::path      SourcePath;
+            std::vector<ShaderFeature> Features;
+            ShaderVariantKey           SpecializationMask = 0;
+            bool                       ModesResolved      = false;
+
+            std::unordered_map<ShaderVariantKey, uint32_t>             References;
+            std::unordered_map<ShaderVariantKey, Scope<ShaderVariant>> Variants;
+            // keyed by the preprocessor features only, a failed compile leaves an entry with a null module
+            std::unordered_map<ShaderVariantKey, ModuleEntry> Modules;
+
+            std::vector<std::filesystem::path>                               Dependencies;
+            std::vector<std::pair<ShaderVariantKey, Ref<ShaderCompileTask>>> PendingReloads;
+            bool                                                             ReloadAgain = false; // edited meanwhile
+        };
+
+        ShaderCompileRequest MakeRequest(const ShaderEntry& shader, ShaderVariantKey moduleKey) const;
+
+        bool           AddModule(ShaderEntry& shader, ShaderVariantKey moduleKey, const ShaderCompileResult& result);
+        void           ResolveFeatureModes(ShaderEntry& shader);
+        ShaderVariant* BuildVariant(ShaderEntry& shader, ShaderVariantKey key);
+        void           FillVariant(const ShaderEntry& shader, const ModuleEntry& module, ShaderVariant& variant) const;
+        void           StartReload(ShaderEntry& shader);
+        bool           SwapReloadedModules(ShaderEntry& shader);
+
+    private:
+        Ref<RHI>            m_RHI;
+        Ref<ShaderCompiler> m_Compiler;
+
+        std::vector<ShaderEntry> m_Shaders;
+    };
+} // namespace Galaxy
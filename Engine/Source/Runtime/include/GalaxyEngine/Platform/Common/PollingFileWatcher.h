@@ -0,0 +1,46 @@
+//
+// PollingFileWatcher.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 10:41.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/FileWatcher.h"
+#include "GalaxyEngine/Core/Time/Timer.h"
+
+#include <unordered_map>
+
+namespace Galaxy
+{
+    // Compares modification times twice a second, for platforms without a native watcher implementation yet
+    class PollingFileWatcher : public FileWatcher
+    {
+    public:
+        virtual void Init() override;
+        virtual void Shutdown() override;
+
+        virtual FileWatchId WatchDirectory(const std::filesystem::path& directory,
+                                           FileChangedCallback          callback) override;
+        virtual void        Unwatch(FileWatchId watchId) override;
+
+        virtual void Poll() override;
+
+    private:
+        using FileTimes = std::unordered_map<std::string, std::filesystem::file_time_type>;
+
+        struct Watch
+        {
+            std::filesystem::path Directory;
+            FileChangedCallback   Callback;
+            FileTimes             WriteTimes;
+        };
+
+        static void Scan(const std::filesystem::path& directory, FileTimes& outWriteTimes);
+
+        Timer       m_Timer;
+        FileWatchId m_NextWatchId {1};
+
+        std::unordered_map<FileWatchId, Watch> m_Watches;
+    };
+} // namespace Galaxy
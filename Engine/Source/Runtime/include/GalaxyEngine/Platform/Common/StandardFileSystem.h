@@ -14,5 +14,6 @@ namespace Galaxy
     {
     public:
         virtual std::vector<char> ReadFileAllText(const std::string& fileName) override;
+        virtual bool              WriteFileAtomically(const std::string& fileName, const std::vector<char>& data) override;
     };
 } // namespace Galaxy
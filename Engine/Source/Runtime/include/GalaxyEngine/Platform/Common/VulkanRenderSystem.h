@@ -14,13 +14,23 @@ namespace Galaxy
     class VulkanRenderSystem : public RenderSystem
     {
     public:
-        virtual void     Init(RenderSystemInitInfo initInfo) override;
-        virtual void     Release() override;
-        virtual Ref<RHI> GetRHI() override;
+        virtual void                      Init(RenderSystemInitInfo initInfo) override;
+        virtual void                      Release() override;
+        virtual Ref<RHI>                  GetRHI() override;
+        virtual Ref<PipelineStateCache>   GetPipelineStateCache() override;
+        virtual Ref<PipelineLayoutCache>  GetPipelineLayoutCache() override;
+        virtual Ref<ShaderCompiler>       GetShaderCompiler() override;
+        virtual Ref<ShaderVariantLibrary> GetShaderVariantLibrary() override;
+        virtual Ref<ShaderHotReloader>    GetShaderHotReloader() override;
 
         virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 
     private:
-        Ref<VulkanRHI> m_RHI;
+        Ref<VulkanRHI>            m_RHI;
+        Ref<PipelineStateCache>   m_PipelineStateCache;
+        Ref<PipelineLayoutCache>  m_PipelineLayoutCache;
+        Ref<ShaderCompiler>       m_ShaderCompiler;
+        Ref<ShaderVariantLibrary> m_ShaderVariantLibrary;
+        Ref<ShaderHotReloader>    m_ShaderHotReloader;
     };
 } // namespace Galaxy
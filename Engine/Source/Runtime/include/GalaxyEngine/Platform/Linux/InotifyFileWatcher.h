@@ -0,0 +1,41 @@
+//
+// InotifyFileWatcher.h
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 10:41.
+//
+
+#pragma once
+
+#include "GalaxyEngine/Core/FileWatcher.h"
+
+#include <unordered_map>
+
+namespace Galaxy
+{
+    // Directory watches through inotify, the kernel queues the events and Poll drains them without blocking
+    class InotifyFileWatcher : public FileWatcher
+    {
+    public:
+        virtual void Init() override;
+        virtual void Shutdown() override;
+
+        virtual FileWatchId WatchDirectory(const std::filesystem::path& directory,
+                                           FileChangedCallback          callback) override;
+        virtual void        Unwatch(FileWatchId watchId) override;
+
+        virtual void Poll() override;
+
+    private:
+        struct Watch
+        {
+            int                   Descriptor;
+            std::filesystem::path Directory;
+            FileChangedCallback   Callback;
+        };
+
+        int         m_InotifyFd {-1};
+        FileWatchId m_NextWatchId {1};
+
+        std::unordered_map<FileWatchId, Watch> m_Watches;
+    };
+} // namespace Galaxy
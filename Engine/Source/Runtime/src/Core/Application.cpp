@@ -6,6 +6,8 @@
 
 #include "GalaxyEngine/Core/Application.h"
 #include "GalaxyEngine/Core/FileSystem.h"
+#include "GalaxyEngine/Core/FileWatcher.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
 #include "GalaxyEngine/Core/Macro.h"
 #include "GalaxyEngine/Core/Time/Time.h"
 #include "GalaxyEngine/Core/WindowSystem.h"
@@ -19,7 +21,8 @@ namespace Galaxy
     Application::Application(const ApplicationSpecification& specification) : m_Specification(specification)
     {
         RuntimeGlobalContextInitInfo runtimeGlobalContextInitInfo = {};
-        runtimeGlobalContextInitInfo.AppName = specification.Name;
+        runtimeGlobalContextInitInfo.AppName        = specification.Name;
+        runtimeGlobalContextInitInfo.ExecutablePath = specification.CommandLineArgs.Args[0];
         g_RuntimeGlobalContext.StartSystems(runtimeGlobalContextInitInfo);
 
         GAL_CORE_ASSERT(!s_Instance, "[Application] Application already exists!");
@@ -27,9 +30,6 @@ namespace Galaxy
 
         GAL_CORE_INFO("[Application] Initializing...");
 
-        // Init Executable Directory
-        g_RuntimeGlobalContext.FileSys->InitExecutableDirectory(specification.CommandLineArgs.Args[0]);
-
         // Set working directory here
         if (!m_Specification.WorkingDirectory.empty())
         {
@@ -56,12 +56,14 @@ namespace Galaxy
                 break;
             }
 
+            g_RuntimeGlobalContext.FileWatcherSys->Poll();
+            g_RuntimeGlobalContext.RenderSys->GetShaderHotReloader()->BeginFrame();
+            // after the reloader so the pipelines it just replaced start aging out this frame
+            g_RuntimeGlobalContext.RenderSys->GetPipelineStateCache()->BeginFrame();
+
             if (!m_IsMinimized)
             {
-                for (auto layer : m_LayerStack)
-                {
-                    layer->OnUpdate(timeStep);
-                }
+                m_LayerStack.OnUpdate(timeStep, *g_RuntimeGlobalContext.JobSys);
             }
 
             g_RuntimeGlobalContext.WindowSys->OnRender();
@@ -80,6 +82,7 @@ namespace Galaxy
         EventDispatcher dispatcher(e);
         dispatcher.Dispatch<WindowCloseEvent>(GAL_BIND_EVENT_FN(Application::OnWindowClose));
         dispatcher.Dispatch<WindowResizeEvent>(GAL_BIND_EVENT_FN(Application::OnWindowResize));
+        dispatcher.Dispatch<KeyPressedEvent>(GAL_BIND_EVENT_FN(Application::OnKeyPressed));
 
         for (auto it = m_LayerStack.rbegin(); it != m_LayerStack.rend(); ++it)
         {
@@ -124,4 +127,17 @@ namespace Galaxy
 
         return false;
     }
+
+    bool Application::OnKeyPressed(KeyPressedEvent& e)
+    {
+        // GPU memory snapshot, open it with VMA's GpuMemDumpVis
+        if (e.GetKeyCode() == Key::F12 && !e.IsRepeat())
+        {
+            g_RuntimeGlobalContext.RenderSys->GetRHI()->DumpMemoryStats(
+                GAL_RELATIVE_PATH("Cache/GpuMemoryStats.json").string());
+            return true;
+        }
+
+        return false;
+    }
 } // namespace Galaxy
\ No newline at end of file
@@ -0,0 +1,389 @@
+//
+// JobSystem.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/24 10:12.
+//
+
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#if defined(GAL_PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(GAL_PLATFORM_LINUX) || defined(GAL_PLATFORM_DARWIN)
+#include <pthread.h>
+#endif
+
+namespace Galaxy
+{
+    static thread_local uint32_t s_ThreadIndex = 0;
+
+    JobSystem::~JobSystem() { Shutdown(); }
+
+    void JobSystem::Init(const JobSystemInitInfo& initInfo)
+    {
+        GAL_CORE_ASSERT(!m_Running, "[JobSystem] Already initialized!");
+
+        uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        uint32_t workerCount     = initInfo.WorkerCount;
+        if (workerCount == 0)
+        {
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+
+        // Queue 0 belongs to the main thread, queue i to worker i
+        m_Queues.clear();
+        for (uint32_t i = 0; i <= workerCount; ++i)
+        {
+            m_Queues.emplace_back(CreateScope<WorkQueue>());
+        }
+
+        s_ThreadIndex = 0;
+        m_Running     = true;
+
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 1; i <= workerCount; ++i)
+        {
+            std::string name   = initInfo.WorkerNamePrefix + std::to_string(i);
+            bool        pin    = initInfo.PinWorkers;
+            uint32_t    coreId = i % hardwareThreads;
+            m_Workers.emplace_back([this, i, name, pin, coreId]() {
+                SetCurrentThreadName(name);
+                if (pin && !PinCurrentThreadToCore(coreId))
+                {
+                    GAL_CORE_WARN("[JobSystem] Failed to pin {0} to core {1}", name, coreId);
+                }
+                WorkerLoop(i);
+            });
+        }
+
+        if (initInfo.PinWorkers)
+        {
+            PinCurrentThreadToCore(0);
+        }
+
+        GAL_CORE_INFO("[JobSystem] Started {0} worker threads ({1} hardware threads)", workerCount, hardwareThreads);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!m_Running)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_Running = false;
+        }
+        m_WakeCondition.notify_all();
+
+        for (auto& worker : m_Workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        m_Workers.clear();
+
+        // Anything still queued runs on the calling thread so counters are not left dangling
+        JobFunction job;
+        while (TryPop(0, job) || TrySteal(0, job))
+        {
+            job();
+        }
+        while (RunOneBackground())
+        {
+            // the job already ran, continuations it released ran inline with it
+        }
+        m_Queues.clear();
+    }
+
+    void JobSystem::Run(JobFunction job, const Ref<JobCounter>& counter)
+    {
+        if (counter)
+        {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Push([this, job = std::move(job), counter]() {
+            job();
+            Finish(counter);
+        });
+    }
+
+    void JobSystem::RunBackground(JobFunction job, const Ref<JobCounter>& counter)
+    {
+        if (counter)
+        {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        JobFunction wrapped = [this, job = std::move(job), counter]() {
+            job();
+            Finish(counter);
+        };
+
+        // Not started, shut down or no worker to hand it to: run inline
+        if (!m_Running || m_Workers.empty())
+        {
+            wrapped();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_BackgroundQueue.Mutex);
+            m_BackgroundQueue.Jobs.emplace_back(std::move(wrapped));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_QueuedJobs.fetch_add(1, std::memory_order_release);
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    void JobSystem::RunAfter(const Ref<JobCounter>& dependency, JobFunction job, const Ref<JobCounter>& counter)
+    {
+        if (!dependency)
+        {
+            Run(std::move(job), counter);
+            return;
+        }
+
+        if (counter)
+        {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        JobFunction wrapped = [this, job = std::move(job), counter]() {
+            job();
+            Finish(counter);
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(dependency->m_ContinuationMutex);
+            if (!dependency->IsDone())
+            {
+                dependency->m_Continuations.emplace_back(std::move(wrapped));
+                return;
+            }
+        }
+
+        Push(std::move(wrapped));
+    }
+
+    void JobSystem::Wait(const Ref<JobCounter>& counter)
+    {
+        if (!counter)
+        {
+            return;
+        }
+
+        // Background jobs are left to the workers, the main thread must not get stuck in one while it waits
+        uint32_t threadIndex = GetCurrentThreadIndex();
+        while (!counter->IsDone())
+        {
+            if (!RunOne(threadIndex) && (threadIndex == 0 || !RunOneBackground()))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::ParallelFor(uint32_t                                        count,
+                                uint32_t                                        batchSize,
+                                const std::function<void(uint32_t, uint32_t)>& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        batchSize = std::max(1u, batchSize);
+        if (count <= batchSize || m_Workers.empty())
+        {
+            func(0, count);
+            return;
+        }
+
+        auto counter = CreateRef<JobCounter>();
+        for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+        {
+            uint32_t end = std::min(begin + batchSize, count);
+            Run([&func, begin, end]() { func(begin, end); }, counter);
+        }
+
+        // The caller takes the first batch itself instead of idling
+        func(0, std::min(batchSize, count));
+
+        Wait(counter);
+    }
+
+    uint32_t JobSystem::GetCurrentThreadIndex() { return s_ThreadIndex; }
+
+    void JobSystem::SetCurrentThreadName(const std::string& name)
+    {
+#if defined(GAL_PLATFORM_WINDOWS)
+        std::wstring wideName(name.begin(), name.end());
+        SetThreadDescription(GetCurrentThread(), wideName.c_str());
+#elif defined(GAL_PLATFORM_LINUX)
+        // Linux limits thread names to 15 characters plus the terminator
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(GAL_PLATFORM_DARWIN)
+        pthread_setname_np(name.c_str());
+#endif
+    }
+
+    bool JobSystem::PinCurrentThreadToCore(uint32_t coreIndex)
+    {
+#if defined(GAL_PLATFORM_WINDOWS)
+        DWORD_PTR mask = static_cast<DWORD_PTR>(1) << coreIndex;
+        return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(GAL_PLATFORM_LINUX)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(coreIndex, &cpuSet);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+        // macOS does not expose hard affinity, leave scheduling to the OS
+        return false;
+#endif
+    }
+
+    void JobSystem::WorkerLoop(uint32_t threadIndex)
+    {
+        s_ThreadIndex = threadIndex;
+
+        while (m_Running)
+        {
+            if (RunOne(threadIndex) || RunOneBackground())
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_WakeMutex);
+            m_WakeCondition.wait(lock, [this]() { return !m_Running || m_QueuedJobs.load() > 0; });
+        }
+    }
+
+    void JobSystem::Push(JobFunction job)
+    {
+        // Not started (or single threaded after shutdown): run inline
+        if (!m_Running)
+        {
+            job();
+            return;
+        }
+
+        uint32_t   threadIndex = GetCurrentThreadIndex();
+        WorkQueue& queue       = *m_Queues[threadIndex < m_Queues.size() ? threadIndex : 0];
+        {
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            queue.Jobs.emplace_back(std::move(job));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_QueuedJobs.fetch_add(1, std::memory_order_release);
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    bool JobSystem::TryPop(uint32_t threadIndex, JobFunction& job)
+    {
+        WorkQueue&                  queue = *m_Queues[threadIndex];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (queue.Jobs.empty())
+        {
+            return false;
+        }
+
+        // Owner works LIFO for cache locality
+        job = std::move(queue.Jobs.back());
+        queue.Jobs.pop_back();
+        m_QueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool JobSystem::TrySteal(uint32_t thiefIndex, JobFunction& job)
+    {
+        size_t queueCount = m_Queues.size();
+        for (size_t offset = 1; offset < queueCount; ++offset)
+        {
+            WorkQueue&                  victim = *m_Queues[(thiefIndex + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(victim.Mutex);
+            if (victim.Jobs.empty())
+            {
+                continue;
+            }
+
+            // Thieves take the oldest job, which is usually the largest chunk of remaining work
+            job = std::move(victim.Jobs.front());
+            victim.Jobs.pop_front();
+            m_QueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+        return false;
+    }
+
+    bool JobSystem::RunOne(uint32_t threadIndex)
+    {
+        JobFunction job;
+        if (TryPop(threadIndex, job) || TrySteal(threadIndex, job))
+        {
+            job();
+            return true;
+        }
+        return false;
+    }
+
+    bool JobSystem::RunOneBackground()
+    {
+        JobFunction job;
+        {
+            std::lock_guard<std::mutex> lock(m_BackgroundQueue.Mutex);
+            if (m_BackgroundQueue.Jobs.empty())
+            {
+                return false;
+            }
+
+            // Oldest first, nobody is waiting on locality here
+            job = std::move(m_BackgroundQueue.Jobs.front());
+            m_BackgroundQueue.Jobs.pop_front();
+            m_QueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        job();
+        return true;
+    }
+
+    void JobSystem::Finish(const Ref<JobCounter>& counter)
+    {
+        if (!counter)
+        {
+            return;
+        }
+
+        std::vector<JobFunction> released;
+        {
+            std::lock_guard<std::mutex> lock(counter->m_ContinuationMutex);
+            if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+            released.swap(counter->m_Continuations);
+        }
+
+        for (auto& job : released)
+        {
+            Push(std::move(job));
+        }
+    }
+} // namespace Galaxy
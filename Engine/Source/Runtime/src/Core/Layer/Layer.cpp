@@ -9,4 +9,28 @@
 namespace Galaxy
 {
     Layer::Layer(const std::string& name) : m_DebugName(name) {}
+
+    bool Layer::ConflictsWith(const Layer& other) const
+    {
+        auto contains = [](const std::vector<std::string>& resources, const std::string& resource) {
+            return std::find(resources.begin(), resources.end(), resource) != resources.end();
+        };
+
+        // write-write and read-write hazards in either direction
+        for (const auto& resource : m_Writes)
+        {
+            if (contains(other.m_Writes, resource) || contains(other.m_Reads, resource))
+            {
+                return true;
+            }
+        }
+        for (const auto& resource : m_Reads)
+        {
+            if (contains(other.m_Writes, resource))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 } // namespace Galaxy
\ No newline at end of file
@@ -5,6 +5,7 @@
 //
 
 #include "GalaxyEngine/Core/Layer/LayerStack.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
 
 namespace Galaxy
 {
@@ -44,4 +45,91 @@ namespace Galaxy
             m_Layers.erase(it);
         }
     }
+
+    void LayerStack::OnUpdate(TimeStep ts, JobSystem& jobSystem)
+    {
+        BuildUpdateWaves();
+
+        size_t cursor = 0;
+        while (cursor < m_UpdateOrder.size())
+        {
+            uint32_t wave = m_UpdateWaves[m_UpdateOrder[cursor]];
+            size_t   last = cursor + 1;
+            while (last < m_UpdateOrder.size() && m_UpdateWaves[m_UpdateOrder[last]] == wave)
+            {
+                ++last;
+            }
+
+            Layer* first = m_Layers[m_UpdateOrder[cursor]].get();
+            if (last - cursor == 1)
+            {
+                first->OnUpdate(ts);
+            }
+            else
+            {
+                auto counter = CreateRef<JobCounter>();
+                for (size_t i = cursor + 1; i < last; ++i)
+                {
+                    Layer* layer = m_Layers[m_UpdateOrder[i]].get();
+                    jobSystem.Run([layer, ts]() { layer->OnUpdate(ts); }, counter);
+                }
+
+                // The first layer of the wave runs here instead of leaving the main thread idle
+                first->OnUpdate(ts);
+                jobSystem.Wait(counter);
+            }
+
+            cursor = last;
+        }
+    }
+
+    void LayerStack::BuildUpdateWaves()
+    {
+        uint32_t layerCount = static_cast<uint32_t>(m_Layers.size());
+        m_UpdateWaves.assign(layerCount, 0);
+
+        uint32_t waveCount   = 0;
+        uint32_t barrierWave = 0;
+        for (uint32_t i = 0; i < layerCount; ++i)
+        {
+            const Layer& layer = *m_Layers[i];
+
+            // Overlays are updated after every regular layer, whatever they declare
+            if (i == m_LayerInsertIndex)
+            {
+                barrierWave = waveCount;
+            }
+
+            uint32_t wave = barrierWave;
+            if (!layer.IsParallelUpdate())
+            {
+                wave        = waveCount;
+                barrierWave = wave + 1;
+            }
+            else
+            {
+                for (uint32_t j = 0; j < i; ++j)
+                {
+                    if (m_UpdateWaves[j] >= wave && layer.ConflictsWith(*m_Layers[j]))
+                    {
+                        wave = m_UpdateWaves[j] + 1;
+                    }
+                }
+            }
+
+            m_UpdateWaves[i] = wave;
+            waveCount        = std::max(waveCount, wave + 1);
+        }
+
+        m_UpdateOrder.resize(layerCount);
+        for (uint32_t i = 0; i < layerCount; ++i)
+        {
+            m_UpdateOrder[i] = i;
+        }
+
+        // Stable, so layers inside one wave keep their stack order
+        std::stable_sort(m_UpdateOrder.begin(), m_UpdateOrder.end(), [this](uint32_t lhs, uint32_t rhs) {
+            return m_UpdateWaves[lhs] < m_UpdateWaves[rhs];
+        });
+    }
 } // namespace Galaxy
\ No newline at end of file
@@ -0,0 +1,141 @@
+//
+// FrameAllocator.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/24 15:40.
+//
+
+#include "GalaxyEngine/Core/Memory/FrameAllocator.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+namespace Galaxy
+{
+    LinearArena::LinearArena(size_t blockSize) : m_BlockSize(blockSize) {}
+
+    void* LinearArena::Allocate(size_t size, size_t alignment)
+    {
+        GAL_CORE_ASSERT((alignment & (alignment - 1)) == 0, "[LinearArena] Alignment must be a power of two");
+
+        size = std::max<size_t>(size, 1);
+        while (true)
+        {
+            if (m_CurrentBlock >= m_Blocks.size())
+            {
+                AddBlock(size + alignment, m_Blocks.size());
+                m_Offset = 0;
+                continue;
+            }
+
+            Block&    block   = m_Blocks[m_CurrentBlock];
+            uintptr_t base    = reinterpret_cast<uintptr_t>(block.Memory.get());
+            uintptr_t aligned = (base + m_Offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            size_t    end     = static_cast<size_t>(aligned - base) + size;
+            if (end <= block.Size)
+            {
+                m_UsedBytes += end - m_Offset;
+                m_Offset = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            // Spill into the next block, reusing it when it is large enough
+            size_t next = m_CurrentBlock + 1;
+            if (next >= m_Blocks.size() || m_Blocks[next].Size < size + alignment)
+            {
+                AddBlock(size + alignment, next);
+            }
+            m_CurrentBlock = next;
+            m_Offset       = 0;
+        }
+    }
+
+    void LinearArena::ResetToMarker(const Marker& marker)
+    {
+        m_CurrentBlock = marker.Block;
+        m_Offset       = marker.Offset;
+        m_UsedBytes    = marker.Used;
+    }
+
+    void LinearArena::Reset()
+    {
+        if (m_Blocks.size() > 1)
+        {
+            size_t capacity = GetCapacity();
+            m_Blocks.clear();
+            AddBlock(capacity, 0);
+        }
+
+        m_CurrentBlock = 0;
+        m_Offset       = 0;
+        m_UsedBytes    = 0;
+    }
+
+    size_t LinearArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const auto& block : m_Blocks)
+        {
+            capacity += block.Size;
+        }
+        return capacity;
+    }
+
+    void LinearArena::AddBlock(size_t minSize, size_t index)
+    {
+        Block block;
+        block.Size   = std::max(m_BlockSize, minSize);
+        block.Memory = Scope<std::byte[]>(new std::byte[block.Size]);
+        m_Blocks.insert(m_Blocks.begin() + index, std::move(block));
+    }
+
+    void FrameAllocator::Init(const FrameAllocatorInitInfo& initInfo)
+    {
+        GAL_CORE_ASSERT(initInfo.FramesInFlight > 0 && initInfo.ThreadCount > 0);
+
+        m_Slots.clear();
+        m_Slots.resize(initInfo.FramesInFlight);
+        for (auto& slot : m_Slots)
+        {
+            for (uint32_t i = 0; i < initInfo.ThreadCount; ++i)
+            {
+                slot.emplace_back(CreateScope<LinearArena>(initInfo.BlockSize));
+            }
+        }
+        m_CurrentFrame = 0;
+        m_MainThreadId = std::this_thread::get_id();
+
+        GAL_CORE_INFO("[FrameAllocator] {0} frame slots x {1} thread arenas",
+                      initInfo.FramesInFlight,
+                      initInfo.ThreadCount);
+    }
+
+    void FrameAllocator::BeginFrame(uint32_t frameIndex)
+    {
+        GAL_CORE_ASSERT(frameIndex < m_Slots.size(), "[FrameAllocator] Frame index out of range");
+
+        for (auto& arena : m_Slots[frameIndex])
+        {
+            arena->Reset();
+        }
+        m_CurrentFrame.store(frameIndex, std::memory_order_release);
+    }
+
+    LinearArena& FrameAllocator::GetThreadArena()
+    {
+        auto&    slot        = m_Slots[m_CurrentFrame.load(std::memory_order_acquire)];
+        uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+        GAL_CORE_ASSERT(threadIndex < slot.size(), "[FrameAllocator] Thread is not known to the frame allocator");
+        GAL_CORE_ASSERT(threadIndex != 0 || std::this_thread::get_id() == m_MainThreadId,
+                        "[FrameAllocator] Only the main thread and job workers may allocate frame memory");
+        return *slot[threadIndex];
+    }
+
+    size_t FrameAllocator::GetUsedBytes(uint32_t frameIndex) const
+    {
+        size_t used = 0;
+        for (const auto& arena : m_Slots[frameIndex])
+        {
+            used += arena->GetUsedBytes();
+        }
+        return used;
+    }
+} // namespace Galaxy
@@ -0,0 +1,16 @@
+//
+// ScratchArray.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/25 09:30.
+//
+
+#include "GalaxyEngine/Core/Memory/ScratchArray.h"
+
+namespace Galaxy
+{
+    LinearArena& GetThreadScratchArena()
+    {
+        static thread_local LinearArena s_ScratchArena(64 * 1024);
+        return s_ScratchArena;
+    }
+} // namespace Galaxy
@@ -5,10 +5,15 @@
 //
 
 #include "GalaxyEngine/Function/Global/GlobalContext.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
 #include "GalaxyEngine/Core/LoggerSystem.h"
+#include "GalaxyEngine/Core/Memory/FrameAllocator.h"
 #include "GalaxyEngine/Platform/Common/GLFWWindowSystem.h"
+#include "GalaxyEngine/Platform/Common/PollingFileWatcher.h"
 #include "GalaxyEngine/Platform/Common/StandardFileSystem.h"
 #include "GalaxyEngine/Platform/Common/VulkanRenderSystem.h"
+#include "GalaxyEngine/Platform/Linux/InotifyFileWatcher.h"
+#include "GalaxyEngine/Platform/Platform.h"
 
 namespace Galaxy
 {
@@ -18,7 +23,30 @@ namespace Galaxy
     {
         LoggerSys = CreateRef<LoggerSystem>();
 
+        JobSys = CreateRef<JobSystem>();
+        JobSys->Init();
+
+        // One scratch slot per frame in flight, one arena per job system thread in each slot
+        FrameAllocSys = CreateRef<FrameAllocator>();
+        FrameAllocatorInitInfo frameAllocatorInitInfo = {};
+        frameAllocatorInitInfo.FramesInFlight = VulkanRHI::MaxFramesInFlight;
+        frameAllocatorInitInfo.ThreadCount    = JobSys->GetThreadCount();
+        FrameAllocSys->Init(frameAllocatorInitInfo);
+
+        // Resolve the executable directory before any system loads files relative to it
         FileSys = CreateRef<StandardFileSystem>();
+        if (initInfo.ExecutablePath != nullptr)
+        {
+            FileSys->InitExecutableDirectory(initInfo.ExecutablePath);
+        }
+
+        // Native change notifications where we have them, polling elsewhere
+#ifdef GAL_PLATFORM_LINUX
+        FileWatcherSys = CreateRef<InotifyFileWatcher>();
+#else
+        FileWatcherSys = CreateRef<PollingFileWatcher>();
+#endif
+        FileWatcherSys->Init();
 
         // Currently, we create GLFW window for Vulkan backend
         WindowSys = CreateRef<GLFWWindowSystem>();
@@ -37,11 +65,22 @@ namespace Galaxy
     {
         RenderSys->Release();
 
+        // Leftover jobs run inline here and may still use the file system or the frame arenas, both go after this.
+        // Jobs scheduled from now on run inline on the calling thread.
+        JobSys->Shutdown();
+
         WindowSys->Shutdown();
         WindowSys.reset();
 
+        FileWatcherSys->Shutdown();
+        FileWatcherSys.reset();
+
         FileSys.reset();
 
+        FrameAllocSys.reset();
+
+        JobSys.reset();
+
         LoggerSys.reset();
     }
 } // namespace Galaxy
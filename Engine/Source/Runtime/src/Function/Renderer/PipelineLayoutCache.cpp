@@ -0,0 +1,326 @@
+//
+// PipelineLayoutCache.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/29 14:05.
+//
+
+#include "GalaxyEngine/Function/Renderer/PipelineLayoutCache.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Core/Memory/ScratchArray.h"
+
+namespace Galaxy
+{
+    namespace
+    {
+        // keys hold every field that goes into the layout, two layouts are shared only when their keys are equal
+        template<typename... Ts>
+        void AppendKey(std::string& key, const Ts&... values)
+        {
+            (key.append(reinterpret_cast<const char*>(&values), sizeof(values)), ...);
+        }
+
+        RHIDescriptorSetLayoutBinding ToLayoutBinding(const ShaderResourceBinding& binding)
+        {
+            return {binding.Binding, binding.DescriptorType, binding.DescriptorCount, binding.StageFlags, nullptr};
+        }
+
+        // how one descriptor of the type is laid out in template data
+        bool GetPackedInfoLayout(RHIDescriptorType type, size_t& outSize, size_t& outAlignment)
+        {
+            switch (type)
+            {
+                case RHI_DESCRIPTOR_TYPE_SAMPLER:
+                case RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                case RHI_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                case RHI_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                    outSize      = sizeof(RHIDescriptorImageInfo);
+                    outAlignment = alignof(RHIDescriptorImageInfo);
+                    return true;
+                case RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                case RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                    outSize      = sizeof(RHIDescriptorBufferInfo);
+                    outAlignment = alignof(RHIDescriptorBufferInfo);
+                    return true;
+                case RHI_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                    outSize      = sizeof(RHIBufferView);
+                    outAlignment = alignof(RHIBufferView);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    } // namespace
+
+    void PipelineLayoutCache::Init(PipelineLayoutCacheInitInfo initInfo) { m_RHI = initInfo.Rhi; }
+
+    void PipelineLayoutCache::Shutdown()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto& [setLayout, updateTemplate] : m_UpdateTemplates)
+        {
+            m_RHI->DestroyDescriptorUpdateTemplate(updateTemplate);
+        }
+        for (auto& [key, pipelineLayout] : m_PipelineLayouts)
+        {
+            m_RHI->DestroyPipelineLayout(pipelineLayout);
+        }
+        for (auto& [key, setLayout] : m_SetLayouts)
+        {
+            m_RHI->DestroyDescriptorSetLayout(setLayout);
+        }
+        m_UpdateTemplates.clear();
+        m_PipelineLayouts.clear();
+        m_SetLayouts.clear();
+        m_RHI.reset();
+    }
+
+    bool PipelineLayoutCache::GetLayouts(const ShaderReflection& reflection, ShaderPipelineLayout& outLayout)
+    {
+        const std::vector<ShaderResourceBinding>& bindings = reflection.GetBindings();
+
+        outLayout.SetLayouts.resize(reflection.GetSetCount());
+        outLayout.UpdateTemplates.assign(reflection.GetSetCount(), nullptr);
+
+        size_t begin = 0;
+        for (uint32_t set = 0; set < outLayout.SetLayouts.size(); ++set)
+        {
+            size_t end           = begin;
+            bool   isBindlessSet = false;
+            while (end < bindings.size() && bindings[end].Set == set)
+            {
+                // runtime sized arrays are how shaders declare the bindless set, see Bindless.glsl
+                isBindlessSet |= bindings[end].DescriptorCount == 0;
+                end++;
+            }
+
+            if (isBindlessSet)
+            {
+                if (!m_RHI->IsBindlessSupported())
+                {
+                    GAL_CORE_ERROR("[PipelineLayoutCache] Set {0} is bindless, which the device does not support", set);
+                    return false;
+                }
+                outLayout.SetLayouts[set] = m_RHI->GetBindlessSetLayout();
+                begin                     = end;
+                continue;
+            }
+
+            ScratchArray<RHIDescriptorSetLayoutBinding, 16> setBindings(end - begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                setBindings[i - begin] = ToLayoutBinding(bindings[i]);
+            }
+            begin = end;
+
+            bool isNewLayout = false;
+            outLayout.SetLayouts[set] =
+                GetSetLayout(setBindings.data(), static_cast<uint32_t>(setBindings.size()), isNewLayout);
+            if (outLayout.SetLayouts[set] == nullptr)
+            {
+                return false;
+            }
+            if (setBindings.empty())
+            {
+                continue;
+            }
+
+            // every distinct set layout weighs in once on how the RHI sizes its descriptor pools
+            if (isNewLayout)
+            {
+                std::vector<RHIDescriptorPoolSize> poolSizes;
+                reflection.AccumulatePoolSizes(set, 1, poolSizes);
+                m_RHI->RegisterDescriptorSetSizes(poolSizes.data(), static_cast<uint32_t>(poolSizes.size()));
+            }
+            outLayout.UpdateTemplates[set] = GetUpdateTemplate(reflection, set);
+        }
+
+        const std::vector<RHIPushConstantRange>& pushConstantRanges = reflection.GetPushConstantRanges();
+        outLayout.PipelineLayout = GetPipelineLayout(outLayout.SetLayouts.data(),
+                                                     static_cast<uint32_t>(outLayout.SetLayouts.size()),
+                                                     pushConstantRanges.data(),
+                                                     static_cast<uint32_t>(pushConstantRanges.size()));
+        return outLayout.PipelineLayout != nullptr;
+    }
+
+    RHIDescriptorUpdateTemplate PipelineLayoutCache::GetUpdateTemplate(const ShaderReflection& reflection, uint32_t set)
+    {
+        std::vector<RHIDescriptorSetLayoutBinding>    setBindings;
+        std::vector<RHIDescriptorUpdateTemplateEntry> entries;
+
+        size_t offset = 0;
+        for (const ShaderResourceBinding& binding : reflection.GetBindings())
+        {
+            if (binding.Set != set)
+            {
+                continue;
+            }
+
+            size_t size      = 0;
+            size_t alignment = 1;
+            if (binding.DescriptorCount == 0 || !GetPackedInfoLayout(binding.DescriptorType, size, alignment))
+            {
+                GAL_CORE_ERROR("[PipelineLayoutCache] Binding {0} of set {1} cannot be written by a template",
+                               binding.Binding,
+                               set);
+                return nullptr;
+            }
+
+            offset = (offset + alignment - 1) / alignment * alignment;
+            entries.push_back({binding.Binding, 0, binding.DescriptorCount, binding.DescriptorType, offset, size});
+            offset += size * binding.DescriptorCount;
+
+            setBindings.push_back(ToLayoutBinding(binding));
+        }
+
+        if (setBindings.empty())
+        {
+            return nullptr;
+        }
+
+        RHIDescriptorSetLayout setLayout = GetSetLayout(setBindings.data(), static_cast<uint32_t>(setBindings.size()));
+        if (setLayout == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto iter = m_UpdateTemplates.find(setLayout);
+        if (iter != m_UpdateTemplates.end())
+        {
+            return iter->second;
+        }
+
+        RHIDescriptorUpdateTemplateCreateInfo createInfo {};
+        createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        createInfo.pDescriptorUpdateEntries   = entries.data();
+        createInfo.descriptorSetLayout        = setLayout;
+
+        RHIDescriptorUpdateTemplate updateTemplate;
+        if (!m_RHI->CreateDescriptorUpdateTemplate(&createInfo, updateTemplate))
+        {
+            GAL_CORE_ERROR("[PipelineLayoutCache] Failed to create descriptor update template");
+            return nullptr;
+        }
+
+        m_UpdateTemplates.emplace(setLayout, updateTemplate);
+        return updateTemplate;
+    }
+
+    RHIDescriptorSetLayout PipelineLayoutCache::GetSetLayout(const RHIDescriptorSetLayoutBinding* pBindings,
+                                                             uint32_t                             bindingCount)
+    {
+        bool isNewLayout;
+        return GetSetLayout(pBindings, bindingCount, isNewLayout);
+    }
+
+    RHIDescriptorSetLayout PipelineLayoutCache::GetSetLayout(const RHIDescriptorSetLayoutBinding* pBindings,
+                                                             uint32_t                             bindingCount,
+                                                             bool&                                outIsNew)
+    {
+        outIsNew = false;
+
+        std::string key;
+        AppendKey(key, bindingCount);
+        for (uint32_t i = 0; i < bindingCount; ++i)
+        {
+            const RHIDescriptorSetLayoutBinding& binding = pBindings[i];
+            AppendKey(key, binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags);
+            AppendKey(key, binding.pImmutableSamplers != nullptr);
+            for (uint32_t j = 0; binding.pImmutableSamplers != nullptr && j < binding.descriptorCount; ++j)
+            {
+                AppendKey(key, binding.pImmutableSamplers[j]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto iter = m_SetLayouts.find(key);
+        if (iter != m_SetLayouts.end())
+        {
+            return iter->second;
+        }
+
+        RHIDescriptorSetLayoutCreateInfo createInfo {};
+        createInfo.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        createInfo.bindingCount = bindingCount;
+        createInfo.pBindings    = pBindings;
+
+        RHIDescriptorSetLayout setLayout;
+        if (!m_RHI->CreateDescriptorSetLayout(&createInfo, setLayout))
+        {
+            GAL_CORE_ERROR("[PipelineLayoutCache] Failed to create descriptor set layout");
+            return nullptr;
+        }
+
+        m_SetLayouts.emplace(std::move(key), setLayout);
+        outIsNew = true;
+        return setLayout;
+    }
+
+    RHIPipelineLayout PipelineLayoutCache::GetPipelineLayout(const RHIDescriptorSetLayout* pSetLayouts,
+                                                             uint32_t                      setLayoutCount,
+                                                             const RHIPushConstantRange*   pPushConstantRanges,
+                                                             uint32_t                      pushConstantRangeCount)
+    {
+        std::string key;
+        AppendKey(key, setLayoutCount, pushConstantRangeCount);
+        for (uint32_t i = 0; i < setLayoutCount; ++i)
+        {
+            AppendKey(key, pSetLayouts[i]);
+        }
+        for (uint32_t i = 0; i < pushConstantRangeCount; ++i)
+        {
+            const RHIPushConstantRange& range = pPushConstantRanges[i];
+            AppendKey(key, range.stageFlags, range.offset, range.size);
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto iter = m_PipelineLayouts.find(key);
+        if (iter != m_PipelineLayouts.end())
+        {
+            return iter->second;
+        }
+
+        RHIPipelineLayoutCreateInfo createInfo {};
+        createInfo.sType                  = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        createInfo.setLayoutCount         = setLayoutCount;
+        createInfo.pSetLayouts            = pSetLayouts;
+        createInfo.pushConstantRangeCount = pushConstantRangeCount;
+        createInfo.pPushConstantRanges    = pPushConstantRanges;
+
+        RHIPipelineLayout pipelineLayout;
+        if (!m_RHI->CreatePipelineLayout(&createInfo, pipelineLayout))
+        {
+            GAL_CORE_ERROR("[PipelineLayoutCache] Failed to create pipeline layout");
+            return nullptr;
+        }
+
+        m_PipelineLayouts.emplace(std::move(key), pipelineLayout);
+        return pipelineLayout;
+    }
+
+    size_t PipelineLayoutCache::GetSetLayoutCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_SetLayouts.size();
+    }
+
+    size_t PipelineLayoutCache::GetPipelineLayoutCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_PipelineLayouts.size();
+    }
+
+    size_t PipelineLayoutCache::GetUpdateTemplateCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_UpdateTemplates.size();
+    }
+} // namespace Galaxy
@@ -0,0 +1,509 @@
+//
+// PipelineStateCache.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/27 14:36.
+//
+
+#include "GalaxyEngine/Function/Renderer/PipelineStateCache.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#include <string_view>
+#include <type_traits>
+
+namespace Galaxy
+{
+    // Descriptions are serialized field by field into a key string. Two descriptions share a pipeline only when their
+    // keys are equal, the hash just picks the bucket.
+    static void AppendKey(std::string& key, std::string_view text)
+    {
+        size_t size = text.size();
+        key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        key.append(text.data(), text.size());
+    }
+
+    template<typename T>
+    static void AppendKey(std::string& key, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be part of a pipeline key");
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T, typename... Ts>
+    static void AppendKey(std::string& key, const T& value, const Ts&... rest)
+    {
+        AppendKey(key, value);
+        (AppendKey(key, rest), ...);
+    }
+
+    static void AppendKeyBytes(std::string& key, const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        AppendKey(key, bytes != nullptr ? std::string_view(bytes, size) : std::string_view());
+    }
+
+    static void AppendShaderStage(std::string& key, const RHIPipelineShaderStageCreateInfo& stage)
+    {
+        AppendKey(key, stage.pNext, stage.flags, stage.stage, stage.module);
+        AppendKey(key, std::string_view(stage.pName != nullptr ? stage.pName : ""));
+
+        const RHISpecializationInfo* specializationInfo = stage.pSpecializationInfo;
+        AppendKey(key, specializationInfo != nullptr);
+        if (specializationInfo != nullptr)
+        {
+            AppendKey(key, specializationInfo->mapEntryCount);
+            for (uint32_t i = 0; i < specializationInfo->mapEntryCount; ++i)
+            {
+                const RHISpecializationMapEntry* mapEntry = specializationInfo->pMapEntries[i];
+                AppendKey(key, mapEntry->constantID, mapEntry->offset, mapEntry->size);
+            }
+            AppendKeyBytes(key, specializationInfo->pData, specializationInfo->dataSize);
+        }
+    }
+
+    static void AppendStencilOpState(std::string& key, const RHIStencilOpState& state)
+    {
+        AppendKey(key,
+                  state.failOp,
+                  state.passOp,
+                  state.depthFailOp,
+                  state.compareOp,
+                  state.compareMask,
+                  state.writeMask,
+                  state.reference);
+    }
+
+    static void AppendGraphicsStates(std::string& key, const RHIGraphicsPipelineCreateInfo& createInfo)
+    {
+        const auto* vertexInputState = createInfo.pVertexInputState;
+        AppendKey(key, vertexInputState != nullptr);
+        if (vertexInputState != nullptr)
+        {
+            AppendKey(key,
+                      vertexInputState->pNext,
+                      vertexInputState->flags,
+                      vertexInputState->vertexBindingDescriptionCount);
+            for (uint32_t i = 0; i < vertexInputState->vertexBindingDescriptionCount; ++i)
+            {
+                const auto& binding = vertexInputState->pVertexBindingDescriptions[i];
+                AppendKey(key, binding.binding, binding.stride, binding.inputRate);
+            }
+            AppendKey(key, vertexInputState->vertexAttributeDescriptionCount);
+            for (uint32_t i = 0; i < vertexInputState->vertexAttributeDescriptionCount; ++i)
+            {
+                const auto& attribute = vertexInputState->pVertexAttributeDescriptions[i];
+                AppendKey(key, attribute.location, attribute.binding, attribute.format, attribute.offset);
+            }
+        }
+
+        const auto* inputAssemblyState = createInfo.pInputAssemblyState;
+        AppendKey(key, inputAssemblyState != nullptr);
+        if (inputAssemblyState != nullptr)
+        {
+            AppendKey(key,
+                      inputAssemblyState->pNext,
+                      inputAssemblyState->flags,
+                      inputAssemblyState->topology,
+                      inputAssemblyState->primitiveRestartEnable);
+        }
+
+        const auto* tessellationState = createInfo.pTessellationState;
+        AppendKey(key, tessellationState != nullptr);
+        if (tessellationState != nullptr)
+        {
+            AppendKey(key,
+                      tessellationState->pNext,
+                      tessellationState->flags,
+                      tessellationState->patchControlPoints);
+        }
+
+        const auto* viewportState = createInfo.pViewportState;
+        AppendKey(key, viewportState != nullptr);
+        if (viewportState != nullptr)
+        {
+            AppendKey(key,
+                      viewportState->pNext,
+                      viewportState->flags,
+                      viewportState->viewportCount,
+                      viewportState->scissorCount);
+            for (uint32_t i = 0; viewportState->pViewports != nullptr && i < viewportState->viewportCount; ++i)
+            {
+                const auto& rhiViewport = viewportState->pViewports[i];
+                AppendKey(key,
+                          rhiViewport.x,
+                          rhiViewport.y,
+                          rhiViewport.width,
+                          rhiViewport.height,
+                          rhiViewport.minDepth,
+                          rhiViewport.maxDepth);
+            }
+            for (uint32_t i = 0; viewportState->pScissors != nullptr && i < viewportState->scissorCount; ++i)
+            {
+                const auto& scissor = viewportState->pScissors[i];
+                AppendKey(key, scissor.offset.x, scissor.offset.y, scissor.extent.width, scissor.extent.height);
+            }
+        }
+
+        const auto* rasterizationState = createInfo.pRasterizationState;
+        AppendKey(key, rasterizationState != nullptr);
+        if (rasterizationState != nullptr)
+        {
+            AppendKey(key,
+                      rasterizationState->pNext,
+                      rasterizationState->flags,
+                      rasterizationState->depthClampEnable,
+                      rasterizationState->rasterizerDiscardEnable,
+                      rasterizationState->polygonMode,
+                      rasterizationState->cullMode,
+                      rasterizationState->frontFace);
+            AppendKey(key,
+                      rasterizationState->depthBiasEnable,
+                      rasterizationState->depthBiasConstantFactor,
+                      rasterizationState->depthBiasClamp,
+                      rasterizationState->depthBiasSlopeFactor,
+                      rasterizationState->lineWidth);
+        }
+
+        const auto* multisampleState = createInfo.pMultisampleState;
+        AppendKey(key, multisampleState != nullptr);
+        if (multisampleState != nullptr)
+        {
+            AppendKey(key,
+                      multisampleState->pNext,
+                      multisampleState->flags,
+                      multisampleState->rasterizationSamples,
+                      multisampleState->sampleShadingEnable,
+                      multisampleState->minSampleShading,
+                      multisampleState->alphaToCoverageEnable,
+                      multisampleState->alphaToOneEnable);
+
+            // read the same way the backend passes it on, one pointed to word per 32 samples
+            AppendKey(key, multisampleState->pSampleMask != nullptr);
+            if (multisampleState->pSampleMask != nullptr)
+            {
+                for (uint32_t i = 0; i < (multisampleState->rasterizationSamples + 31) / 32; ++i)
+                {
+                    AppendKey(key, *multisampleState->pSampleMask[i]);
+                }
+            }
+        }
+
+        const auto* depthStencilState = createInfo.pDepthStencilState;
+        AppendKey(key, depthStencilState != nullptr);
+        if (depthStencilState != nullptr)
+        {
+            AppendKey(key,
+                      depthStencilState->pNext,
+                      depthStencilState->flags,
+                      depthStencilState->depthTestEnable,
+                      depthStencilState->depthWriteEnable,
+                      depthStencilState->depthCompareOp,
+                      depthStencilState->depthBoundsTestEnable,
+                      depthStencilState->stencilTestEnable,
+                      depthStencilState->minDepthBounds,
+                      depthStencilState->maxDepthBounds);
+            AppendStencilOpState(key, depthStencilState->front);
+            AppendStencilOpState(key, depthStencilState->back);
+        }
+
+        const auto* colorBlendState = createInfo.pColorBlendState;
+        AppendKey(key, colorBlendState != nullptr);
+        if (colorBlendState != nullptr)
+        {
+            AppendKey(key,
+                      colorBlendState->pNext,
+                      colorBlendState->flags,
+                      colorBlendState->logicOpEnable,
+                      colorBlendState->logicOp,
+                      colorBlendState->attachmentCount);
+            for (uint32_t i = 0; i < colorBlendState->attachmentCount; ++i)
+            {
+                const auto& attachment = colorBlendState->pAttachments[i];
+                AppendKey(key,
+                          attachment.blendEnable,
+                          attachment.srcColorBlendFactor,
+                          attachment.dstColorBlendFactor,
+                          attachment.colorBlendOp,
+                          attachment.srcAlphaBlendFactor,
+                          attachment.dstAlphaBlendFactor,
+                          attachment.alphaBlendOp,
+                          attachment.colorWriteMask);
+            }
+            AppendKey(key,
+                      colorBlendState->blendConstants[0],
+                      colorBlendState->blendConstants[1],
+                      colorBlendState->blendConstants[2],
+                      colorBlendState->blendConstants[3]);
+        }
+
+        const auto* dynamicState = createInfo.pDynamicState;
+        AppendKey(key, dynamicState != nullptr);
+        if (dynamicState != nullptr)
+        {
+            AppendKey(key, dynamicState->pNext, dynamicState->flags, dynamicState->dynamicStateCount);
+            for (uint32_t i = 0; i < dynamicState->dynamicStateCount; ++i)
+            {
+                AppendKey(key, dynamicState->pDynamicStates[i]);
+            }
+        }
+    }
+
+    std::string PipelineStateCache::MakeKey(const RHIGraphicsPipelineCreateInfo& createInfo)
+    {
+        std::string key;
+        key.reserve(512);
+        AppendKey(key, RHI_PIPELINE_BIND_POINT_GRAPHICS, createInfo.pNext, createInfo.flags, createInfo.stageCount);
+        for (uint32_t i = 0; i < createInfo.stageCount; ++i)
+        {
+            AppendShaderStage(key, createInfo.pStages[i]);
+        }
+
+        AppendGraphicsStates(key, createInfo);
+
+        AppendKey(key,
+                  createInfo.layout,
+                  createInfo.renderPass,
+                  createInfo.subpass,
+                  createInfo.basePipelineHandle,
+                  createInfo.basePipelineIndex);
+        return key;
+    }
+
+    std::string PipelineStateCache::MakeKey(const RHIComputePipelineCreateInfo& createInfo)
+    {
+        std::string key;
+        AppendKey(key, RHI_PIPELINE_BIND_POINT_COMPUTE, createInfo.pNext, createInfo.flags);
+        AppendShaderStage(key, *createInfo.pStages);
+        AppendKey(key, createInfo.layout, createInfo.basePipelineHandle, createInfo.basePipelineIndex);
+        return key;
+    }
+
+    size_t PipelineStateCache::Hash(const RHIGraphicsPipelineCreateInfo& createInfo)
+    {
+        return std::hash<std::string> {}(MakeKey(createInfo));
+    }
+
+    size_t PipelineStateCache::Hash(const RHIComputePipelineCreateInfo& createInfo)
+    {
+        return std::hash<std::string> {}(MakeKey(createInfo));
+    }
+
+    void PipelineStateCache::Init(PipelineStateCacheInitInfo initInfo)
+    {
+        m_RHI              = initInfo.Rhi;
+        m_MaxIdlePipelines = initInfo.MaxIdlePipelines;
+        m_FrameNumber      = 0;
+        m_RenderThreadId   = std::this_thread::get_id();
+    }
+
+    void PipelineStateCache::Shutdown()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        GAL_CORE_ASSERT(m_Requests.empty(), "[PipelineStateCache] Pipelines were still requested on shutdown");
+
+        size_t referencedCount = m_Entries.size() - m_IdleKeys.size();
+        if (referencedCount > 0)
+        {
+            GAL_CORE_WARN("[PipelineStateCache] {0} pipelines are still referenced on shutdown", referencedCount);
+        }
+
+        for (auto& [key, entry] : m_Entries)
+        {
+            m_RHI->DestroyPipeline(entry.Pipeline);
+        }
+        m_Entries.clear();
+        m_PipelineKeys.clear();
+        m_IdleKeys.clear();
+        m_RHI.reset();
+    }
+
+    bool PipelineStateCache::IsRenderThread() const { return std::this_thread::get_id() == m_RenderThreadId; }
+
+    RHIPipeline PipelineStateCache::RunOnRenderThread(const std::function<RHIPipeline()>& request)
+    {
+        if (IsRenderThread())
+        {
+            return request();
+        }
+
+        // RHI handles are only created and destroyed on the render thread, it serves the request in BeginFrame
+        PendingRequest pendingRequest {request, {}};
+        std::future<RHIPipeline> result = pendingRequest.Result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Requests.push_back(&pendingRequest);
+        }
+        return result.get();
+    }
+
+    template<typename CreateFunction>
+    RHIPipeline PipelineStateCache::AcquireOrCreate(std::string&& key, CreateFunction&& create)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Entries.find(key);
+            if (it != m_Entries.end())
+            {
+                AddReference(it->second);
+                return it->second.Pipeline;
+            }
+        }
+
+        // Release may run concurrently on other threads, the lock is only needed around the maps
+        GAL_CORE_ASSERT(IsRenderThread(), "[PipelineStateCache] Pipelines are created on the render thread only");
+        RHIPipeline pipeline;
+        if (!create(&pipeline))
+        {
+            GAL_CORE_ERROR("[PipelineStateCache] Failed to create pipeline {0:x}", std::hash<std::string> {}(key));
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto [it, inserted] = m_Entries.try_emplace(std::move(key));
+        it->second.Pipeline      = pipeline;
+        it->second.RefCount      = 1;
+        m_PipelineKeys[pipeline] = &it->first;
+        return pipeline;
+    }
+
+    RHIPipeline PipelineStateCache::Acquire(const RHIGraphicsPipelineCreateInfo& createInfo)
+    {
+        return RunOnRenderThread([this, &createInfo]() {
+            RHIPipeline pipeline = AcquireOrCreate(MakeKey(createInfo), [this, &createInfo](RHIPipeline* pPipeline) {
+                return m_RHI->CreateGraphicsPipelines(nullptr, 1, &createInfo, pPipeline);
+            });
+            return WaitUntilReady(pipeline);
+        });
+    }
+
+    RHIPipeline PipelineStateCache::Acquire(const RHIComputePipelineCreateInfo& createInfo)
+    {
+        return RunOnRenderThread([this, &createInfo]() {
+            RHIPipeline pipeline = AcquireOrCreate(MakeKey(createInfo), [this, &createInfo](RHIPipeline* pPipeline) {
+                return m_RHI->CreateComputePipelines(nullptr, 1, &createInfo, pPipeline);
+            });
+            return WaitUntilReady(pipeline);
+        });
+    }
+
+    RHIPipeline PipelineStateCache::AcquireAsync(const RHIGraphicsPipelineCreateInfo& createInfo)
+    {
+        return RunOnRenderThread([this, &createInfo]() {
+            return AcquireOrCreate(MakeKey(createInfo), [this, &createInfo](RHIPipeline* pPipeline) {
+                m_RHI->CreateGraphicsPipelinesAsync(1, &createInfo, pPipeline);
+                return true;
+            });
+        });
+    }
+
+    RHIPipeline PipelineStateCache::AcquireAsync(const RHIComputePipelineCreateInfo& createInfo)
+    {
+        return RunOnRenderThread([this, &createInfo]() {
+            return AcquireOrCreate(MakeKey(createInfo), [this, &createInfo](RHIPipeline* pPipeline) {
+                m_RHI->CreateComputePipelinesAsync(1, &createInfo, pPipeline);
+                return true;
+            });
+        });
+    }
+
+    RHIPipeline PipelineStateCache::Resolve(RHIPipeline pipeline, RHIPipeline fallback) const
+    {
+        if (pipeline == nullptr || m_RHI->GetPipelineStatus(pipeline) != Pipeline_Status_Ready)
+        {
+            return fallback;
+        }
+        return pipeline;
+    }
+
+    RHIPipeline PipelineStateCache::WaitUntilReady(RHIPipeline pipeline)
+    {
+        if (pipeline == nullptr || m_RHI->WaitForPipeline(pipeline))
+        {
+            return pipeline;
+        }
+
+        // the entry came from an AcquireAsync whose compile failed, it is cached like any other until evicted
+        GAL_CORE_ERROR("[PipelineStateCache] Requested pipeline failed to compile asynchronously");
+        Release(pipeline);
+        return nullptr;
+    }
+
+    void PipelineStateCache::AddReference(Entry& entry)
+    {
+        if (entry.RefCount == 0)
+        {
+            m_IdleKeys.erase(entry.IdleIterator);
+        }
+        entry.RefCount++;
+    }
+
+    void PipelineStateCache::Release(RHIPipeline pipeline)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto keyIt = m_PipelineKeys.find(pipeline);
+        if (keyIt == m_PipelineKeys.end())
+        {
+            GAL_CORE_WARN("[PipelineStateCache] Released a pipeline that does not belong to the cache");
+            return;
+        }
+
+        Entry& entry = m_Entries.at(*keyIt->second);
+        GAL_CORE_ASSERT(entry.RefCount > 0, "[PipelineStateCache] Pipeline released more often than acquired");
+        if (--entry.RefCount == 0)
+        {
+            entry.ReleasedFrame = m_FrameNumber;
+            entry.IdleIterator  = m_IdleKeys.insert(m_IdleKeys.end(), keyIt->second);
+        }
+    }
+
+    void PipelineStateCache::BeginFrame()
+    {
+        GAL_CORE_ASSERT(IsRenderThread(), "[PipelineStateCache] BeginFrame is called by the render thread");
+
+        std::vector<PendingRequest*> requests;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            requests.swap(m_Requests);
+        }
+        for (PendingRequest* request : requests)
+        {
+            request->Result.set_value(request->Request());
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_FrameNumber++;
+
+        // a pipeline released during frame N may be referenced by command buffers until frame N + frames in flight
+        uint64_t framesInFlight = m_RHI->GetMaxFramesInFlight();
+        while (m_IdleKeys.size() > m_MaxIdlePipelines)
+        {
+            auto   entryIt = m_Entries.find(*m_IdleKeys.front());
+            Entry& entry   = entryIt->second;
+            if (entry.ReleasedFrame + framesInFlight > m_FrameNumber)
+            {
+                break;
+            }
+
+            m_RHI->DestroyPipeline(entry.Pipeline);
+            m_PipelineKeys.erase(entry.Pipeline);
+            m_IdleKeys.pop_front();
+            m_Entries.erase(entryIt);
+        }
+    }
+
+    size_t PipelineStateCache::GetPipelineCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Entries.size();
+    }
+
+    size_t PipelineStateCache::GetIdlePipelineCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_IdleKeys.size();
+    }
+} // namespace Galaxy
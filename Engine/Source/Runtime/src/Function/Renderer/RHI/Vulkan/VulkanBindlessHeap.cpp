@@ -0,0 +1,266 @@
+//
+// VulkanBindlessHeap.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/31 10:26.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanBindlessHeap.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+namespace Galaxy
+{
+    namespace
+    {
+        constexpr uint32_t s_TextureBinding = 0;
+        constexpr uint32_t s_BufferBinding  = 1;
+    } // namespace
+
+    bool VulkanBindlessHeap::Initialize(const VulkanDeviceTable& device,
+                                        uint32_t                 textureCapacity,
+                                        uint32_t                 bufferCapacity,
+                                        uint32_t                 framesInFlight)
+    {
+        m_Device = &device;
+        m_Textures.Initialize(textureCapacity, framesInFlight);
+        m_Buffers.Initialize(bufferCapacity, framesInFlight);
+
+        VkDescriptorSetLayoutBinding bindings[2] {};
+        bindings[0].binding         = s_TextureBinding;
+        bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount = textureCapacity;
+        bindings[0].stageFlags      = VK_SHADER_STAGE_ALL;
+        bindings[1].binding         = s_BufferBinding;
+        bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount = bufferCapacity;
+        bindings[1].stageFlags      = VK_SHADER_STAGE_ALL;
+
+        // slots never written are fine as long as no shader reads them, and writing a slot no command buffer
+        // uses does not have to wait for the frames in flight
+        VkDescriptorBindingFlags bindingFlags[2];
+        bindingFlags[0] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        bindingFlags[1] = bindingFlags[0];
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo {};
+        bindingFlagsCreateInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsCreateInfo.bindingCount  = 2;
+        bindingFlagsCreateInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutCreateInfo {};
+        layoutCreateInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.pNext        = &bindingFlagsCreateInfo;
+        layoutCreateInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutCreateInfo.bindingCount = 2;
+        layoutCreateInfo.pBindings    = bindings;
+
+        if (m_Device->vkCreateDescriptorSetLayout(m_Device->Device, &layoutCreateInfo, nullptr, &m_SetLayout) !=
+            VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanBindlessHeap] Failed to create the bindless set layout");
+            return false;
+        }
+
+        VkDescriptorPoolSize poolSizes[2];
+        poolSizes[0] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureCapacity};
+        poolSizes[1] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bufferCapacity};
+
+        VkDescriptorPoolCreateInfo poolCreateInfo {};
+        poolCreateInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolCreateInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolCreateInfo.maxSets       = 1;
+        poolCreateInfo.poolSizeCount = 2;
+        poolCreateInfo.pPoolSizes    = poolSizes;
+
+        if (m_Device->vkCreateDescriptorPool(m_Device->Device, &poolCreateInfo, nullptr, &m_Pool) != VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanBindlessHeap] Failed to create the bindless descriptor pool");
+            Destroy();
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo allocateInfo {};
+        allocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool     = m_Pool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts        = &m_SetLayout;
+
+        if (m_Device->vkAllocateDescriptorSets(m_Device->Device, &allocateInfo, &m_Set) != VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanBindlessHeap] Failed to allocate the bindless descriptor set");
+            Destroy();
+            return false;
+        }
+
+        GAL_CORE_INFO("[VulkanBindlessHeap] Created with room for {0} textures and {1} buffers",
+                      textureCapacity,
+                      bufferCapacity);
+        return true;
+    }
+
+    void VulkanBindlessHeap::Destroy()
+    {
+        if (m_Device == nullptr)
+        {
+            return;
+        }
+
+        // the set goes with its pool
+        if (m_Pool != VK_NULL_HANDLE)
+        {
+            m_Device->vkDestroyDescriptorPool(m_Device->Device, m_Pool, nullptr);
+        }
+        if (m_SetLayout != VK_NULL_HANDLE)
+        {
+            m_Device->vkDestroyDescriptorSetLayout(m_Device->Device, m_SetLayout, nullptr);
+        }
+        m_TextureInfos.clear();
+        m_BufferInfos.clear();
+        m_Pool      = VK_NULL_HANDLE;
+        m_SetLayout = VK_NULL_HANDLE;
+        m_Set       = VK_NULL_HANDLE;
+        m_Device    = nullptr;
+    }
+
+    uint32_t VulkanBindlessHeap::AddTexture(VkImageView imageView, VkSampler sampler)
+    {
+        uint32_t index = m_Textures.Allocate();
+        if (index == InvalidIndex)
+        {
+            GAL_CORE_ERROR("[VulkanBindlessHeap] Out of texture slots");
+            return InvalidIndex;
+        }
+
+        VkDescriptorImageInfo imageInfo {};
+        imageInfo.sampler     = sampler;
+        imageInfo.imageView   = imageView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        if (index >= m_TextureInfos.size())
+        {
+            m_TextureInfos.resize(index + 1);
+        }
+        m_TextureInfos[index] = imageInfo;
+
+        VkWriteDescriptorSet write {};
+        write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet          = m_Set;
+        write.dstBinding      = s_TextureBinding;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo      = &imageInfo;
+        m_Device->vkUpdateDescriptorSets(m_Device->Device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32_t VulkanBindlessHeap::AddBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    {
+        uint32_t index = m_Buffers.Allocate();
+        if (index == InvalidIndex)
+        {
+            GAL_CORE_ERROR("[VulkanBindlessHeap] Out of buffer slots");
+            return InvalidIndex;
+        }
+
+        VkDescriptorBufferInfo bufferInfo {};
+        bufferInfo.buffer = buffer;
+        bufferInfo.offset = offset;
+        bufferInfo.range  = range;
+
+        if (index >= m_BufferInfos.size())
+        {
+            m_BufferInfos.resize(index + 1);
+        }
+        m_BufferInfos[index] = bufferInfo;
+
+        VkWriteDescriptorSet write {};
+        write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet          = m_Set;
+        write.dstBinding      = s_BufferBinding;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo     = &bufferInfo;
+        m_Device->vkUpdateDescriptorSets(m_Device->Device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void VulkanBindlessHeap::RemoveTexture(uint32_t index, uint32_t frameIndex)
+    {
+        m_Textures.Retire(index, frameIndex);
+    }
+
+    void VulkanBindlessHeap::RemoveBuffer(uint32_t index, uint32_t frameIndex) { m_Buffers.Retire(index, frameIndex); }
+
+    bool VulkanBindlessHeap::References(VkImageView imageView) const
+    {
+        for (const VkDescriptorImageInfo& imageInfo : m_TextureInfos)
+        {
+            if (imageInfo.imageView == imageView)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool VulkanBindlessHeap::References(VkBuffer buffer) const
+    {
+        for (const VkDescriptorBufferInfo& bufferInfo : m_BufferInfos)
+        {
+            if (bufferInfo.buffer == buffer)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void VulkanBindlessHeap::BeginFrame(uint32_t frameIndex)
+    {
+        m_Textures.Recycle(frameIndex);
+        m_Buffers.Recycle(frameIndex);
+    }
+
+    void VulkanBindlessHeap::IndexAllocator::Initialize(uint32_t capacity, uint32_t framesInFlight)
+    {
+        m_Capacity  = capacity;
+        m_NextIndex = 0;
+        m_FreeIndices.clear();
+        m_RetiredIndices.assign(framesInFlight, {});
+    }
+
+    uint32_t VulkanBindlessHeap::IndexAllocator::Allocate()
+    {
+        if (!m_FreeIndices.empty())
+        {
+            uint32_t index = m_FreeIndices.back();
+            m_FreeIndices.pop_back();
+            return index;
+        }
+        return m_NextIndex < m_Capacity ? m_NextIndex++ : InvalidIndex;
+    }
+
+    void VulkanBindlessHeap::IndexAllocator::Retire(uint32_t index, uint32_t frameIndex)
+    {
+        GAL_CORE_ASSERT(index < m_NextIndex, "[VulkanBindlessHeap] Removing an index that was never added");
+        m_RetiredIndices[frameIndex].push_back(index);
+    }
+
+    void VulkanBindlessHeap::IndexAllocator::Recycle(uint32_t frameIndex)
+    {
+        std::vector<uint32_t>& retiredIndices = m_RetiredIndices[frameIndex];
+        m_FreeIndices.insert(m_FreeIndices.end(), retiredIndices.begin(), retiredIndices.end());
+        retiredIndices.clear();
+    }
+
+    uint32_t VulkanBindlessHeap::IndexAllocator::GetUsedCount() const
+    {
+        size_t retiredCount = 0;
+        for (const std::vector<uint32_t>& retiredIndices : m_RetiredIndices)
+        {
+            retiredCount += retiredIndices.size();
+        }
+        return m_NextIndex - static_cast<uint32_t>(m_FreeIndices.size() + retiredCount);
+    }
+} // namespace Galaxy
@@ -0,0 +1,41 @@
+//
+// VulkanCommandEncoder.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 14:20.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanCommandEncoder.h"
+
+namespace Galaxy
+{
+    void VulkanCommandEncoder::CmdBeginRenderPassPfn(const RHIRenderPassBeginInfo* pRenderPassBegin,
+                                                     RHISubpassContents            contents)
+    {
+        uint32_t                      clearValueCount = pRenderPassBegin->clearValueCount;
+        ScratchArray<VkClearValue, 8> vkClearValues(clearValueCount);
+        for (uint32_t i = 0; i < clearValueCount; ++i)
+        {
+            // RHIClearValue and VkClearValue are the same union, copying the widest member copies all of them
+            const auto& rhiClearValue = pRenderPassBegin->pClearValues[i];
+            for (int component = 0; component < 4; ++component)
+            {
+                vkClearValues[i].color.uint32[component] = rhiClearValue.color.uint32[component];
+            }
+        }
+
+        VkRenderPassBeginInfo vkRenderPassBeginInfo {};
+        vkRenderPassBeginInfo.sType                    = static_cast<VkStructureType>(pRenderPassBegin->sType);
+        vkRenderPassBeginInfo.pNext                    = pRenderPassBegin->pNext;
+        vkRenderPassBeginInfo.renderPass               = m_RHI->Resources.Get(pRenderPassBegin->renderPass);
+        vkRenderPassBeginInfo.framebuffer              = m_RHI->Resources.Get(pRenderPassBegin->framebuffer);
+        vkRenderPassBeginInfo.renderArea.offset.x      = pRenderPassBegin->renderArea.offset.x;
+        vkRenderPassBeginInfo.renderArea.offset.y      = pRenderPassBegin->renderArea.offset.y;
+        vkRenderPassBeginInfo.renderArea.extent.width  = pRenderPassBegin->renderArea.extent.width;
+        vkRenderPassBeginInfo.renderArea.extent.height = pRenderPassBegin->renderArea.extent.height;
+        vkRenderPassBeginInfo.clearValueCount          = clearValueCount;
+        vkRenderPassBeginInfo.pClearValues             = vkClearValues.data();
+
+        m_RHI->DeviceTable.vkCmdBeginRenderPass(
+            m_CommandBuffer, &vkRenderPassBeginInfo, static_cast<VkSubpassContents>(contents));
+    }
+} // namespace Galaxy
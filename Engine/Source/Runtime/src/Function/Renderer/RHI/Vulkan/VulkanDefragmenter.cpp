@@ -0,0 +1,577 @@
+//
+// VulkanDefragmenter.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/11/03 15:10.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDefragmenter.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Core/Memory/ScratchArray.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanBindlessHeap.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanRHI.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanUtil.h"
+
+#include <algorithm>
+
+namespace Galaxy
+{
+    namespace
+    {
+        // the heap statistics are cheap, but there is no point in looking every frame
+        constexpr uint32_t s_CheckInterval = 300;
+        constexpr uint32_t s_RunCooldown   = 3600;
+
+        // a heap is worth compacting once this much of its blocks sits unused between allocations
+        constexpr VkDeviceSize s_MinFreeBytes    = 64 * 1024 * 1024;
+        constexpr VkDeviceSize s_MinFreeFraction = 4; // of the block bytes
+
+        // bounds the copies recorded ahead of a single frame
+        constexpr VkDeviceSize s_MaxBytesPerPass = 32 * 1024 * 1024;
+        constexpr uint32_t     s_MaxMovesPerPass = 64;
+        constexpr uint32_t     s_MaxPassesPerRun = 256;
+
+        constexpr VkImageUsageFlags s_ImageWriteUsage =
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+            VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+        constexpr VkImageUsageFlags s_ImageCopyUsage =
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        constexpr VkDeviceSize ToMiB(VkDeviceSize bytes) { return bytes >> 20; }
+    } // namespace
+
+    void VulkanDefragmenter::Initialize(VulkanRHI& rhi, VulkanBindlessHeap* pBindlessHeap)
+    {
+        m_RHI              = &rhi;
+        m_pBindlessHeap    = pBindlessHeap;
+        m_FramesUntilCheck = s_CheckInterval;
+    }
+
+    void VulkanDefragmenter::Destroy()
+    {
+        if (m_PassBatchSerial != 0)
+        {
+            // the copies may have been submitted after the last frame
+            m_RHI->GetStagingRing().WaitIdle();
+            EndPass();
+        }
+        if (IsRunning())
+        {
+            End();
+        }
+
+        m_Movables.clear();
+        m_MovableImages.clear();
+        m_ImageViews.clear();
+        m_MovedCallback = nullptr;
+        m_pBindlessHeap = nullptr;
+        m_RHI           = nullptr;
+    }
+
+    void VulkanDefragmenter::RegisterBuffer(VmaAllocation      allocation,
+                                            RHIBuffer          buffer,
+                                            VkDeviceSize       size,
+                                            VkBufferUsageFlags usage)
+    {
+        // the old buffer is the source of the copy
+        if (allocation == VK_NULL_HANDLE || !(usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+        {
+            return;
+        }
+
+        MovableResource& resource             = m_Movables[allocation];
+        resource.Buffer                       = buffer;
+        resource.BufferCreateInfo             = {};
+        resource.BufferCreateInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        resource.BufferCreateInfo.size        = size;
+        resource.BufferCreateInfo.usage       = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        resource.BufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    void
+    VulkanDefragmenter::RegisterImage(VmaAllocation allocation, RHIImage image, const VkImageCreateInfo& createInfo)
+    {
+        // sampled images sit in shader read only layout once uploaded, anything a pass or shader writes may not
+        if (allocation == VK_NULL_HANDLE || (createInfo.usage & s_ImageWriteUsage) ||
+            (createInfo.usage & s_ImageCopyUsage) != s_ImageCopyUsage ||
+            !(createInfo.usage & VK_IMAGE_USAGE_SAMPLED_BIT))
+        {
+            return;
+        }
+
+        MovableResource& resource = m_Movables[allocation];
+        resource.Image            = image;
+        resource.ImageCreateInfo  = createInfo;
+        m_MovableImages[image]    = allocation;
+    }
+
+    void VulkanDefragmenter::RegisterImageView(RHIImageView       imageView,
+                                               RHIImage           image,
+                                               VkFormat           format,
+                                               VkImageAspectFlags aspectFlags,
+                                               VkImageViewType    viewType,
+                                               uint32_t           layerCount,
+                                               uint32_t           mipLevels)
+    {
+        ImageViewDesc& desc = m_ImageViews[imageView];
+        desc.Image          = image;
+        desc.Format         = format;
+        desc.AspectFlags    = aspectFlags;
+        desc.ViewType       = viewType;
+        desc.LayerCount     = layerCount;
+        desc.MipLevels      = mipLevels;
+    }
+
+    void VulkanDefragmenter::UnregisterImageView(RHIImageView imageView) { m_ImageViews.erase(imageView); }
+
+    void VulkanDefragmenter::MarkUploaded(RHIImage image, RHIUploadTicket ticket)
+    {
+        auto iter = m_MovableImages.find(image);
+        if (iter != m_MovableImages.end())
+        {
+            m_Movables[iter->second].UploadTicket = ticket;
+        }
+    }
+
+    bool VulkanDefragmenter::Unregister(VmaAllocation allocation)
+    {
+        auto iter = m_Movables.find(allocation);
+        if (iter != m_Movables.end())
+        {
+            m_MovableImages.erase(iter->second.Image);
+            m_Movables.erase(iter);
+        }
+
+        // VMA still owns the allocation until the pass ends, it frees the source and the new place together
+        for (uint32_t i = 0; m_PassBatchSerial != 0 && i < m_PassInfo.moveCount; ++i)
+        {
+            VmaDefragmentationMove& move = m_PassInfo.pMoves[i];
+            if (move.srcAllocation == allocation)
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void VulkanDefragmenter::Update()
+    {
+        if (m_PassBatchSerial != 0)
+        {
+            // the copies are done and so is every frame submitted before them, nothing reads the old memory
+            if (m_RHI->GetStagingRing().GetRetiredBatchSerial() < m_PassBatchSerial)
+            {
+                return;
+            }
+            EndPass();
+        }
+
+        if (!IsRunning())
+        {
+            if (m_FramesUntilCheck > 0)
+            {
+                --m_FramesUntilCheck;
+                return;
+            }
+
+            m_FramesUntilCheck = s_CheckInterval;
+
+            // without the callback nobody writes the descriptor sets referencing a moved resource again
+            if (!m_MovedCallback || m_Movables.empty() || !IsFragmented())
+            {
+                return;
+            }
+
+            Begin();
+            if (!IsRunning())
+            {
+                return;
+            }
+        }
+
+        RunPass();
+    }
+
+    bool VulkanDefragmenter::IsFragmented() const
+    {
+        const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+        vmaGetMemoryProperties(m_RHI->AssetsAllocator, &pMemoryProperties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_RHI->AssetsAllocator, budgets);
+
+        for (uint32_t heapIndex = 0; heapIndex < pMemoryProperties->memoryHeapCount; ++heapIndex)
+        {
+            if (!(pMemoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+            {
+                continue;
+            }
+
+            const VmaStatistics& statistics = budgets[heapIndex].statistics;
+            VkDeviceSize         freeBytes  = statistics.blockBytes - statistics.allocationBytes;
+            if (freeBytes >= s_MinFreeBytes && freeBytes >= statistics.blockBytes / s_MinFreeFraction)
+            {
+                GAL_CORE_INFO("[VulkanDefragmenter] Heap {0} has {1} of {2} MiB free between allocations, compacting",
+                              heapIndex,
+                              ToMiB(freeBytes),
+                              ToMiB(statistics.blockBytes));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void VulkanDefragmenter::Begin()
+    {
+        VmaDefragmentationInfo defragmentationInfo {};
+        defragmentationInfo.flags                 = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+        defragmentationInfo.maxBytesPerPass       = s_MaxBytesPerPass;
+        defragmentationInfo.maxAllocationsPerPass = s_MaxMovesPerPass;
+
+        if (vmaBeginDefragmentation(m_RHI->AssetsAllocator, &defragmentationInfo, &m_Context) != VK_SUCCESS)
+        {
+            GAL_CORE_WARN("[VulkanDefragmenter] Failed to begin defragmentation");
+            m_Context = VK_NULL_HANDLE;
+            return;
+        }
+        m_RunPasses = 0;
+    }
+
+    void VulkanDefragmenter::End()
+    {
+        VmaDefragmentationStats defragmentationStats {};
+        vmaEndDefragmentation(m_RHI->AssetsAllocator, m_Context, &defragmentationStats);
+        m_Context = VK_NULL_HANDLE;
+
+        m_Stats.Runs++;
+        m_Stats.AllocationsMoved += defragmentationStats.allocationsMoved;
+        m_Stats.BytesMoved += defragmentationStats.bytesMoved;
+        m_Stats.BytesFreed += defragmentationStats.bytesFreed;
+
+        // whatever could not be moved is still there, give streaming a while before looking again
+        m_FramesUntilCheck = s_RunCooldown;
+
+        GAL_CORE_INFO("[VulkanDefragmenter] Moved {0} allocations ({1} MiB) in {2} passes, freed {3} blocks ({4} MiB)",
+                      defragmentationStats.allocationsMoved,
+                      ToMiB(defragmentationStats.bytesMoved),
+                      m_RunPasses,
+                      defragmentationStats.deviceMemoryBlocksFreed,
+                      ToMiB(defragmentationStats.bytesFreed));
+    }
+
+    void VulkanDefragmenter::RunPass()
+    {
+        VulkanRHI& rhi = *m_RHI;
+
+        if (!m_MovedCallback)
+        {
+            End();
+            return;
+        }
+
+        m_PassInfo      = {};
+        VkResult result = vmaBeginDefragmentationPass(rhi.AssetsAllocator, m_Context, &m_PassInfo);
+        if (result != VK_INCOMPLETE)
+        {
+            // VK_SUCCESS, nothing left to move
+            End();
+            return;
+        }
+
+        VulkanStagingRing&       ring          = rhi.GetStagingRing();
+        VkCommandBuffer          commandBuffer = VK_NULL_HANDLE;
+        std::vector<PendingMove> pendingMoves;
+        pendingMoves.reserve(m_PassInfo.moveCount);
+        for (uint32_t i = 0; i < m_PassInfo.moveCount; ++i)
+        {
+            VmaDefragmentationMove& move = m_PassInfo.pMoves[i];
+
+            const MovableResource* pResource = FindMovable(move.srcAllocation);
+            if (pResource == nullptr)
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            if (commandBuffer == VK_NULL_HANDLE)
+            {
+                // earlier frames and uploads may still be writing the old resources
+                commandBuffer = ring.GetCommandBuffer();
+
+                VkMemoryBarrier barrier {};
+                barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+                rhi.DeviceTable.vkCmdPipelineBarrier(commandBuffer,
+                                                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                     0,
+                                                     1,
+                                                     &barrier,
+                                                     0,
+                                                     nullptr,
+                                                     0,
+                                                     nullptr);
+            }
+
+            PendingMove& pendingMove = pendingMoves.emplace_back();
+            if (!RecordMove(commandBuffer, move, *pResource, pendingMove))
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                pendingMoves.pop_back();
+            }
+        }
+
+        if (pendingMoves.empty())
+        {
+            EndPass();
+            return;
+        }
+
+        // the frames after this one read the copies
+        VkMemoryBarrier barrier {};
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        rhi.DeviceTable.vkCmdPipelineBarrier(commandBuffer,
+                                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                             0,
+                                             1,
+                                             &barrier,
+                                             0,
+                                             nullptr,
+                                             0,
+                                             nullptr);
+
+        // Submitted now rather than with the frame, so the originals released below go to the deletion queue after
+        // the copies in submission order, whichever submit the frame ends up taking.
+        m_PassBatchSerial = ring.GetOpenBatchSerial();
+        ring.Submit();
+
+        for (const PendingMove& pendingMove : pendingMoves)
+        {
+            FinishMove(pendingMove);
+        }
+        m_MovedCallback();
+    }
+
+    void VulkanDefragmenter::EndPass()
+    {
+        m_PassBatchSerial = 0;
+        m_Stats.Passes++;
+        m_RunPasses++;
+
+        VkResult result = vmaEndDefragmentationPass(m_RHI->AssetsAllocator, m_Context, &m_PassInfo);
+        m_PassInfo      = {};
+        if (result == VK_SUCCESS || m_RunPasses >= s_MaxPassesPerRun)
+        {
+            End();
+        }
+    }
+
+    const VulkanDefragmenter::MovableResource* VulkanDefragmenter::FindMovable(VmaAllocation allocation) const
+    {
+        auto iter = m_Movables.find(allocation);
+        if (iter == m_Movables.end())
+        {
+            return nullptr;
+        }
+
+        // a mapped pointer someone holds would go stale, and the CPU would have to do the copy
+        VkMemoryPropertyFlags memoryProperties = 0;
+        vmaGetAllocationMemoryProperties(m_RHI->AssetsAllocator, allocation, &memoryProperties);
+        if (memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            return nullptr;
+        }
+
+        // destroyed, only the memory is left
+        const MovableResource& resource = iter->second;
+        bool isAlive =
+            resource.Buffer ? m_RHI->Resources.IsAlive(resource.Buffer) : m_RHI->Resources.IsAlive(resource.Image);
+        if (!isAlive || IsInBindlessHeap(resource))
+        {
+            return nullptr;
+        }
+
+        // the copy expects shader read only layout, only a completed upload is known to have left the image in it
+        if (resource.Image && !m_RHI->IsUploadComplete(resource.UploadTicket))
+        {
+            return nullptr;
+        }
+        return &resource;
+    }
+
+    bool VulkanDefragmenter::IsInBindlessHeap(const MovableResource& resource) const
+    {
+        if (m_pBindlessHeap == nullptr)
+        {
+            return false;
+        }
+
+        if (resource.Buffer)
+        {
+            return m_pBindlessHeap->References(m_RHI->Resources.Get(resource.Buffer));
+        }
+
+        for (const auto& [imageView, desc] : m_ImageViews)
+        {
+            if (desc.Image == resource.Image && m_RHI->Resources.IsAlive(imageView) &&
+                m_pBindlessHeap->References(m_RHI->Resources.Get(imageView)))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool VulkanDefragmenter::RecordMove(VkCommandBuffer               commandBuffer,
+                                        const VmaDefragmentationMove& move,
+                                        const MovableResource&        resource,
+                                        PendingMove&                  outMove)
+    {
+        VulkanRHI&               rhi    = *m_RHI;
+        const VulkanDeviceTable& device = rhi.DeviceTable;
+
+        if (resource.Buffer)
+        {
+            VkBuffer newBuffer = VK_NULL_HANDLE;
+            if (device.vkCreateBuffer(rhi.Device, &resource.BufferCreateInfo, nullptr, &newBuffer) != VK_SUCCESS)
+            {
+                return false;
+            }
+            if (vmaBindBufferMemory(rhi.AssetsAllocator, move.dstTmpAllocation, newBuffer) != VK_SUCCESS)
+            {
+                device.vkDestroyBuffer(rhi.Device, newBuffer, nullptr);
+                return false;
+            }
+
+            outMove.Buffer    = resource.Buffer;
+            outMove.OldBuffer = rhi.Resources.Get(resource.Buffer);
+            outMove.NewBuffer = newBuffer;
+
+            VkBufferCopy copyRegion = {0, 0, resource.BufferCreateInfo.size};
+            device.vkCmdCopyBuffer(commandBuffer, outMove.OldBuffer, outMove.NewBuffer, 1, &copyRegion);
+            return true;
+        }
+
+        VkImage newImage = VK_NULL_HANDLE;
+        if (device.vkCreateImage(rhi.Device, &resource.ImageCreateInfo, nullptr, &newImage) != VK_SUCCESS)
+        {
+            return false;
+        }
+        if (vmaBindImageMemory(rhi.AssetsAllocator, move.dstTmpAllocation, newImage) != VK_SUCCESS)
+        {
+            device.vkDestroyImage(rhi.Device, newImage, nullptr);
+            return false;
+        }
+
+        outMove.Image    = resource.Image;
+        outMove.OldImage = rhi.Resources.Get(resource.Image);
+        outMove.NewImage = newImage;
+
+        const VkImageCreateInfo& createInfo = resource.ImageCreateInfo;
+        VkImageSubresourceRange  subresourceRange {
+            VK_IMAGE_ASPECT_COLOR_BIT, 0, createInfo.mipLevels, 0, createInfo.arrayLayers};
+
+        VkImageMemoryBarrier barriers[2] {};
+        barriers[0].sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barriers[0].srcAccessMask       = VK_ACCESS_MEMORY_WRITE_BIT;
+        barriers[0].dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+        barriers[0].oldLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers[0].newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[0].image               = outMove.OldImage;
+        barriers[0].subresourceRange    = subresourceRange;
+        barriers[1]                     = barriers[0];
+        barriers[1].dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[1].oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[1].newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].image               = outMove.NewImage;
+        // frames in flight may still sample the old image, the transition waits for them
+        device.vkCmdPipelineBarrier(commandBuffer,
+                                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    0,
+                                    0,
+                                    nullptr,
+                                    0,
+                                    nullptr,
+                                    2,
+                                    barriers);
+
+        ScratchArray<VkImageCopy, 16> copyRegions(createInfo.mipLevels);
+        for (uint32_t mipLevel = 0; mipLevel < createInfo.mipLevels; ++mipLevel)
+        {
+            VkImageCopy& copyRegion   = copyRegions[mipLevel];
+            copyRegion                = {};
+            copyRegion.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0, createInfo.arrayLayers};
+            copyRegion.dstSubresource = copyRegion.srcSubresource;
+            copyRegion.extent         = {std::max(createInfo.extent.width >> mipLevel, 1u),
+                                         std::max(createInfo.extent.height >> mipLevel, 1u),
+                                         1};
+        }
+        device.vkCmdCopyImage(commandBuffer,
+                              outMove.OldImage,
+                              VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                              outMove.NewImage,
+                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              createInfo.mipLevels,
+                              copyRegions.data());
+
+        // frames submitted after the copy only read the new image, it goes back to where shaders expect it
+        barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barriers[1].oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        device.vkCmdPipelineBarrier(commandBuffer,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                    0,
+                                    0,
+                                    nullptr,
+                                    0,
+                                    nullptr,
+                                    1,
+                                    &barriers[1]);
+        return true;
+    }
+
+    void VulkanDefragmenter::FinishMove(const PendingMove& move)
+    {
+        VulkanRHI&               rhi    = *m_RHI;
+        const VulkanDeviceTable& device = rhi.DeviceTable;
+
+        // the originals get handles of their own, the deletion queue destroys them once no frame reads them anymore
+        if (move.Buffer)
+        {
+            RHIBuffer oldBuffer = rhi.Resources.Create<RHIBuffer>(move.OldBuffer);
+            rhi.Resources.Set(move.Buffer, move.NewBuffer);
+            rhi.DestroyBuffer(oldBuffer);
+            return;
+        }
+
+        // views cannot be pointed at another image, every view of the old one is created again
+        for (const auto& [imageView, desc] : m_ImageViews)
+        {
+            if (desc.Image != move.Image || !rhi.Resources.IsAlive(imageView))
+            {
+                continue;
+            }
+
+            VkImage      newImage     = move.NewImage;
+            RHIImageView oldImageView = rhi.Resources.Create<RHIImageView>(rhi.Resources.Get(imageView));
+            VkImageView  newImageView = VulkanUtil::CreateImageView(
+                device, newImage, desc.Format, desc.AspectFlags, desc.ViewType, desc.LayerCount, desc.MipLevels);
+
+            rhi.Resources.Set(imageView, newImageView);
+            rhi.DestroyImageView(oldImageView);
+        }
+
+        RHIImage oldImage = rhi.Resources.Create<RHIImage>(move.OldImage);
+        rhi.Resources.Set(move.Image, move.NewImage);
+        rhi.DestroyImage(oldImage);
+    }
+} // namespace Galaxy
@@ -0,0 +1,109 @@
+//
+// VulkanDeletionQueue.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/11/04 10:05.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeletionQueue.h"
+
+namespace Galaxy
+{
+    namespace
+    {
+        template<typename THandle>
+        void AppendHandles(std::vector<THandle>& dst, std::vector<THandle>& src)
+        {
+            if (dst.empty())
+            {
+                dst.swap(src);
+                return;
+            }
+            dst.insert(dst.end(), src.begin(), src.end());
+            src.clear();
+        }
+    } // namespace
+
+    bool VulkanDeletionQueue::Batch::IsEmpty() const
+    {
+        return DescriptorSets.empty() && Framebuffers.empty() && ImageViews.empty() && Buffers.empty() &&
+               Images.empty() && Pipelines.empty() && Samplers.empty() && Memories.empty();
+    }
+
+    void VulkanDeletionQueue::Batch::Clear()
+    {
+        DescriptorSets.clear();
+        Framebuffers.clear();
+        ImageViews.clear();
+        Buffers.clear();
+        Images.clear();
+        Pipelines.clear();
+        Samplers.clear();
+        Memories.clear();
+    }
+
+    void VulkanDeletionQueue::Batch::Append(Batch& other)
+    {
+        AppendHandles(DescriptorSets, other.DescriptorSets);
+        AppendHandles(Framebuffers, other.Framebuffers);
+        AppendHandles(ImageViews, other.ImageViews);
+        AppendHandles(Buffers, other.Buffers);
+        AppendHandles(Images, other.Images);
+        AppendHandles(Pipelines, other.Pipelines);
+        AppendHandles(Samplers, other.Samplers);
+        AppendHandles(Memories, other.Memories);
+    }
+
+    void VulkanDeletionQueue::Initialize(uint32_t framesInFlight) { m_Submitted.resize(framesInFlight); }
+
+    template<typename THandle>
+    void VulkanDeletionQueue::Push(std::vector<THandle> Batch::*list, THandle handle)
+    {
+        if (!handle)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        (m_Pending.*list).push_back(handle);
+    }
+
+    void VulkanDeletionQueue::Enqueue(RHIDescriptorSet descriptorSet) { Push(&Batch::DescriptorSets, descriptorSet); }
+
+    void VulkanDeletionQueue::Enqueue(RHIFramebuffer framebuffer) { Push(&Batch::Framebuffers, framebuffer); }
+
+    void VulkanDeletionQueue::Enqueue(RHIImageView imageView) { Push(&Batch::ImageViews, imageView); }
+
+    void VulkanDeletionQueue::Enqueue(RHIBuffer buffer) { Push(&Batch::Buffers, buffer); }
+
+    void VulkanDeletionQueue::Enqueue(RHIImage image) { Push(&Batch::Images, image); }
+
+    void VulkanDeletionQueue::Enqueue(RHIPipeline pipeline) { Push(&Batch::Pipelines, pipeline); }
+
+    void VulkanDeletionQueue::Enqueue(RHISampler sampler) { Push(&Batch::Samplers, sampler); }
+
+    void VulkanDeletionQueue::Enqueue(RHIDeviceMemory memory) { Push(&Batch::Memories, memory); }
+
+    void VulkanDeletionQueue::Submit(uint32_t frameIndex)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // the slot was retired when its fence was waited for at the start of this frame
+        m_Submitted[frameIndex].Append(m_Pending);
+    }
+
+    void VulkanDeletionQueue::Retire(uint32_t frameIndex, Batch& outBatch)
+    {
+        std::swap(outBatch, m_Submitted[frameIndex]);
+    }
+
+    void VulkanDeletionQueue::RetireAll(Batch& outBatch)
+    {
+        for (Batch& batch : m_Submitted)
+        {
+            outBatch.Append(batch);
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        outBatch.Append(m_Pending);
+    }
+} // namespace Galaxy
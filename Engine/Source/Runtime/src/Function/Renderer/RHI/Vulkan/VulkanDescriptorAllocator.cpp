@@ -0,0 +1,282 @@
+//
+// VulkanDescriptorAllocator.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 17:05.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDescriptorAllocator.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#include <algorithm>
+
+namespace Galaxy
+{
+    namespace
+    {
+        // only until the first set is registered, one descriptor of every common type per set
+        constexpr VkDescriptorType s_UnregisteredPoolTypes[] = {
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            VK_DESCRIPTOR_TYPE_SAMPLER,
+            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        };
+    } // namespace
+
+    void VulkanDescriptorAllocator::Initialize(const VulkanDeviceTable& device,
+                                               uint32_t                 framesInFlight,
+                                               uint32_t                 threadCount)
+    {
+        m_Device = &device;
+        m_FrameChains.assign(framesInFlight, std::vector<PoolChain>(threadCount));
+    }
+
+    void VulkanDescriptorAllocator::Destroy()
+    {
+        if (m_Device == nullptr)
+        {
+            return;
+        }
+
+        LogStats();
+
+        auto destroyChain = [this](PoolChain& chain) {
+            for (VkDescriptorPool pool : chain.Pools)
+            {
+                m_Device->vkDestroyDescriptorPool(m_Device->Device, pool, nullptr);
+            }
+            chain = {};
+        };
+
+        destroyChain(m_Persistent);
+        m_PersistentSetPools.clear();
+        for (std::vector<PoolChain>& threadChains : m_FrameChains)
+        {
+            for (PoolChain& chain : threadChains)
+            {
+                destroyChain(chain);
+            }
+        }
+        m_FrameChains.clear();
+        m_Device = nullptr;
+    }
+
+    VkResult VulkanDescriptorAllocator::AllocatePersistent(const VkDescriptorSetLayout* pSetLayouts,
+                                                           uint32_t                     setCount,
+                                                           const void*                  pNext,
+                                                           VkDescriptorSet*             pDescriptorSets)
+    {
+        std::lock_guard<std::mutex> lock(m_PersistentMutex);
+
+        VkResult result = Allocate(m_Persistent, pSetLayouts, setCount, pNext, pDescriptorSets);
+        if (result == VK_SUCCESS)
+        {
+            // a successful allocation leaves Current at the pool it came from
+            for (uint32_t i = 0; i < setCount; ++i)
+            {
+                m_PersistentSetPools.emplace(pDescriptorSets[i], m_Persistent.Current);
+            }
+        }
+        return result;
+    }
+
+    void VulkanDescriptorAllocator::FreePersistent(const VkDescriptorSet* pDescriptorSets, uint32_t setCount)
+    {
+        std::lock_guard<std::mutex> lock(m_PersistentMutex);
+
+        for (uint32_t i = 0; i < setCount; ++i)
+        {
+            auto iter = m_PersistentSetPools.find(pDescriptorSets[i]);
+            if (iter == m_PersistentSetPools.end())
+            {
+                GAL_CORE_ERROR("[VulkanDescriptorAllocator] Freed a descriptor set that is not a persistent one");
+                continue;
+            }
+
+            size_t poolIndex = iter->second;
+            m_Device->vkFreeDescriptorSets(m_Device->Device, m_Persistent.Pools[poolIndex], 1, &pDescriptorSets[i]);
+            m_PersistentSetPools.erase(iter);
+            m_Persistent.SetCount--;
+
+            // allocations walk forward from Current, step back so the freed space is found again
+            m_Persistent.Current = std::min(m_Persistent.Current, poolIndex);
+        }
+    }
+
+    VkResult VulkanDescriptorAllocator::AllocateFrame(uint32_t                     frameIndex,
+                                                      const VkDescriptorSetLayout* pSetLayouts,
+                                                      uint32_t                     setCount,
+                                                      const void*                  pNext,
+                                                      VkDescriptorSet*             pDescriptorSets)
+    {
+        std::vector<PoolChain>& threadChains = m_FrameChains[frameIndex];
+
+        uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+        GAL_CORE_ASSERT(threadIndex < threadChains.size(), "[VulkanDescriptorAllocator] Unknown thread");
+        return Allocate(threadChains[threadIndex], pSetLayouts, setCount, pNext, pDescriptorSets);
+    }
+
+    void VulkanDescriptorAllocator::BeginFrame(uint32_t frameIndex)
+    {
+        for (PoolChain& chain : m_FrameChains[frameIndex])
+        {
+            // pools past Current were not touched since the last reset
+            for (size_t i = 0; i < chain.Pools.size() && i <= chain.Current; ++i)
+            {
+                m_Device->vkResetDescriptorPool(m_Device->Device, chain.Pools[i], 0);
+            }
+            chain.Current  = 0;
+            chain.SetCount = 0;
+        }
+    }
+
+    void VulkanDescriptorAllocator::RegisterSetSizes(const VkDescriptorPoolSize* pPoolSizes, uint32_t poolSizeCount)
+    {
+        std::lock_guard<std::mutex> lock(m_SizesMutex);
+
+        for (uint32_t i = 0; i < poolSizeCount; ++i)
+        {
+            auto iter = std::find_if(m_RegisteredSizes.begin(), m_RegisteredSizes.end(), [&](const auto& poolSize) {
+                return poolSize.type == pPoolSizes[i].type;
+            });
+            if (iter == m_RegisteredSizes.end())
+            {
+                iter = m_RegisteredSizes.insert(m_RegisteredSizes.end(), {pPoolSizes[i].type, 0});
+            }
+            iter->descriptorCount += pPoolSizes[i].descriptorCount;
+        }
+        m_RegisteredSetCount++;
+    }
+
+    VulkanDescriptorAllocatorStats VulkanDescriptorAllocator::GetStats() const
+    {
+        VulkanDescriptorAllocatorStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_PersistentMutex);
+            stats.PersistentPools = static_cast<uint32_t>(m_Persistent.Pools.size());
+            stats.PersistentSets  = m_Persistent.SetCount;
+        }
+        for (const std::vector<PoolChain>& threadChains : m_FrameChains)
+        {
+            for (const PoolChain& chain : threadChains)
+            {
+                stats.FramePools += static_cast<uint32_t>(chain.Pools.size());
+                stats.FrameSets  += chain.SetCount;
+            }
+        }
+        stats.PoolGrowths = m_PoolGrowths.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void VulkanDescriptorAllocator::LogStats() const
+    {
+        VulkanDescriptorAllocatorStats stats = GetStats();
+        GAL_CORE_INFO("[VulkanDescriptorAllocator] {0} persistent sets in {1} pools, {2} frame sets in {3} pools, "
+                      "{4} pools added when full",
+                      stats.PersistentSets,
+                      stats.PersistentPools,
+                      stats.FrameSets,
+                      stats.FramePools,
+                      stats.PoolGrowths);
+    }
+
+    VkResult VulkanDescriptorAllocator::Allocate(PoolChain&                   chain,
+                                                 const VkDescriptorSetLayout* pSetLayouts,
+                                                 uint32_t                     setCount,
+                                                 const void*                  pNext,
+                                                 VkDescriptorSet*             pDescriptorSets)
+    {
+        VkDescriptorSetAllocateInfo allocateInfo {};
+        allocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext              = pNext;
+        allocateInfo.descriptorSetCount = setCount;
+        allocateInfo.pSetLayouts        = pSetLayouts;
+
+        while (true)
+        {
+            bool isNewPool = chain.Current == chain.Pools.size();
+            if (isNewPool)
+            {
+                // every pool twice the size of the previous one, a busy chain settles on a few large pools
+                size_t   shift   = std::min<size_t>(chain.Pools.size(), 6);
+                uint32_t maxSets = std::min(s_MinSetsPerPool << shift, s_MaxSetsPerPool);
+
+                // persistent sets are freed one by one, frame pools are only ever reset
+                VkDescriptorPoolCreateFlags flags =
+                    &chain == &m_Persistent ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0;
+
+                VkDescriptorPool pool = CreatePool(std::max(maxSets, setCount), flags);
+                if (pool == VK_NULL_HANDLE)
+                {
+                    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+                }
+                if (!chain.Pools.empty())
+                {
+                    m_PoolGrowths.fetch_add(1, std::memory_order_relaxed);
+                }
+                chain.Pools.push_back(pool);
+            }
+
+            allocateInfo.descriptorPool = chain.Pools[chain.Current];
+            VkResult result = m_Device->vkAllocateDescriptorSets(m_Device->Device, &allocateInfo, pDescriptorSets);
+            if (result == VK_SUCCESS)
+            {
+                chain.SetCount += setCount;
+                return result;
+            }
+
+            // a fresh pool that cannot hold the request never will, e.g. a set with more descriptors than it has
+            if ((result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) || isNewPool)
+            {
+                GAL_CORE_ERROR("[VulkanDescriptorAllocator] Failed to allocate {0} descriptor sets: {1}",
+                               setCount,
+                               (int)result);
+                return result;
+            }
+            chain.Current++;
+        }
+    }
+
+    VkDescriptorPool VulkanDescriptorAllocator::CreatePool(uint32_t maxSets, VkDescriptorPoolCreateFlags flags)
+    {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        {
+            std::lock_guard<std::mutex> lock(m_SizesMutex);
+            for (const VkDescriptorPoolSize& registeredSize : m_RegisteredSizes)
+            {
+                // rounded up, a type one set in a hundred uses still gets room in every pool
+                uint64_t descriptorCount = (static_cast<uint64_t>(registeredSize.descriptorCount) * maxSets +
+                                            m_RegisteredSetCount - 1) /
+                                           m_RegisteredSetCount;
+                poolSizes.push_back({registeredSize.type, static_cast<uint32_t>(descriptorCount)});
+            }
+        }
+
+        if (poolSizes.empty())
+        {
+            GAL_CORE_WARN("[VulkanDescriptorAllocator] No set sizes registered, guessing the pool sizes");
+            for (VkDescriptorType type : s_UnregisteredPoolTypes)
+            {
+                poolSizes.push_back({type, maxSets});
+            }
+        }
+
+        VkDescriptorPoolCreateInfo createInfo {};
+        createInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.flags         = flags;
+        createInfo.maxSets       = maxSets;
+        createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        createInfo.pPoolSizes    = poolSizes.data();
+
+        VkDescriptorPool pool   = VK_NULL_HANDLE;
+        VkResult         result = m_Device->vkCreateDescriptorPool(m_Device->Device, &createInfo, nullptr, &pool);
+        if (result != VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanDescriptorAllocator] Failed to create a descriptor pool for {0} sets", maxSets);
+            return VK_NULL_HANDLE;
+        }
+        return pool;
+    }
+} // namespace Galaxy
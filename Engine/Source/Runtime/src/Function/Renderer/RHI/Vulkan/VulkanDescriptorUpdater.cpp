@@ -0,0 +1,396 @@
+//
+// VulkanDescriptorUpdater.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/31 15:40.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDescriptorUpdater.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#include <cstring>
+
+namespace Galaxy
+{
+    namespace
+    {
+        enum class DescriptorInfoKind
+        {
+            Image,
+            Buffer,
+            TexelBuffer,
+            Unsupported
+        };
+
+        DescriptorInfoKind GetInfoKind(RHIDescriptorType type)
+        {
+            switch (type)
+            {
+                case RHI_DESCRIPTOR_TYPE_SAMPLER:
+                case RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                case RHI_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                case RHI_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                    return DescriptorInfoKind::Image;
+                case RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                case RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                    return DescriptorInfoKind::Buffer;
+                case RHI_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+                case RHI_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                    return DescriptorInfoKind::TexelBuffer;
+                default:
+                    return DescriptorInfoKind::Unsupported;
+            }
+        }
+
+        size_t GetVkInfoSize(DescriptorInfoKind kind)
+        {
+            switch (kind)
+            {
+                case DescriptorInfoKind::Image:
+                    return sizeof(VkDescriptorImageInfo);
+                case DescriptorInfoKind::Buffer:
+                    return sizeof(VkDescriptorBufferInfo);
+                case DescriptorInfoKind::TexelBuffer:
+                    return sizeof(VkBufferView);
+                default:
+                    return 0;
+            }
+        }
+    } // namespace
+
+    void VulkanDescriptorUpdater::Initialize(const VulkanDeviceTable& device,
+                                             VulkanResources&         resources,
+                                             uint32_t                 threadCount)
+    {
+        m_Device    = &device;
+        m_Resources = &resources;
+        m_Batches.assign(threadCount, {});
+    }
+
+    void VulkanDescriptorUpdater::Destroy()
+    {
+        if (m_Device == nullptr)
+        {
+            return;
+        }
+
+        m_Templates.clear();
+        m_Batches.clear();
+        m_Device    = nullptr;
+        m_Resources = nullptr;
+    }
+
+    bool VulkanDescriptorUpdater::CreateTemplate(const RHIDescriptorUpdateTemplateCreateInfo& createInfo,
+                                                 RHIDescriptorUpdateTemplate&                 outTemplate)
+    {
+        TemplateInfo info;
+        info.Entries.assign(createInfo.pDescriptorUpdateEntries,
+                            createInfo.pDescriptorUpdateEntries + createInfo.descriptorUpdateEntryCount);
+        info.VkOffsets.resize(info.Entries.size());
+
+        // the Vulkan side gets its own tightly packed layout, the RHI structs hold handles of a different size
+        std::vector<VkDescriptorUpdateTemplateEntry> vkEntries(info.Entries.size());
+        for (size_t i = 0; i < info.Entries.size(); ++i)
+        {
+            const RHIDescriptorUpdateTemplateEntry& entry = info.Entries[i];
+
+            DescriptorInfoKind kind = GetInfoKind(entry.descriptorType);
+            if (kind == DescriptorInfoKind::Unsupported || entry.descriptorCount == 0)
+            {
+                GAL_CORE_ERROR("[VulkanDescriptorUpdater] Template entry for binding {0} has nothing to write",
+                               entry.dstBinding);
+                return false;
+            }
+
+            size_t vkStride   = GetVkInfoSize(kind);
+            info.VkOffsets[i] = info.VkDataSize;
+            info.VkDataSize  += vkStride * entry.descriptorCount;
+
+            vkEntries[i].dstBinding      = entry.dstBinding;
+            vkEntries[i].dstArrayElement = entry.dstArrayElement;
+            vkEntries[i].descriptorCount = entry.descriptorCount;
+            vkEntries[i].descriptorType  = (VkDescriptorType)entry.descriptorType;
+            vkEntries[i].offset          = info.VkOffsets[i];
+            vkEntries[i].stride          = vkStride;
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo vkCreateInfo {};
+        vkCreateInfo.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        vkCreateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(vkEntries.size());
+        vkCreateInfo.pDescriptorUpdateEntries   = vkEntries.data();
+        vkCreateInfo.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        vkCreateInfo.descriptorSetLayout        = m_Resources->Get(createInfo.descriptorSetLayout);
+
+        VkDescriptorUpdateTemplate vkTemplate = VK_NULL_HANDLE;
+        if (m_Device->vkCreateDescriptorUpdateTemplate(m_Device->Device, &vkCreateInfo, nullptr, &vkTemplate) !=
+            VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanDescriptorUpdater] Failed to create descriptor update template");
+            return false;
+        }
+
+        outTemplate = m_Resources->Create<RHIDescriptorUpdateTemplate>(vkTemplate);
+        if (outTemplate.GetIndex() >= m_Templates.size())
+        {
+            m_Templates.resize(outTemplate.GetIndex() + 1);
+        }
+        m_Templates[outTemplate.GetIndex()] = std::move(info);
+        return true;
+    }
+
+    void VulkanDescriptorUpdater::DestroyTemplate(RHIDescriptorUpdateTemplate updateTemplate)
+    {
+        m_Device->vkDestroyDescriptorUpdateTemplate(m_Device->Device, m_Resources->Get(updateTemplate), nullptr);
+        if (m_Resources->Destroy(updateTemplate))
+        {
+            m_Templates[updateTemplate.GetIndex()] = {};
+        }
+    }
+
+    void VulkanDescriptorUpdater::Update(uint32_t                     writeCount,
+                                         const RHIWriteDescriptorSet* pWrites,
+                                         uint32_t                     copyCount,
+                                         const RHICopyDescriptorSet*  pCopies)
+    {
+        ConvertWrites(writeCount, pWrites);
+
+        m_VkCopies.resize(copyCount);
+        for (uint32_t i = 0; i < copyCount; ++i)
+        {
+            const RHICopyDescriptorSet& copy   = pCopies[i];
+            VkCopyDescriptorSet&        vkCopy = m_VkCopies[i];
+
+            vkCopy.sType           = (VkStructureType)copy.sType;
+            vkCopy.pNext           = copy.pNext;
+            vkCopy.srcSet          = m_Resources->Get(copy.srcSet);
+            vkCopy.srcBinding      = copy.srcBinding;
+            vkCopy.srcArrayElement = copy.srcArrayElement;
+            vkCopy.dstSet          = m_Resources->Get(copy.dstSet);
+            vkCopy.dstBinding      = copy.dstBinding;
+            vkCopy.dstArrayElement = copy.dstArrayElement;
+            vkCopy.descriptorCount = copy.descriptorCount;
+        }
+
+        m_Device->vkUpdateDescriptorSets(m_Device->Device, writeCount, m_VkWrites.data(), copyCount, m_VkCopies.data());
+    }
+
+    void VulkanDescriptorUpdater::UpdateWithTemplate(RHIDescriptorSet            set,
+                                                     RHIDescriptorUpdateTemplate updateTemplate,
+                                                     const void*                 pData)
+    {
+        VkDescriptorUpdateTemplate vkTemplate = m_Resources->Get(updateTemplate);
+        if (vkTemplate == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        const TemplateInfo& info = m_Templates[updateTemplate.GetIndex()];
+        m_TemplateData.resize(info.VkDataSize);
+
+        const unsigned char* pSource = static_cast<const unsigned char*>(pData);
+        for (size_t i = 0; i < info.Entries.size(); ++i)
+        {
+            const RHIDescriptorUpdateTemplateEntry& entry = info.Entries[i];
+
+            DescriptorInfoKind kind = GetInfoKind(entry.descriptorType);
+            unsigned char*     pDst = m_TemplateData.data() + info.VkOffsets[i];
+            for (uint32_t j = 0; j < entry.descriptorCount; ++j)
+            {
+                // the caller's struct may be packed, copy out instead of dereferencing in place
+                const unsigned char* pSrc = pSource + entry.offset + j * entry.stride;
+                if (kind == DescriptorInfoKind::Image)
+                {
+                    RHIDescriptorImageInfo imageInfo;
+                    std::memcpy(&imageInfo, pSrc, sizeof(imageInfo));
+
+                    VkDescriptorImageInfo vkImageInfo {};
+                    vkImageInfo.sampler     = m_Resources->Get(imageInfo.sampler);
+                    vkImageInfo.imageView   = m_Resources->Get(imageInfo.imageView);
+                    vkImageInfo.imageLayout = (VkImageLayout)imageInfo.imageLayout;
+                    std::memcpy(pDst, &vkImageInfo, sizeof(vkImageInfo));
+                    pDst += sizeof(vkImageInfo);
+                }
+                else if (kind == DescriptorInfoKind::Buffer)
+                {
+                    RHIDescriptorBufferInfo bufferInfo;
+                    std::memcpy(&bufferInfo, pSrc, sizeof(bufferInfo));
+
+                    VkDescriptorBufferInfo vkBufferInfo {};
+                    vkBufferInfo.buffer = m_Resources->Get(bufferInfo.buffer);
+                    vkBufferInfo.offset = (VkDeviceSize)bufferInfo.offset;
+                    vkBufferInfo.range  = (VkDeviceSize)bufferInfo.range;
+                    std::memcpy(pDst, &vkBufferInfo, sizeof(vkBufferInfo));
+                    pDst += sizeof(vkBufferInfo);
+                }
+                else
+                {
+                    RHIBufferView bufferView;
+                    std::memcpy(&bufferView, pSrc, sizeof(bufferView));
+
+                    VkBufferView vkBufferView = m_Resources->Get(bufferView);
+                    std::memcpy(pDst, &vkBufferView, sizeof(vkBufferView));
+                    pDst += sizeof(vkBufferView);
+                }
+            }
+        }
+
+        m_Device->vkUpdateDescriptorSetWithTemplate(
+            m_Device->Device, m_Resources->Get(set), vkTemplate, m_TemplateData.data());
+    }
+
+    void VulkanDescriptorUpdater::Queue(uint32_t writeCount, const RHIWriteDescriptorSet* pWrites)
+    {
+        uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+        GAL_CORE_ASSERT(threadIndex < m_Batches.size(), "[VulkanDescriptorUpdater] Unknown thread");
+        WriteBatch& batch = m_Batches[threadIndex];
+
+        for (uint32_t i = 0; i < writeCount; ++i)
+        {
+            RHIWriteDescriptorSet write = pWrites[i];
+            write.pNext                 = nullptr;
+
+            // ConvertWrites reads every array that is set, so every one of them is copied
+            FirstInfo firstInfo;
+            if (write.pImageInfo != nullptr)
+            {
+                firstInfo.Image = static_cast<uint32_t>(batch.ImageInfos.size());
+                batch.ImageInfos.insert(
+                    batch.ImageInfos.end(), write.pImageInfo, write.pImageInfo + write.descriptorCount);
+            }
+            if (write.pBufferInfo != nullptr)
+            {
+                firstInfo.Buffer = static_cast<uint32_t>(batch.BufferInfos.size());
+                batch.BufferInfos.insert(
+                    batch.BufferInfos.end(), write.pBufferInfo, write.pBufferInfo + write.descriptorCount);
+            }
+            if (write.pTexelBufferView != nullptr)
+            {
+                firstInfo.TexelBuffer = static_cast<uint32_t>(batch.TexelBufferViews.size());
+                batch.TexelBufferViews.insert(batch.TexelBufferViews.end(),
+                                              write.pTexelBufferView,
+                                              write.pTexelBufferView + write.descriptorCount);
+            }
+
+            batch.Writes.push_back(write);
+            batch.FirstInfos.push_back(firstInfo);
+        }
+    }
+
+    uint32_t VulkanDescriptorUpdater::Flush()
+    {
+        m_FlushWrites.clear();
+        for (WriteBatch& batch : m_Batches)
+        {
+            for (size_t i = 0; i < batch.Writes.size(); ++i)
+            {
+                RHIWriteDescriptorSet& write     = batch.Writes[i];
+                const FirstInfo&       firstInfo = batch.FirstInfos[i];
+                if (write.pImageInfo != nullptr)
+                {
+                    write.pImageInfo = batch.ImageInfos.data() + firstInfo.Image;
+                }
+                if (write.pBufferInfo != nullptr)
+                {
+                    write.pBufferInfo = batch.BufferInfos.data() + firstInfo.Buffer;
+                }
+                if (write.pTexelBufferView != nullptr)
+                {
+                    write.pTexelBufferView = batch.TexelBufferViews.data() + firstInfo.TexelBuffer;
+                }
+            }
+            m_FlushWrites.insert(m_FlushWrites.end(), batch.Writes.begin(), batch.Writes.end());
+        }
+
+        uint32_t writeCount = static_cast<uint32_t>(m_FlushWrites.size());
+        if (writeCount > 0)
+        {
+            ConvertWrites(writeCount, m_FlushWrites.data());
+            m_Device->vkUpdateDescriptorSets(m_Device->Device, writeCount, m_VkWrites.data(), 0, nullptr);
+        }
+
+        // capacity is kept for the next frame
+        for (WriteBatch& batch : m_Batches)
+        {
+            batch.Writes.clear();
+            batch.FirstInfos.clear();
+            batch.ImageInfos.clear();
+            batch.BufferInfos.clear();
+            batch.TexelBufferViews.clear();
+        }
+        return writeCount;
+    }
+
+    void VulkanDescriptorUpdater::ConvertWrites(uint32_t writeCount, const RHIWriteDescriptorSet* pWrites)
+    {
+        // sized up front, the Vulkan writes point into these arrays
+        size_t imageInfoCount       = 0;
+        size_t bufferInfoCount      = 0;
+        size_t texelBufferViewCount = 0;
+        for (uint32_t i = 0; i < writeCount; ++i)
+        {
+            const RHIWriteDescriptorSet& write = pWrites[i];
+            imageInfoCount       += write.pImageInfo != nullptr ? write.descriptorCount : 0;
+            bufferInfoCount      += write.pBufferInfo != nullptr ? write.descriptorCount : 0;
+            texelBufferViewCount += write.pTexelBufferView != nullptr ? write.descriptorCount : 0;
+        }
+        m_VkWrites.resize(writeCount);
+        m_VkImageInfos.resize(imageInfoCount);
+        m_VkBufferInfos.resize(bufferInfoCount);
+        m_VkTexelBufferViews.resize(texelBufferViewCount);
+
+        VkDescriptorImageInfo*  pVkImageInfo       = m_VkImageInfos.data();
+        VkDescriptorBufferInfo* pVkBufferInfo      = m_VkBufferInfos.data();
+        VkBufferView*           pVkTexelBufferView = m_VkTexelBufferViews.data();
+
+        for (uint32_t i = 0; i < writeCount; ++i)
+        {
+            const RHIWriteDescriptorSet& write   = pWrites[i];
+            VkWriteDescriptorSet&        vkWrite = m_VkWrites[i];
+
+            vkWrite                 = {};
+            vkWrite.sType           = (VkStructureType)write.sType;
+            vkWrite.pNext           = write.pNext;
+            vkWrite.dstSet          = m_Resources->Get(write.dstSet);
+            vkWrite.dstBinding      = write.dstBinding;
+            vkWrite.dstArrayElement = write.dstArrayElement;
+            vkWrite.descriptorCount = write.descriptorCount;
+            vkWrite.descriptorType  = (VkDescriptorType)write.descriptorType;
+
+            if (write.pImageInfo != nullptr)
+            {
+                vkWrite.pImageInfo = pVkImageInfo;
+                for (uint32_t j = 0; j < write.descriptorCount; ++j, ++pVkImageInfo)
+                {
+                    const RHIDescriptorImageInfo& imageInfo = write.pImageInfo[j];
+
+                    pVkImageInfo->sampler     = m_Resources->Get(imageInfo.sampler);
+                    pVkImageInfo->imageView   = m_Resources->Get(imageInfo.imageView);
+                    pVkImageInfo->imageLayout = (VkImageLayout)imageInfo.imageLayout;
+                }
+            }
+            if (write.pBufferInfo != nullptr)
+            {
+                vkWrite.pBufferInfo = pVkBufferInfo;
+                for (uint32_t j = 0; j < write.descriptorCount; ++j, ++pVkBufferInfo)
+                {
+                    const RHIDescriptorBufferInfo& bufferInfo = write.pBufferInfo[j];
+
+                    pVkBufferInfo->buffer = m_Resources->Get(bufferInfo.buffer);
+                    pVkBufferInfo->offset = (VkDeviceSize)bufferInfo.offset;
+                    pVkBufferInfo->range  = (VkDeviceSize)bufferInfo.range;
+                }
+            }
+            if (write.pTexelBufferView != nullptr)
+            {
+                vkWrite.pTexelBufferView = pVkTexelBufferView;
+                for (uint32_t j = 0; j < write.descriptorCount; ++j, ++pVkTexelBufferView)
+                {
+                    *pVkTexelBufferView = m_Resources->Get(write.pTexelBufferView[j]);
+                }
+            }
+        }
+    }
+} // namespace Galaxy
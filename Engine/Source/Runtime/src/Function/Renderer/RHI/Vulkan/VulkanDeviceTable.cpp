@@ -0,0 +1,49 @@
+//
+// VulkanDeviceTable.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/26 16:05.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanDeviceTable.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+namespace Galaxy
+{
+    bool VulkanDeviceTable::Load(VkDevice device)
+    {
+        Device = device;
+
+        bool complete = true;
+#define GAL_LOAD_VULKAN_FUNCTION(name) \
+    name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name)); \
+    if (name == nullptr) \
+    { \
+        GAL_CORE_ERROR("[VulkanDeviceTable] Device does not expose " #name); \
+        complete = false; \
+    }
+        GAL_VULKAN_DEVICE_FUNCTIONS(GAL_LOAD_VULKAN_FUNCTION)
+#undef GAL_LOAD_VULKAN_FUNCTION
+
+        return complete;
+    }
+
+    void VulkanDeviceTable::FillVmaFunctions(VmaVulkanFunctions& functions) const
+    {
+        // instance level functions and the optional *2KHR entry points are still fetched by VMA itself
+        functions.vkAllocateMemory               = vkAllocateMemory;
+        functions.vkFreeMemory                   = vkFreeMemory;
+        functions.vkMapMemory                    = vkMapMemory;
+        functions.vkUnmapMemory                  = vkUnmapMemory;
+        functions.vkFlushMappedMemoryRanges      = vkFlushMappedMemoryRanges;
+        functions.vkInvalidateMappedMemoryRanges = vkInvalidateMappedMemoryRanges;
+        functions.vkBindBufferMemory             = vkBindBufferMemory;
+        functions.vkBindImageMemory              = vkBindImageMemory;
+        functions.vkGetBufferMemoryRequirements  = vkGetBufferMemoryRequirements;
+        functions.vkGetImageMemoryRequirements   = vkGetImageMemoryRequirements;
+        functions.vkCreateBuffer                 = vkCreateBuffer;
+        functions.vkDestroyBuffer                = vkDestroyBuffer;
+        functions.vkCreateImage                  = vkCreateImage;
+        functions.vkDestroyImage                 = vkDestroyImage;
+        functions.vkCmdCopyBuffer                = vkCmdCopyBuffer;
+    }
+} // namespace Galaxy
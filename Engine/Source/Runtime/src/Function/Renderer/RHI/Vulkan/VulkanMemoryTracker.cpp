@@ -0,0 +1,206 @@
+//
+// VulkanMemoryTracker.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/11/03 09:40.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanMemoryTracker.h"
+#include "GalaxyEngine/Core/FileSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Function/Global/GlobalContext.h"
+
+#include <cstring>
+
+namespace Galaxy
+{
+    namespace
+    {
+        const char* const s_CategoryNames[Memory_Category_Count] = {
+            "Other", "Texture", "Mesh", "RenderTarget", "Staging"};
+
+        // the category lives in the user data, offset by one so untracked allocations keep reading as null
+        void* EncodeCategory(RHIMemoryCategory category)
+        {
+            return reinterpret_cast<void*>(static_cast<uintptr_t>(category) + 1);
+        }
+
+        constexpr VkDeviceSize ToMiB(VkDeviceSize bytes) { return bytes >> 20; }
+    } // namespace
+
+    void VulkanMemoryTracker::Initialize(VmaAllocator allocator, bool hasBudgetExtension)
+    {
+        m_Allocator          = allocator;
+        m_HasBudgetExtension = hasBudgetExtension;
+
+        const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+        vmaGetMemoryProperties(m_Allocator, &pMemoryProperties);
+        m_HeapCount = pMemoryProperties->memoryHeapCount;
+        m_BudgetStates.assign(m_HeapCount, BudgetState::Normal);
+
+        if (!m_HasBudgetExtension)
+        {
+            GAL_CORE_INFO("[VulkanMemoryTracker] VK_EXT_memory_budget is not available, heap budgets are estimated");
+        }
+    }
+
+    void VulkanMemoryTracker::BeginFrame()
+    {
+        // lets VMA refresh the budget from the driver, it only does so when the frame index changes
+        vmaSetCurrentFrameIndex(m_Allocator, ++m_FrameNumber);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_Allocator, budgets);
+
+        for (uint32_t heapIndex = 0; heapIndex < m_HeapCount; ++heapIndex)
+        {
+            const VmaBudget& budget = budgets[heapIndex];
+            if (budget.budget == 0)
+            {
+                continue;
+            }
+
+            BudgetState state = BudgetState::Normal;
+            if (budget.usage > budget.budget)
+            {
+                state = BudgetState::Over;
+            }
+            else if (budget.usage > budget.budget / 10 * 9)
+            {
+                state = BudgetState::Near;
+            }
+
+            if (state == m_BudgetStates[heapIndex])
+            {
+                continue;
+            }
+
+            if (state == BudgetState::Over)
+            {
+                GAL_CORE_WARN("[VulkanMemoryTracker] Heap {0} is over budget, {1} of {2} MiB in use",
+                              heapIndex,
+                              ToMiB(budget.usage),
+                              ToMiB(budget.budget));
+            }
+            else if (state == BudgetState::Near && m_BudgetStates[heapIndex] == BudgetState::Normal)
+            {
+                GAL_CORE_WARN("[VulkanMemoryTracker] Heap {0} is close to its budget, {1} of {2} MiB in use",
+                              heapIndex,
+                              ToMiB(budget.usage),
+                              ToMiB(budget.budget));
+            }
+            else if (state == BudgetState::Normal)
+            {
+                GAL_CORE_INFO("[VulkanMemoryTracker] Heap {0} is back within budget, {1} of {2} MiB in use",
+                              heapIndex,
+                              ToMiB(budget.usage),
+                              ToMiB(budget.budget));
+            }
+            m_BudgetStates[heapIndex] = state;
+        }
+    }
+
+    void VulkanMemoryTracker::Track(VmaAllocation allocation, RHIMemoryCategory category)
+    {
+        if (allocation == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(m_Allocator, allocation, &allocationInfo);
+        if (allocationInfo.pUserData != nullptr)
+        {
+            Untrack(allocation);
+        }
+
+        vmaSetAllocationUserData(m_Allocator, allocation, EncodeCategory(category));
+        vmaSetAllocationName(m_Allocator, allocation, s_CategoryNames[category]);
+        m_CategoryBytes[category] += allocationInfo.size;
+    }
+
+    void VulkanMemoryTracker::Untrack(VmaAllocation allocation)
+    {
+        if (allocation == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(m_Allocator, allocation, &allocationInfo);
+        if (allocationInfo.pUserData == nullptr)
+        {
+            return;
+        }
+
+        uintptr_t category = reinterpret_cast<uintptr_t>(allocationInfo.pUserData) - 1;
+        m_CategoryBytes[category] -= allocationInfo.size;
+        vmaSetAllocationUserData(m_Allocator, allocation, nullptr);
+    }
+
+    RHIMemoryCategory VulkanMemoryTracker::GetBufferCategory(VkBufferUsageFlags usage)
+    {
+        if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+        {
+            return Memory_Category_Mesh;
+        }
+        if (usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+        {
+            return Memory_Category_Staging;
+        }
+        return Memory_Category_Other;
+    }
+
+    RHIMemoryCategory VulkanMemoryTracker::GetImageCategory(VkImageUsageFlags usage)
+    {
+        if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
+        {
+            return Memory_Category_RenderTarget;
+        }
+        return Memory_Category_Texture;
+    }
+
+    void VulkanMemoryTracker::GetStats(RHIMemoryStats& outStats) const
+    {
+        const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+        vmaGetMemoryProperties(m_Allocator, &pMemoryProperties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_Allocator, budgets);
+
+        outStats.hasBudget = m_HasBudgetExtension;
+        outStats.heaps.resize(m_HeapCount);
+        for (uint32_t heapIndex = 0; heapIndex < m_HeapCount; ++heapIndex)
+        {
+            RHIMemoryHeapStats& heapStats = outStats.heaps[heapIndex];
+            heapStats.budget              = budgets[heapIndex].budget;
+            heapStats.usage               = budgets[heapIndex].usage;
+            heapStats.blockBytes          = budgets[heapIndex].statistics.blockBytes;
+            heapStats.allocationBytes     = budgets[heapIndex].statistics.allocationBytes;
+            heapStats.isDeviceLocal =
+                (pMemoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+
+        for (uint32_t category = 0; category < Memory_Category_Count; ++category)
+        {
+            outStats.categoryBytes[category] = m_CategoryBytes[category].load();
+        }
+    }
+
+    bool VulkanMemoryTracker::DumpStats(const std::string& path) const
+    {
+        char* pStatsString = nullptr;
+        vmaBuildStatsString(m_Allocator, &pStatsString, VK_TRUE);
+
+        std::vector<char> data(pStatsString, pStatsString + strlen(pStatsString));
+        vmaFreeStatsString(m_Allocator, pStatsString);
+
+        if (!g_RuntimeGlobalContext.FileSys->WriteFileAtomically(path, data))
+        {
+            GAL_CORE_ERROR("[VulkanMemoryTracker] Failed to write memory statistics to {0}", path);
+            return false;
+        }
+
+        GAL_CORE_INFO("[VulkanMemoryTracker] Wrote memory statistics to {0}", path);
+        return true;
+    }
+} // namespace Galaxy
@@ -0,0 +1,252 @@
+//
+// VulkanPipelineCache.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/27 10:12.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanPipelineCache.h"
+#include "GalaxyEngine/Core/FileSystem.h"
+#include "GalaxyEngine/Core/Hash.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Core/Memory/ScratchArray.h"
+#include "GalaxyEngine/Function/Global/GlobalContext.h"
+
+#include <cstring>
+
+namespace Galaxy
+{
+    void VulkanPipelineCache::Initialize(const VulkanDeviceTable&          device,
+                                         const VkPhysicalDeviceProperties& properties,
+                                         const std::filesystem::path&      filePath)
+    {
+        m_Device     = &device;
+        m_Properties = properties;
+        m_FilePath   = filePath;
+
+        // slot 0 is the main thread, which records straight into the main cache
+        m_ThreadCaches.assign(g_RuntimeGlobalContext.JobSys->GetThreadCount(), VK_NULL_HANDLE);
+
+        std::vector<char> initialData;
+        if (LoadFile(initialData))
+        {
+            m_SavedHash = hash_fnv1a(initialData.data(), initialData.size());
+        }
+
+        VkPipelineCacheCreateInfo createInfo {};
+        createInfo.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = initialData.size();
+        createInfo.pInitialData    = initialData.empty() ? nullptr : initialData.data();
+
+        VkResult result = m_Device->vkCreatePipelineCache(m_Device->Device, &createInfo, nullptr, &m_MainCache);
+        if (result != VK_SUCCESS && !initialData.empty())
+        {
+            GAL_CORE_WARN("[VulkanPipelineCache] Driver rejected {0}, starting from an empty cache",
+                          m_FilePath.string());
+
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData    = nullptr;
+            m_SavedHash                = 0;
+            result = m_Device->vkCreatePipelineCache(m_Device->Device, &createInfo, nullptr, &m_MainCache);
+        }
+        VK_CHECK(result, "[VulkanPipelineCache] Failed to create pipeline cache");
+
+        GAL_CORE_INFO("[VulkanPipelineCache] Created with {0} bytes from {1}", initialData.size(), m_FilePath.string());
+    }
+
+    void VulkanPipelineCache::Destroy()
+    {
+        if (m_MainCache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        for (VkPipelineCache& threadCache : m_ThreadCaches)
+        {
+            if (threadCache != VK_NULL_HANDLE)
+            {
+                m_Device->vkDestroyPipelineCache(m_Device->Device, threadCache, nullptr);
+                threadCache = VK_NULL_HANDLE;
+            }
+        }
+
+        m_Device->vkDestroyPipelineCache(m_Device->Device, m_MainCache, nullptr);
+        m_MainCache = VK_NULL_HANDLE;
+    }
+
+    VkPipelineCache VulkanPipelineCache::GetThreadCache()
+    {
+        uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+        if (threadIndex == 0 || threadIndex >= m_ThreadCaches.size())
+        {
+            return m_MainCache;
+        }
+
+        // each slot is only ever touched by its own worker, and by MergeThreadCaches while no worker compiles
+        VkPipelineCache& threadCache = m_ThreadCaches[threadIndex];
+        if (threadCache == VK_NULL_HANDLE)
+        {
+            VkPipelineCacheCreateInfo createInfo {};
+            createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+            if (m_Device->vkCreatePipelineCache(m_Device->Device, &createInfo, nullptr, &threadCache) != VK_SUCCESS)
+            {
+                GAL_CORE_WARN("[VulkanPipelineCache] Failed to create cache for thread {0}", threadIndex);
+                threadCache = VK_NULL_HANDLE;
+                return m_MainCache;
+            }
+        }
+        return threadCache;
+    }
+
+    void VulkanPipelineCache::MergeThreadCaches()
+    {
+        ScratchArray<VkPipelineCache, 16> sourceCaches(m_ThreadCaches.size());
+        uint32_t                          sourceCount = 0;
+        for (VkPipelineCache threadCache : m_ThreadCaches)
+        {
+            if (threadCache != VK_NULL_HANDLE)
+            {
+                sourceCaches[sourceCount++] = threadCache;
+            }
+        }
+
+        if (sourceCount == 0)
+        {
+            return;
+        }
+
+        VkResult result =
+            m_Device->vkMergePipelineCaches(m_Device->Device, m_MainCache, sourceCount, sourceCaches.data());
+        if (result != VK_SUCCESS)
+        {
+            // keep the thread caches, the next merge tries again
+            GAL_CORE_WARN("[VulkanPipelineCache] Failed to merge thread caches: {0}", (int)result);
+            return;
+        }
+
+        // merged caches start over empty so the next merge only carries new pipelines
+        for (VkPipelineCache& threadCache : m_ThreadCaches)
+        {
+            if (threadCache != VK_NULL_HANDLE)
+            {
+                m_Device->vkDestroyPipelineCache(m_Device->Device, threadCache, nullptr);
+                threadCache = VK_NULL_HANDLE;
+            }
+        }
+    }
+
+    bool VulkanPipelineCache::Save()
+    {
+        if (m_MainCache == VK_NULL_HANDLE)
+        {
+            return false;
+        }
+
+        MergeThreadCaches();
+
+        size_t   dataSize = 0;
+        VkResult result   = m_Device->vkGetPipelineCacheData(m_Device->Device, m_MainCache, &dataSize, nullptr);
+        if (result != VK_SUCCESS || dataSize == 0)
+        {
+            return false;
+        }
+
+        std::vector<char> fileData(sizeof(FileHeader) + dataSize);
+        char*             cacheData = fileData.data() + sizeof(FileHeader);
+
+        result = m_Device->vkGetPipelineCacheData(m_Device->Device, m_MainCache, &dataSize, cacheData);
+        if (result != VK_SUCCESS)
+        {
+            GAL_CORE_WARN("[VulkanPipelineCache] Failed to read back pipeline cache data: {0}", (int)result);
+            return false;
+        }
+        fileData.resize(sizeof(FileHeader) + dataSize);
+
+        uint64_t dataHash = hash_fnv1a(cacheData, dataSize);
+        if (dataHash == m_SavedHash)
+        {
+            return true;
+        }
+
+        FileHeader header {};
+        header.Magic         = s_FileMagic;
+        header.Version       = s_FileVersion;
+        header.VendorID      = m_Properties.vendorID;
+        header.DeviceID      = m_Properties.deviceID;
+        header.DriverVersion = m_Properties.driverVersion;
+        header.DataSize      = dataSize;
+        header.DataHash      = dataHash;
+        std::memcpy(header.PipelineCacheUUID, m_Properties.pipelineCacheUUID, VK_UUID_SIZE);
+        std::memcpy(fileData.data(), &header, sizeof(FileHeader));
+
+        if (!g_RuntimeGlobalContext.FileSys->WriteFileAtomically(m_FilePath.string(), fileData))
+        {
+            return false;
+        }
+
+        m_SavedHash = dataHash;
+        GAL_CORE_INFO("[VulkanPipelineCache] Saved {0} bytes to {1}", dataSize, m_FilePath.string());
+        return true;
+    }
+
+    bool VulkanPipelineCache::LoadFile(std::vector<char>& outData) const
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(m_FilePath, error))
+        {
+            return false;
+        }
+
+        std::vector<char> fileData = g_RuntimeGlobalContext.FileSys->ReadFileAllText(m_FilePath.string());
+        if (fileData.size() < sizeof(FileHeader))
+        {
+            GAL_CORE_WARN("[VulkanPipelineCache] Ignoring truncated cache file {0}", m_FilePath.string());
+            return false;
+        }
+
+        FileHeader header;
+        std::memcpy(&header, fileData.data(), sizeof(FileHeader));
+        if (!IsCompatible(header))
+        {
+            GAL_CORE_INFO("[VulkanPipelineCache] Cache file {0} belongs to another device or driver, ignoring it",
+                          m_FilePath.string());
+            return false;
+        }
+
+        const char* cacheData = fileData.data() + sizeof(FileHeader);
+        size_t      dataSize  = fileData.size() - sizeof(FileHeader);
+        if (header.DataSize != dataSize || header.DataHash != hash_fnv1a(cacheData, dataSize))
+        {
+            GAL_CORE_WARN("[VulkanPipelineCache] Ignoring corrupted cache file {0}", m_FilePath.string());
+            return false;
+        }
+
+        // the driver validates its own header too, but not every driver handles foreign blobs gracefully
+        VkPipelineCacheHeaderVersionOne driverHeader;
+        if (dataSize < sizeof(driverHeader))
+        {
+            return false;
+        }
+        std::memcpy(&driverHeader, cacheData, sizeof(driverHeader));
+        if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            driverHeader.vendorID != m_Properties.vendorID || driverHeader.deviceID != m_Properties.deviceID ||
+            std::memcmp(driverHeader.pipelineCacheUUID, m_Properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            GAL_CORE_WARN("[VulkanPipelineCache] Ignoring cache file {0} with a mismatching driver header",
+                          m_FilePath.string());
+            return false;
+        }
+
+        outData.assign(cacheData, cacheData + dataSize);
+        return true;
+    }
+
+    bool VulkanPipelineCache::IsCompatible(const FileHeader& header) const
+    {
+        return header.Magic == s_FileMagic && header.Version == s_FileVersion &&
+               header.VendorID == m_Properties.vendorID && header.DeviceID == m_Properties.deviceID &&
+               header.DriverVersion == m_Properties.driverVersion &&
+               std::memcmp(header.PipelineCacheUUID, m_Properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+} // namespace Galaxy
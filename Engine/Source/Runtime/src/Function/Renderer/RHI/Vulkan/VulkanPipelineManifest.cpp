@@ -0,0 +1,1033 @@
+//
+// VulkanPipelineManifest.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/28 09:47.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanPipelineManifest.h"
+#include "GalaxyEngine/Core/FileSystem.h"
+#include "GalaxyEngine/Core/Job/JobSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Core/Memory/FrameAllocator.h"
+#include "GalaxyEngine/Core/Time/Timer.h"
+#include "GalaxyEngine/Function/Global/GlobalContext.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanPipelineCache.h"
+
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace Galaxy
+{
+    // Appends plain values to a blob. Arrays are prefixed with their element count, a null array is written as empty.
+    class ManifestWriter
+    {
+    public:
+        explicit ManifestWriter(std::vector<char>& data) : m_Data(data) {}
+
+        template<typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be written");
+            WriteBytes(&value, sizeof(T));
+        }
+
+        template<typename T>
+        void WriteArray(const T* values, uint32_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be written");
+            count = values != nullptr ? count : 0;
+            Write(count);
+            WriteBytes(values, sizeof(T) * count);
+        }
+
+    private:
+        void WriteBytes(const void* data, size_t size)
+        {
+            if (size > 0)
+            {
+                const char* bytes = static_cast<const char*>(data);
+                m_Data.insert(m_Data.end(), bytes, bytes + size);
+            }
+        }
+
+        std::vector<char>& m_Data;
+    };
+
+    // Reads back what ManifestWriter wrote. Arrays are copied into the arena so they are properly aligned. Reading past
+    // the end leaves the reader invalid and returns zeroes from then on.
+    class ManifestReader
+    {
+    public:
+        ManifestReader(const std::vector<char>& data, LinearArena& arena) : m_Data(data), m_Arena(arena) {}
+
+        template<typename T>
+        T Read()
+        {
+            T value {};
+            ReadBytes(&value, sizeof(T));
+            return value;
+        }
+
+        // null for an empty array
+        template<typename T>
+        const T* ReadArray(uint32_t& outCount)
+        {
+            outCount = Read<uint32_t>();
+            if (outCount == 0 || !Reserve(sizeof(T) * outCount))
+            {
+                outCount = 0;
+                return nullptr;
+            }
+
+            T* values = m_Arena.AllocateArray<T>(outCount);
+            ReadBytes(values, sizeof(T) * outCount);
+            return values;
+        }
+
+        bool IsValid() const { return m_Valid; }
+
+    private:
+        bool Reserve(size_t size)
+        {
+            m_Valid = m_Valid && size <= m_Data.size() - m_Offset;
+            return m_Valid;
+        }
+
+        void ReadBytes(void* out, size_t size)
+        {
+            if (Reserve(size))
+            {
+                std::memcpy(out, m_Data.data() + m_Offset, size);
+                m_Offset += size;
+            }
+        }
+
+        const std::vector<char>& m_Data;
+        LinearArena&             m_Arena;
+        size_t                   m_Offset = 0;
+        bool                     m_Valid  = true;
+    };
+
+    // Objects recreated from the manifest, indexed like the blobs they came from
+    struct ManifestObjects
+    {
+        std::vector<VkShaderModule>        ShaderModules;
+        std::vector<VkSampler>             Samplers;
+        std::vector<VkDescriptorSetLayout> SetLayouts;
+        std::vector<VkPipelineLayout>      PipelineLayouts;
+        std::vector<VkRenderPass>          RenderPasses;
+    };
+
+    template<typename VkHandle>
+    static uint64_t HandleKey(VkHandle handle)
+    {
+        return (uint64_t)handle;
+    }
+
+    template<typename VkHandle>
+    static VkHandle Lookup(const std::vector<VkHandle>& objects, uint32_t index)
+    {
+        return index < objects.size() ? objects[index] : VK_NULL_HANDLE;
+    }
+
+    template<typename T>
+    static T* AllocateZeroed(LinearArena& arena)
+    {
+        return new (arena.AllocateArray<T>(1)) T {};
+    }
+
+    static void WriteShaderStage(ManifestWriter& writer, const VkPipelineShaderStageCreateInfo& stage, uint32_t moduleIndex)
+    {
+        writer.Write(stage.flags);
+        writer.Write(stage.stage);
+        writer.Write(moduleIndex);
+        writer.WriteArray(stage.pName, static_cast<uint32_t>(std::strlen(stage.pName) + 1));
+
+        const VkSpecializationInfo* specializationInfo = stage.pSpecializationInfo;
+        writer.Write<uint8_t>(specializationInfo != nullptr);
+        if (specializationInfo != nullptr)
+        {
+            writer.WriteArray(specializationInfo->pMapEntries, specializationInfo->mapEntryCount);
+            writer.WriteArray(static_cast<const char*>(specializationInfo->pData),
+                              static_cast<uint32_t>(specializationInfo->dataSize));
+        }
+    }
+
+    static bool ReadShaderStage(ManifestReader&                  reader,
+                                const ManifestObjects&           objects,
+                                LinearArena&                     arena,
+                                VkPipelineShaderStageCreateInfo& stage)
+    {
+        stage.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage.flags  = reader.Read<VkPipelineShaderStageCreateFlags>();
+        stage.stage  = reader.Read<VkShaderStageFlagBits>();
+        stage.module = Lookup(objects.ShaderModules, reader.Read<uint32_t>());
+
+        uint32_t nameLength = 0;
+        stage.pName         = reader.ReadArray<char>(nameLength);
+        if (stage.pName == nullptr || stage.pName[nameLength - 1] != '\0')
+        {
+            return false;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto*    specializationInfo = AllocateZeroed<VkSpecializationInfo>(arena);
+            uint32_t dataSize           = 0;
+            specializationInfo->pMapEntries =
+                reader.ReadArray<VkSpecializationMapEntry>(specializationInfo->mapEntryCount);
+            specializationInfo->pData    = reader.ReadArray<char>(dataSize);
+            specializationInfo->dataSize = dataSize;
+            stage.pSpecializationInfo    = specializationInfo;
+        }
+        return stage.module != VK_NULL_HANDLE;
+    }
+
+    static bool ReadDescriptorSetLayout(ManifestReader&                  reader,
+                                        const ManifestObjects&           objects,
+                                        LinearArena&                     arena,
+                                        VkDescriptorSetLayoutCreateInfo& createInfo)
+    {
+        createInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        createInfo.flags        = reader.Read<VkDescriptorSetLayoutCreateFlags>();
+        createInfo.bindingCount = reader.Read<uint32_t>();
+
+        auto* bindings = arena.AllocateArray<VkDescriptorSetLayoutBinding>(createInfo.bindingCount);
+        for (uint32_t i = 0; i < createInfo.bindingCount && reader.IsValid(); ++i)
+        {
+            VkDescriptorSetLayoutBinding& binding = bindings[i];
+            binding.binding                       = reader.Read<uint32_t>();
+            binding.descriptorType                = reader.Read<VkDescriptorType>();
+            binding.descriptorCount               = reader.Read<uint32_t>();
+            binding.stageFlags                    = reader.Read<VkShaderStageFlags>();
+            binding.pImmutableSamplers            = nullptr;
+
+            uint32_t        samplerCount   = 0;
+            const uint32_t* samplerIndices = reader.ReadArray<uint32_t>(samplerCount);
+            if (samplerCount > 0)
+            {
+                auto* samplers = arena.AllocateArray<VkSampler>(samplerCount);
+                for (uint32_t j = 0; j < samplerCount; ++j)
+                {
+                    samplers[j] = Lookup(objects.Samplers, samplerIndices[j]);
+                    if (samplers[j] == VK_NULL_HANDLE)
+                    {
+                        return false;
+                    }
+                }
+                binding.pImmutableSamplers = samplers;
+            }
+        }
+        createInfo.pBindings = bindings;
+        return reader.IsValid();
+    }
+
+    static bool ReadPipelineLayout(ManifestReader&             reader,
+                                   const ManifestObjects&      objects,
+                                   LinearArena&                arena,
+                                   VkPipelineLayoutCreateInfo& createInfo)
+    {
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        createInfo.flags = reader.Read<VkPipelineLayoutCreateFlags>();
+
+        const uint32_t* setLayoutIndices = reader.ReadArray<uint32_t>(createInfo.setLayoutCount);
+        auto*           setLayouts       = arena.AllocateArray<VkDescriptorSetLayout>(createInfo.setLayoutCount);
+        for (uint32_t i = 0; i < createInfo.setLayoutCount; ++i)
+        {
+            setLayouts[i] = Lookup(objects.SetLayouts, setLayoutIndices[i]);
+            if (setLayouts[i] == VK_NULL_HANDLE)
+            {
+                return false;
+            }
+        }
+        createInfo.pSetLayouts         = setLayouts;
+        createInfo.pPushConstantRanges = reader.ReadArray<VkPushConstantRange>(createInfo.pushConstantRangeCount);
+        return reader.IsValid();
+    }
+
+    static bool ReadRenderPass(ManifestReader& reader, LinearArena& arena, VkRenderPassCreateInfo& createInfo)
+    {
+        createInfo.sType        = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        createInfo.flags        = reader.Read<VkRenderPassCreateFlags>();
+        createInfo.pAttachments = reader.ReadArray<VkAttachmentDescription>(createInfo.attachmentCount);
+        createInfo.subpassCount = reader.Read<uint32_t>();
+
+        auto* subpasses = arena.AllocateArray<VkSubpassDescription>(createInfo.subpassCount);
+        for (uint32_t i = 0; i < createInfo.subpassCount && reader.IsValid(); ++i)
+        {
+            uint32_t resolveCount      = 0;
+            uint32_t depthStencilCount = 0;
+
+            VkSubpassDescription& subpass   = subpasses[i];
+
+            subpass.flags                   = reader.Read<VkSubpassDescriptionFlags>();
+            subpass.pipelineBindPoint       = reader.Read<VkPipelineBindPoint>();
+            subpass.pInputAttachments       = reader.ReadArray<VkAttachmentReference>(subpass.inputAttachmentCount);
+            subpass.pColorAttachments       = reader.ReadArray<VkAttachmentReference>(subpass.colorAttachmentCount);
+            subpass.pResolveAttachments     = reader.ReadArray<VkAttachmentReference>(resolveCount);
+            subpass.pDepthStencilAttachment = reader.ReadArray<VkAttachmentReference>(depthStencilCount);
+            subpass.pPreserveAttachments    = reader.ReadArray<uint32_t>(subpass.preserveAttachmentCount);
+        }
+        createInfo.pSubpasses    = subpasses;
+        createInfo.pDependencies = reader.ReadArray<VkSubpassDependency>(createInfo.dependencyCount);
+        return reader.IsValid();
+    }
+
+    static bool ReadGraphicsPipeline(ManifestReader&               reader,
+                                     const ManifestObjects&        objects,
+                                     LinearArena&                  arena,
+                                     VkGraphicsPipelineCreateInfo& createInfo)
+    {
+        createInfo.sType      = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.flags      = reader.Read<VkPipelineCreateFlags>();
+        createInfo.stageCount = reader.Read<uint32_t>();
+
+        auto* stages = arena.AllocateArray<VkPipelineShaderStageCreateInfo>(createInfo.stageCount);
+        for (uint32_t i = 0; i < createInfo.stageCount && reader.IsValid(); ++i)
+        {
+            stages[i] = {};
+            if (!ReadShaderStage(reader, objects, arena, stages[i]))
+            {
+                return false;
+            }
+        }
+        createInfo.pStages = stages;
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state  = AllocateZeroed<VkPipelineVertexInputStateCreateInfo>(arena);
+            state->sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+            state->flags = reader.Read<VkPipelineVertexInputStateCreateFlags>();
+            state->pVertexBindingDescriptions =
+                reader.ReadArray<VkVertexInputBindingDescription>(state->vertexBindingDescriptionCount);
+            state->pVertexAttributeDescriptions =
+                reader.ReadArray<VkVertexInputAttributeDescription>(state->vertexAttributeDescriptionCount);
+            createInfo.pVertexInputState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state                    = AllocateZeroed<VkPipelineInputAssemblyStateCreateInfo>(arena);
+            state->sType                   = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+            state->flags                   = reader.Read<VkPipelineInputAssemblyStateCreateFlags>();
+            state->topology                = reader.Read<VkPrimitiveTopology>();
+            state->primitiveRestartEnable  = reader.Read<VkBool32>();
+            createInfo.pInputAssemblyState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state                   = AllocateZeroed<VkPipelineTessellationStateCreateInfo>(arena);
+            state->sType                  = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
+            state->flags                  = reader.Read<VkPipelineTessellationStateCreateFlags>();
+            state->patchControlPoints     = reader.Read<uint32_t>();
+            createInfo.pTessellationState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            // counts are kept on their own, the arrays are empty when viewport and scissor are dynamic
+            uint32_t viewportCount = 0;
+            uint32_t scissorCount  = 0;
+
+            auto* state               = AllocateZeroed<VkPipelineViewportStateCreateInfo>(arena);
+            state->sType              = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+            state->flags              = reader.Read<VkPipelineViewportStateCreateFlags>();
+            state->viewportCount      = reader.Read<uint32_t>();
+            state->scissorCount       = reader.Read<uint32_t>();
+            state->pViewports         = reader.ReadArray<VkViewport>(viewportCount);
+            state->pScissors          = reader.ReadArray<VkRect2D>(scissorCount);
+            createInfo.pViewportState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state                    = AllocateZeroed<VkPipelineRasterizationStateCreateInfo>(arena);
+            *state                         = reader.Read<VkPipelineRasterizationStateCreateInfo>();
+            state->pNext                   = nullptr;
+            createInfo.pRasterizationState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            uint32_t sampleMaskCount = 0;
+
+            auto* state                  = AllocateZeroed<VkPipelineMultisampleStateCreateInfo>(arena);
+            *state                       = reader.Read<VkPipelineMultisampleStateCreateInfo>();
+            state->pNext                 = nullptr;
+            state->pSampleMask           = reader.ReadArray<VkSampleMask>(sampleMaskCount);
+            createInfo.pMultisampleState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state                   = AllocateZeroed<VkPipelineDepthStencilStateCreateInfo>(arena);
+            *state                        = reader.Read<VkPipelineDepthStencilStateCreateInfo>();
+            state->pNext                  = nullptr;
+            createInfo.pDepthStencilState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state          = AllocateZeroed<VkPipelineColorBlendStateCreateInfo>(arena);
+            state->sType         = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+            state->flags         = reader.Read<VkPipelineColorBlendStateCreateFlags>();
+            state->logicOpEnable = reader.Read<VkBool32>();
+            state->logicOp       = reader.Read<VkLogicOp>();
+            state->pAttachments  = reader.ReadArray<VkPipelineColorBlendAttachmentState>(state->attachmentCount);
+            for (float& blendConstant : state->blendConstants)
+            {
+                blendConstant = reader.Read<float>();
+            }
+            createInfo.pColorBlendState = state;
+        }
+
+        if (reader.Read<uint8_t>() != 0)
+        {
+            auto* state              = AllocateZeroed<VkPipelineDynamicStateCreateInfo>(arena);
+            state->sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            state->flags             = reader.Read<VkPipelineDynamicStateCreateFlags>();
+            state->pDynamicStates    = reader.ReadArray<VkDynamicState>(state->dynamicStateCount);
+            createInfo.pDynamicState = state;
+        }
+
+        createInfo.layout             = Lookup(objects.PipelineLayouts, reader.Read<uint32_t>());
+        createInfo.renderPass         = Lookup(objects.RenderPasses, reader.Read<uint32_t>());
+        createInfo.subpass            = reader.Read<uint32_t>();
+        createInfo.basePipelineHandle = VK_NULL_HANDLE;
+        createInfo.basePipelineIndex  = -1;
+        return reader.IsValid() && createInfo.layout != VK_NULL_HANDLE && createInfo.renderPass != VK_NULL_HANDLE;
+    }
+
+    static bool ReadComputePipeline(ManifestReader&              reader,
+                                    const ManifestObjects&       objects,
+                                    LinearArena&                 arena,
+                                    VkComputePipelineCreateInfo& createInfo)
+    {
+        createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        createInfo.flags = reader.Read<VkPipelineCreateFlags>();
+        if (!ReadShaderStage(reader, objects, arena, createInfo.stage))
+        {
+            return false;
+        }
+
+        createInfo.layout             = Lookup(objects.PipelineLayouts, reader.Read<uint32_t>());
+        createInfo.basePipelineHandle = VK_NULL_HANDLE;
+        createInfo.basePipelineIndex  = -1;
+        return reader.IsValid() && createInfo.layout != VK_NULL_HANDLE;
+    }
+
+    void VulkanPipelineManifest::Initialize(const VulkanDeviceTable& device, const std::filesystem::path& filePath)
+    {
+        m_Device   = &device;
+        m_FilePath = filePath;
+    }
+
+    bool VulkanPipelineManifest::Load()
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(m_FilePath, error))
+        {
+            return false;
+        }
+
+        std::vector<char> fileData = g_RuntimeGlobalContext.FileSys->ReadFileAllText(m_FilePath.string());
+
+        FileHeader header {};
+        if (fileData.size() < sizeof(FileHeader))
+        {
+            GAL_CORE_WARN("[VulkanPipelineManifest] Ignoring truncated manifest {0}", m_FilePath.string());
+            return false;
+        }
+        std::memcpy(&header, fileData.data(), sizeof(FileHeader));
+        if (header.Magic != s_FileMagic || header.Version != s_FileVersion)
+        {
+            GAL_CORE_WARN("[VulkanPipelineManifest] Ignoring manifest {0} with an unknown version",
+                          m_FilePath.string());
+            return false;
+        }
+
+        ObjectTable tables[Object_Type_Count];
+        size_t      offset = sizeof(FileHeader);
+        for (uint32_t type = 0; type < Object_Type_Count; ++type)
+        {
+            for (uint32_t i = 0; i < header.ObjectCounts[type]; ++i)
+            {
+                uint32_t blobSize = 0;
+                if (fileData.size() - offset < sizeof(blobSize))
+                {
+                    GAL_CORE_WARN("[VulkanPipelineManifest] Ignoring corrupted manifest {0}", m_FilePath.string());
+                    return false;
+                }
+                std::memcpy(&blobSize, fileData.data() + offset, sizeof(blobSize));
+                offset += sizeof(blobSize);
+
+                if (fileData.size() - offset < blobSize)
+                {
+                    GAL_CORE_WARN("[VulkanPipelineManifest] Ignoring corrupted manifest {0}", m_FilePath.string());
+                    return false;
+                }
+
+                std::vector<char> blob(fileData.begin() + offset, fileData.begin() + offset + blobSize);
+                offset += blobSize;
+
+                std::string_view blobView(blob.data(), blob.size());
+                tables[type].BlobIndices.emplace(std::hash<std::string_view> {}(blobView), i);
+                tables[type].Blobs.push_back(std::move(blob));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (uint32_t type = 0; type < Object_Type_Count; ++type)
+        {
+            m_Tables[type] = std::move(tables[type]);
+        }
+        m_Dirty = false;
+
+        GAL_CORE_INFO("[VulkanPipelineManifest] Loaded {0} graphics and {1} compute pipelines from {2}",
+                      m_Tables[Object_Graphics_Pipeline].Blobs.size(),
+                      m_Tables[Object_Compute_Pipeline].Blobs.size(),
+                      m_FilePath.string());
+        return true;
+    }
+
+    bool VulkanPipelineManifest::Save()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Dirty)
+        {
+            return true;
+        }
+
+        FileHeader header {};
+        header.Magic   = s_FileMagic;
+        header.Version = s_FileVersion;
+
+        std::vector<char> fileData(sizeof(FileHeader));
+        ManifestWriter    writer(fileData);
+        for (uint32_t type = 0; type < Object_Type_Count; ++type)
+        {
+            header.ObjectCounts[type] = static_cast<uint32_t>(m_Tables[type].Blobs.size());
+            for (const std::vector<char>& blob : m_Tables[type].Blobs)
+            {
+                writer.WriteArray(blob.data(), static_cast<uint32_t>(blob.size()));
+            }
+        }
+        std::memcpy(fileData.data(), &header, sizeof(FileHeader));
+
+        if (!g_RuntimeGlobalContext.FileSys->WriteFileAtomically(m_FilePath.string(), fileData))
+        {
+            return false;
+        }
+
+        m_Dirty = false;
+        GAL_CORE_INFO("[VulkanPipelineManifest] Saved {0} graphics and {1} compute pipelines to {2}",
+                      m_Tables[Object_Graphics_Pipeline].Blobs.size(),
+                      m_Tables[Object_Compute_Pipeline].Blobs.size(),
+                      m_FilePath.string());
+        return true;
+    }
+
+    uint32_t VulkanPipelineManifest::Replay(VulkanPipelineCache& pipelineCache)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        const auto& graphicsBlobs = m_Tables[Object_Graphics_Pipeline].Blobs;
+        const auto& computeBlobs  = m_Tables[Object_Compute_Pipeline].Blobs;
+        if (graphicsBlobs.empty() && computeBlobs.empty())
+        {
+            return 0;
+        }
+
+        Timer         timer;
+        LinearArena   arena(256 * 1024);
+        VkDevice      device = m_Device->Device;
+        ManifestObjects objects;
+
+        // dependencies first, in the order they reference each other, a failed object stays VK_NULL_HANDLE and
+        // takes everything using it down with it
+        objects.ShaderModules.assign(m_Tables[Object_Shader_Module].Blobs.size(), VK_NULL_HANDLE);
+        for (size_t i = 0; i < objects.ShaderModules.size(); ++i)
+        {
+            ScopedArenaMarker arenaMarker(arena);
+            ManifestReader    reader(m_Tables[Object_Shader_Module].Blobs[i], arena);
+
+            VkShaderModuleCreateInfo createInfo {};
+            uint32_t                 wordCount = 0;
+            createInfo.sType                   = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            createInfo.pCode                   = reader.ReadArray<uint32_t>(wordCount);
+            createInfo.codeSize                = wordCount * sizeof(uint32_t);
+            if (wordCount == 0 ||
+                m_Device->vkCreateShaderModule(device, &createInfo, nullptr, &objects.ShaderModules[i]) != VK_SUCCESS)
+            {
+                objects.ShaderModules[i] = VK_NULL_HANDLE;
+            }
+        }
+
+        objects.Samplers.assign(m_Tables[Object_Sampler].Blobs.size(), VK_NULL_HANDLE);
+        for (size_t i = 0; i < objects.Samplers.size(); ++i)
+        {
+            ManifestReader      reader(m_Tables[Object_Sampler].Blobs[i], arena);
+            VkSamplerCreateInfo createInfo = reader.Read<VkSamplerCreateInfo>();
+            createInfo.pNext               = nullptr;
+            if (!reader.IsValid() ||
+                m_Device->vkCreateSampler(device, &createInfo, nullptr, &objects.Samplers[i]) != VK_SUCCESS)
+            {
+                objects.Samplers[i] = VK_NULL_HANDLE;
+            }
+        }
+
+        objects.SetLayouts.assign(m_Tables[Object_Descriptor_Set_Layout].Blobs.size(), VK_NULL_HANDLE);
+        for (size_t i = 0; i < objects.SetLayouts.size(); ++i)
+        {
+            ScopedArenaMarker arenaMarker(arena);
+            ManifestReader    reader(m_Tables[Object_Descriptor_Set_Layout].Blobs[i], arena);
+
+            VkDescriptorSetLayoutCreateInfo createInfo {};
+            if (!ReadDescriptorSetLayout(reader, objects, arena, createInfo) ||
+                m_Device->vkCreateDescriptorSetLayout(device, &createInfo, nullptr, &objects.SetLayouts[i]) !=
+                    VK_SUCCESS)
+            {
+                objects.SetLayouts[i] = VK_NULL_HANDLE;
+            }
+        }
+
+        objects.PipelineLayouts.assign(m_Tables[Object_Pipeline_Layout].Blobs.size(), VK_NULL_HANDLE);
+        for (size_t i = 0; i < objects.PipelineLayouts.size(); ++i)
+        {
+            ScopedArenaMarker arenaMarker(arena);
+            ManifestReader    reader(m_Tables[Object_Pipeline_Layout].Blobs[i], arena);
+
+            VkPipelineLayoutCreateInfo createInfo {};
+            if (!ReadPipelineLayout(reader, objects, arena, createInfo) ||
+                m_Device->vkCreatePipelineLayout(device, &createInfo, nullptr, &objects.PipelineLayouts[i]) !=
+                    VK_SUCCESS)
+            {
+                objects.PipelineLayouts[i] = VK_NULL_HANDLE;
+            }
+        }
+
+        objects.RenderPasses.assign(m_Tables[Object_Render_Pass].Blobs.size(), VK_NULL_HANDLE);
+        for (size_t i = 0; i < objects.RenderPasses.size(); ++i)
+        {
+            ScopedArenaMarker arenaMarker(arena);
+            ManifestReader    reader(m_Tables[Object_Render_Pass].Blobs[i], arena);
+
+            VkRenderPassCreateInfo createInfo {};
+            if (!ReadRenderPass(reader, arena, createInfo) ||
+                m_Device->vkCreateRenderPass(device, &createInfo, nullptr, &objects.RenderPasses[i]) != VK_SUCCESS)
+            {
+                objects.RenderPasses[i] = VK_NULL_HANDLE;
+            }
+        }
+
+        // pipelines are decoded up front, the arena is not touched again while the workers compile
+        std::vector<VkGraphicsPipelineCreateInfo> graphicsCreateInfos;
+        for (const std::vector<char>& blob : graphicsBlobs)
+        {
+            ManifestReader               reader(blob, arena);
+            VkGraphicsPipelineCreateInfo createInfo {};
+            if (ReadGraphicsPipeline(reader, objects, arena, createInfo))
+            {
+                graphicsCreateInfos.push_back(createInfo);
+            }
+        }
+
+        std::vector<VkComputePipelineCreateInfo> computeCreateInfos;
+        for (const std::vector<char>& blob : computeBlobs)
+        {
+            ManifestReader              reader(blob, arena);
+            VkComputePipelineCreateInfo createInfo {};
+            if (ReadComputePipeline(reader, objects, arena, createInfo))
+            {
+                computeCreateInfos.push_back(createInfo);
+            }
+        }
+
+        std::atomic<uint32_t> compiledCount {0};
+        uint32_t graphicsCount = static_cast<uint32_t>(graphicsCreateInfos.size());
+        uint32_t totalCount    = graphicsCount + static_cast<uint32_t>(computeCreateInfos.size());
+        g_RuntimeGlobalContext.JobSys->ParallelFor(totalCount, 1, [&](uint32_t begin, uint32_t end) {
+            VkPipelineCache threadCache = pipelineCache.GetThreadCache();
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                VkPipeline pipeline = VK_NULL_HANDLE;
+                VkResult   result   = i < graphicsCount ?
+                                          m_Device->vkCreateGraphicsPipelines(
+                                              device, threadCache, 1, &graphicsCreateInfos[i], nullptr, &pipeline) :
+                                          m_Device->vkCreateComputePipelines(device,
+                                                                             threadCache,
+                                                                             1,
+                                                                             &computeCreateInfos[i - graphicsCount],
+                                                                             nullptr,
+                                                                             &pipeline);
+                if (result == VK_SUCCESS)
+                {
+                    // only the cache entry was wanted
+                    m_Device->vkDestroyPipeline(device, pipeline, nullptr);
+                    compiledCount.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+        pipelineCache.MergeThreadCaches();
+
+        for (VkRenderPass renderPass : objects.RenderPasses)
+        {
+            m_Device->vkDestroyRenderPass(device, renderPass, nullptr);
+        }
+        for (VkPipelineLayout pipelineLayout : objects.PipelineLayouts)
+        {
+            m_Device->vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        }
+        for (VkDescriptorSetLayout setLayout : objects.SetLayouts)
+        {
+            m_Device->vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+        }
+        for (VkSampler sampler : objects.Samplers)
+        {
+            m_Device->vkDestroySampler(device, sampler, nullptr);
+        }
+        for (VkShaderModule shaderModule : objects.ShaderModules)
+        {
+            m_Device->vkDestroyShaderModule(device, shaderModule, nullptr);
+        }
+
+        size_t recordedCount = graphicsBlobs.size() + computeBlobs.size();
+        GAL_CORE_INFO("[VulkanPipelineManifest] Replayed {0} of {1} pipelines in {2} ms",
+                      compiledCount.load(),
+                      recordedCount,
+                      timer.ElapsedMilliseconds());
+        return compiledCount.load();
+    }
+
+    void VulkanPipelineManifest::RecordShaderModule(VkShaderModule shaderModule, const std::vector<unsigned char>& code)
+    {
+        if (!m_Recording || shaderModule == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.WriteArray(reinterpret_cast<const uint32_t*>(code.data()),
+                          static_cast<uint32_t>(code.size() / sizeof(uint32_t)));
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        MapHandle(Object_Shader_Module, HandleKey(shaderModule), AddObject(Object_Shader_Module, std::move(blob)));
+    }
+
+    void VulkanPipelineManifest::RecordSampler(VkSampler sampler, const VkSamplerCreateInfo& createInfo)
+    {
+        if (!m_Recording || sampler == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        VkSamplerCreateInfo samplerInfo = createInfo;
+        samplerInfo.pNext               = nullptr;
+
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.Write(samplerInfo);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        MapHandle(Object_Sampler, HandleKey(sampler), AddObject(Object_Sampler, std::move(blob)));
+    }
+
+    void VulkanPipelineManifest::RecordDescriptorSetLayout(VkDescriptorSetLayout                  setLayout,
+                                                           const VkDescriptorSetLayoutCreateInfo& createInfo)
+    {
+        if (!m_Recording || setLayout == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.Write(createInfo.flags);
+        writer.Write(createInfo.bindingCount);
+        for (uint32_t i = 0; i < createInfo.bindingCount; ++i)
+        {
+            const VkDescriptorSetLayoutBinding& binding = createInfo.pBindings[i];
+            writer.Write(binding.binding);
+            writer.Write(binding.descriptorType);
+            writer.Write(binding.descriptorCount);
+            writer.Write(binding.stageFlags);
+
+            uint32_t samplerCount = binding.pImmutableSamplers != nullptr ? binding.descriptorCount : 0;
+            writer.Write(samplerCount);
+            for (uint32_t j = 0; j < samplerCount; ++j)
+            {
+                uint32_t samplerIndex = FindIndex(Object_Sampler, HandleKey(binding.pImmutableSamplers[j]));
+                if (samplerIndex == s_InvalidIndex)
+                {
+                    return;
+                }
+                writer.Write(samplerIndex);
+            }
+        }
+
+        MapHandle(Object_Descriptor_Set_Layout,
+                  HandleKey(setLayout),
+                  AddObject(Object_Descriptor_Set_Layout, std::move(blob)));
+    }
+
+    void VulkanPipelineManifest::RecordPipelineLayout(VkPipelineLayout                  pipelineLayout,
+                                                      const VkPipelineLayoutCreateInfo& createInfo)
+    {
+        if (!m_Recording || pipelineLayout == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.Write(createInfo.flags);
+        writer.Write(createInfo.setLayoutCount);
+        for (uint32_t i = 0; i < createInfo.setLayoutCount; ++i)
+        {
+            uint32_t setLayoutIndex = FindIndex(Object_Descriptor_Set_Layout, HandleKey(createInfo.pSetLayouts[i]));
+            if (setLayoutIndex == s_InvalidIndex)
+            {
+                return;
+            }
+            writer.Write(setLayoutIndex);
+        }
+        writer.WriteArray(createInfo.pPushConstantRanges, createInfo.pushConstantRangeCount);
+
+        MapHandle(Object_Pipeline_Layout,
+                  HandleKey(pipelineLayout),
+                  AddObject(Object_Pipeline_Layout, std::move(blob)));
+    }
+
+    void VulkanPipelineManifest::RecordRenderPass(VkRenderPass renderPass, const VkRenderPassCreateInfo& createInfo)
+    {
+        if (!m_Recording || renderPass == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.Write(createInfo.flags);
+        writer.WriteArray(createInfo.pAttachments, createInfo.attachmentCount);
+        writer.Write(createInfo.subpassCount);
+        for (uint32_t i = 0; i < createInfo.subpassCount; ++i)
+        {
+            const VkSubpassDescription& subpass = createInfo.pSubpasses[i];
+            writer.Write(subpass.flags);
+            writer.Write(subpass.pipelineBindPoint);
+            writer.WriteArray(subpass.pInputAttachments, subpass.inputAttachmentCount);
+            writer.WriteArray(subpass.pColorAttachments, subpass.colorAttachmentCount);
+            writer.WriteArray(subpass.pResolveAttachments, subpass.colorAttachmentCount);
+            writer.WriteArray(subpass.pDepthStencilAttachment, 1);
+            writer.WriteArray(subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+        }
+        writer.WriteArray(createInfo.pDependencies, createInfo.dependencyCount);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        MapHandle(Object_Render_Pass, HandleKey(renderPass), AddObject(Object_Render_Pass, std::move(blob)));
+    }
+
+    void VulkanPipelineManifest::RecordGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo)
+    {
+        if (!m_Recording)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        uint32_t layoutIndex     = FindIndex(Object_Pipeline_Layout, HandleKey(createInfo.layout));
+        uint32_t renderPassIndex = FindIndex(Object_Render_Pass, HandleKey(createInfo.renderPass));
+        if (layoutIndex == s_InvalidIndex || renderPassIndex == s_InvalidIndex)
+        {
+            return;
+        }
+
+        // replayed pipelines are created one by one, so they cannot derive from each other
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.Write(createInfo.flags & ~VK_PIPELINE_CREATE_DERIVATIVE_BIT);
+        writer.Write(createInfo.stageCount);
+        for (uint32_t i = 0; i < createInfo.stageCount; ++i)
+        {
+            const VkPipelineShaderStageCreateInfo& stage = createInfo.pStages[i];
+
+            uint32_t moduleIndex = FindIndex(Object_Shader_Module, HandleKey(stage.module));
+            if (moduleIndex == s_InvalidIndex)
+            {
+                return;
+            }
+            WriteShaderStage(writer, stage, moduleIndex);
+        }
+
+        const auto* vertexInputState = createInfo.pVertexInputState;
+        writer.Write<uint8_t>(vertexInputState != nullptr);
+        if (vertexInputState != nullptr)
+        {
+            writer.Write(vertexInputState->flags);
+            writer.WriteArray(vertexInputState->pVertexBindingDescriptions,
+                              vertexInputState->vertexBindingDescriptionCount);
+            writer.WriteArray(vertexInputState->pVertexAttributeDescriptions,
+                              vertexInputState->vertexAttributeDescriptionCount);
+        }
+
+        const auto* inputAssemblyState = createInfo.pInputAssemblyState;
+        writer.Write<uint8_t>(inputAssemblyState != nullptr);
+        if (inputAssemblyState != nullptr)
+        {
+            writer.Write(inputAssemblyState->flags);
+            writer.Write(inputAssemblyState->topology);
+            writer.Write(inputAssemblyState->primitiveRestartEnable);
+        }
+
+        const auto* tessellationState = createInfo.pTessellationState;
+        writer.Write<uint8_t>(tessellationState != nullptr);
+        if (tessellationState != nullptr)
+        {
+            writer.Write(tessellationState->flags);
+            writer.Write(tessellationState->patchControlPoints);
+        }
+
+        const auto* viewportState = createInfo.pViewportState;
+        writer.Write<uint8_t>(viewportState != nullptr);
+        if (viewportState != nullptr)
+        {
+            writer.Write(viewportState->flags);
+            writer.Write(viewportState->viewportCount);
+            writer.Write(viewportState->scissorCount);
+            writer.WriteArray(viewportState->pViewports, viewportState->viewportCount);
+            writer.WriteArray(viewportState->pScissors, viewportState->scissorCount);
+        }
+
+        // these three have no pointers besides pNext and are stored as they are
+        writer.Write<uint8_t>(createInfo.pRasterizationState != nullptr);
+        if (createInfo.pRasterizationState != nullptr)
+        {
+            writer.Write(*createInfo.pRasterizationState);
+        }
+
+        const auto* multisampleState = createInfo.pMultisampleState;
+        writer.Write<uint8_t>(multisampleState != nullptr);
+        if (multisampleState != nullptr)
+        {
+            writer.Write(*multisampleState);
+            writer.WriteArray(multisampleState->pSampleMask, (multisampleState->rasterizationSamples + 31) / 32);
+        }
+
+        writer.Write<uint8_t>(createInfo.pDepthStencilState != nullptr);
+        if (createInfo.pDepthStencilState != nullptr)
+        {
+            writer.Write(*createInfo.pDepthStencilState);
+        }
+
+        const auto* colorBlendState = createInfo.pColorBlendState;
+        writer.Write<uint8_t>(colorBlendState != nullptr);
+        if (colorBlendState != nullptr)
+        {
+            writer.Write(colorBlendState->flags);
+            writer.Write(colorBlendState->logicOpEnable);
+            writer.Write(colorBlendState->logicOp);
+            writer.WriteArray(colorBlendState->pAttachments, colorBlendState->attachmentCount);
+            for (float blendConstant : colorBlendState->blendConstants)
+            {
+                writer.Write(blendConstant);
+            }
+        }
+
+        const auto* dynamicState = createInfo.pDynamicState;
+        writer.Write<uint8_t>(dynamicState != nullptr);
+        if (dynamicState != nullptr)
+        {
+            writer.Write(dynamicState->flags);
+            writer.WriteArray(dynamicState->pDynamicStates, dynamicState->dynamicStateCount);
+        }
+
+        writer.Write(layoutIndex);
+        writer.Write(renderPassIndex);
+        writer.Write(createInfo.subpass);
+
+        AddObject(Object_Graphics_Pipeline, std::move(blob));
+    }
+
+    void VulkanPipelineManifest::RecordComputePipeline(const VkComputePipelineCreateInfo& createInfo)
+    {
+        if (!m_Recording)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        uint32_t layoutIndex = FindIndex(Object_Pipeline_Layout, HandleKey(createInfo.layout));
+        uint32_t moduleIndex = FindIndex(Object_Shader_Module, HandleKey(createInfo.stage.module));
+        if (layoutIndex == s_InvalidIndex || moduleIndex == s_InvalidIndex)
+        {
+            return;
+        }
+
+        std::vector<char> blob;
+        ManifestWriter    writer(blob);
+        writer.Write(createInfo.flags & ~VK_PIPELINE_CREATE_DERIVATIVE_BIT);
+        WriteShaderStage(writer, createInfo.stage, moduleIndex);
+        writer.Write(layoutIndex);
+
+        AddObject(Object_Compute_Pipeline, std::move(blob));
+    }
+
+    void VulkanPipelineManifest::ForgetShaderModule(VkShaderModule shaderModule)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tables[Object_Shader_Module].HandleIndices.erase(HandleKey(shaderModule));
+    }
+
+    void VulkanPipelineManifest::ForgetSampler(VkSampler sampler)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tables[Object_Sampler].HandleIndices.erase(HandleKey(sampler));
+    }
+
+    size_t VulkanPipelineManifest::GetPipelineCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Tables[Object_Graphics_Pipeline].Blobs.size() + m_Tables[Object_Compute_Pipeline].Blobs.size();
+    }
+
+    uint32_t VulkanPipelineManifest::AddObject(ObjectType type, std::vector<char>&& blob)
+    {
+        ObjectTable& table = m_Tables[type];
+        size_t       hash  = std::hash<std::string_view> {}(std::string_view(blob.data(), blob.size()));
+
+        auto it = table.BlobIndices.find(hash);
+        if (it != table.BlobIndices.end() && table.Blobs[it->second] == blob)
+        {
+            return it->second;
+        }
+
+        uint32_t index = static_cast<uint32_t>(table.Blobs.size());
+        table.Blobs.push_back(std::move(blob));
+        table.BlobIndices.emplace(hash, index);
+        m_Dirty = true;
+        return index;
+    }
+
+    void VulkanPipelineManifest::MapHandle(ObjectType type, uint64_t handle, uint32_t index)
+    {
+        m_Tables[type].HandleIndices[handle] = index;
+    }
+
+    uint32_t VulkanPipelineManifest::FindIndex(ObjectType type, uint64_t handle) const
+    {
+        const auto& handleIndices = m_Tables[type].HandleIndices;
+
+        auto it = handleIndices.find(handle);
+        return it != handleIndices.end() ? it->second : s_InvalidIndex;
+    }
+} // namespace Galaxy
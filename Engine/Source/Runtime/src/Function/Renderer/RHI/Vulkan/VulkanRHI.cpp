@@ -5,11 +5,19 @@
 //
 
 #include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanRHI.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanCommandEncoder.h"
 #include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanUtil.h"
+#include "GalaxyEngine/Core/Hash.h"
 #include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Core/Memory/FrameAllocator.h"
+#include "GalaxyEngine/Core/Memory/ScratchArray.h"
 #include "GalaxyEngine/Platform/Common/GLFWWindowSystem.h"
 #include "GalaxyEngine/Platform/Platform.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
 
@@ -54,11 +62,16 @@ namespace Galaxy
 
         CreateLogicalDevice();
 
+        // every buffer and image below is allocated through it, the depth buffer included
+        CreateAssetAllocator();
+
         CreateCommandPool();
 
         CreateCommandBuffers();
 
-        CreateDescriptorPool();
+        CreateDescriptorAllocator();
+
+        CreateBindlessHeap();
 
         CreateSyncPrimitives();
 
@@ -68,13 +81,23 @@ namespace Galaxy
 
         CreateFramebufferImageAndView();
 
-        CreateAssetAllocator();
+        CreateStagingRing();
+
+        CreateUploadQueue();
+
+        CreateDefragmenter();
+
+        CreatePipelineCache();
+
+        CreatePipelineManifest();
+
+        CreateSamplerCache();
     }
 
     void VulkanRHI::PrepareContext()
     {
         VkCurrentCommandBuffer = VkCommandBuffers[CurrentFrameIndex];
-        static_cast<VulkanCommandBuffer*>(CurrentCommandBuffer)->SetResource(VkCurrentCommandBuffer);
+        CurrentCommandBuffer   = CommandBuffers[CurrentFrameIndex];
     }
 
     void VulkanRHI::Clear()
@@ -83,30 +106,131 @@ namespace Galaxy
         {
             DestroyDebugUtilsMessengerEXT(Instance, m_DebugMessenger, nullptr);
         }
+
+        SavePipelineCache();
+        m_PipelineCache.Destroy();
+
+        // the common samplers hold a reference of their own
+        DestroyDefaultSampler(Default_Sampler_Linear);
+        DestroyDefaultSampler(Default_Sampler_Nearest);
+        DestroyMipmappedSampler();
+
+        // whatever is still queued for deletion goes now, including releases not submitted with any frame
+        DeviceTable.vkWaitForFences(Device, MaxFramesInFlight, IsFrameInFlightFences, VK_TRUE, UINT64_MAX);
+        m_DeletionQueue.RetireAll(m_RetiredResources);
+        DestroyRetiredResources(m_RetiredResources);
+        m_SamplerCache.Destroy();
+
+        m_Defragmenter.Destroy();
+        m_UploadQueue.Destroy();
+        m_TransferRing.Destroy();
+        m_StagingRing.Destroy();
+
+        for (std::vector<RHIDescriptorSet>& frameDescriptorSets : m_FrameDescriptorSets)
+        {
+            for (RHIDescriptorSet descriptorSet : frameDescriptorSets)
+            {
+                Resources.Destroy(descriptorSet);
+            }
+            frameDescriptorSets.clear();
+        }
+        m_DescriptorAllocator.Destroy();
+        m_DescriptorUpdater.Destroy();
+
+        if (m_IsBindlessSupported)
+        {
+            Resources.Destroy(m_BindlessSet);
+            Resources.Destroy(m_BindlessSetLayout);
+            m_BindlessHeap.Destroy();
+        }
+
+        size_t liveObjects = Resources.ReportLiveObjects();
+        if (liveObjects > 0)
+        {
+            GAL_CORE_WARN("[VulkanRHI] {0} RHI objects were never destroyed", liveObjects);
+        }
+    }
+
+    void VulkanRHI::SavePipelineCache()
+    {
+        // checkpoint, call it after a batch of pipelines was created, e.g. after loading a level. Merging the thread
+        // caches must not overlap with workers still compiling into them.
+        WaitForPipelineBatches();
+        m_PipelineCache.Save();
+
+        if (m_PipelineManifest.IsRecording())
+        {
+            m_PipelineManifest.Save();
+        }
+    }
+
+    void VulkanRHI::SetPipelineManifestRecording(bool recording) { m_PipelineManifest.SetRecording(recording); }
+
+    uint32_t VulkanRHI::ReplayPipelineManifest()
+    {
+        // replay merges the thread caches when it is done, nothing else may be compiling into them
+        WaitForPipelineBatches();
+        return m_PipelineManifest.Replay(m_PipelineCache);
     }
 
     void VulkanRHI::WaitForFences()
     {
         VkResult result =
-            _vkWaitForFences(Device, 1, &IsFrameInFlightFences[CurrentFrameIndex], VK_TRUE, UINT64_MAX);
+            DeviceTable.vkWaitForFences(Device, 1, &IsFrameInFlightFences[CurrentFrameIndex], VK_TRUE, UINT64_MAX);
 
         VK_CHECK(result, "[VulkanRHI] Failed to synchronize!");
+
+        // The GPU is done with this frame slot, its scratch memory can be handed out again
+        g_RuntimeGlobalContext.FrameAllocSys->BeginFrame(CurrentFrameIndex);
+
+        // and so can its descriptor sets
+        for (RHIDescriptorSet descriptorSet : m_FrameDescriptorSets[CurrentFrameIndex])
+        {
+            Resources.Destroy(descriptorSet);
+        }
+        m_FrameDescriptorSets[CurrentFrameIndex].clear();
+        m_DescriptorAllocator.BeginFrame(CurrentFrameIndex);
+        if (m_IsBindlessSupported)
+        {
+            m_BindlessHeap.BeginFrame(CurrentFrameIndex);
+        }
+
+        // resources released before this slot was last submitted are no longer referenced by any command buffer
+        m_DeletionQueue.Retire(CurrentFrameIndex, m_RetiredResources);
+        DestroyRetiredResources(m_RetiredResources);
+
+        // budgets are refreshed once per frame, VMA caches them in between
+        m_MemoryTracker.BeginFrame();
+
+        // upload batches finish in submission order, most of them are done by now
+        m_StagingRing.Retire();
+
+        // finished streaming uploads are acquired by the graphics queue ahead of this frame
+        m_UploadQueue.Poll();
+
+        // a streamed resource must not move while the transfer queue still writes it
+        if (m_UploadQueue.IsIdle())
+        {
+            m_Defragmenter.Update();
+        }
+
+        PollPipelineBatches();
     }
 
-    bool VulkanRHI::WaitForFences(uint32_t fenceCount, const RHIFence* const* pFences, RHIBool32 waitAll, uint64_t timeout)
+    bool VulkanRHI::WaitForFences(uint32_t fenceCount, const RHIFence* pFences, RHIBool32 waitAll, uint64_t timeout)
     {
         // fence
         int fenceSize = fenceCount;
-        std::vector<VkFence> vkFenceList(fenceSize);
+        ScratchArray<VkFence, 8> vkFenceList(fenceSize);
         for (int i = 0; i < fenceSize; ++i)
         {
             const auto& rhiFenceElement = pFences[i];
             auto& vkFenceElement = vkFenceList[i];
 
-            vkFenceElement = ((VulkanFence*)rhiFenceElement)->GetResource();
+            vkFenceElement = Resources.Get(rhiFenceElement);
         };
 
-        VkResult result = vkWaitForFences(Device, fenceCount, vkFenceList.data(), waitAll, timeout);
+        VkResult result = DeviceTable.vkWaitForFences(Device, fenceCount, vkFenceList.data(), waitAll, timeout);
         VK_CHECK_RETURN_BOOLEAN(result, "aaa")
     }
 
@@ -262,19 +386,22 @@ namespace Galaxy
 
     void VulkanRHI::ResetCommandPool()
     {
-        VkResult result = _vkResetCommandPool(Device, CommandPools[CurrentFrameIndex], 0);
+        VkResult result = DeviceTable.vkResetCommandPool(Device, CommandPools[CurrentFrameIndex], 0);
         VK_CHECK(result, "[VulkanRHI] Failed to synchronize!");
     }
 
     bool VulkanRHI::PrepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
+        // writes queued while updating the frame land before any pass binds their sets
+        m_DescriptorUpdater.Flush();
+
         VkResult result =
-            vkAcquireNextImageKHR(Device,
-                                  Swapchain,
-                                  UINT64_MAX,
-                                  ImageAvailableForRenderSemaphores[CurrentFrameIndex],
-                                  VK_NULL_HANDLE,
-                                  &CurrentSwapchainImageIndex);
+            DeviceTable.vkAcquireNextImageKHR(Device,
+                                              Swapchain,
+                                              UINT64_MAX,
+                                              ImageAvailableForRenderSemaphores[CurrentFrameIndex],
+                                              VK_NULL_HANDLE,
+                                              &CurrentSwapchainImageIndex);
 
         if (VK_ERROR_OUT_OF_DATE_KHR == result)
         {
@@ -299,10 +426,12 @@ namespace Galaxy
             submitInfo.signalSemaphoreCount   = 0;
             submitInfo.pSignalSemaphores      = VK_NULL_HANDLE;
 
-            result = _vkResetFences(Device, 1, &IsFrameInFlightFences[CurrentFrameIndex]);
+            result = DeviceTable.vkResetFences(Device, 1, &IsFrameInFlightFences[CurrentFrameIndex]);
             VK_CHECK(result, "[VulkanRHI] Failed to reset fences!");
 
-            result = vkQueueSubmit(((VulkanQueue*)GraphicsQueue)->GetResource(), 1, &submitInfo, IsFrameInFlightFences[CurrentFrameIndex]);
+            m_DeletionQueue.Submit(CurrentFrameIndex);
+
+            result = DeviceTable.vkQueueSubmit(Resources.Get(GraphicsQueue), 1, &submitInfo, IsFrameInFlightFences[CurrentFrameIndex]);
             if (VK_SUCCESS != result)
             {
                 GAL_CORE_ERROR("[VulkanRHI] Failed to submit queue!");
@@ -327,7 +456,7 @@ namespace Galaxy
         commandBufferBeginInfo.pInheritanceInfo = nullptr;
 
         VkResult resBeginCommandBuffer =
-            _vkBeginCommandBuffer(VkCommandBuffers[CurrentFrameIndex], &commandBufferBeginInfo);
+            DeviceTable.vkBeginCommandBuffer(VkCommandBuffers[CurrentFrameIndex], &commandBufferBeginInfo);
 
         if (VK_SUCCESS != resBeginCommandBuffer)
         {
@@ -340,14 +469,14 @@ namespace Galaxy
     void VulkanRHI::SubmitRendering(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
         // end command buffer
-        VkResult result = _vkEndCommandBuffer(VkCommandBuffers[CurrentFrameIndex]);
+        VkResult result = DeviceTable.vkEndCommandBuffer(VkCommandBuffers[CurrentFrameIndex]);
         if (VK_SUCCESS != result)
         {
             GAL_CORE_ERROR("[VulkanRHI] Failed to end command buffer!");
             return;
         }
 
-        VkSemaphore semaphores[2] = { ((VulkanSemaphore*)ImageAvailableForTexturescopySemaphores[CurrentFrameIndex])->GetResource(),
+        VkSemaphore semaphores[2] = { Resources.Get(ImageAvailableForTexturescopySemaphores[CurrentFrameIndex]),
                                      ImageFinishedForPresentationSemaphores[CurrentFrameIndex] };
 
         // submit command buffer
@@ -362,14 +491,22 @@ namespace Galaxy
         submitInfo.signalSemaphoreCount = 2;
         submitInfo.pSignalSemaphores = semaphores;
 
-        result = _vkResetFences(Device, 1, &IsFrameInFlightFences[CurrentFrameIndex]);
+        result = DeviceTable.vkResetFences(Device, 1, &IsFrameInFlightFences[CurrentFrameIndex]);
 
         if (VK_SUCCESS != result)
         {
             GAL_CORE_ERROR("[VulkanRHI] Failed to reset fences!");
             return;
         }
-        result = vkQueueSubmit(((VulkanQueue*)GraphicsQueue)->GetResource(), 1, &submitInfo, IsFrameInFlightFences[CurrentFrameIndex]);
+
+        // uploads recorded during the frame go first on the same queue, the frame sees their results
+        m_UploadQueue.Submit();
+        m_StagingRing.Submit();
+
+        // released so far means released before this frame was recorded to its end, its fence covers them
+        m_DeletionQueue.Submit(CurrentFrameIndex);
+
+        result = DeviceTable.vkQueueSubmit(Resources.Get(GraphicsQueue), 1, &submitInfo, IsFrameInFlightFences[CurrentFrameIndex]);
 
         if (VK_SUCCESS != result)
         {
@@ -386,7 +523,7 @@ namespace Galaxy
         presentInfo.pSwapchains        = &Swapchain;
         presentInfo.pImageIndices      = &CurrentSwapchainImageIndex;
 
-        result = vkQueuePresentKHR(PresentQueue, &presentInfo);
+        result = DeviceTable.vkQueuePresentKHR(PresentQueue, &presentInfo);
         if (VK_ERROR_OUT_OF_DATE_KHR == result || VK_SUBOPTIMAL_KHR == result)
         {
             RecreateSwapchain();
@@ -404,43 +541,51 @@ namespace Galaxy
         CurrentFrameIndex = (CurrentFrameIndex + 1) % MaxFramesInFlight;
     }
 
-    RHICommandBuffer* VulkanRHI::BeginSingleTimeCommands()
+    RHICommandBuffer VulkanRHI::BeginSingleTimeCommands()
     {
         VkCommandBufferAllocateInfo allocInfo {};
         allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool        = ((VulkanCommandPool*)RhiCommandPool)->GetResource();
+        allocInfo.commandPool        = Resources.Get(RhiCommandPool);
         allocInfo.commandBufferCount = 1;
 
         VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(Device, &allocInfo, &commandBuffer);
+        DeviceTable.vkAllocateCommandBuffers(Device, &allocInfo, &commandBuffer);
 
         VkCommandBufferBeginInfo beginInfo {};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-        _vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        DeviceTable.vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
-        RHICommandBuffer* rhiCommandBuffer = new VulkanCommandBuffer();
-        ((VulkanCommandBuffer*)rhiCommandBuffer)->SetResource(commandBuffer);
-        return rhiCommandBuffer;
+        return Resources.Create<RHICommandBuffer>(commandBuffer);
     }
 
-    void VulkanRHI::EndSingleTimeCommands(RHICommandBuffer* commandBuffer)
+    void VulkanRHI::EndSingleTimeCommands(RHICommandBuffer commandBuffer)
     {
-        VkCommandBuffer vkCommandBuffer = ((VulkanCommandBuffer*)commandBuffer)->GetResource();
-        _vkEndCommandBuffer(vkCommandBuffer);
+        VkCommandBuffer vkCommandBuffer = Resources.Get(commandBuffer);
+        DeviceTable.vkEndCommandBuffer(vkCommandBuffer);
+
+        // the commands may read what was uploaded so far
+        m_StagingRing.Submit();
 
         VkSubmitInfo submitInfo {};
         submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers    = &vkCommandBuffer;
 
-        vkQueueSubmit(((VulkanQueue*)GraphicsQueue)->GetResource(), 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(((VulkanQueue*)GraphicsQueue)->GetResource());
+        // wait for this submission only, not for the frames in flight on the same queue
+        VkFenceCreateInfo fenceCreateInfo {};
+        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        VkFence fence;
+        DeviceTable.vkCreateFence(Device, &fenceCreateInfo, nullptr, &fence);
+        DeviceTable.vkQueueSubmit(Resources.Get(GraphicsQueue), 1, &submitInfo, fence);
+        DeviceTable.vkWaitForFences(Device, 1, &fence, VK_TRUE, UINT64_MAX);
+        DeviceTable.vkDestroyFence(Device, fence, nullptr);
 
-        vkFreeCommandBuffers(Device, ((VulkanCommandPool*)RhiCommandPool)->GetResource(), 1, &vkCommandBuffer);
-        delete(commandBuffer);
+        DeviceTable.vkFreeCommandBuffers(Device, Resources.Get(RhiCommandPool), 1, &vkCommandBuffer);
+        Resources.Destroy(commandBuffer);
     }
 
     // validation layers
@@ -519,7 +664,24 @@ namespace Galaxy
             GAL_CORE_ERROR("[VulkanRHI] Validation layers requested, but not available!");
         }
 
-        m_VulkanApiVersion = VK_API_VERSION_1_1;
+        // 1.1 is the minimum, properties2 and features2 are used as core. A 1.0 loader does not export
+        // vkEnumerateInstanceVersion, so it is looked up rather than linked against.
+        uint32_t instanceVersion          = VK_API_VERSION_1_0;
+        auto     pEnumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+            vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion"));
+        if (pEnumerateInstanceVersion != nullptr)
+        {
+            pEnumerateInstanceVersion(&instanceVersion);
+        }
+        if (instanceVersion < VK_API_VERSION_1_1)
+        {
+            GAL_CORE_ERROR("[VulkanRHI] Vulkan 1.1 is required, the loader only supports {0}.{1}",
+                           VK_API_VERSION_MAJOR(instanceVersion),
+                           VK_API_VERSION_MINOR(instanceVersion));
+        }
+
+        // 1.2 makes descriptor indexing core, loaders too old for it stay on 1.1
+        m_VulkanApiVersion = instanceVersion >= VK_API_VERSION_1_2 ? VK_API_VERSION_1_2 : VK_API_VERSION_1_1;
 
         // app info
         VkApplicationInfo appInfo {};
@@ -659,6 +821,10 @@ namespace Galaxy
         std::set<uint32_t>                   queueFamilies = {QueueIndices.graphicsFamily.value(),
                                                               QueueIndices.presentFamily.value(),
                                                               QueueIndices.computeFamily.value()};
+        if (QueueIndices.transferFamily.has_value())
+        {
+            queueFamilies.insert(QueueIndices.transferFamily.value());
+        }
 
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : queueFamilies) // for every queue family
@@ -672,6 +838,27 @@ namespace Galaxy
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        // a 1.2 instance may still drive a 1.1 device, from here on only what both support is used. Devices below
+        // 1.1 were rejected by IsDeviceSuitable.
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(PhysicalDevice, &physicalDeviceProperties);
+        if (physicalDeviceProperties.apiVersion < m_VulkanApiVersion)
+        {
+            m_VulkanApiVersion = VK_API_VERSION_1_1;
+        }
+
+        // bindless needs descriptor indexing, core since 1.2 and an extension before
+        VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures {};
+        descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        m_IsBindlessSupported            = CheckBindlessSupport(descriptorIndexingFeatures);
+
+        // real heap budgets instead of VMA's estimate, needs get_physical_device_properties2 which 1.1 made core
+        m_IsMemoryBudgetSupported = IsDeviceExtensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (m_IsMemoryBudgetSupported)
+        {
+            m_DeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
         // physical device features
         VkPhysicalDeviceFeatures physicalDeviceFeatures = {};
 
@@ -692,6 +879,7 @@ namespace Galaxy
         // device create info
         VkDeviceCreateInfo deviceCreateInfo {};
         deviceCreateInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceCreateInfo.pNext                   = m_IsBindlessSupported ? &descriptorIndexingFeatures : nullptr;
         deviceCreateInfo.pQueueCreateInfos       = queueCreateInfos.data();
         deviceCreateInfo.queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size());
         deviceCreateInfo.pEnabledFeatures        = &physicalDeviceFeatures;
@@ -702,36 +890,30 @@ namespace Galaxy
         VkResult result = vkCreateDevice(PhysicalDevice, &deviceCreateInfo, nullptr, &Device);
         VK_CHECK(result, "[VulkanRHI] Failed to create device!");
 
+        // every device call after this point goes through the table instead of the loader
+        if (!DeviceTable.Load(Device))
+        {
+            GAL_CORE_ERROR("[VulkanRHI] Failed to load device functions!");
+            abort();
+        }
+
         // initialize queues of this device
         VkQueue vkGraphicsQueue;
-        vkGetDeviceQueue(Device, QueueIndices.graphicsFamily.value(), 0, &vkGraphicsQueue);
-        GraphicsQueue = new VulkanQueue();
-        ((VulkanQueue*)GraphicsQueue)->SetResource(vkGraphicsQueue);
+        DeviceTable.vkGetDeviceQueue(Device, QueueIndices.graphicsFamily.value(), 0, &vkGraphicsQueue);
+        GraphicsQueue = Resources.Create<RHIQueue>(vkGraphicsQueue);
 
-        vkGetDeviceQueue(Device, QueueIndices.presentFamily.value(), 0, &PresentQueue);
+        DeviceTable.vkGetDeviceQueue(Device, QueueIndices.presentFamily.value(), 0, &PresentQueue);
 
         VkQueue vkComputeQueue;
-        vkGetDeviceQueue(Device, QueueIndices.computeFamily.value(), 0, &vkComputeQueue);
-        ComputeQueue = new VulkanQueue();
-        ((VulkanQueue*)ComputeQueue)->SetResource(vkComputeQueue);
-
-        // more efficient pointer
-        _vkResetCommandPool      = (PFN_vkResetCommandPool)vkGetDeviceProcAddr(Device, "vkResetCommandPool");
-        _vkBeginCommandBuffer    = (PFN_vkBeginCommandBuffer)vkGetDeviceProcAddr(Device, "vkBeginCommandBuffer");
-        _vkEndCommandBuffer      = (PFN_vkEndCommandBuffer)vkGetDeviceProcAddr(Device, "vkEndCommandBuffer");
-        _vkCmdBeginRenderPass    = (PFN_vkCmdBeginRenderPass)vkGetDeviceProcAddr(Device, "vkCmdBeginRenderPass");
-        _vkCmdNextSubpass        = (PFN_vkCmdNextSubpass)vkGetDeviceProcAddr(Device, "vkCmdNextSubpass");
-        _vkCmdEndRenderPass      = (PFN_vkCmdEndRenderPass)vkGetDeviceProcAddr(Device, "vkCmdEndRenderPass");
-        _vkCmdBindPipeline       = (PFN_vkCmdBindPipeline)vkGetDeviceProcAddr(Device, "vkCmdBindPipeline");
-        _vkCmdSetViewport        = (PFN_vkCmdSetViewport)vkGetDeviceProcAddr(Device, "vkCmdSetViewport");
-        _vkCmdSetScissor         = (PFN_vkCmdSetScissor)vkGetDeviceProcAddr(Device, "vkCmdSetScissor");
-        _vkWaitForFences         = (PFN_vkWaitForFences)vkGetDeviceProcAddr(Device, "vkWaitForFences");
-        _vkResetFences           = (PFN_vkResetFences)vkGetDeviceProcAddr(Device, "vkResetFences");
-        _vkCmdDrawIndexed        = (PFN_vkCmdDrawIndexed)vkGetDeviceProcAddr(Device, "vkCmdDrawIndexed");
-        _vkCmdBindVertexBuffers  = (PFN_vkCmdBindVertexBuffers)vkGetDeviceProcAddr(Device, "vkCmdBindVertexBuffers");
-        _vkCmdBindIndexBuffer    = (PFN_vkCmdBindIndexBuffer)vkGetDeviceProcAddr(Device, "vkCmdBindIndexBuffer");
-        _vkCmdBindDescriptorSets = (PFN_vkCmdBindDescriptorSets)vkGetDeviceProcAddr(Device, "vkCmdBindDescriptorSets");
-        _vkCmdClearAttachments   = (PFN_vkCmdClearAttachments)vkGetDeviceProcAddr(Device, "vkCmdClearAttachments");
+        DeviceTable.vkGetDeviceQueue(Device, QueueIndices.computeFamily.value(), 0, &vkComputeQueue);
+        ComputeQueue = Resources.Create<RHIQueue>(vkComputeQueue);
+
+        if (QueueIndices.transferFamily.has_value())
+        {
+            VkQueue vkTransferQueue;
+            DeviceTable.vkGetDeviceQueue(Device, QueueIndices.transferFamily.value(), 0, &vkTransferQueue);
+            TransferQueue = Resources.Create<RHIQueue>(vkTransferQueue);
+        }
 
         DepthImageFormat = (RHIFormat)FindDepthFormat();
     }
@@ -740,7 +922,6 @@ namespace Galaxy
     {
         // default graphics command pool
         {
-            RhiCommandPool = new VulkanCommandPool();
             VkCommandPool vkCommandPool;
             VkCommandPoolCreateInfo commandPoolCreateInfo {};
             commandPoolCreateInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -748,10 +929,10 @@ namespace Galaxy
             commandPoolCreateInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
             commandPoolCreateInfo.queueFamilyIndex = QueueIndices.graphicsFamily.value();
 
-            VkResult result = vkCreateCommandPool(Device, &commandPoolCreateInfo, nullptr, &vkCommandPool);
+            VkResult result = DeviceTable.vkCreateCommandPool(Device, &commandPoolCreateInfo, nullptr, &vkCommandPool);
             VK_CHECK(result, "[VulkanRHI] Failed to create command pool!");
 
-            ((VulkanCommandPool*)RhiCommandPool)->SetResource(vkCommandPool);
+            RhiCommandPool = Resources.Create<RHICommandPool>(vkCommandPool);
         }
 
         // other command pools
@@ -764,13 +945,13 @@ namespace Galaxy
 
             for (uint32_t i = 0; i < MaxFramesInFlight; ++i)
             {
-                VkResult result = vkCreateCommandPool(Device, &commandPoolCreateInfo, nullptr, &CommandPools[i]);
+                VkResult result = DeviceTable.vkCreateCommandPool(Device, &commandPoolCreateInfo, nullptr, &CommandPools[i]);
                 VK_CHECK(result, "[VulkanRHI] Failed to create command pool!");
             }
         }
     }
 
-    bool VulkanRHI::CreateCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool* &pCommandPool)
+    bool VulkanRHI::CreateCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool& pCommandPool)
     {
         VkCommandPoolCreateInfo createInfo{};
         createInfo.sType = (VkStructureType)pCreateInfo->sType;
@@ -778,18 +959,17 @@ namespace Galaxy
         createInfo.flags = (VkCommandPoolCreateFlags)pCreateInfo->flags;
         createInfo.queueFamilyIndex = pCreateInfo->queueFamilyIndex;
 
-        pCommandPool = new VulkanCommandPool();
         VkCommandPool vkCommandPool;
-        VkResult result = vkCreateCommandPool(Device, &createInfo, nullptr, &vkCommandPool);
-        ((VulkanCommandPool*)pCommandPool)->SetResource(vkCommandPool);
+        VkResult result = DeviceTable.vkCreateCommandPool(Device, &createInfo, nullptr, &vkCommandPool);
+        pCommandPool = Resources.Create<RHICommandPool>(vkCommandPool);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create command pool!")
     }
 
-    bool VulkanRHI::CreateDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool* & pDescriptorPool)
+    bool VulkanRHI::CreateDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool& pDescriptorPool)
     {
         int size = pCreateInfo->poolSizeCount;
-        std::vector<VkDescriptorPoolSize> descriptorPoolSize(size);
+        ScratchArray<VkDescriptorPoolSize, 16> descriptorPoolSize(size);
         for (int i = 0; i < size; ++i)
         {
             const auto& rhiDesc = pCreateInfo->pPoolSizes[i];
@@ -807,19 +987,18 @@ namespace Galaxy
         createInfo.poolSizeCount = pCreateInfo->poolSizeCount;
         createInfo.pPoolSizes = descriptorPoolSize.data();
 
-        pDescriptorPool = new VulkanDescriptorPool();
         VkDescriptorPool vkDescriptorPool;
-        VkResult result = vkCreateDescriptorPool(Device, &createInfo, nullptr, &vkDescriptorPool);
-        ((VulkanDescriptorPool*)pDescriptorPool)->SetResource(vkDescriptorPool);
+        VkResult result = DeviceTable.vkCreateDescriptorPool(Device, &createInfo, nullptr, &vkDescriptorPool);
+        pDescriptorPool = Resources.Create<RHIDescriptorPool>(vkDescriptorPool);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create descriptor pool!")
     }
 
-    bool VulkanRHI::CreateDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout)
+    bool VulkanRHI::CreateDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout& pSetLayout)
     {
         //descriptor_set_layout_binding
         int descriptorSetLayoutBindingSize = pCreateInfo->bindingCount;
-        std::vector<VkDescriptorSetLayoutBinding> vkDescriptorSetLayoutBindingList(descriptorSetLayoutBindingSize);
+        ScratchArray<VkDescriptorSetLayoutBinding, 16> vkDescriptorSetLayoutBindingList(descriptorSetLayoutBindingSize);
 
         int samplerCount = 0;
         for (int i = 0; i < descriptorSetLayoutBindingSize; ++i)
@@ -830,7 +1009,7 @@ namespace Galaxy
                 samplerCount += rhiDescriptorSetLayoutBindingElement.descriptorCount;
             }
         }
-        std::vector<VkSampler> samplerList(samplerCount);
+        ScratchArray<VkSampler, 16> samplerList(samplerCount);
         int samplerCurrent = 0;
 
         for (int i = 0; i < descriptorSetLayoutBindingSize; ++i)
@@ -848,7 +1027,7 @@ namespace Galaxy
                     const auto& rhiSamplerElement = rhiDescriptorSetLayoutBindingElement.pImmutableSamplers[i];
                     auto& vkSamplerElement = samplerList[samplerCurrent];
 
-                    vkSamplerElement = ((VulkanSampler*)rhiSamplerElement)->GetResource();
+                    vkSamplerElement = Resources.Get(rhiSamplerElement);
 
                     samplerCurrent++;
                 };
@@ -872,461 +1051,780 @@ namespace Galaxy
         createInfo.bindingCount = pCreateInfo->bindingCount;
         createInfo.pBindings = vkDescriptorSetLayoutBindingList.data();
 
-        pSetLayout = new VulkanDescriptorSetLayout();
         VkDescriptorSetLayout vkDescriptorSetLayout;
-        VkResult result = vkCreateDescriptorSetLayout(Device, &createInfo, nullptr, &vkDescriptorSetLayout);
-        ((VulkanDescriptorSetLayout*)pSetLayout)->SetResource(vkDescriptorSetLayout);
+        VkResult result = DeviceTable.vkCreateDescriptorSetLayout(Device, &createInfo, nullptr, &vkDescriptorSetLayout);
+        pSetLayout = Resources.Create<RHIDescriptorSetLayout>(vkDescriptorSetLayout);
+        if (result == VK_SUCCESS)
+        {
+            m_PipelineManifest.RecordDescriptorSetLayout(vkDescriptorSetLayout, createInfo);
+        }
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create descriptor layout!")
     }
 
-    bool VulkanRHI::CreateFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence* &pFence)
+    bool VulkanRHI::CreateDescriptorUpdateTemplate(const RHIDescriptorUpdateTemplateCreateInfo* pCreateInfo,
+                                                   RHIDescriptorUpdateTemplate&                 pUpdateTemplate)
+    {
+        return m_DescriptorUpdater.CreateTemplate(*pCreateInfo, pUpdateTemplate);
+    }
+
+    bool VulkanRHI::CreateFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence& pFence)
     {
         VkFenceCreateInfo createInfo{};
         createInfo.sType = (VkStructureType)pCreateInfo->sType;
         createInfo.pNext = (const void*)pCreateInfo->pNext;
         createInfo.flags = (VkFenceCreateFlags)pCreateInfo->flags;
 
-        pFence = new VulkanFence();
         VkFence vkFence;
-        VkResult result = vkCreateFence(Device, &createInfo, nullptr, &vkFence);
-        ((VulkanFence*)pFence)->SetResource(vkFence);
+        VkResult result = DeviceTable.vkCreateFence(Device, &createInfo, nullptr, &vkFence);
+        pFence = Resources.Create<RHIFence>(vkFence);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create fence!")
     }
 
-    bool VulkanRHI::CreateFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer)
+    bool VulkanRHI::CreateFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer& pFramebuffer)
     {
         //image_view
         int imageViewSize = pCreateInfo->attachmentCount;
-        std::vector<VkImageView> vkImageViewList(imageViewSize);
+        ScratchArray<VkImageView, 8> vkImageViewList(imageViewSize);
         for (int i = 0; i < imageViewSize; ++i)
         {
             const auto& rhiImageViewElement = pCreateInfo->pAttachments[i];
             auto& vkImageViewElement = vkImageViewList[i];
 
-            vkImageViewElement = ((VulkanImageView*)rhiImageViewElement)->GetResource();
+            vkImageViewElement = Resources.Get(rhiImageViewElement);
         };
 
         VkFramebufferCreateInfo createInfo{};
         createInfo.sType = (VkStructureType)pCreateInfo->sType;
         createInfo.pNext = (const void*)pCreateInfo->pNext;
         createInfo.flags = (VkFramebufferCreateFlags)pCreateInfo->flags;
-        createInfo.renderPass = ((VulkanRenderPass*)pCreateInfo->renderPass)->GetResource();
+        createInfo.renderPass = Resources.Get(pCreateInfo->renderPass);
         createInfo.attachmentCount = pCreateInfo->attachmentCount;
         createInfo.pAttachments = vkImageViewList.data();
         createInfo.width = pCreateInfo->width;
         createInfo.height = pCreateInfo->height;
         createInfo.layers = pCreateInfo->layers;
 
-        pFramebuffer = new VulkanFramebuffer();
         VkFramebuffer vkFramebuffer;
-        VkResult result = vkCreateFramebuffer(Device, &createInfo, nullptr, &vkFramebuffer);
-        ((VulkanFramebuffer*)pFramebuffer)->SetResource(vkFramebuffer);
+        VkResult result = DeviceTable.vkCreateFramebuffer(Device, &createInfo, nullptr, &vkFramebuffer);
+        pFramebuffer = Resources.Create<RHIFramebuffer>(vkFramebuffer);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create framebuffer!")
     }
 
-    bool VulkanRHI::CreateGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfo, RHIPipeline* &pPipelines)
+    template<typename T>
+    static T* AllocateVkArray(LinearArena& arena, size_t count)
     {
-        //pipeline_shader_stage_create_info
-        int pipelineShaderStageCreateInfoSize = pCreateInfo->stageCount;
-        std::vector<VkPipelineShaderStageCreateInfo> vkPipelineShaderStageCreateInfoList(pipelineShaderStageCreateInfoSize);
+        T* data = arena.AllocateArray<T>(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (&data[i]) T {};
+        }
+        return data;
+    }
 
-        int specializationMapEntrySizeTotal = 0;
-        int specializationInfoTotal = 0;
-        for (int i = 0; i < pipelineShaderStageCreateInfoSize; ++i)
+    static const void* CopyToArena(LinearArena& arena, const void* data, size_t size)
+    {
+        if (data == nullptr)
         {
-            const auto& rhiPipelineShaderStageCreateInfoElement = pCreateInfo->pStages[i];
-            if (rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo != nullptr)
+            return nullptr;
+        }
+
+        void* copy = arena.Allocate(size);
+        std::memcpy(copy, data, size);
+        return copy;
+    }
+
+    static void TranslateShaderStage(const VulkanResources&                  resources,
+                                     const RHIPipelineShaderStageCreateInfo& rhiStage,
+                                     VkPipelineShaderStageCreateInfo&        vkStage,
+                                     LinearArena&                            arena)
+    {
+        vkStage.sType  = (VkStructureType)rhiStage.sType;
+        vkStage.pNext  = (const void*)rhiStage.pNext;
+        vkStage.flags  = (VkPipelineShaderStageCreateFlags)rhiStage.flags;
+        vkStage.stage  = (VkShaderStageFlagBits)rhiStage.stage;
+        vkStage.module = resources.Get(rhiStage.module);
+        vkStage.pName  = (const char*)CopyToArena(arena, rhiStage.pName, std::strlen(rhiStage.pName) + 1);
+
+        const RHISpecializationInfo* rhiSpecializationInfo = rhiStage.pSpecializationInfo;
+        if (rhiSpecializationInfo == nullptr)
+        {
+            vkStage.pSpecializationInfo = nullptr;
+            return;
+        }
+
+        auto* vkMapEntries = AllocateVkArray<VkSpecializationMapEntry>(arena, rhiSpecializationInfo->mapEntryCount);
+        for (uint32_t i = 0; i < rhiSpecializationInfo->mapEntryCount; ++i)
+        {
+            vkMapEntries[i].constantID = rhiSpecializationInfo->pMapEntries[i]->constantID;
+            vkMapEntries[i].offset     = rhiSpecializationInfo->pMapEntries[i]->offset;
+            vkMapEntries[i].size       = rhiSpecializationInfo->pMapEntries[i]->size;
+        }
+
+        auto* vkSpecializationInfo          = AllocateVkArray<VkSpecializationInfo>(arena, 1);
+        vkSpecializationInfo->mapEntryCount = rhiSpecializationInfo->mapEntryCount;
+        vkSpecializationInfo->pMapEntries   = vkMapEntries;
+        vkSpecializationInfo->dataSize      = rhiSpecializationInfo->dataSize;
+        vkSpecializationInfo->pData =
+            CopyToArena(arena, rhiSpecializationInfo->pData, rhiSpecializationInfo->dataSize);
+        vkStage.pSpecializationInfo         = vkSpecializationInfo;
+    }
+
+    static VkStencilOpState TranslateStencilOpState(const RHIStencilOpState& rhiState)
+    {
+        VkStencilOpState vkState {};
+        vkState.failOp      = (VkStencilOp)rhiState.failOp;
+        vkState.passOp      = (VkStencilOp)rhiState.passOp;
+        vkState.depthFailOp = (VkStencilOp)rhiState.depthFailOp;
+        vkState.compareOp   = (VkCompareOp)rhiState.compareOp;
+        vkState.compareMask = rhiState.compareMask;
+        vkState.writeMask   = rhiState.writeMask;
+        vkState.reference   = rhiState.reference;
+        return vkState;
+    }
+
+    // Fills vkCreateInfo, every array and string it points to is copied into arena and lives as long as the arena
+    // does. pNext chains are opaque and passed through as they are.
+    static void TranslateGraphicsPipelineCreateInfo(const VulkanResources&               resources,
+                                                    const RHIGraphicsPipelineCreateInfo& rhiCreateInfo,
+                                                    VkGraphicsPipelineCreateInfo&        vkCreateInfo,
+                                                    LinearArena&                         arena)
+    {
+        //shader_stage
+        auto* vkStages = AllocateVkArray<VkPipelineShaderStageCreateInfo>(arena, rhiCreateInfo.stageCount);
+        for (uint32_t i = 0; i < rhiCreateInfo.stageCount; ++i)
+        {
+            TranslateShaderStage(resources, rhiCreateInfo.pStages[i], vkStages[i], arena);
+        }
+
+        //vertex_input
+        VkPipelineVertexInputStateCreateInfo* vkVertexInputState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pVertexInputState; rhiState != nullptr)
+        {
+            auto* vkBindings =
+                AllocateVkArray<VkVertexInputBindingDescription>(arena, rhiState->vertexBindingDescriptionCount);
+            for (uint32_t i = 0; i < rhiState->vertexBindingDescriptionCount; ++i)
             {
-                specializationInfoTotal++;
-                specializationMapEntrySizeTotal+= rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo->mapEntryCount;
+                vkBindings[i].binding   = rhiState->pVertexBindingDescriptions[i].binding;
+                vkBindings[i].stride    = rhiState->pVertexBindingDescriptions[i].stride;
+                vkBindings[i].inputRate = (VkVertexInputRate)rhiState->pVertexBindingDescriptions[i].inputRate;
             }
+
+            auto* vkAttributes =
+                AllocateVkArray<VkVertexInputAttributeDescription>(arena, rhiState->vertexAttributeDescriptionCount);
+            for (uint32_t i = 0; i < rhiState->vertexAttributeDescriptionCount; ++i)
+            {
+                vkAttributes[i].location = rhiState->pVertexAttributeDescriptions[i].location;
+                vkAttributes[i].binding  = rhiState->pVertexAttributeDescriptions[i].binding;
+                vkAttributes[i].format   = (VkFormat)rhiState->pVertexAttributeDescriptions[i].format;
+                vkAttributes[i].offset   = rhiState->pVertexAttributeDescriptions[i].offset;
+            }
+
+            vkVertexInputState        = AllocateVkArray<VkPipelineVertexInputStateCreateInfo>(arena, 1);
+            vkVertexInputState->sType = (VkStructureType)rhiState->sType;
+            vkVertexInputState->pNext = (const void*)rhiState->pNext;
+            vkVertexInputState->flags = (VkPipelineVertexInputStateCreateFlags)rhiState->flags;
+            vkVertexInputState->vertexBindingDescriptionCount   = rhiState->vertexBindingDescriptionCount;
+            vkVertexInputState->pVertexBindingDescriptions      = vkBindings;
+            vkVertexInputState->vertexAttributeDescriptionCount = rhiState->vertexAttributeDescriptionCount;
+            vkVertexInputState->pVertexAttributeDescriptions    = vkAttributes;
         }
-        std::vector<VkSpecializationInfo> vkSpecializationInfoList(specializationInfoTotal);
-        std::vector<VkSpecializationMapEntry> vkSpecializationMapEntryList(specializationMapEntrySizeTotal);
-        int specializationMapEntryCurrent = 0;
-        int specializationInfoCurrent = 0;
 
-        for (int i = 0; i < pipelineShaderStageCreateInfoSize; ++i)
+        //input_assembly
+        VkPipelineInputAssemblyStateCreateInfo* vkInputAssemblyState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pInputAssemblyState; rhiState != nullptr)
         {
-            const auto& rhiPipelineShaderStageCreateInfoElement = pCreateInfo->pStages[i];
-            auto& vkPipelineShaderStageCreateInfoElement = vkPipelineShaderStageCreateInfoList[i];
+            vkInputAssemblyState           = AllocateVkArray<VkPipelineInputAssemblyStateCreateInfo>(arena, 1);
+            vkInputAssemblyState->sType    = (VkStructureType)rhiState->sType;
+            vkInputAssemblyState->pNext    = (const void*)rhiState->pNext;
+            vkInputAssemblyState->flags    = (VkPipelineInputAssemblyStateCreateFlags)rhiState->flags;
+            vkInputAssemblyState->topology = (VkPrimitiveTopology)rhiState->topology;
+            vkInputAssemblyState->primitiveRestartEnable = (VkBool32)rhiState->primitiveRestartEnable;
+        }
+
+        //tessellation
+        VkPipelineTessellationStateCreateInfo* vkTessellationState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pTessellationState; rhiState != nullptr)
+        {
+            vkTessellationState                     = AllocateVkArray<VkPipelineTessellationStateCreateInfo>(arena, 1);
+            vkTessellationState->sType              = (VkStructureType)rhiState->sType;
+            vkTessellationState->pNext              = (const void*)rhiState->pNext;
+            vkTessellationState->flags              = (VkPipelineTessellationStateCreateFlags)rhiState->flags;
+            vkTessellationState->patchControlPoints = rhiState->patchControlPoints;
+        }
 
-            if (rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo != nullptr)
+        //viewport
+        VkPipelineViewportStateCreateInfo* vkViewportState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pViewportState; rhiState != nullptr)
+        {
+            VkViewport* vkViewports = nullptr;
+            if (rhiState->pViewports != nullptr)
             {
-                vkPipelineShaderStageCreateInfoElement.pSpecializationInfo = &vkSpecializationInfoList[specializationInfoCurrent];
+                vkViewports = AllocateVkArray<VkViewport>(arena, rhiState->viewportCount);
+                for (uint32_t i = 0; i < rhiState->viewportCount; ++i)
+                {
+                    vkViewports[i].x        = rhiState->pViewports[i].x;
+                    vkViewports[i].y        = rhiState->pViewports[i].y;
+                    vkViewports[i].width    = rhiState->pViewports[i].width;
+                    vkViewports[i].height   = rhiState->pViewports[i].height;
+                    vkViewports[i].minDepth = rhiState->pViewports[i].minDepth;
+                    vkViewports[i].maxDepth = rhiState->pViewports[i].maxDepth;
+                }
+            }
 
-                VkSpecializationInfo vkSpecializationInfo{};
-                vkSpecializationInfo.mapEntryCount = rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo->mapEntryCount;
-                vkSpecializationInfo.pMapEntries = &vkSpecializationMapEntryList[specializationMapEntryCurrent];
-                vkSpecializationInfo.dataSize = rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo->dataSize;
-                vkSpecializationInfo.pData = (const void*)rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo->pData;
+            VkRect2D* vkScissors = nullptr;
+            if (rhiState->pScissors != nullptr)
+            {
+                vkScissors = AllocateVkArray<VkRect2D>(arena, rhiState->scissorCount);
+                for (uint32_t i = 0; i < rhiState->scissorCount; ++i)
+                {
+                    vkScissors[i].offset.x      = rhiState->pScissors[i].offset.x;
+                    vkScissors[i].offset.y      = rhiState->pScissors[i].offset.y;
+                    vkScissors[i].extent.width  = rhiState->pScissors[i].extent.width;
+                    vkScissors[i].extent.height = rhiState->pScissors[i].extent.height;
+                }
+            }
 
-                //specialization_map_entry
-                for (int i = 0; i < rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo->mapEntryCount; ++i)
+            vkViewportState                = AllocateVkArray<VkPipelineViewportStateCreateInfo>(arena, 1);
+            vkViewportState->sType         = (VkStructureType)rhiState->sType;
+            vkViewportState->pNext         = (const void*)rhiState->pNext;
+            vkViewportState->flags         = (VkPipelineViewportStateCreateFlags)rhiState->flags;
+            vkViewportState->viewportCount = rhiState->viewportCount;
+            vkViewportState->pViewports    = vkViewports;
+            vkViewportState->scissorCount  = rhiState->scissorCount;
+            vkViewportState->pScissors     = vkScissors;
+        }
+
+        //rasterization
+        VkPipelineRasterizationStateCreateInfo* vkRasterizationState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pRasterizationState; rhiState != nullptr)
+        {
+            vkRasterizationState = AllocateVkArray<VkPipelineRasterizationStateCreateInfo>(arena, 1);
+            vkRasterizationState->sType                   = (VkStructureType)rhiState->sType;
+            vkRasterizationState->pNext                   = (const void*)rhiState->pNext;
+            vkRasterizationState->flags                   = (VkPipelineRasterizationStateCreateFlags)rhiState->flags;
+            vkRasterizationState->depthClampEnable        = (VkBool32)rhiState->depthClampEnable;
+            vkRasterizationState->rasterizerDiscardEnable = (VkBool32)rhiState->rasterizerDiscardEnable;
+            vkRasterizationState->polygonMode             = (VkPolygonMode)rhiState->polygonMode;
+            vkRasterizationState->cullMode                = (VkCullModeFlags)rhiState->cullMode;
+            vkRasterizationState->frontFace               = (VkFrontFace)rhiState->frontFace;
+            vkRasterizationState->depthBiasEnable         = (VkBool32)rhiState->depthBiasEnable;
+            vkRasterizationState->depthBiasConstantFactor = rhiState->depthBiasConstantFactor;
+            vkRasterizationState->depthBiasClamp          = rhiState->depthBiasClamp;
+            vkRasterizationState->depthBiasSlopeFactor    = rhiState->depthBiasSlopeFactor;
+            vkRasterizationState->lineWidth               = rhiState->lineWidth;
+        }
+
+        //multisample
+        VkPipelineMultisampleStateCreateInfo* vkMultisampleState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pMultisampleState; rhiState != nullptr)
+        {
+            // one mask word per 32 samples, the RHI passes them as an array of pointers like pMapEntries
+            VkSampleMask* vkSampleMask = nullptr;
+            if (rhiState->pSampleMask != nullptr)
+            {
+                uint32_t sampleMaskCount = (rhiState->rasterizationSamples + 31) / 32;
+                vkSampleMask             = AllocateVkArray<VkSampleMask>(arena, sampleMaskCount);
+                for (uint32_t i = 0; i < sampleMaskCount; ++i)
                 {
-                    const auto& rhiSpecializationMapEntryElement = rhiPipelineShaderStageCreateInfoElement.pSpecializationInfo->pMapEntries[i];
-                    auto& vkSpecializationMapEntryElement = vkSpecializationMapEntryList[specializationMapEntryCurrent];
+                    vkSampleMask[i] = *rhiState->pSampleMask[i];
+                }
+            }
 
-                    vkSpecializationMapEntryElement.constantID = rhiSpecializationMapEntryElement->constantID;
-                    vkSpecializationMapEntryElement.offset = rhiSpecializationMapEntryElement->offset;
-                    vkSpecializationMapEntryElement.size = rhiSpecializationMapEntryElement->size;
+            vkMultisampleState                        = AllocateVkArray<VkPipelineMultisampleStateCreateInfo>(arena, 1);
+            vkMultisampleState->sType                 = (VkStructureType)rhiState->sType;
+            vkMultisampleState->pNext                 = (const void*)rhiState->pNext;
+            vkMultisampleState->flags                 = (VkPipelineMultisampleStateCreateFlags)rhiState->flags;
+            vkMultisampleState->rasterizationSamples  = (VkSampleCountFlagBits)rhiState->rasterizationSamples;
+            vkMultisampleState->sampleShadingEnable   = (VkBool32)rhiState->sampleShadingEnable;
+            vkMultisampleState->minSampleShading      = rhiState->minSampleShading;
+            vkMultisampleState->pSampleMask           = vkSampleMask;
+            vkMultisampleState->alphaToCoverageEnable = (VkBool32)rhiState->alphaToCoverageEnable;
+            vkMultisampleState->alphaToOneEnable      = (VkBool32)rhiState->alphaToOneEnable;
+        }
+
+        //depth_stencil
+        VkPipelineDepthStencilStateCreateInfo* vkDepthStencilState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pDepthStencilState; rhiState != nullptr)
+        {
+            vkDepthStencilState = AllocateVkArray<VkPipelineDepthStencilStateCreateInfo>(arena, 1);
+            vkDepthStencilState->sType                 = (VkStructureType)rhiState->sType;
+            vkDepthStencilState->pNext                 = (const void*)rhiState->pNext;
+            vkDepthStencilState->flags                 = (VkPipelineDepthStencilStateCreateFlags)rhiState->flags;
+            vkDepthStencilState->depthTestEnable       = (VkBool32)rhiState->depthTestEnable;
+            vkDepthStencilState->depthWriteEnable      = (VkBool32)rhiState->depthWriteEnable;
+            vkDepthStencilState->depthCompareOp        = (VkCompareOp)rhiState->depthCompareOp;
+            vkDepthStencilState->depthBoundsTestEnable = (VkBool32)rhiState->depthBoundsTestEnable;
+            vkDepthStencilState->stencilTestEnable     = (VkBool32)rhiState->stencilTestEnable;
+            vkDepthStencilState->front                 = TranslateStencilOpState(rhiState->front);
+            vkDepthStencilState->back                  = TranslateStencilOpState(rhiState->back);
+            vkDepthStencilState->minDepthBounds        = rhiState->minDepthBounds;
+            vkDepthStencilState->maxDepthBounds        = rhiState->maxDepthBounds;
+        }
+
+        //color_blend
+        VkPipelineColorBlendStateCreateInfo* vkColorBlendState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pColorBlendState; rhiState != nullptr)
+        {
+            auto* vkAttachments =
+                AllocateVkArray<VkPipelineColorBlendAttachmentState>(arena, rhiState->attachmentCount);
+            for (uint32_t i = 0; i < rhiState->attachmentCount; ++i)
+            {
+                const auto& rhiAttachment = rhiState->pAttachments[i];
+                auto&       vkAttachment  = vkAttachments[i];
+
+                vkAttachment.blendEnable         = (VkBool32)rhiAttachment.blendEnable;
+                vkAttachment.srcColorBlendFactor = (VkBlendFactor)rhiAttachment.srcColorBlendFactor;
+                vkAttachment.dstColorBlendFactor = (VkBlendFactor)rhiAttachment.dstColorBlendFactor;
+                vkAttachment.colorBlendOp        = (VkBlendOp)rhiAttachment.colorBlendOp;
+                vkAttachment.srcAlphaBlendFactor = (VkBlendFactor)rhiAttachment.srcAlphaBlendFactor;
+                vkAttachment.dstAlphaBlendFactor = (VkBlendFactor)rhiAttachment.dstAlphaBlendFactor;
+                vkAttachment.alphaBlendOp        = (VkBlendOp)rhiAttachment.alphaBlendOp;
+                vkAttachment.colorWriteMask      = (VkColorComponentFlags)rhiAttachment.colorWriteMask;
+            }
 
-                    specializationMapEntryCurrent++;
-                };
+            vkColorBlendState                  = AllocateVkArray<VkPipelineColorBlendStateCreateInfo>(arena, 1);
+            vkColorBlendState->sType           = (VkStructureType)rhiState->sType;
+            vkColorBlendState->pNext           = rhiState->pNext;
+            vkColorBlendState->flags           = rhiState->flags;
+            vkColorBlendState->logicOpEnable   = rhiState->logicOpEnable;
+            vkColorBlendState->logicOp         = (VkLogicOp)rhiState->logicOp;
+            vkColorBlendState->attachmentCount = rhiState->attachmentCount;
+            vkColorBlendState->pAttachments    = vkAttachments;
+            for (int i = 0; i < 4; ++i)
+            {
+                vkColorBlendState->blendConstants[i] = rhiState->blendConstants[i];
+            }
+        }
 
-                specializationInfoCurrent++;
+        //dynamic_state
+        VkPipelineDynamicStateCreateInfo* vkDynamicState = nullptr;
+        if (const auto* rhiState = rhiCreateInfo.pDynamicState; rhiState != nullptr)
+        {
+            auto* vkDynamicStates = AllocateVkArray<VkDynamicState>(arena, rhiState->dynamicStateCount);
+            for (uint32_t i = 0; i < rhiState->dynamicStateCount; ++i)
+            {
+                vkDynamicStates[i] = (VkDynamicState)rhiState->pDynamicStates[i];
             }
-            else
+
+            vkDynamicState                    = AllocateVkArray<VkPipelineDynamicStateCreateInfo>(arena, 1);
+            vkDynamicState->sType             = (VkStructureType)rhiState->sType;
+            vkDynamicState->pNext             = rhiState->pNext;
+            vkDynamicState->flags             = (VkPipelineDynamicStateCreateFlags)rhiState->flags;
+            vkDynamicState->dynamicStateCount = rhiState->dynamicStateCount;
+            vkDynamicState->pDynamicStates    = vkDynamicStates;
+        }
+
+        vkCreateInfo                     = {};
+        vkCreateInfo.sType               = (VkStructureType)rhiCreateInfo.sType;
+        vkCreateInfo.pNext               = (const void*)rhiCreateInfo.pNext;
+        vkCreateInfo.flags               = (VkPipelineCreateFlags)rhiCreateInfo.flags;
+        vkCreateInfo.stageCount          = rhiCreateInfo.stageCount;
+        vkCreateInfo.pStages             = vkStages;
+        vkCreateInfo.pVertexInputState   = vkVertexInputState;
+        vkCreateInfo.pInputAssemblyState = vkInputAssemblyState;
+        vkCreateInfo.pTessellationState  = vkTessellationState;
+        vkCreateInfo.pViewportState      = vkViewportState;
+        vkCreateInfo.pRasterizationState = vkRasterizationState;
+        vkCreateInfo.pMultisampleState   = vkMultisampleState;
+        vkCreateInfo.pDepthStencilState  = vkDepthStencilState;
+        vkCreateInfo.pColorBlendState    = vkColorBlendState;
+        vkCreateInfo.pDynamicState       = vkDynamicState;
+        vkCreateInfo.layout              = resources.Get(rhiCreateInfo.layout);
+        vkCreateInfo.renderPass          = resources.Get(rhiCreateInfo.renderPass);
+        vkCreateInfo.subpass             = rhiCreateInfo.subpass;
+        vkCreateInfo.basePipelineHandle  = resources.Get(rhiCreateInfo.basePipelineHandle);
+        vkCreateInfo.basePipelineIndex   = rhiCreateInfo.basePipelineIndex;
+    }
+
+    static void TranslateComputePipelineCreateInfo(const VulkanResources&              resources,
+                                                   const RHIComputePipelineCreateInfo& rhiCreateInfo,
+                                                   VkComputePipelineCreateInfo&        vkCreateInfo,
+                                                   LinearArena&                        arena)
+    {
+        vkCreateInfo       = {};
+        vkCreateInfo.sType = (VkStructureType)rhiCreateInfo.sType;
+        vkCreateInfo.pNext = (const void*)rhiCreateInfo.pNext;
+        vkCreateInfo.flags = (VkPipelineCreateFlags)rhiCreateInfo.flags;
+        TranslateShaderStage(resources, *rhiCreateInfo.pStages, vkCreateInfo.stage, arena);
+        vkCreateInfo.layout             = resources.Get(rhiCreateInfo.layout);
+        vkCreateInfo.basePipelineHandle = resources.Get(rhiCreateInfo.basePipelineHandle);
+        vkCreateInfo.basePipelineIndex  = rhiCreateInfo.basePipelineIndex;
+    }
+
+    // Async creation outlives the caller's create infos and pNext chains cannot be copied without knowing every
+    // structure in them, so chains are not accepted there.
+    static bool HasNextChain(const RHIPipelineShaderStageCreateInfo& rhiStage) { return rhiStage.pNext != nullptr; }
+
+    static bool HasNextChain(const RHIGraphicsPipelineCreateInfo& rhiCreateInfo)
+    {
+        for (uint32_t i = 0; i < rhiCreateInfo.stageCount; ++i)
+        {
+            if (HasNextChain(rhiCreateInfo.pStages[i]))
             {
-                vkPipelineShaderStageCreateInfoElement.pSpecializationInfo = nullptr;
+                return true;
             }
-            vkPipelineShaderStageCreateInfoElement.sType = (VkStructureType)rhiPipelineShaderStageCreateInfoElement.sType;
-            vkPipelineShaderStageCreateInfoElement.pNext = (const void*)rhiPipelineShaderStageCreateInfoElement.pNext;
-            vkPipelineShaderStageCreateInfoElement.flags = (VkPipelineShaderStageCreateFlags)rhiPipelineShaderStageCreateInfoElement.flags;
-            vkPipelineShaderStageCreateInfoElement.stage = (VkShaderStageFlagBits)rhiPipelineShaderStageCreateInfoElement.stage;
-            vkPipelineShaderStageCreateInfoElement.module = ((VulkanShader*)rhiPipelineShaderStageCreateInfoElement.module)->GetResource();
-            vkPipelineShaderStageCreateInfoElement.pName = rhiPipelineShaderStageCreateInfoElement.pName;
-        };
+        }
+
+        auto hasNext = [](const auto* rhiState) { return rhiState != nullptr && rhiState->pNext != nullptr; };
+        return rhiCreateInfo.pNext != nullptr || hasNext(rhiCreateInfo.pVertexInputState) ||
+               hasNext(rhiCreateInfo.pInputAssemblyState) || hasNext(rhiCreateInfo.pTessellationState) ||
+               hasNext(rhiCreateInfo.pViewportState) || hasNext(rhiCreateInfo.pRasterizationState) ||
+               hasNext(rhiCreateInfo.pMultisampleState) || hasNext(rhiCreateInfo.pDepthStencilState) ||
+               hasNext(rhiCreateInfo.pColorBlendState) || hasNext(rhiCreateInfo.pDynamicState);
+    }
 
-        if ((specializationMapEntrySizeTotal != specializationMapEntryCurrent)
-              || (specializationInfoTotal != specializationInfoCurrent))
+    static bool HasNextChain(const RHIComputePipelineCreateInfo& rhiCreateInfo)
+    {
+        return rhiCreateInfo.pNext != nullptr || HasNextChain(*rhiCreateInfo.pStages);
+    }
+
+    bool VulkanRHI::CreateGraphicsPipelines(RHIPipelineCache                     pipelineCache,
+                                            uint32_t                             createInfoCount,
+                                            const RHIGraphicsPipelineCreateInfo* pCreateInfos,
+                                            RHIPipeline*                         pPipelines)
+    {
+        LinearArena&      arena = GetThreadScratchArena();
+        ScopedArenaMarker arenaMarker(arena);
+
+        auto* vkCreateInfos = AllocateVkArray<VkGraphicsPipelineCreateInfo>(arena, createInfoCount);
+        for (uint32_t i = 0; i < createInfoCount; ++i)
         {
-            GAL_CORE_ERROR("[VulkanRHI] (specialization_map_entry_size_total == specialization_map_entry_current)&& (specialization_info_total == specialization_info_current)");
-            return false;
+            TranslateGraphicsPipelineCreateInfo(Resources, pCreateInfos[i], vkCreateInfos[i], arena);
+            m_PipelineManifest.RecordGraphicsPipeline(vkCreateInfos[i]);
         }
 
-        //vertex_input_binding_description
-        int vertexInputBindingDescriptionSize = pCreateInfo->pVertexInputState->vertexBindingDescriptionCount;
-        std::vector<VkVertexInputBindingDescription> vkVertexInputBindingDescriptionList(vertexInputBindingDescriptionSize);
-        for (int i = 0; i < vertexInputBindingDescriptionSize; ++i)
+        VkPipelineCache vkPipelineCache = m_PipelineCache.GetThreadCache();
+        if (pipelineCache != nullptr)
         {
-            const auto& rhiVertexInputBindingDescriptionElement = pCreateInfo->pVertexInputState->pVertexBindingDescriptions[i];
-            auto& vkVertexInputBindingDescriptionElement = vkVertexInputBindingDescriptionList[i];
-
-            vkVertexInputBindingDescriptionElement.binding = rhiVertexInputBindingDescriptionElement.binding;
-            vkVertexInputBindingDescriptionElement.stride = rhiVertexInputBindingDescriptionElement.stride;
-            vkVertexInputBindingDescriptionElement.inputRate = (VkVertexInputRate)rhiVertexInputBindingDescriptionElement.inputRate;
-        };
+            vkPipelineCache = Resources.Get(pipelineCache);
+        }
 
-        //vertex_input_attribute_description
-        int vertexInputAttributeDescriptionSize = pCreateInfo->pVertexInputState->vertexAttributeDescriptionCount;
-        std::vector<VkVertexInputAttributeDescription> vkVertexInputAttributeDescriptionList(vertexInputAttributeDescriptionSize);
-        for (int i = 0; i < vertexInputAttributeDescriptionSize; ++i)
+        // failed entries come back as VK_NULL_HANDLE and get a null RHI handle
+        auto*    vkPipelines = AllocateVkArray<VkPipeline>(arena, createInfoCount);
+        VkResult result      = DeviceTable.vkCreateGraphicsPipelines(
+            Device, vkPipelineCache, createInfoCount, vkCreateInfos, nullptr, vkPipelines);
+        for (uint32_t i = 0; i < createInfoCount; ++i)
         {
-            const auto& rhiVertexInputAttributeDescriptionElement = pCreateInfo->pVertexInputState->pVertexAttributeDescriptions[i];
-            auto& vkVertexInputAttributeDescriptionElement = vkVertexInputAttributeDescriptionList[i];
+            pPipelines[i] = vkPipelines[i] != VK_NULL_HANDLE ? Resources.Create<RHIPipeline>(vkPipelines[i]) : nullptr;
+        }
 
-            vkVertexInputAttributeDescriptionElement.location = rhiVertexInputAttributeDescriptionElement.location;
-            vkVertexInputAttributeDescriptionElement.binding = rhiVertexInputAttributeDescriptionElement.binding;
-            vkVertexInputAttributeDescriptionElement.format = (VkFormat)rhiVertexInputAttributeDescriptionElement.format;
-            vkVertexInputAttributeDescriptionElement.offset = rhiVertexInputAttributeDescriptionElement.offset;
-        };
+        VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create graphics pipeline!")
+    }
 
-        VkPipelineVertexInputStateCreateInfo vkPipelineVertexInputStateCreateInfo{};
-        vkPipelineVertexInputStateCreateInfo.sType = (VkStructureType)pCreateInfo->pVertexInputState->sType;
-        vkPipelineVertexInputStateCreateInfo.pNext = (const void*)pCreateInfo->pVertexInputState->pNext;
-        vkPipelineVertexInputStateCreateInfo.flags = (VkPipelineVertexInputStateCreateFlags)pCreateInfo->pVertexInputState->flags;
-        vkPipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount = pCreateInfo->pVertexInputState->vertexBindingDescriptionCount;
-        vkPipelineVertexInputStateCreateInfo.pVertexBindingDescriptions = vkVertexInputBindingDescriptionList.data();
-        vkPipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount = pCreateInfo->pVertexInputState->vertexAttributeDescriptionCount;
-        vkPipelineVertexInputStateCreateInfo.pVertexAttributeDescriptions = vkVertexInputAttributeDescriptionList.data();
+    bool VulkanRHI::CreateComputePipelines(RHIPipelineCache                    pipelineCache,
+                                           uint32_t                            createInfoCount,
+                                           const RHIComputePipelineCreateInfo* pCreateInfos,
+                                           RHIPipeline*                        pPipelines)
+    {
+        LinearArena&      arena = GetThreadScratchArena();
+        ScopedArenaMarker arenaMarker(arena);
 
-        VkPipelineInputAssemblyStateCreateInfo vkPipelineInputAssemblyStateCreateInfo{};
-        vkPipelineInputAssemblyStateCreateInfo.sType = (VkStructureType)pCreateInfo->pInputAssemblyState->sType;
-        vkPipelineInputAssemblyStateCreateInfo.pNext = (const void*)pCreateInfo->pInputAssemblyState->pNext;
-        vkPipelineInputAssemblyStateCreateInfo.flags = (VkPipelineInputAssemblyStateCreateFlags)pCreateInfo->pInputAssemblyState->flags;
-        vkPipelineInputAssemblyStateCreateInfo.topology = (VkPrimitiveTopology)pCreateInfo->pInputAssemblyState->topology;
-        vkPipelineInputAssemblyStateCreateInfo.primitiveRestartEnable = (VkBool32)pCreateInfo->pInputAssemblyState->primitiveRestartEnable;
+        auto* vkCreateInfos = AllocateVkArray<VkComputePipelineCreateInfo>(arena, createInfoCount);
+        for (uint32_t i = 0; i < createInfoCount; ++i)
+        {
+            TranslateComputePipelineCreateInfo(Resources, pCreateInfos[i], vkCreateInfos[i], arena);
+            m_PipelineManifest.RecordComputePipeline(vkCreateInfos[i]);
+        }
 
-        const VkPipelineTessellationStateCreateInfo* vkPipelineTessellationStateCreateInfoPtr = nullptr;
-        VkPipelineTessellationStateCreateInfo vkPipelineTessellationStateCreateInfo{};
-        if (pCreateInfo->pTessellationState != nullptr)
+        VkPipelineCache vkPipelineCache = m_PipelineCache.GetThreadCache();
+        if (pipelineCache != nullptr)
         {
-            vkPipelineTessellationStateCreateInfo.sType = (VkStructureType)pCreateInfo->pTessellationState->sType;
-            vkPipelineTessellationStateCreateInfo.pNext = (const void*)pCreateInfo->pTessellationState->pNext;
-            vkPipelineTessellationStateCreateInfo.flags = (VkPipelineTessellationStateCreateFlags)pCreateInfo->pTessellationState->flags;
-            vkPipelineTessellationStateCreateInfo.patchControlPoints = pCreateInfo->pTessellationState->patchControlPoints;
+            vkPipelineCache = Resources.Get(pipelineCache);
+        }
 
-            vkPipelineTessellationStateCreateInfoPtr = &vkPipelineTessellationStateCreateInfo;
+        auto*    vkPipelines = AllocateVkArray<VkPipeline>(arena, createInfoCount);
+        VkResult result      = DeviceTable.vkCreateComputePipelines(
+            Device, vkPipelineCache, createInfoCount, vkCreateInfos, nullptr, vkPipelines);
+        for (uint32_t i = 0; i < createInfoCount; ++i)
+        {
+            pPipelines[i] = vkPipelines[i] != VK_NULL_HANDLE ? Resources.Create<RHIPipeline>(vkPipelines[i]) : nullptr;
         }
 
-        //viewport
-        int viewportSize = pCreateInfo->pViewportState->viewportCount;
-        std::vector<VkViewport> vkViewportList(viewportSize);
-        for (int i = 0; i < viewportSize; ++i)
-        {
-            const auto& rhiViewportElement = pCreateInfo->pViewportState->pViewports[i];
-            auto& vkViewportElement = vkViewportList[i];
-
-            vkViewportElement.x = rhiViewportElement.x;
-            vkViewportElement.y = rhiViewportElement.y;
-            vkViewportElement.width = rhiViewportElement.width;
-            vkViewportElement.height = rhiViewportElement.height;
-            vkViewportElement.minDepth = rhiViewportElement.minDepth;
-            vkViewportElement.maxDepth = rhiViewportElement.maxDepth;
-        };
+        VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create compute pipelines!")
+    }
 
-        //rect_2d
-        int rect2dSize = pCreateInfo->pViewportState->scissorCount;
-        std::vector<VkRect2D> vkRect2dList(rect2dSize);
-        for (int i = 0; i < rect2dSize; ++i)
-        {
-            const auto& rhiRect2dElement = pCreateInfo->pViewportState->pScissors[i];
-            auto& vkRect2dElement = vkRect2dList[i];
+    void VulkanRHI::CreateGraphicsPipelinesAsync(uint32_t                             createInfoCount,
+                                                 const RHIGraphicsPipelineCreateInfo* pCreateInfos,
+                                                 RHIPipeline*                         pPipelines)
+    {
+        PipelineBatch& batch = BeginPipelineBatch(createInfoCount, pPipelines);
 
-            VkOffset2D offset2d{};
-            offset2d.x = vkRect2dElement.offset.x;
-            offset2d.y = vkRect2dElement.offset.y;
+        for (uint32_t i = 0; i < createInfoCount; ++i)
+        {
+            if (HasNextChain(pCreateInfos[i]))
+            {
+                // nothing is queued, the batch retires on the next poll and every handle reports failed
+                GAL_CORE_ERROR("[VulkanRHI] Async pipeline creation does not accept pNext chains");
+                batch.Result = VK_ERROR_FEATURE_NOT_PRESENT;
+                return;
+            }
+        }
 
-            VkExtent2D extend2d{};
-            extend2d.width = rhiRect2dElement.extent.width;
-            extend2d.height = rhiRect2dElement.extent.height;
+        auto* vkCreateInfos = AllocateVkArray<VkGraphicsPipelineCreateInfo>(batch.Arena, createInfoCount);
+        for (uint32_t i = 0; i < createInfoCount; ++i)
+        {
+            TranslateGraphicsPipelineCreateInfo(Resources, pCreateInfos[i], vkCreateInfos[i], batch.Arena);
+            m_PipelineManifest.RecordGraphicsPipeline(vkCreateInfos[i]);
+        }
 
-            vkRect2dElement.offset = offset2d;
-            vkRect2dElement.extent = extend2d;
-        };
+        g_RuntimeGlobalContext.JobSys->RunBackground(
+            [this, &batch, createInfoCount, vkCreateInfos]() {
+                batch.Result = DeviceTable.vkCreateGraphicsPipelines(Device,
+                                                                     m_PipelineCache.GetThreadCache(),
+                                                                     createInfoCount,
+                                                                     vkCreateInfos,
+                                                                     nullptr,
+                                                                     batch.VkPipelines.data());
+            },
+            batch.Counter);
+    }
 
-        VkPipelineViewportStateCreateInfo vkPipelineViewportStateCreateInfo{};
-        vkPipelineViewportStateCreateInfo.sType = (VkStructureType)pCreateInfo->pViewportState->sType;
-        vkPipelineViewportStateCreateInfo.pNext = (const void*)pCreateInfo->pViewportState->pNext;
-        vkPipelineViewportStateCreateInfo.flags = (VkPipelineViewportStateCreateFlags)pCreateInfo->pViewportState->flags;
-        vkPipelineViewportStateCreateInfo.viewportCount = pCreateInfo->pViewportState->viewportCount;
-        vkPipelineViewportStateCreateInfo.pViewports = vkViewportList.data();
-        vkPipelineViewportStateCreateInfo.scissorCount = pCreateInfo->pViewportState->scissorCount;
-        vkPipelineViewportStateCreateInfo.pScissors = vkRect2dList.data();
-
-        VkPipelineRasterizationStateCreateInfo vkPipelineRasterizationStateCreateInfo{};
-        vkPipelineRasterizationStateCreateInfo.sType = (VkStructureType)pCreateInfo->pRasterizationState->sType;
-        vkPipelineRasterizationStateCreateInfo.pNext = (const void*)pCreateInfo->pRasterizationState->pNext;
-        vkPipelineRasterizationStateCreateInfo.flags = (VkPipelineRasterizationStateCreateFlags)pCreateInfo->pRasterizationState->flags;
-        vkPipelineRasterizationStateCreateInfo.depthClampEnable = (VkBool32)pCreateInfo->pRasterizationState->depthClampEnable;
-        vkPipelineRasterizationStateCreateInfo.rasterizerDiscardEnable = (VkBool32)pCreateInfo->pRasterizationState->rasterizerDiscardEnable;
-        vkPipelineRasterizationStateCreateInfo.polygonMode = (VkPolygonMode)pCreateInfo->pRasterizationState->polygonMode;
-        vkPipelineRasterizationStateCreateInfo.cullMode = (VkCullModeFlags)pCreateInfo->pRasterizationState->cullMode;
-        vkPipelineRasterizationStateCreateInfo.frontFace = (VkFrontFace)pCreateInfo->pRasterizationState->frontFace;
-        vkPipelineRasterizationStateCreateInfo.depthBiasEnable = (VkBool32)pCreateInfo->pRasterizationState->depthBiasEnable;
-        vkPipelineRasterizationStateCreateInfo.depthBiasConstantFactor = pCreateInfo->pRasterizationState->depthBiasConstantFactor;
-        vkPipelineRasterizationStateCreateInfo.depthBiasClamp = pCreateInfo->pRasterizationState->depthBiasClamp;
-        vkPipelineRasterizationStateCreateInfo.depthBiasSlopeFactor = pCreateInfo->pRasterizationState->depthBiasSlopeFactor;
-        vkPipelineRasterizationStateCreateInfo.lineWidth = pCreateInfo->pRasterizationState->lineWidth;
-
-        VkPipelineMultisampleStateCreateInfo vkPipelineMultisampleStateCreateInfo{};
-        vkPipelineMultisampleStateCreateInfo.sType = (VkStructureType)pCreateInfo->pMultisampleState->sType;
-        vkPipelineMultisampleStateCreateInfo.pNext = (const void*)pCreateInfo->pMultisampleState->pNext;
-        vkPipelineMultisampleStateCreateInfo.flags = (VkPipelineMultisampleStateCreateFlags)pCreateInfo->pMultisampleState->flags;
-        vkPipelineMultisampleStateCreateInfo.rasterizationSamples = (VkSampleCountFlagBits)pCreateInfo->pMultisampleState->rasterizationSamples;
-        vkPipelineMultisampleStateCreateInfo.sampleShadingEnable = (VkBool32)pCreateInfo->pMultisampleState->sampleShadingEnable;
-        vkPipelineMultisampleStateCreateInfo.minSampleShading = pCreateInfo->pMultisampleState->minSampleShading;
-        vkPipelineMultisampleStateCreateInfo.pSampleMask = (const RHISampleMask*)pCreateInfo->pMultisampleState->pSampleMask;
-        vkPipelineMultisampleStateCreateInfo.alphaToCoverageEnable = (VkBool32)pCreateInfo->pMultisampleState->alphaToCoverageEnable;
-        vkPipelineMultisampleStateCreateInfo.alphaToOneEnable = (VkBool32)pCreateInfo->pMultisampleState->alphaToOneEnable;
-
-        VkStencilOpState stencilOpStateFront{};
-        stencilOpStateFront.failOp = (VkStencilOp)pCreateInfo->pDepthStencilState->front.failOp;
-        stencilOpStateFront.passOp = (VkStencilOp)pCreateInfo->pDepthStencilState->front.passOp;
-        stencilOpStateFront.depthFailOp = (VkStencilOp)pCreateInfo->pDepthStencilState->front.depthFailOp;
-        stencilOpStateFront.compareOp = (VkCompareOp)pCreateInfo->pDepthStencilState->front.compareOp;
-        stencilOpStateFront.compareMask = pCreateInfo->pDepthStencilState->front.compareMask;
-        stencilOpStateFront.writeMask = pCreateInfo->pDepthStencilState->front.writeMask;
-        stencilOpStateFront.reference = pCreateInfo->pDepthStencilState->front.reference;
-
-        VkStencilOpState stencilOpStateBack{};
-        stencilOpStateBack.failOp = (VkStencilOp)pCreateInfo->pDepthStencilState->back.failOp;
-        stencilOpStateBack.passOp = (VkStencilOp)pCreateInfo->pDepthStencilState->back.passOp;
-        stencilOpStateBack.depthFailOp = (VkStencilOp)pCreateInfo->pDepthStencilState->back.depthFailOp;
-        stencilOpStateBack.compareOp = (VkCompareOp)pCreateInfo->pDepthStencilState->back.compareOp;
-        stencilOpStateBack.compareMask = pCreateInfo->pDepthStencilState->back.compareMask;
-        stencilOpStateBack.writeMask = pCreateInfo->pDepthStencilState->back.writeMask;
-        stencilOpStateBack.reference = pCreateInfo->pDepthStencilState->back.reference;
-
-
-        VkPipelineDepthStencilStateCreateInfo vkPipelineDepthStencilStateCreateInfo{};
-        vkPipelineDepthStencilStateCreateInfo.sType = (VkStructureType)pCreateInfo->pDepthStencilState->sType;
-        vkPipelineDepthStencilStateCreateInfo.pNext = (const void*)pCreateInfo->pDepthStencilState->pNext;
-        vkPipelineDepthStencilStateCreateInfo.flags = (VkPipelineDepthStencilStateCreateFlags)pCreateInfo->pDepthStencilState->flags;
-        vkPipelineDepthStencilStateCreateInfo.depthTestEnable = (VkBool32)pCreateInfo->pDepthStencilState->depthTestEnable;
-        vkPipelineDepthStencilStateCreateInfo.depthWriteEnable = (VkBool32)pCreateInfo->pDepthStencilState->depthWriteEnable;
-        vkPipelineDepthStencilStateCreateInfo.depthCompareOp = (VkCompareOp)pCreateInfo->pDepthStencilState->depthCompareOp;
-        vkPipelineDepthStencilStateCreateInfo.depthBoundsTestEnable = (VkBool32)pCreateInfo->pDepthStencilState->depthBoundsTestEnable;
-        vkPipelineDepthStencilStateCreateInfo.stencilTestEnable = (VkBool32)pCreateInfo->pDepthStencilState->stencilTestEnable;
-        vkPipelineDepthStencilStateCreateInfo.front = stencilOpStateFront;
-        vkPipelineDepthStencilStateCreateInfo.back = stencilOpStateBack;
-        vkPipelineDepthStencilStateCreateInfo.minDepthBounds = pCreateInfo->pDepthStencilState->minDepthBounds;
-        vkPipelineDepthStencilStateCreateInfo.maxDepthBounds = pCreateInfo->pDepthStencilState->maxDepthBounds;
-
-        //pipeline_color_blend_attachment_state
-        int pipelineColorBlendAttachmentStateSize = pCreateInfo->pColorBlendState->attachmentCount;
-        std::vector<VkPipelineColorBlendAttachmentState> vkPipelineColorBlendAttachmentStateList(pipelineColorBlendAttachmentStateSize);
-        for (int i = 0; i < pipelineColorBlendAttachmentStateSize; ++i)
-        {
-            const auto& rhiPipelineColorBlendAttachmentStateElement = pCreateInfo->pColorBlendState->pAttachments[i];
-            auto& vkPipelineColorBlendAttachmentStateElement = vkPipelineColorBlendAttachmentStateList[i];
-
-            vkPipelineColorBlendAttachmentStateElement.blendEnable = (VkBool32)rhiPipelineColorBlendAttachmentStateElement.blendEnable;
-            vkPipelineColorBlendAttachmentStateElement.srcColorBlendFactor = (VkBlendFactor)rhiPipelineColorBlendAttachmentStateElement.srcColorBlendFactor;
-            vkPipelineColorBlendAttachmentStateElement.dstColorBlendFactor = (VkBlendFactor)rhiPipelineColorBlendAttachmentStateElement.dstColorBlendFactor;
-            vkPipelineColorBlendAttachmentStateElement.colorBlendOp = (VkBlendOp)rhiPipelineColorBlendAttachmentStateElement.colorBlendOp;
-            vkPipelineColorBlendAttachmentStateElement.srcAlphaBlendFactor = (VkBlendFactor)rhiPipelineColorBlendAttachmentStateElement.srcAlphaBlendFactor;
-            vkPipelineColorBlendAttachmentStateElement.dstAlphaBlendFactor = (VkBlendFactor)rhiPipelineColorBlendAttachmentStateElement.dstAlphaBlendFactor;
-            vkPipelineColorBlendAttachmentStateElement.alphaBlendOp = (VkBlendOp)rhiPipelineColorBlendAttachmentStateElement.alphaBlendOp;
-            vkPipelineColorBlendAttachmentStateElement.colorWriteMask = (VkColorComponentFlags)rhiPipelineColorBlendAttachmentStateElement.colorWriteMask;
-        };
+    void VulkanRHI::CreateComputePipelinesAsync(uint32_t                            createInfoCount,
+                                                const RHIComputePipelineCreateInfo* pCreateInfos,
+                                                RHIPipeline*                        pPipelines)
+    {
+        PipelineBatch& batch = BeginPipelineBatch(createInfoCount, pPipelines);
 
-        VkPipelineColorBlendStateCreateInfo vkPipelineColorBlendStateCreateInfo{};
-        vkPipelineColorBlendStateCreateInfo.sType = (VkStructureType)pCreateInfo->pColorBlendState->sType;
-        vkPipelineColorBlendStateCreateInfo.pNext = pCreateInfo->pColorBlendState->pNext;
-        vkPipelineColorBlendStateCreateInfo.flags = pCreateInfo->pColorBlendState->flags;
-        vkPipelineColorBlendStateCreateInfo.logicOpEnable = pCreateInfo->pColorBlendState->logicOpEnable;
-        vkPipelineColorBlendStateCreateInfo.logicOp = (VkLogicOp)pCreateInfo->pColorBlendState->logicOp;
-        vkPipelineColorBlendStateCreateInfo.attachmentCount = pCreateInfo->pColorBlendState->attachmentCount;
-        vkPipelineColorBlendStateCreateInfo.pAttachments = vkPipelineColorBlendAttachmentStateList.data();
-        for (int i = 0; i < 4; ++i)
-        {
-            vkPipelineColorBlendStateCreateInfo.blendConstants[i] = pCreateInfo->pColorBlendState->blendConstants[i];
-        };
+        for (uint32_t i = 0; i < createInfoCount; ++i)
+        {
+            if (HasNextChain(pCreateInfos[i]))
+            {
+                // nothing is queued, the batch retires on the next poll and every handle reports failed
+                GAL_CORE_ERROR("[VulkanRHI] Async pipeline creation does not accept pNext chains");
+                batch.Result = VK_ERROR_FEATURE_NOT_PRESENT;
+                return;
+            }
+        }
 
-        //dynamic_state
-        int dynamicStateSize = pCreateInfo->pDynamicState->dynamicStateCount;
-        std::vector<VkDynamicState> vkDynamicStateList(dynamicStateSize);
-        for (int i = 0; i < dynamicStateSize; ++i)
+        auto* vkCreateInfos = AllocateVkArray<VkComputePipelineCreateInfo>(batch.Arena, createInfoCount);
+        for (uint32_t i = 0; i < createInfoCount; ++i)
         {
-            const auto& rhiDynamicStateElement = pCreateInfo->pDynamicState->pDynamicStates[i];
-            auto& vkDynamicStateElement = vkDynamicStateList[i];
+            TranslateComputePipelineCreateInfo(Resources, pCreateInfos[i], vkCreateInfos[i], batch.Arena);
+            m_PipelineManifest.RecordComputePipeline(vkCreateInfos[i]);
+        }
 
-            vkDynamicStateElement = (VkDynamicState)rhiDynamicStateElement;
-        };
+        g_RuntimeGlobalContext.JobSys->RunBackground(
+            [this, &batch, createInfoCount, vkCreateInfos]() {
+                batch.Result = DeviceTable.vkCreateComputePipelines(Device,
+                                                                    m_PipelineCache.GetThreadCache(),
+                                                                    createInfoCount,
+                                                                    vkCreateInfos,
+                                                                    nullptr,
+                                                                    batch.VkPipelines.data());
+            },
+            batch.Counter);
+    }
 
-        VkPipelineDynamicStateCreateInfo vkPipelineDynamicStateCreateInfo{};
-        vkPipelineDynamicStateCreateInfo.sType = (VkStructureType)pCreateInfo->pDynamicState->sType;
-        vkPipelineDynamicStateCreateInfo.pNext = pCreateInfo->pDynamicState->pNext;
-        vkPipelineDynamicStateCreateInfo.flags = (VkPipelineDynamicStateCreateFlags)pCreateInfo->pDynamicState->flags;
-        vkPipelineDynamicStateCreateInfo.dynamicStateCount = pCreateInfo->pDynamicState->dynamicStateCount;
-        vkPipelineDynamicStateCreateInfo.pDynamicStates = vkDynamicStateList.data();
+    RHIPipelineStatus VulkanRHI::GetPipelineStatus(RHIPipeline pipeline)
+    {
+        PollPipelineBatches();
 
-        VkGraphicsPipelineCreateInfo createInfo{};
-        createInfo.sType = (VkStructureType)pCreateInfo->sType;
-        createInfo.pNext = (const void*)pCreateInfo->pNext;
-        createInfo.flags = (VkPipelineCreateFlags)pCreateInfo->flags;
-        createInfo.stageCount = pCreateInfo->stageCount;
-        createInfo.pStages = vkPipelineShaderStageCreateInfoList.data();
-        createInfo.pVertexInputState = &vkPipelineVertexInputStateCreateInfo;
-        createInfo.pInputAssemblyState = &vkPipelineInputAssemblyStateCreateInfo;
-        createInfo.pTessellationState = vkPipelineTessellationStateCreateInfoPtr;
-        createInfo.pViewportState = &vkPipelineViewportStateCreateInfo;
-        createInfo.pRasterizationState = &vkPipelineRasterizationStateCreateInfo;
-        createInfo.pMultisampleState = &vkPipelineMultisampleStateCreateInfo;
-        createInfo.pDepthStencilState = &vkPipelineDepthStencilStateCreateInfo;
-        createInfo.pColorBlendState = &vkPipelineColorBlendStateCreateInfo;
-        createInfo.pDynamicState = &vkPipelineDynamicStateCreateInfo;
-        createInfo.layout = ((VulkanPipelineLayout*)pCreateInfo->layout)->GetResource();
-        createInfo.renderPass = ((VulkanRenderPass*)pCreateInfo->renderPass)->GetResource();
-        createInfo.subpass = pCreateInfo->subpass;
-        if (pCreateInfo->basePipelineHandle != nullptr)
-        {
-            createInfo.basePipelineHandle = ((VulkanPipeline*)pCreateInfo->basePipelineHandle)->GetResource();
-        }
-        else
+        if (FindPipelineBatch(pipeline) != nullptr)
         {
-            createInfo.basePipelineHandle = VK_NULL_HANDLE;
+            return Pipeline_Status_Pending;
         }
-        createInfo.basePipelineIndex = pCreateInfo->basePipelineIndex;
+        return Resources.Get(pipeline) != VK_NULL_HANDLE ? Pipeline_Status_Ready : Pipeline_Status_Failed;
+    }
 
-        pPipelines = new VulkanPipeline();
-        VkPipeline vkPipelines;
-        VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
-        if (pipelineCache != nullptr)
+    bool VulkanRHI::WaitForPipeline(RHIPipeline pipeline)
+    {
+        if (PipelineBatch* batch = FindPipelineBatch(pipeline))
         {
-            vkPipelineCache = ((VulkanPipelineCache*)pipelineCache)->GetResource();
+            // compiles run on background workers only, the render thread helps with other jobs while it waits
+            g_RuntimeGlobalContext.JobSys->Wait(batch->Counter);
         }
-        VkResult result = vkCreateGraphicsPipelines(Device, vkPipelineCache, createInfoCount, &createInfo, nullptr, &vkPipelines);
-        ((VulkanPipeline*)pPipelines)->SetResource(vkPipelines);
 
-        VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create graphics pipeline!")
+        return GetPipelineStatus(pipeline) == Pipeline_Status_Ready;
     }
 
-    bool VulkanRHI::CreateComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines)
+    bool VulkanRHI::IsBindlessSupported() const { return m_IsBindlessSupported; }
+
+    RHIDescriptorSetLayout VulkanRHI::GetBindlessSetLayout() const { return m_BindlessSetLayout; }
+
+    RHIDescriptorSet VulkanRHI::GetBindlessSet() const { return m_BindlessSet; }
+
+    uint32_t VulkanRHI::AddBindlessTexture(RHIImageView imageView, RHISampler sampler)
     {
-        VkPipelineShaderStageCreateInfo shaderStageCreateInfo{};
-        if (pCreateInfos->pStages->pSpecializationInfo != nullptr)
+        if (!m_IsBindlessSupported)
         {
-            //will be complete soon if needed.
-            shaderStageCreateInfo.pSpecializationInfo = nullptr;
+            return InvalidBindlessIndex;
         }
-        else
+        return m_BindlessHeap.AddTexture(Resources.Get(imageView), Resources.Get(sampler));
+    }
+
+    uint32_t VulkanRHI::AddBindlessBuffer(RHIBuffer buffer, RHIDeviceSize offset, RHIDeviceSize range)
+    {
+        if (!m_IsBindlessSupported)
+        {
+            return InvalidBindlessIndex;
+        }
+        return m_BindlessHeap.AddBuffer(Resources.Get(buffer), offset, range);
+    }
+
+    void VulkanRHI::RemoveBindlessTexture(uint32_t index) { m_BindlessHeap.RemoveTexture(index, CurrentFrameIndex); }
+
+    void VulkanRHI::RemoveBindlessBuffer(uint32_t index) { m_BindlessHeap.RemoveBuffer(index, CurrentFrameIndex); }
+
+    bool VulkanRHI::HasDedicatedTransferQueue() const { return m_UploadQueue.IsDedicated(); }
+
+    RHIUploadTicket
+    VulkanRHI::UploadBufferAsync(RHIBuffer dstBuffer, RHIDeviceSize dstOffset, const void* pData, RHIDeviceSize size)
+    {
+        return m_UploadQueue.UploadBuffer(Resources.Get(dstBuffer), dstOffset, pData, size);
+    }
+
+    RHIUploadTicket VulkanRHI::UploadImageAsync(RHIImage      dstImage,
+                                                RHIFormat     format,
+                                                uint32_t      width,
+                                                uint32_t      height,
+                                                uint32_t      layerCount,
+                                                uint32_t      mipLevels,
+                                                const void*   pData,
+                                                RHIDeviceSize size)
+    {
+        RHIUploadTicket ticket = m_UploadQueue.UploadImage(
+            Resources.Get(dstImage), (VkFormat)format, width, height, layerCount, mipLevels, pData, size);
+
+        // the defragmenter knows the layout of the image from here on
+        if (ticket != RHI_INVALID_UPLOAD_TICKET)
         {
-            shaderStageCreateInfo.pSpecializationInfo = nullptr;
+            m_Defragmenter.MarkUploaded(dstImage, ticket);
         }
-        shaderStageCreateInfo.sType = (VkStructureType)pCreateInfos->pStages->sType;
-        shaderStageCreateInfo.pNext = (const void*)pCreateInfos->pStages->pNext;
-        shaderStageCreateInfo.flags = (VkPipelineShaderStageCreateFlags)pCreateInfos->pStages->flags;
-        shaderStageCreateInfo.stage = (VkShaderStageFlagBits)pCreateInfos->pStages->stage;
-        shaderStageCreateInfo.module = ((VulkanShader*)pCreateInfos->pStages->module)->GetResource();
-        shaderStageCreateInfo.pName = pCreateInfos->pStages->pName;
+        return ticket;
+    }
+
+    bool VulkanRHI::IsUploadComplete(RHIUploadTicket ticket) const { return m_UploadQueue.IsComplete(ticket); }
+
+    void VulkanRHI::WaitForUpload(RHIUploadTicket ticket) { m_UploadQueue.Wait(ticket); }
+
+    void VulkanRHI::GetMemoryStats(RHIMemoryStats& outStats) const { m_MemoryTracker.GetStats(outStats); }
+
+    void VulkanRHI::SetMemoryCategory(RHIDeviceMemory memory, RHIMemoryCategory category)
+    {
+        m_MemoryTracker.Track(Resources.Get(memory), category);
+    }
 
-        VkComputePipelineCreateInfo createInfo{};
-        createInfo.sType = (VkStructureType)pCreateInfos->sType;
-        createInfo.pNext = (const void*)pCreateInfos->pNext;
-        createInfo.flags = (VkPipelineCreateFlags)pCreateInfos->flags;
-        createInfo.stage = shaderStageCreateInfo;
-        createInfo.layout = ((VulkanPipelineLayout*)pCreateInfos->layout)->GetResource();;
-        if (pCreateInfos->basePipelineHandle != nullptr)
+    bool VulkanRHI::DumpMemoryStats(const std::string& path) const { return m_MemoryTracker.DumpStats(path); }
+
+    void VulkanRHI::SetMemoryMovedCallback(std::function<void()> callback)
+    {
+        m_Defragmenter.SetMovedCallback(std::move(callback));
+    }
+
+    VulkanRHI::PipelineBatch& VulkanRHI::BeginPipelineBatch(uint32_t createInfoCount, RHIPipeline* pPipelines)
+    {
+        PollPipelineBatches();
+
+        auto batch     = CreateScope<PipelineBatch>();
+        batch->Counter = CreateRef<JobCounter>();
+        batch->VkPipelines.assign(createInfoCount, VK_NULL_HANDLE);
+        batch->Pipelines.resize(createInfoCount);
+
+        // handles are reserved up front, they resolve to VK_NULL_HANDLE until the batch is published
+        for (uint32_t i = 0; i < createInfoCount; ++i)
         {
-            createInfo.basePipelineHandle = ((VulkanPipeline*)pCreateInfos->basePipelineHandle)->GetResource();
+            batch->Pipelines[i] = Resources.Create<RHIPipeline>(VK_NULL_HANDLE);
+            pPipelines[i]       = batch->Pipelines[i];
         }
-        else
+
+        m_PipelineBatches.push_back(std::move(batch));
+        return *m_PipelineBatches.back();
+    }
+
+    VulkanRHI::PipelineBatch* VulkanRHI::FindPipelineBatch(RHIPipeline pipeline)
+    {
+        for (const Scope<PipelineBatch>& batch : m_PipelineBatches)
         {
-            createInfo.basePipelineHandle = VK_NULL_HANDLE;
+            if (std::find(batch->Pipelines.begin(), batch->Pipelines.end(), pipeline) != batch->Pipelines.end())
+            {
+                return batch.get();
+            }
         }
-        createInfo.basePipelineIndex = pCreateInfos->basePipelineIndex;
+        return nullptr;
+    }
 
-        pPipelines = new VulkanPipeline();
-        VkPipeline vkPipelines;
-        VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
-        if (pipelineCache != nullptr)
+    void VulkanRHI::PollPipelineBatches()
+    {
+        auto isPending = [](const Scope<PipelineBatch>& batch) { return !batch->Counter->IsDone(); };
+        auto finished  = std::stable_partition(m_PipelineBatches.begin(), m_PipelineBatches.end(), isPending);
+
+        for (auto it = finished; it != m_PipelineBatches.end(); ++it)
         {
-            vkPipelineCache = ((VulkanPipelineCache*)pipelineCache)->GetResource();
+            PipelineBatch& batch = **it;
+            if (batch.Result != VK_SUCCESS)
+            {
+                GAL_CORE_ERROR("[VulkanRHI] Failed to create {0} async pipelines: {1}",
+                               batch.Pipelines.size(),
+                               (int)batch.Result);
+            }
+
+            // failed entries keep their handle, it reports Pipeline_Status_Failed until it is destroyed
+            for (size_t i = 0; i < batch.Pipelines.size(); ++i)
+            {
+                Resources.Set(batch.Pipelines[i], batch.VkPipelines[i]);
+            }
         }
-        VkResult result = vkCreateComputePipelines(Device, vkPipelineCache, createInfoCount, &createInfo, nullptr, &vkPipelines);
-        ((VulkanPipeline*)pPipelines)->SetResource(vkPipelines);
+        m_PipelineBatches.erase(finished, m_PipelineBatches.end());
+    }
 
-        VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create compute pipelines!")
+    void VulkanRHI::WaitForPipelineBatches()
+    {
+        for (const Scope<PipelineBatch>& batch : m_PipelineBatches)
+        {
+            g_RuntimeGlobalContext.JobSys->Wait(batch->Counter);
+        }
+        PollPipelineBatches();
     }
 
-    bool VulkanRHI::CreatePipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout* &pPipelineLayout)
+    bool VulkanRHI::CreatePipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout& pPipelineLayout)
     {
         //descriptor_set_layout
         int descriptorSetLayoutSize = pCreateInfo->setLayoutCount;
-        std::vector<VkDescriptorSetLayout> vkDescriptorSetLayoutList(descriptorSetLayoutSize);
+        ScratchArray<VkDescriptorSetLayout, 8> vkDescriptorSetLayoutList(descriptorSetLayoutSize);
         for (int i = 0; i < descriptorSetLayoutSize; ++i)
         {
             const auto& rhiDescriptorSetLayoutElement = pCreateInfo->pSetLayouts[i];
             auto& vkDescriptorSetLayoutElement = vkDescriptorSetLayoutList[i];
 
-            vkDescriptorSetLayoutElement = ((VulkanDescriptorSetLayout*)rhiDescriptorSetLayoutElement)->GetResource();
+            vkDescriptorSetLayoutElement = Resources.Get(rhiDescriptorSetLayoutElement);
         };
 
+        //push_constant_range
+        ScratchArray<VkPushConstantRange, 4> vkPushConstantRanges(pCreateInfo->pushConstantRangeCount);
+        for (uint32_t i = 0; i < pCreateInfo->pushConstantRangeCount; ++i)
+        {
+            vkPushConstantRanges[i].stageFlags = (VkShaderStageFlags)pCreateInfo->pPushConstantRanges[i].stageFlags;
+            vkPushConstantRanges[i].offset     = pCreateInfo->pPushConstantRanges[i].offset;
+            vkPushConstantRanges[i].size       = pCreateInfo->pPushConstantRanges[i].size;
+        }
+
         VkPipelineLayoutCreateInfo createInfo{};
         createInfo.sType = (VkStructureType)pCreateInfo->sType;
         createInfo.pNext = (const void*)pCreateInfo->pNext;
         createInfo.flags = (VkPipelineLayoutCreateFlags)pCreateInfo->flags;
         createInfo.setLayoutCount = pCreateInfo->setLayoutCount;
         createInfo.pSetLayouts = vkDescriptorSetLayoutList.data();
+        createInfo.pushConstantRangeCount = pCreateInfo->pushConstantRangeCount;
+        createInfo.pPushConstantRanges    = vkPushConstantRanges.data();
 
-        pPipelineLayout = new VulkanPipelineLayout();
         VkPipelineLayout vkPipelineLayout;
-        VkResult result = vkCreatePipelineLayout(Device, &createInfo, nullptr, &vkPipelineLayout);
-        ((VulkanPipelineLayout*)pPipelineLayout)->SetResource(vkPipelineLayout);
+        VkResult result = DeviceTable.vkCreatePipelineLayout(Device, &createInfo, nullptr, &vkPipelineLayout);
+        pPipelineLayout = Resources.Create<RHIPipelineLayout>(vkPipelineLayout);
+        if (result == VK_SUCCESS)
+        {
+            m_PipelineManifest.RecordPipelineLayout(vkPipelineLayout, createInfo);
+        }
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create pipeline layout!")
     }
 
-    bool VulkanRHI::CreateRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass* &pRenderPass)
+    bool VulkanRHI::CreateRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass& pRenderPass)
     {
         // attachment convert
-        std::vector<VkAttachmentDescription> vkAttachments(pCreateInfo->attachmentCount);
+        ScratchArray<VkAttachmentDescription, 8> vkAttachments(pCreateInfo->attachmentCount);
         for (int i = 0; i < pCreateInfo->attachmentCount; ++i)
         {
             const auto& rhiDesc = pCreateInfo->pAttachments[i];
@@ -1359,8 +1857,8 @@ namespace Galaxy
                 totalAttachmentReference += rhiDesc.colorAttachmentCount; // pResolveAttachments
             }
         }
-        std::vector<VkSubpassDescription> vkSubpassDescription(pCreateInfo->subpassCount);
-        std::vector<VkAttachmentReference> vkAttachmentReference(totalAttachmentReference);
+        ScratchArray<VkSubpassDescription, 4> vkSubpassDescription(pCreateInfo->subpassCount);
+        ScratchArray<VkAttachmentReference, 16> vkAttachmentReference(totalAttachmentReference);
         int                                currentAttachmentReference = 0;
         for (int i = 0; i < pCreateInfo->subpassCount; ++i)
         {
@@ -1434,7 +1932,7 @@ namespace Galaxy
             return false;
         }
 
-        std::vector<VkSubpassDependency> vkSubpassDepandecy(pCreateInfo->dependencyCount);
+        ScratchArray<VkSubpassDependency, 8> vkSubpassDepandecy(pCreateInfo->dependencyCount);
         for (int i = 0; i < pCreateInfo->dependencyCount; ++i)
         {
             const auto& rhiDesc = pCreateInfo->pDependencies[i];
@@ -1460,15 +1958,18 @@ namespace Galaxy
         createInfo.dependencyCount = pCreateInfo->dependencyCount;
         createInfo.pDependencies = vkSubpassDepandecy.data();
 
-        pRenderPass = new VulkanRenderPass();
         VkRenderPass vkRenderPass;
-        VkResult result = vkCreateRenderPass(Device, &createInfo, nullptr, &vkRenderPass);
-        ((VulkanRenderPass*)pRenderPass)->SetResource(vkRenderPass);
+        VkResult result = DeviceTable.vkCreateRenderPass(Device, &createInfo, nullptr, &vkRenderPass);
+        pRenderPass = Resources.Create<RHIRenderPass>(vkRenderPass);
+        if (result == VK_SUCCESS)
+        {
+            m_PipelineManifest.RecordRenderPass(vkRenderPass, createInfo);
+        }
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create render pass!")
     }
 
-    bool VulkanRHI::CreateSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler* &pSampler)
+    bool VulkanRHI::CreateSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler& pSampler)
     {
         VkSamplerCreateInfo createInfo{};
         createInfo.sType = (VkStructureType)pCreateInfo->sType;
@@ -1490,70 +1991,96 @@ namespace Galaxy
         createInfo.borderColor = (VkBorderColor)pCreateInfo->borderColor;
         createInfo.unnormalizedCoordinates = (VkBool32)pCreateInfo->unnormalizedCoordinates;
 
-        pSampler = new VulkanSampler();
+        pSampler = AcquireSampler(createInfo);
+        return pSampler != RHI_NULL_HANDLE;
+    }
+
+    RHISampler VulkanRHI::AcquireSampler(const VkSamplerCreateInfo& createInfo)
+    {
+        VkSamplerCreateInfo normalizedCreateInfo = VulkanSamplerCache::Normalize(createInfo);
+
+        RHISampler sampler = m_SamplerCache.Acquire(normalizedCreateInfo);
+        if (sampler)
+        {
+            return sampler;
+        }
+
+        if (!m_SamplerCache.CanCreate())
+        {
+            GAL_CORE_ERROR("[VulkanRHI] All {0} samplers of maxSamplerAllocationCount are in use",
+                           m_SamplerCache.GetMaxSamplerCount());
+            return RHI_NULL_HANDLE;
+        }
+
         VkSampler vkSampler;
-        VkResult result = vkCreateSampler(Device, &createInfo, nullptr, &vkSampler);
-        ((VulkanSampler*)pSampler)->SetResource(vkSampler);
+        VkResult  result = DeviceTable.vkCreateSampler(Device, &normalizedCreateInfo, nullptr, &vkSampler);
+        if (result != VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanRHI] Failed to create sampler!");
+            return RHI_NULL_HANDLE;
+        }
+        m_PipelineManifest.RecordSampler(vkSampler, normalizedCreateInfo);
 
-        VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create sample!")
+        sampler = Resources.Create<RHISampler>(vkSampler);
+        m_SamplerCache.Insert(normalizedCreateInfo, sampler);
+        return sampler;
     }
 
-    bool VulkanRHI::CreateSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore* &pSemaphore)
+    bool VulkanRHI::CreateSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore& pSemaphore)
     {
         VkSemaphoreCreateInfo createInfo{};
         createInfo.sType = (VkStructureType)pCreateInfo->sType;
         createInfo.pNext = pCreateInfo->pNext;
         createInfo.flags = (VkSemaphoreCreateFlags)pCreateInfo->flags;
 
-        pSemaphore = new VulkanSemaphore();
         VkSemaphore vkSemaphore;
-        VkResult result = vkCreateSemaphore(Device, &createInfo, nullptr, &vkSemaphore);
-        ((VulkanSemaphore*)pSemaphore)->SetResource(vkSemaphore);
+        VkResult result = DeviceTable.vkCreateSemaphore(Device, &createInfo, nullptr, &vkSemaphore);
+        pSemaphore = Resources.Create<RHISemaphore>(vkSemaphore);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create semaphore!")
     }
 
-    bool VulkanRHI::WaitForFencesPfn(uint32_t fenceCount, RHIFence* const* pFences, RHIBool32 waitAll, uint64_t timeout)
+    bool VulkanRHI::WaitForFencesPfn(uint32_t fenceCount, const RHIFence* pFences, RHIBool32 waitAll, uint64_t timeout)
     {
         //fence
         int fenceSize = fenceCount;
-        std::vector<VkFence> vkFenceList(fenceSize);
+        ScratchArray<VkFence, 8> vkFenceList(fenceSize);
         for (int i = 0; i < fenceSize; ++i)
         {
             const auto& rhiFenceElement = pFences[i];
             auto& vkFenceElement = vkFenceList[i];
 
-            vkFenceElement = ((VulkanFence*)rhiFenceElement)->GetResource();
+            vkFenceElement = Resources.Get(rhiFenceElement);
         };
 
-        VkResult result = _vkWaitForFences(Device, fenceCount, vkFenceList.data(), waitAll, timeout);
+        VkResult result = DeviceTable.vkWaitForFences(Device, fenceCount, vkFenceList.data(), waitAll, timeout);
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to wait for fences!")
     }
 
-    bool VulkanRHI::ResetFencesPfn(uint32_t fenceCount, RHIFence* const* pFences)
+    bool VulkanRHI::ResetFencesPfn(uint32_t fenceCount, const RHIFence* pFences)
     {
         //fence
         int fenceSize = fenceCount;
-        std::vector<VkFence> vkFenceList(fenceSize);
+        ScratchArray<VkFence, 8> vkFenceList(fenceSize);
         for (int i = 0; i < fenceSize; ++i)
         {
             const auto& rhiFenceElement = pFences[i];
             auto& vkFenceElement = vkFenceList[i];
 
-            vkFenceElement = ((VulkanFence*)rhiFenceElement)->GetResource();
+            vkFenceElement = Resources.Get(rhiFenceElement);
         };
 
-        VkResult result = _vkResetFences(Device, fenceCount, vkFenceList.data());
+        VkResult result = DeviceTable.vkResetFences(Device, fenceCount, vkFenceList.data());
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to reset fences!")
     }
 
-    bool VulkanRHI::ResetCommandPoolPfn(RHICommandPool* commandPool, RHICommandPoolResetFlags flags)
+    bool VulkanRHI::ResetCommandPoolPfn(RHICommandPool commandPool, RHICommandPoolResetFlags flags)
     {
-        VkResult result = _vkResetCommandPool(Device, ((VulkanCommandPool*)commandPool)->GetResource(), (VkCommandPoolResetFlags)flags);
+        VkResult result = DeviceTable.vkResetCommandPool(Device, Resources.Get(commandPool), (VkCommandPoolResetFlags)flags);
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to reset command pool!")
     }
 
-    bool VulkanRHI::BeginCommandBufferPfn(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
+    bool VulkanRHI::BeginCommandBufferPfn(RHICommandBuffer commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
     {
         VkCommandBufferInheritanceInfo* commandBufferInheritanceInfoPtr = nullptr;
         VkCommandBufferInheritanceInfo commandBufferInheritanceInfo{};
@@ -1561,9 +2088,9 @@ namespace Galaxy
         {
             commandBufferInheritanceInfo.sType = (VkStructureType)pBeginInfo->pInheritanceInfo->sType;
             commandBufferInheritanceInfo.pNext = (const void*)pBeginInfo->pInheritanceInfo->pNext;
-            commandBufferInheritanceInfo.renderPass = ((VulkanRenderPass*)pBeginInfo->pInheritanceInfo->renderPass)->GetResource();
+            commandBufferInheritanceInfo.renderPass = Resources.Get(pBeginInfo->pInheritanceInfo->renderPass);
             commandBufferInheritanceInfo.subpass = pBeginInfo->pInheritanceInfo->subpass;
-            commandBufferInheritanceInfo.framebuffer = ((VulkanFramebuffer*)pBeginInfo->pInheritanceInfo->framebuffer)->GetResource();
+            commandBufferInheritanceInfo.framebuffer = Resources.Get(pBeginInfo->pInheritanceInfo->framebuffer);
             commandBufferInheritanceInfo.occlusionQueryEnable = (VkBool32)pBeginInfo->pInheritanceInfo->occlusionQueryEnable;
             commandBufferInheritanceInfo.queryFlags = (VkQueryControlFlags)pBeginInfo->pInheritanceInfo->queryFlags;
             commandBufferInheritanceInfo.pipelineStatistics = (VkQueryPipelineStatisticFlags)pBeginInfo->pInheritanceInfo->pipelineStatistics;
@@ -1576,222 +2103,84 @@ namespace Galaxy
         commandBufferBeginInfo.pNext = (const void*)pBeginInfo->pNext;
         commandBufferBeginInfo.flags = (VkCommandBufferUsageFlags)pBeginInfo->flags;
         commandBufferBeginInfo.pInheritanceInfo = commandBufferInheritanceInfoPtr;
-        VkResult result = _vkBeginCommandBuffer(((VulkanCommandBuffer*)commandBuffer)->GetResource(), &commandBufferBeginInfo);
+        VkResult result = DeviceTable.vkBeginCommandBuffer(Resources.Get(commandBuffer), &commandBufferBeginInfo);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to begin command buffer!")
     }
 
-    bool VulkanRHI::EndCommandBufferPfn(RHICommandBuffer* commandBuffer)
+    bool VulkanRHI::EndCommandBufferPfn(RHICommandBuffer commandBuffer)
     {
-        VkResult result = _vkEndCommandBuffer(((VulkanCommandBuffer*)commandBuffer)->GetResource());
+        VkResult result = DeviceTable.vkEndCommandBuffer(Resources.Get(commandBuffer));
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to end command buffer!")
     }
 
-    void VulkanRHI::CmdBeginRenderPassPfn(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents)
+    void VulkanRHI::CmdBeginRenderPassPfn(RHICommandBuffer commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents)
     {
-        VkOffset2D offset2d{};
-        offset2d.x = pRenderPassBegin->renderArea.offset.x;
-        offset2d.y = pRenderPassBegin->renderArea.offset.y;
-
-        VkExtent2D extent2d{};
-        extent2d.width = pRenderPassBegin->renderArea.extent.width;
-        extent2d.height = pRenderPassBegin->renderArea.extent.height;
-
-        VkRect2D rect2d{};
-        rect2d.offset = offset2d;
-        rect2d.extent = extent2d;
-
-        //clear_values
-        int clearValueSize = pRenderPassBegin->clearValueCount;
-        std::vector<VkClearValue> vkClearValueList(clearValueSize);
-        for (int i = 0; i < clearValueSize; ++i)
-        {
-            const auto& rhiClearValueElement = pRenderPassBegin->pClearValues[i];
-            auto& vkClearValueElement = vkClearValueList[i];
-
-            VkClearColorValue vkClearColorValue;
-            vkClearColorValue.float32[0] = rhiClearValueElement.color.float32[0];
-            vkClearColorValue.float32[1] = rhiClearValueElement.color.float32[1];
-            vkClearColorValue.float32[2] = rhiClearValueElement.color.float32[2];
-            vkClearColorValue.float32[3] = rhiClearValueElement.color.float32[3];
-            vkClearColorValue.int32[0] = rhiClearValueElement.color.int32[0];
-            vkClearColorValue.int32[1] = rhiClearValueElement.color.int32[1];
-            vkClearColorValue.int32[2] = rhiClearValueElement.color.int32[2];
-            vkClearColorValue.int32[3] = rhiClearValueElement.color.int32[3];
-            vkClearColorValue.uint32[0] = rhiClearValueElement.color.uint32[0];
-            vkClearColorValue.uint32[1] = rhiClearValueElement.color.uint32[1];
-            vkClearColorValue.uint32[2] = rhiClearValueElement.color.uint32[2];
-            vkClearColorValue.uint32[3] = rhiClearValueElement.color.uint32[3];
-
-            VkClearDepthStencilValue vkClearDepthStencilValue;
-            vkClearDepthStencilValue.depth = rhiClearValueElement.depthStencil.depth;
-            vkClearDepthStencilValue.stencil = rhiClearValueElement.depthStencil.stencil;
-
-            vkClearValueElement.color = vkClearColorValue;
-            vkClearValueElement.depthStencil = vkClearDepthStencilValue;
-
-        };
-
-        VkRenderPassBeginInfo vkRenderPassBeginInfo{};
-        vkRenderPassBeginInfo.sType = (VkStructureType)pRenderPassBegin->sType;
-        vkRenderPassBeginInfo.pNext = pRenderPassBegin->pNext;
-        vkRenderPassBeginInfo.renderPass = ((VulkanRenderPass*)pRenderPassBegin->renderPass)->GetResource();
-        vkRenderPassBeginInfo.framebuffer = ((VulkanFramebuffer*)pRenderPassBegin->framebuffer)->GetResource();
-        vkRenderPassBeginInfo.renderArea = rect2d;
-        vkRenderPassBeginInfo.clearValueCount = pRenderPassBegin->clearValueCount;
-        vkRenderPassBeginInfo.pClearValues = vkClearValueList.data();
-
-        return _vkCmdBeginRenderPass(((VulkanCommandBuffer*)commandBuffer)->GetResource(), &vkRenderPassBeginInfo, (VkSubpassContents)contents);
+        VulkanCommandEncoder(*this, commandBuffer).CmdBeginRenderPassPfn(pRenderPassBegin, contents);
     }
 
-    void VulkanRHI::CmdNextSubpassPfn(RHICommandBuffer* commandBuffer, RHISubpassContents contents)
+    void VulkanRHI::CmdNextSubpassPfn(RHICommandBuffer commandBuffer, RHISubpassContents contents)
     {
-        return _vkCmdNextSubpass(((VulkanCommandBuffer*)commandBuffer)->GetResource(), ((VkSubpassContents)contents));
+        VulkanCommandEncoder(*this, commandBuffer).CmdNextSubpassPfn(contents);
     }
 
-    void VulkanRHI::CmdEndRenderPassPfn(RHICommandBuffer* commandBuffer)
+    void VulkanRHI::CmdEndRenderPassPfn(RHICommandBuffer commandBuffer)
     {
-        return _vkCmdEndRenderPass(((VulkanCommandBuffer*)commandBuffer)->GetResource());
+        VulkanCommandEncoder(*this, commandBuffer).CmdEndRenderPassPfn();
     }
 
-    void VulkanRHI::CmdBindPipelinePfn(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline* pipeline)
+    void VulkanRHI::CmdBindPipelinePfn(RHICommandBuffer commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline pipeline)
     {
-        return _vkCmdBindPipeline(((VulkanCommandBuffer*)commandBuffer)->GetResource(), (VkPipelineBindPoint)pipelineBindPoint, ((VulkanPipeline*)pipeline)->GetResource());
+        VulkanCommandEncoder(*this, commandBuffer).CmdBindPipelinePfn(pipelineBindPoint, pipeline);
     }
 
-    void VulkanRHI::CmdSetViewportPfn(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports)
+    void VulkanRHI::CmdSetViewportPfn(RHICommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports)
     {
-        //viewport
-        int viewportSize = viewportCount;
-        std::vector<VkViewport> vkViewportList(viewportSize);
-        for (int i = 0; i < viewportSize; ++i)
-        {
-            const auto& rhiViewportElement = pViewports[i];
-            auto& vkViewportElement = vkViewportList[i];
-
-            vkViewportElement.x = rhiViewportElement.x;
-            vkViewportElement.y = rhiViewportElement.y;
-            vkViewportElement.width = rhiViewportElement.width;
-            vkViewportElement.height = rhiViewportElement.height;
-            vkViewportElement.minDepth = rhiViewportElement.minDepth;
-            vkViewportElement.maxDepth = rhiViewportElement.maxDepth;
-        };
-
-        return _vkCmdSetViewport(((VulkanCommandBuffer*)commandBuffer)->GetResource(), firstViewport, viewportCount, vkViewportList.data());
+        VulkanCommandEncoder(*this, commandBuffer).CmdSetViewportPfn(firstViewport, viewportCount, pViewports);
     }
 
-    void VulkanRHI::CmdSetScissorPfn(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
+    void VulkanRHI::CmdSetScissorPfn(RHICommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
     {
-        //rect_2d
-        int rect2dSize = scissorCount;
-        std::vector<VkRect2D> vkRect2dList(rect2dSize);
-        for (int i = 0; i < rect2dSize; ++i)
-        {
-            const auto& rhiRect2dElement = pScissors[i];
-            auto& vkRect2dElement = vkRect2dList[i];
-
-            VkOffset2D offset2d{};
-            offset2d.x = rhiRect2dElement.offset.x;
-            offset2d.y = rhiRect2dElement.offset.y;
-
-            VkExtent2D extent2d{};
-            extent2d.width = rhiRect2dElement.extent.width;
-            extent2d.height = rhiRect2dElement.extent.height;
-
-            vkRect2dElement.offset = (VkOffset2D)offset2d;
-            vkRect2dElement.extent = (VkExtent2D)extent2d;
-
-        };
-
-        return _vkCmdSetScissor(((VulkanCommandBuffer*)commandBuffer)->GetResource(), firstScissor, scissorCount, vkRect2dList.data());
+        VulkanCommandEncoder(*this, commandBuffer).CmdSetScissorPfn(firstScissor, scissorCount, pScissors);
     }
 
     void VulkanRHI::CmdBindVertexBuffersPfn(
-        RHICommandBuffer* commandBuffer,
+        RHICommandBuffer commandBuffer,
         uint32_t firstBinding,
         uint32_t bindingCount,
-        RHIBuffer* const* pBuffers,
+        const RHIBuffer* pBuffers,
         const RHIDeviceSize* pOffsets)
     {
-        //buffer
-        int bufferSize = bindingCount;
-        std::vector<VkBuffer> vkBufferList(bufferSize);
-        for (int i = 0; i < bufferSize; ++i)
-        {
-            const auto& rhiBufferElement = pBuffers[i];
-            auto& vkBufferElement = vkBufferList[i];
-
-            vkBufferElement = ((VulkanBuffer*)rhiBufferElement)->GetResource();
-        };
-
-        //offset
-        int offsetSize = bindingCount;
-        std::vector<VkDeviceSize> vkDeviceSizeList(offsetSize);
-        for (int i = 0; i < offsetSize; ++i)
-        {
-            const auto& rhiOffsetElement = pOffsets[i];
-            auto& vkOffsetElement = vkDeviceSizeList[i];
-
-            vkOffsetElement = rhiOffsetElement;
-        };
-
-        return _vkCmdBindVertexBuffers(((VulkanCommandBuffer*)commandBuffer)->GetResource(), firstBinding, bindingCount, vkBufferList.data(), vkDeviceSizeList.data());
+        VulkanCommandEncoder(*this, commandBuffer).CmdBindVertexBuffersPfn(firstBinding, bindingCount, pBuffers, pOffsets);
     }
 
-    void VulkanRHI::CmdBindIndexBufferPfn(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType)
+    void VulkanRHI::CmdBindIndexBufferPfn(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset, RHIIndexType indexType)
     {
-        return _vkCmdBindIndexBuffer(((VulkanCommandBuffer*)commandBuffer)->GetResource(), ((VulkanBuffer*)buffer)->GetResource(), (VkDeviceSize)offset, (VkIndexType)indexType);
+        VulkanCommandEncoder(*this, commandBuffer).CmdBindIndexBufferPfn(buffer, offset, indexType);
     }
 
     void VulkanRHI::CmdBindDescriptorSetsPfn(
-        RHICommandBuffer* commandBuffer,
+        RHICommandBuffer commandBuffer,
         RHIPipelineBindPoint pipelineBindPoint,
-        RHIPipelineLayout* layout,
+        RHIPipelineLayout layout,
         uint32_t firstSet,
         uint32_t descriptorSetCount,
-        const RHIDescriptorSet* const* pDescriptorSets,
+        const RHIDescriptorSet* pDescriptorSets,
         uint32_t dynamicOffsetCount,
         const uint32_t* pDynamicOffsets)
     {
-        //descriptor_set
-        int descriptorSetSize = descriptorSetCount;
-        std::vector<VkDescriptorSet> vkDescriptorSetList(descriptorSetSize);
-        for (int i = 0; i < descriptorSetSize; ++i)
-        {
-            const auto& rhiDescriptorSetElement = pDescriptorSets[i];
-            auto& vkDescriptorSetElement = vkDescriptorSetList[i];
-
-            vkDescriptorSetElement = ((VulkanDescriptorSet*)rhiDescriptorSetElement)->GetResource();
-        };
-
-        //offset
-        int offsetSize = dynamicOffsetCount;
-        std::vector<uint32_t> vkOffsetList(offsetSize);
-        for (int i = 0; i < offsetSize; ++i)
-        {
-            const auto& rhiOffsetElement = pDynamicOffsets[i];
-            auto& vkOffsetElement = vkOffsetList[i];
-
-            vkOffsetElement = rhiOffsetElement;
-        };
-
-        return _vkCmdBindDescriptorSets(
-            ((VulkanCommandBuffer*)commandBuffer)->GetResource(),
-            (VkPipelineBindPoint)pipelineBindPoint,
-            ((VulkanPipelineLayout*)layout)->GetResource(),
-            firstSet, descriptorSetCount,
-            vkDescriptorSetList.data(),
-            dynamicOffsetCount,
-            vkOffsetList.data());
+        VulkanCommandEncoder(*this, commandBuffer)
+            .CmdBindDescriptorSetsPfn(
+                pipelineBindPoint, layout, firstSet, descriptorSetCount, pDescriptorSets, dynamicOffsetCount, pDynamicOffsets);
     }
 
-    void VulkanRHI::CmdDrawIndexedPfn(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+    void VulkanRHI::CmdDrawIndexedPfn(RHICommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
     {
-        return _vkCmdDrawIndexed(((VulkanCommandBuffer*)commandBuffer)->GetResource(), indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+        VulkanCommandEncoder(*this, commandBuffer).CmdDrawIndexedPfn(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
     }
 
     void VulkanRHI::CmdClearAttachmentsPfn(
-        RHICommandBuffer* commandBuffer,
+        RHICommandBuffer commandBuffer,
         uint32_t attachmentCount,
         const RHIClearAttachment* pAttachments,
         uint32_t rectCount,
@@ -1799,7 +2188,7 @@ namespace Galaxy
     {
         //clear_attachment
         int clearAttachmentSize = attachmentCount;
-        std::vector<VkClearAttachment> vkClearAttachmentList(clearAttachmentSize);
+        ScratchArray<VkClearAttachment, 8> vkClearAttachmentList(clearAttachmentSize);
         for (int i = 0; i < clearAttachmentSize; ++i)
         {
             const auto& rhiClearAttachmentElement = pAttachments[i];
@@ -1831,7 +2220,7 @@ namespace Galaxy
 
         //clear_rect
         int clearRectSize = rectCount;
-        std::vector<VkClearRect> vkClearRectList(clearRectSize);
+        ScratchArray<VkClearRect, 4> vkClearRectList(clearRectSize);
         for (int i = 0; i < clearRectSize; ++i)
         {
             const auto& rhiClearRectElement = pRects[i];
@@ -1851,15 +2240,15 @@ namespace Galaxy
             vkClearRectElement.layerCount = rhiClearRectElement.layerCount;
         };
 
-        return _vkCmdClearAttachments(
-            ((VulkanCommandBuffer*)commandBuffer)->GetResource(),
+        return DeviceTable.vkCmdClearAttachments(
+            Resources.Get(commandBuffer),
             attachmentCount,
             vkClearAttachmentList.data(),
             rectCount,
             vkClearRectList.data());
     }
 
-    bool VulkanRHI::BeginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
+    bool VulkanRHI::BeginCommandBuffer(RHICommandBuffer commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
     {
         VkCommandBufferInheritanceInfo commandBufferInheritanceInfo{};
         const VkCommandBufferInheritanceInfo* commandBufferInheritanceInfoPtr = nullptr;
@@ -1867,9 +2256,9 @@ namespace Galaxy
         {
             commandBufferInheritanceInfo.sType = (VkStructureType)(pBeginInfo->pInheritanceInfo->sType);
             commandBufferInheritanceInfo.pNext = (const void*)pBeginInfo->pInheritanceInfo->pNext;
-            commandBufferInheritanceInfo.renderPass = ((VulkanRenderPass*)pBeginInfo->pInheritanceInfo->renderPass)->GetResource();
+            commandBufferInheritanceInfo.renderPass = Resources.Get(pBeginInfo->pInheritanceInfo->renderPass);
             commandBufferInheritanceInfo.subpass = pBeginInfo->pInheritanceInfo->subpass;
-            commandBufferInheritanceInfo.framebuffer = ((VulkanFramebuffer*)(pBeginInfo->pInheritanceInfo->framebuffer))->GetResource();
+            commandBufferInheritanceInfo.framebuffer = Resources.Get(pBeginInfo->pInheritanceInfo->framebuffer);
             commandBufferInheritanceInfo.occlusionQueryEnable = (VkBool32)pBeginInfo->pInheritanceInfo->occlusionQueryEnable;
             commandBufferInheritanceInfo.queryFlags = (VkQueryControlFlags)pBeginInfo->pInheritanceInfo->queryFlags;
             commandBufferInheritanceInfo.pipelineStatistics = (VkQueryPipelineStatisticFlags)pBeginInfo->pInheritanceInfo->pipelineStatistics;
@@ -1883,14 +2272,14 @@ namespace Galaxy
         commandBufferBeginInfo.flags = (VkCommandBufferUsageFlags)pBeginInfo->flags;
         commandBufferBeginInfo.pInheritanceInfo = commandBufferInheritanceInfoPtr;
 
-        VkResult result = vkBeginCommandBuffer(((VulkanCommandBuffer*)commandBuffer)->GetResource(), &commandBufferBeginInfo);
+        VkResult result = DeviceTable.vkBeginCommandBuffer(Resources.Get(commandBuffer), &commandBufferBeginInfo);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to begin command buffer")
     }
 
-    bool VulkanRHI::EndCommandBuffer(RHICommandBuffer* commandBuffer)
+    bool VulkanRHI::EndCommandBuffer(RHICommandBuffer commandBuffer)
     {
-        VkResult result = vkEndCommandBuffer(((VulkanCommandBuffer*)commandBuffer)->GetResource());
+        VkResult result = DeviceTable.vkEndCommandBuffer(Resources.Get(commandBuffer));
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to end command buffer")
     }
 
@@ -1900,106 +2289,24 @@ namespace Galaxy
         uint32_t descriptorCopyCount,
         const RHICopyDescriptorSet* pDescriptorCopies)
     {
-        //write_descriptor_set
-        int writeDescriptorSetSize = descriptorWriteCount;
-        std::vector<VkWriteDescriptorSet> vkWriteDescriptorSetList(writeDescriptorSetSize);
-        int imageInfoCount = 0;
-        int bufferInfoCount = 0;
-        for (int i = 0; i < writeDescriptorSetSize; ++i)
-        {
-            const auto& rhiWriteDescriptorSetElement = pDescriptorWrites[i];
-            if (rhiWriteDescriptorSetElement.pImageInfo != nullptr)
-            {
-                imageInfoCount++;
-            }
-            if (rhiWriteDescriptorSetElement.pBufferInfo != nullptr)
-            {
-                bufferInfoCount++;
-            }
-        }
-        std::vector<VkDescriptorImageInfo> vkDescriptorImageInfoList(imageInfoCount);
-        std::vector<VkDescriptorBufferInfo> vkDescriptorBufferInfoList(bufferInfoCount);
-        int imageInfoCurrent = 0;
-        int bufferInfoCurrent = 0;
-
-        for (int i = 0; i < writeDescriptorSetSize; ++i)
-        {
-            const auto& rhiWriteDescriptorSetElement = pDescriptorWrites[i];
-            auto& vkWriteDescriptorSetElement = vkWriteDescriptorSetList[i];
-
-            const VkDescriptorImageInfo* vkDescriptorImageInfoPtr = nullptr;
-            if (rhiWriteDescriptorSetElement.pImageInfo != nullptr)
-            {
-                auto& vkDescriptorImageInfo = vkDescriptorImageInfoList[imageInfoCurrent];
-                if (rhiWriteDescriptorSetElement.pImageInfo->sampler == nullptr)
-                {
-                    vkDescriptorImageInfo.sampler = nullptr;
-                }
-                else
-                {
-                    vkDescriptorImageInfo.sampler = ((VulkanSampler*)rhiWriteDescriptorSetElement.pImageInfo->sampler)->GetResource();
-                }
-                vkDescriptorImageInfo.imageView = ((VulkanImageView*)rhiWriteDescriptorSetElement.pImageInfo->imageView)->GetResource();
-                vkDescriptorImageInfo.imageLayout = (VkImageLayout)rhiWriteDescriptorSetElement.pImageInfo->imageLayout;
-
-                vkDescriptorImageInfoPtr = &vkDescriptorImageInfo;
-                imageInfoCurrent++;
-            }
-
-            const VkDescriptorBufferInfo* vkDescriptorBufferInfoPtr = nullptr;
-            if (rhiWriteDescriptorSetElement.pBufferInfo != nullptr)
-            {
-                auto& vkDescriptorBufferInfo = vkDescriptorBufferInfoList[bufferInfoCurrent];
-                vkDescriptorBufferInfo.buffer = ((VulkanBuffer*)rhiWriteDescriptorSetElement.pBufferInfo->buffer)->GetResource();
-                vkDescriptorBufferInfo.offset = (VkDeviceSize)rhiWriteDescriptorSetElement.pBufferInfo->offset;
-                vkDescriptorBufferInfo.range = (VkDeviceSize)rhiWriteDescriptorSetElement.pBufferInfo->range;
-
-                vkDescriptorBufferInfoPtr = &vkDescriptorBufferInfo;
-                bufferInfoCurrent++;
-            }
-
-            vkWriteDescriptorSetElement.sType = (VkStructureType)rhiWriteDescriptorSetElement.sType;
-            vkWriteDescriptorSetElement.pNext = (const void*)rhiWriteDescriptorSetElement.pNext;
-            vkWriteDescriptorSetElement.dstSet = ((VulkanDescriptorSet*)rhiWriteDescriptorSetElement.dstSet)->GetResource();
-            vkWriteDescriptorSetElement.dstBinding = rhiWriteDescriptorSetElement.dstBinding;
-            vkWriteDescriptorSetElement.dstArrayElement = rhiWriteDescriptorSetElement.dstArrayElement;
-            vkWriteDescriptorSetElement.descriptorCount = rhiWriteDescriptorSetElement.descriptorCount;
-            vkWriteDescriptorSetElement.descriptorType = (VkDescriptorType)rhiWriteDescriptorSetElement.descriptorType;
-            vkWriteDescriptorSetElement.pImageInfo = vkDescriptorImageInfoPtr;
-            vkWriteDescriptorSetElement.pBufferInfo = vkDescriptorBufferInfoPtr;
-            //vk_write_descriptor_set_element.pTexelBufferView = &((VulkanBufferView*)rhi_write_descriptor_set_element.pTexelBufferView)->GetResource();
-        };
-
-        if (imageInfoCurrent != imageInfoCount
-            || bufferInfoCurrent != bufferInfoCount)
-        {
-            GAL_CORE_ERROR("[VulkanRHI] image_info_current != image_info_count || buffer_info_current != buffer_info_count");
-            return;
-        }
-
-        //copy_descriptor_set
-        int copyDescriptorSetSize = descriptorCopyCount;
-        std::vector<VkCopyDescriptorSet> vkCopyDescriptorSetList(copyDescriptorSetSize);
-        for (int i = 0; i < copyDescriptorSetSize; ++i)
-        {
-            const auto& rhiCopyDescriptorSetElement = pDescriptorCopies[i];
-            auto& vkCopyDescriptorSetElement = vkCopyDescriptorSetList[i];
+        m_DescriptorUpdater.Update(descriptorWriteCount, pDescriptorWrites, descriptorCopyCount, pDescriptorCopies);
+    }
 
-            vkCopyDescriptorSetElement.sType = (VkStructureType)rhiCopyDescriptorSetElement.sType;
-            vkCopyDescriptorSetElement.pNext = (const void*)rhiCopyDescriptorSetElement.pNext;
-            vkCopyDescriptorSetElement.srcSet = ((VulkanDescriptorSet*)rhiCopyDescriptorSetElement.srcSet)->GetResource();
-            vkCopyDescriptorSetElement.srcBinding = rhiCopyDescriptorSetElement.srcBinding;
-            vkCopyDescriptorSetElement.srcArrayElement = rhiCopyDescriptorSetElement.srcArrayElement;
-            vkCopyDescriptorSetElement.dstSet = ((VulkanDescriptorSet*)rhiCopyDescriptorSetElement.dstSet)->GetResource();
-            vkCopyDescriptorSetElement.dstBinding = rhiCopyDescriptorSetElement.dstBinding;
-            vkCopyDescriptorSetElement.dstArrayElement = rhiCopyDescriptorSetElement.dstArrayElement;
-            vkCopyDescriptorSetElement.descriptorCount = rhiCopyDescriptorSetElement.descriptorCount;
-        };
+    void VulkanRHI::UpdateDescriptorSetWithTemplate(RHIDescriptorSet            descriptorSet,
+                                                    RHIDescriptorUpdateTemplate updateTemplate,
+                                                    const void*                 pData)
+    {
+        m_DescriptorUpdater.UpdateWithTemplate(descriptorSet, updateTemplate, pData);
+    }
 
-        vkUpdateDescriptorSets(Device, descriptorWriteCount, vkWriteDescriptorSetList.data(), descriptorCopyCount, vkCopyDescriptorSetList.data());
+    void VulkanRHI::QueueDescriptorWrites(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites)
+    {
+        m_DescriptorUpdater.Queue(descriptorWriteCount, pDescriptorWrites);
     }
 
-    bool VulkanRHI::QueueSubmit(RHIQueue* queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence* fence)
+    void VulkanRHI::FlushDescriptorWrites() { m_DescriptorUpdater.Flush(); }
+
+    bool VulkanRHI::QueueSubmit(RHIQueue queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence fence)
     {
         //submit_info
         int commandBufferSizeTotal = 0;
@@ -2016,10 +2323,10 @@ namespace Galaxy
             signalSemaphoreSizeTotal += rhiSubmitInfoElement.signalSemaphoreCount;
             pipelineStageFlagsSizeTotal += rhiSubmitInfoElement.waitSemaphoreCount;
         }
-        std::vector<VkCommandBuffer> vkCommandBufferListExternal(commandBufferSizeTotal);
-        std::vector<VkSemaphore> vkSemaphoreListExternal(semaphoreSizeTotal);
-        std::vector<VkSemaphore> vkSignalSemaphoreListExternal(signalSemaphoreSizeTotal);
-        std::vector<VkPipelineStageFlags> vkPipelineStageFlagsListExternal(pipelineStageFlagsSizeTotal);
+        ScratchArray<VkCommandBuffer, 8> vkCommandBufferListExternal(commandBufferSizeTotal);
+        ScratchArray<VkSemaphore, 4> vkSemaphoreListExternal(semaphoreSizeTotal);
+        ScratchArray<VkSemaphore, 4> vkSignalSemaphoreListExternal(signalSemaphoreSizeTotal);
+        ScratchArray<VkPipelineStageFlags, 4> vkPipelineStageFlagsListExternal(pipelineStageFlagsSizeTotal);
 
         int commandBufferSizeCurrent = 0;
         int semaphoreSizeCurrent = 0;
@@ -2027,7 +2334,7 @@ namespace Galaxy
         int pipelineStageFlagsSizeCurrent = 0;
 
 
-        std::vector<VkSubmitInfo> vkSubmitInfoList(submitInfoSize);
+        ScratchArray<VkSubmitInfo, 4> vkSubmitInfoList(submitInfoSize);
         for (int i = 0; i < submitInfoSize; ++i)
         {
             const auto& rhiSubmitInfoElement = pSubmits[i];
@@ -2047,7 +2354,7 @@ namespace Galaxy
                     const auto& rhiCommandBufferElement = rhiSubmitInfoElement.pCommandBuffers[i];
                     auto& vkCommandBufferElement = vkCommandBufferListExternal[commandBufferSizeCurrent];
 
-                    vkCommandBufferElement = ((VulkanCommandBuffer*)rhiCommandBufferElement)->GetResource();
+                    vkCommandBufferElement = Resources.Get(rhiCommandBufferElement);
 
                     commandBufferSizeCurrent++;
                 };
@@ -2064,7 +2371,7 @@ namespace Galaxy
                     const auto& rhiSemaphoreElement = rhiSubmitInfoElement.pWaitSemaphores[i];
                     auto& vkSemaphoreElement = vkSemaphoreListExternal[semaphoreSizeCurrent];
 
-                    vkSemaphoreElement = ((VulkanSemaphore*)rhiSemaphoreElement)->GetResource();
+                    vkSemaphoreElement = Resources.Get(rhiSemaphoreElement);
 
                     semaphoreSizeCurrent++;
                 };
@@ -2081,7 +2388,7 @@ namespace Galaxy
                     const auto& rhiSignalSemaphoreElement = rhiSubmitInfoElement.pSignalSemaphores[i];
                     auto& vkSignalSemaphoreElement = vkSignalSemaphoreListExternal[signalSemaphoreSizeCurrent];
 
-                    vkSignalSemaphoreElement = ((VulkanSemaphore*)rhiSignalSemaphoreElement)->GetResource();
+                    vkSignalSemaphoreElement = Resources.Get(rhiSignalSemaphoreElement);
 
                     signalSemaphoreSizeCurrent++;
                 };
@@ -2117,20 +2424,20 @@ namespace Galaxy
         VkFence vk_fence = VK_NULL_HANDLE;
         if (fence != nullptr)
         {
-            vk_fence = ((VulkanFence*)fence)->GetResource();
+            vk_fence = Resources.Get(fence);
         }
 
-        VkResult result = vkQueueSubmit(((VulkanQueue*)queue)->GetResource(), submitCount, vkSubmitInfoList.data(), vk_fence);
+        VkResult result = DeviceTable.vkQueueSubmit(Resources.Get(queue), submitCount, vkSubmitInfoList.data(), vk_fence);
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to submit queue")
     }
 
-    bool VulkanRHI::QueueWaitIdle(RHIQueue* queue)
+    bool VulkanRHI::QueueWaitIdle(RHIQueue queue)
     {
-        VkResult result = vkQueueWaitIdle(((VulkanQueue*)queue)->GetResource());
+        VkResult result = DeviceTable.vkQueueWaitIdle(Resources.Get(queue));
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to wait queue idle")
     }
 
-    void VulkanRHI::CmdPipelineBarrier(RHICommandBuffer* commandBuffer,
+    void VulkanRHI::CmdPipelineBarrier(RHICommandBuffer commandBuffer,
                                        RHIPipelineStageFlags srcStageMask,
                                        RHIPipelineStageFlags dstStageMask,
                                        RHIDependencyFlags dependencyFlags,
@@ -2144,7 +2451,7 @@ namespace Galaxy
 
         //memory_barrier
         int memoryBarrierSize = memoryBarrierCount;
-        std::vector<VkMemoryBarrier> vkMemoryBarrierList(memoryBarrierSize);
+        ScratchArray<VkMemoryBarrier, 4> vkMemoryBarrierList(memoryBarrierSize);
         for (int i = 0; i < memoryBarrierSize; ++i)
         {
             const auto& rhiMemoryBarrierElement = pMemoryBarriers[i];
@@ -2159,7 +2466,7 @@ namespace Galaxy
 
         //buffer_memory_barrier
         int bufferMemoryBarrierSize = bufferMemoryBarrierCount;
-        std::vector<VkBufferMemoryBarrier> vkBufferMemoryBarrierList(bufferMemoryBarrierSize);
+        ScratchArray<VkBufferMemoryBarrier, 8> vkBufferMemoryBarrierList(bufferMemoryBarrierSize);
         for (int i = 0; i < bufferMemoryBarrierSize; ++i)
         {
             const auto& rhiBufferMemoryBarrierElement = pBufferMemoryBarriers[i];
@@ -2171,14 +2478,14 @@ namespace Galaxy
             vkBufferMemoryBarrierElement.dstAccessMask = (VkAccessFlags)rhiBufferMemoryBarrierElement.dstAccessMask;
             vkBufferMemoryBarrierElement.srcQueueFamilyIndex = rhiBufferMemoryBarrierElement.srcQueueFamilyIndex;
             vkBufferMemoryBarrierElement.dstQueueFamilyIndex = rhiBufferMemoryBarrierElement.dstQueueFamilyIndex;
-            vkBufferMemoryBarrierElement.buffer = ((VulkanBuffer*)rhiBufferMemoryBarrierElement.buffer)->GetResource();
+            vkBufferMemoryBarrierElement.buffer = Resources.Get(rhiBufferMemoryBarrierElement.buffer);
             vkBufferMemoryBarrierElement.offset = (VkDeviceSize)rhiBufferMemoryBarrierElement.offset;
             vkBufferMemoryBarrierElement.size = (VkDeviceSize)rhiBufferMemoryBarrierElement.size;
         };
 
         //image_memory_barrier
         int imageMemoryBarrierSize = imageMemoryBarrierCount;
-        std::vector<VkImageMemoryBarrier> vkImageMemoryBarrierList(imageMemoryBarrierSize);
+        ScratchArray<VkImageMemoryBarrier, 8> vkImageMemoryBarrierList(imageMemoryBarrierSize);
         for (int i = 0; i < imageMemoryBarrierSize; ++i)
         {
             const auto& rhiImageMemoryBarrierElement = pImageMemoryBarriers[i];
@@ -2199,12 +2506,12 @@ namespace Galaxy
             vkImageMemoryBarrierElement.newLayout = (VkImageLayout)rhiImageMemoryBarrierElement.newLayout;
             vkImageMemoryBarrierElement.srcQueueFamilyIndex = rhiImageMemoryBarrierElement.srcQueueFamilyIndex;
             vkImageMemoryBarrierElement.dstQueueFamilyIndex = rhiImageMemoryBarrierElement.dstQueueFamilyIndex;
-            vkImageMemoryBarrierElement.image = ((VulkanImage*)rhiImageMemoryBarrierElement.image)->GetResource();
+            vkImageMemoryBarrierElement.image = Resources.Get(rhiImageMemoryBarrierElement.image);
             vkImageMemoryBarrierElement.subresourceRange = imageSubresourceRange;
         };
 
-        vkCmdPipelineBarrier(
-            ((VulkanCommandBuffer*)commandBuffer)->GetResource(),
+        DeviceTable.vkCmdPipelineBarrier(
+            Resources.Get(commandBuffer),
             (RHIPipelineStageFlags)srcStageMask,
             (RHIPipelineStageFlags)dstStageMask,
             (RHIDependencyFlags)dependencyFlags,
@@ -2216,32 +2523,32 @@ namespace Galaxy
             vkImageMemoryBarrierList.data());
     }
 
-    void VulkanRHI::CmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+    void VulkanRHI::CmdDraw(RHICommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
     {
-        vkCmdDraw(((VulkanCommandBuffer*)commandBuffer)->GetResource(), vertexCount, instanceCount, firstVertex, firstInstance);
+        VulkanCommandEncoder(*this, commandBuffer).CmdDraw(vertexCount, instanceCount, firstVertex, firstInstance);
     }
 
-    void VulkanRHI::CmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+    void VulkanRHI::CmdDispatch(RHICommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
     {
-        vkCmdDispatch(((VulkanCommandBuffer*)commandBuffer)->GetResource(), groupCountX, groupCountY, groupCountZ);
+        VulkanCommandEncoder(*this, commandBuffer).CmdDispatch(groupCountX, groupCountY, groupCountZ);
     }
 
-    void VulkanRHI::CmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset)
+    void VulkanRHI::CmdDispatchIndirect(RHICommandBuffer commandBuffer, RHIBuffer buffer, RHIDeviceSize offset)
     {
-        vkCmdDispatchIndirect(((VulkanCommandBuffer*)commandBuffer)->GetResource(), ((VulkanBuffer*)buffer)->GetResource(), offset);
+        VulkanCommandEncoder(*this, commandBuffer).CmdDispatchIndirect(buffer, offset);
     }
 
     void VulkanRHI::CmdCopyImageToBuffer(
-        RHICommandBuffer* commandBuffer,
-        RHIImage* srcImage,
+        RHICommandBuffer commandBuffer,
+        RHIImage srcImage,
         RHIImageLayout srcImageLayout,
-        RHIBuffer* dstBuffer,
+        RHIBuffer dstBuffer,
         uint32_t regionCount,
         const RHIBufferImageCopy* pRegions)
     {
         //buffer_image_copy
         int bufferImageCopySize = regionCount;
-        std::vector<VkBufferImageCopy> vkBufferImageCopyList(bufferImageCopySize);
+        ScratchArray<VkBufferImageCopy, 8> vkBufferImageCopyList(bufferImageCopySize);
         for (int i = 0; i < bufferImageCopySize; ++i)
         {
             const auto& rhiBufferImageCopyElement = pRegions[i];
@@ -2279,16 +2586,16 @@ namespace Galaxy
             vkBufferImageCopyElement.imageExtent = extent3d;
         };
 
-        vkCmdCopyImageToBuffer(
-            ((VulkanCommandBuffer*)commandBuffer)->GetResource(),
-            ((VulkanImage*)srcImage)->GetResource(),
+        DeviceTable.vkCmdCopyImageToBuffer(
+            Resources.Get(commandBuffer),
+            Resources.Get(srcImage),
             (VkImageLayout)srcImageLayout,
-            ((VulkanBuffer*)dstBuffer)->GetResource(),
+            Resources.Get(dstBuffer),
             regionCount,
             vkBufferImageCopyList.data());
     }
 
-    void VulkanRHI::CmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height)
+    void VulkanRHI::CmdCopyImageToImage(RHICommandBuffer commandBuffer, RHIImage srcImage, RHIImageAspectFlagBits srcFlag, RHIImage dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height)
     {
         VkImageCopy imageCopyRegion    = {};
         imageCopyRegion.srcSubresource = { (VkImageAspectFlags)srcFlag, 0, 0, 1 };
@@ -2297,27 +2604,30 @@ namespace Galaxy
         imageCopyRegion.dstOffset = { 0, 0, 0 };
         imageCopyRegion.extent = { width, height, 1 };
 
-        vkCmdCopyImage(((VulkanCommandBuffer*)commandBuffer)->GetResource(),
-                       ((VulkanImage*)srcImage)->GetResource(),
-                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       ((VulkanImage*)dstImage)->GetResource(),
-                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                       1,
-                       &imageCopyRegion);
+        DeviceTable.vkCmdCopyImage(Resources.Get(commandBuffer),
+                                   Resources.Get(srcImage),
+                                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   Resources.Get(dstImage),
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   1,
+                                   &imageCopyRegion);
     }
 
-    void VulkanRHI::CmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions)
+    void VulkanRHI::CmdCopyBuffer(RHICommandBuffer commandBuffer, RHIBuffer srcBuffer, RHIBuffer dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions)
     {
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = pRegions->srcOffset;
-        copyRegion.dstOffset = pRegions->dstOffset;
-        copyRegion.size = pRegions->size;
+        ScratchArray<VkBufferCopy, 8> vkCopyRegions(regionCount);
+        for (uint32_t i = 0; i < regionCount; ++i)
+        {
+            vkCopyRegions[i].srcOffset = pRegions[i].srcOffset;
+            vkCopyRegions[i].dstOffset = pRegions[i].dstOffset;
+            vkCopyRegions[i].size      = pRegions[i].size;
+        }
 
-        vkCmdCopyBuffer(((VulkanCommandBuffer*)commandBuffer)->GetResource(),
-                        ((VulkanBuffer*)srcBuffer)->GetResource(),
-                        ((VulkanBuffer*)dstBuffer)->GetResource(),
-                        regionCount,
-                        &copyRegion);
+        DeviceTable.vkCmdCopyBuffer(Resources.Get(commandBuffer),
+                                    Resources.Get(srcBuffer),
+                                    Resources.Get(dstBuffer),
+                                    regionCount,
+                                    vkCopyRegions.data());
     }
 
     void VulkanRHI::CreateCommandBuffers()
@@ -2331,53 +2641,62 @@ namespace Galaxy
         {
             commandBufferAllocateInfo.commandPool = CommandPools[i];
             VkCommandBuffer vkCommandBuffer;
-            if (vkAllocateCommandBuffers(Device, &commandBufferAllocateInfo, &vkCommandBuffer) != VK_SUCCESS)
+            if (DeviceTable.vkAllocateCommandBuffers(Device, &commandBufferAllocateInfo, &vkCommandBuffer) != VK_SUCCESS)
             {
                 GAL_CORE_ERROR("[VulkanRHI] Failed to allocate command buffers");
             }
             VkCommandBuffers[i] = vkCommandBuffer;
-            CommandBuffers[i] = new VulkanCommandBuffer();
-            ((VulkanCommandBuffer*)CommandBuffers[i])->SetResource(vkCommandBuffer);
+            CommandBuffers[i] = Resources.Create<RHICommandBuffer>(vkCommandBuffer);
         }
     }
 
-    void VulkanRHI::CreateDescriptorPool()
+    void VulkanRHI::CreateDescriptorAllocator()
     {
-        // Since DescriptorSet should be treated as asset in Vulkan, DescriptorPool
-        // should be big enough, and thus we can sub-allocate DescriptorSet from
-        // DescriptorPool merely as we sub-allocate Buffer/Image from DeviceMemory.
+        // Pools are chained as they fill up, so there is no material or mesh count to size them for. Frame sets get
+        // pools per job system thread, which can record without locking.
+        uint32_t threadCount = g_RuntimeGlobalContext.JobSys->GetThreadCount();
+        m_DescriptorAllocator.Initialize(DeviceTable, MaxFramesInFlight, threadCount);
+        m_DescriptorUpdater.Initialize(DeviceTable, Resources, threadCount);
+    }
+
+    void VulkanRHI::CreateBindlessHeap()
+    {
+        if (!m_IsBindlessSupported)
+        {
+            GAL_CORE_INFO("[VulkanRHI] Descriptor indexing is not available, bindless resources are disabled");
+            return;
+        }
 
-        VkDescriptorPoolSize poolSizes[7];
-        poolSizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        poolSizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3;
-        poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        poolSizes[1].descriptorCount = 1 + 1 + 1 * m_MaxVertexBlendingMeshCount;
-        poolSizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSizes[2].descriptorCount = 1 * m_MaxMaterialCount;
-        poolSizes[3].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSizes[3].descriptorCount = 3 + 5 * m_MaxMaterialCount + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
-        poolSizes[4].type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-        poolSizes[4].descriptorCount = 4 + 1 + 1 + 2;
-        poolSizes[5].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-        poolSizes[5].descriptorCount = 3;
-        poolSizes[6].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-        poolSizes[6].descriptorCount = 1;
+        VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties {};
+        descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
 
-        VkDescriptorPoolCreateInfo poolInfo {};
-        poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = sizeof(poolSizes) / sizeof(poolSizes[0]);
-        poolInfo.pPoolSizes    = poolSizes;
-        poolInfo.maxSets =
-            1 + 1 + 1 + m_MaxMaterialCount + m_MaxVertexBlendingMeshCount + 1 + 1; // +skybox + axis descriptor set
-        poolInfo.flags = 0U;
+        VkPhysicalDeviceProperties2 physicalDeviceProperties {};
+        physicalDeviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        physicalDeviceProperties.pNext = &descriptorIndexingProperties;
+        vkGetPhysicalDeviceProperties2(PhysicalDevice, &physicalDeviceProperties);
 
-        if (vkCreateDescriptorPool(Device, &poolInfo, nullptr, &GlobalVkDescriptorPool) != VK_SUCCESS)
+        // the arrays are visible to every stage, so the per stage limits are the ones that bite
+        const VkPhysicalDeviceDescriptorIndexingProperties& limits = descriptorIndexingProperties;
+        uint32_t textureCapacity = std::min({16u * 1024u,
+                                             limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                             limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                             limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                             limits.maxDescriptorSetUpdateAfterBindSamplers});
+        uint32_t bufferCapacity  = std::min({4u * 1024u,
+                                             limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                             limits.maxDescriptorSetUpdateAfterBindStorageBuffers});
+        if (textureCapacity + bufferCapacity > limits.maxPerStageUpdateAfterBindResources)
         {
-            GAL_CORE_ERROR("[VulkanRHI] Failed to create descriptor pool!");
+            textureCapacity = limits.maxPerStageUpdateAfterBindResources - bufferCapacity;
         }
 
-        DescriptorPool = new VulkanDescriptorPool();
-        ((VulkanDescriptorPool*)DescriptorPool)->SetResource(GlobalVkDescriptorPool);
+        if (!m_BindlessHeap.Initialize(DeviceTable, textureCapacity, bufferCapacity, MaxFramesInFlight))
+        {
+            m_IsBindlessSupported = false;
+            return;
+        }
+        m_BindlessSetLayout = Resources.Create<RHIDescriptorSetLayout>(m_BindlessHeap.GetSetLayout());
+        m_BindlessSet       = Resources.Create<RHIDescriptorSet>(m_BindlessHeap.GetSet());
     }
 
     // semaphore : signal an image is ready for rendering // ready for presentation
@@ -2393,30 +2712,32 @@ namespace Galaxy
 
         for (uint32_t i = 0; i < MaxFramesInFlight; i++)
         {
-            ImageAvailableForTexturescopySemaphores[i] = new VulkanSemaphore();
-            if (vkCreateSemaphore(
+            VkSemaphore textureCopySemaphore;
+            if (DeviceTable.vkCreateSemaphore(
                     Device, &semaphoreCreateInfo, nullptr, &ImageAvailableForRenderSemaphores[i]) !=
                     VK_SUCCESS ||
-                vkCreateSemaphore(
+                DeviceTable.vkCreateSemaphore(
                     Device, &semaphoreCreateInfo, nullptr, &ImageFinishedForPresentationSemaphores[i]) !=
                     VK_SUCCESS ||
-                vkCreateSemaphore(
-                    Device, &semaphoreCreateInfo, nullptr, &(((VulkanSemaphore*)ImageAvailableForTexturescopySemaphores[i])->GetResource())) !=
+                DeviceTable.vkCreateSemaphore(
+                    Device, &semaphoreCreateInfo, nullptr, &textureCopySemaphore) !=
                     VK_SUCCESS ||
-                vkCreateFence(Device, &fenceCreateInfo, nullptr, &IsFrameInFlightFences[i]) != VK_SUCCESS)
+                DeviceTable.vkCreateFence(Device, &fenceCreateInfo, nullptr, &IsFrameInFlightFences[i]) != VK_SUCCESS)
             {
                 GAL_CORE_ERROR("[VulkanRHI] Failed to create semaphore & fence!");
             }
 
-            RhiIsFrameInFlightFences[i] = new VulkanFence();
-            ((VulkanFence*)RhiIsFrameInFlightFences[i])->SetResource(IsFrameInFlightFences[i]);
+            ImageAvailableForTexturescopySemaphores[i] = Resources.Create<RHISemaphore>(textureCopySemaphore);
+            RhiIsFrameInFlightFences[i]                = Resources.Create<RHIFence>(IsFrameInFlightFences[i]);
         }
+
+        m_DeletionQueue.Initialize(MaxFramesInFlight);
     }
 
     void VulkanRHI::CreateFramebufferImageAndView()
     {
-        VulkanUtil::CreateImage(PhysicalDevice,
-                                Device,
+        VkImage vkDepthImage;
+        VulkanUtil::CreateImage(AssetsAllocator,
                                 SwapchainExtent.width,
                                 SwapchainExtent.height,
                                 (VkFormat)DepthImageFormat,
@@ -2424,25 +2745,26 @@ namespace Galaxy
                                 VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
                                     VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                ((VulkanImage*)DepthImage)->GetResource(),
-                                DepthImageMemory,
+                                vkDepthImage,
+                                DepthImageAllocation,
                                 0,
                                 1,
                                 1);
+        m_MemoryTracker.Track(DepthImageAllocation, Memory_Category_RenderTarget);
+        DepthImage = Resources.Create<RHIImage>(vkDepthImage);
 
-        ((VulkanImageView*)DepthImageView)->SetResource(
-            VulkanUtil::CreateImageView(Device, ((VulkanImage*)DepthImage)->GetResource(), (VkFormat)DepthImageFormat, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1));
+        DepthImageView = Resources.Create<RHIImageView>(
+            VulkanUtil::CreateImageView(DeviceTable, vkDepthImage, (VkFormat)DepthImageFormat, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1));
     }
 
-    RHISampler* VulkanRHI::GetOrCreateDefaultSampler(RHIDefaultSamplerType type)
+    RHISampler VulkanRHI::GetOrCreateDefaultSampler(RHIDefaultSamplerType type)
     {
         switch (type)
         {
             case Galaxy::Default_Sampler_Linear:
                 if (m_LinearSampler == nullptr)
                 {
-                    m_LinearSampler = new VulkanSampler();
-                    ((VulkanSampler*)m_LinearSampler)->SetResource(VulkanUtil::GetOrCreateLinearSampler(PhysicalDevice, Device));
+                    m_LinearSampler = AcquireSampler(VulkanUtil::GetDefaultSamplerCreateInfo(type));
                 }
                 return m_LinearSampler;
                 break;
@@ -2450,8 +2772,7 @@ namespace Galaxy
             case Galaxy::Default_Sampler_Nearest:
                 if (m_NearestSampler == nullptr)
                 {
-                    m_NearestSampler = new VulkanSampler();
-                    ((VulkanSampler*)m_NearestSampler)->SetResource(VulkanUtil::GetOrCreateNearestSampler(PhysicalDevice, Device));
+                    m_NearestSampler = AcquireSampler(VulkanUtil::GetDefaultSamplerCreateInfo(type));
                 }
                 return m_NearestSampler;
                 break;
@@ -2462,72 +2783,90 @@ namespace Galaxy
         }
     }
 
-    RHISampler* VulkanRHI::GetOrCreateMipmapSampler(uint32_t width, uint32_t height)
+    RHISampler VulkanRHI::GetOrCreateMipmapSampler(uint32_t width, uint32_t height)
     {
         if (width == 0 || height == 0)
         {
             GAL_CORE_ERROR("[VulkanRHI] GetOrCreateMipmapSampler width == 0 || height == 0 !!!");
             return nullptr;
         }
-        RHISampler* sampler;
-        uint32_t  mipLevels = floor(log2(std::max(width, height))) + 1;
-        auto      findSampler = m_MipmapSamplerMap.find(mipLevels);
-        if (findSampler != m_MipmapSamplerMap.end())
+
+        // maxLod is clamped to the mips of the size, the cache keys on it like on the rest of the description
+        uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+        auto     iter      = m_MipmapSamplerMap.find(mipLevels);
+        if (iter != m_MipmapSamplerMap.end())
         {
-            return findSampler->second;
+            return iter->second;
         }
-        else
-        {
-            sampler = new VulkanSampler();
 
-            VkSampler vkSampler = VulkanUtil::GetOrCreateMipmapSampler(PhysicalDevice, Device, width, height);
+        RHISampler sampler = AcquireSampler(VulkanUtil::GetMipmapSamplerCreateInfo(m_MaxSamplerAnisotropy, mipLevels));
+        m_MipmapSamplerMap.emplace(mipLevels, sampler);
+        return sampler;
+    }
 
-            ((VulkanSampler*)sampler)->SetResource(vkSampler);
+    RHIShader VulkanRHI::CreateShaderModule(const std::vector<unsigned char>& shaderCode)
+    {
+        // the same SPIR-V is usually requested by many materials and permutations, share a single module
+        uint64_t key  = hash_fnv1a(shaderCode.data(), shaderCode.size());
+        auto     iter = m_ShaderModules.find(key);
+        if (iter != m_ShaderModules.end() && iter->second.Code == shaderCode)
+        {
+            iter->second.RefCount++;
+            return Resources.Create<RHIShader>(iter->second.Module);
+        }
 
-            m_MipmapSamplerMap.insert(std::make_pair(mipLevels, sampler));
+        VkShaderModule vkShader = VulkanUtil::CreateShaderModule(DeviceTable, shaderCode);
+        m_PipelineManifest.RecordShaderModule(vkShader, shaderCode);
 
-            return sampler;
+        // a colliding module is left unshared, DestroyShaderModule destroys it directly
+        if (vkShader != VK_NULL_HANDLE && iter == m_ShaderModules.end())
+        {
+            m_ShaderModules.emplace(key, SharedShaderModule {vkShader, 1, shaderCode});
+            m_ShaderModuleKeys.emplace(vkShader, key);
         }
+
+        return Resources.Create<RHIShader>(vkShader);
     }
 
-    RHIShader* VulkanRHI::CreateShaderModule(const std::vector<unsigned char>& shaderCode)
+    VkBufferUsageFlags VulkanRHI::GetMovableBufferUsage(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties)
     {
-        RHIShader* shahder = new VulkanShader();
-
-        VkShaderModule vkShader =  VulkanUtil::CreateShaderModule(Device, shaderCode);
-
-        ((VulkanShader*)shahder)->SetResource(vkShader);
-
-        return shahder;
+        // the defragmenter copies device local buffers out of their old memory when it moves them
+        if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            return usage;
+        }
+        return usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     }
 
-    void VulkanRHI::CreateBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer* & buffer, RHIDeviceMemory* & buffer_memory)
+    void VulkanRHI::CreateBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer& buffer, RHIDeviceMemory& buffer_memory)
     {
         VkBuffer vkBuffer;
-        VkDeviceMemory vkDeviceMemory;
+        VmaAllocation allocation;
 
-        VulkanUtil::CreateBuffer(PhysicalDevice, Device, size, usage, properties, vkBuffer, vkDeviceMemory);
+        VkBufferUsageFlags vkUsage = GetMovableBufferUsage(usage, properties);
+        VulkanUtil::CreateBuffer(AssetsAllocator, size, vkUsage, properties, vkBuffer, allocation);
+        m_MemoryTracker.Track(allocation, VulkanMemoryTracker::GetBufferCategory(usage));
 
-        buffer = new VulkanBuffer();
-        buffer_memory = new VulkanDeviceMemory();
-        ((VulkanBuffer*)buffer)->SetResource(vkBuffer);
-        ((VulkanDeviceMemory*)buffer_memory)->SetResource(vkDeviceMemory);
+        buffer = Resources.Create<RHIBuffer>(vkBuffer);
+        buffer_memory = Resources.Create<RHIDeviceMemory>(allocation);
+        m_Defragmenter.RegisterBuffer(allocation, buffer, size, vkUsage);
     }
 
-    void VulkanRHI::CreateBufferAndInitialize(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer*& buffer, RHIDeviceMemory*& bufferMemory, RHIDeviceSize size, void* data, int                    dataSize)
+    void VulkanRHI::CreateBufferAndInitialize(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer& buffer, RHIDeviceMemory& bufferMemory, RHIDeviceSize size, void* data, int                    dataSize)
     {
         VkBuffer vkBuffer;
-        VkDeviceMemory vkDeviceMemory;
+        VmaAllocation allocation;
 
-        VulkanUtil::CreateBufferAndInitialize(Device, PhysicalDevice, usage, properties, &vkBuffer, &vkDeviceMemory, size, data, dataSize);
+        VkBufferUsageFlags vkUsage = GetMovableBufferUsage(usage, properties);
+        VulkanUtil::CreateBufferAndInitialize(AssetsAllocator, vkUsage, properties, &vkBuffer, &allocation, size, data, dataSize);
+        m_MemoryTracker.Track(allocation, VulkanMemoryTracker::GetBufferCategory(usage));
 
-        buffer = new VulkanBuffer();
-        bufferMemory = new VulkanDeviceMemory();
-        ((VulkanBuffer*)buffer)->SetResource(vkBuffer);
-        ((VulkanDeviceMemory*)bufferMemory)->SetResource(vkDeviceMemory);
+        buffer = Resources.Create<RHIBuffer>(vkBuffer);
+        bufferMemory = Resources.Create<RHIDeviceMemory>(allocation);
+        m_Defragmenter.RegisterBuffer(allocation, buffer, size, vkUsage);
     }
 
-    bool VulkanRHI::CreateBufferVma(VmaAllocator allocator, const RHIBufferCreateInfo* pBufferCreateInfo, const VmaAllocationCreateInfo* pAllocationCreateInfo, RHIBuffer* & pBuffer, VmaAllocation* pAllocation, VmaAllocationInfo* pAllocationInfo)
+    bool VulkanRHI::CreateBufferVma(VmaAllocator allocator, const RHIBufferCreateInfo* pBufferCreateInfo, const VmaAllocationCreateInfo* pAllocationCreateInfo, RHIBuffer& pBuffer, VmaAllocation* pAllocation, VmaAllocationInfo* pAllocationInfo)
     {
         VkBuffer vkBuffer;
         VkBufferCreateInfo bufferCreateInfo{};
@@ -2540,7 +2879,6 @@ namespace Galaxy
         bufferCreateInfo.queueFamilyIndexCount = pBufferCreateInfo->queueFamilyIndexCount;
         bufferCreateInfo.pQueueFamilyIndices = (const uint32_t*)pBufferCreateInfo->pQueueFamilyIndices;
 
-        pBuffer = new VulkanBuffer();
         VkResult result = vmaCreateBuffer(allocator,
                                           &bufferCreateInfo,
                                           pAllocationCreateInfo,
@@ -2548,12 +2886,12 @@ namespace Galaxy
                                           pAllocation,
                                           pAllocationInfo);
 
-        ((VulkanBuffer*)pBuffer)->SetResource(vkBuffer);
+        pBuffer = Resources.Create<RHIBuffer>(vkBuffer);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create buffer VMA!")
     }
 
-    bool VulkanRHI::CreateBufferWithAlignmentVma(VmaAllocator allocator, const RHIBufferCreateInfo* pBufferCreateInfo, const VmaAllocationCreateInfo* pAllocationCreateInfo, RHIDeviceSize minAlignment, RHIBuffer* &pBuffer, VmaAllocation* pAllocation, VmaAllocationInfo* pAllocationInfo)
+    bool VulkanRHI::CreateBufferWithAlignmentVma(VmaAllocator allocator, const RHIBufferCreateInfo* pBufferCreateInfo, const VmaAllocationCreateInfo* pAllocationCreateInfo, RHIDeviceSize minAlignment, RHIBuffer& pBuffer, VmaAllocation* pAllocation, VmaAllocationInfo* pAllocationInfo)
     {
         VkBuffer vkBuffer;
         VkBufferCreateInfo bufferCreateInfo{};
@@ -2566,7 +2904,6 @@ namespace Galaxy
         bufferCreateInfo.queueFamilyIndexCount = pBufferCreateInfo->queueFamilyIndexCount;
         bufferCreateInfo.pQueueFamilyIndices = (const uint32_t*)pBufferCreateInfo->pQueueFamilyIndices;
 
-        pBuffer = new VulkanBuffer();
         VkResult result = vmaCreateBufferWithAlignment(allocator,
                                                        &bufferCreateInfo,
                                                        pAllocationCreateInfo,
@@ -2575,27 +2912,26 @@ namespace Galaxy
                                                        pAllocation,
                                                        pAllocationInfo);
 
-        ((VulkanBuffer*)pBuffer)->SetResource(vkBuffer);
+        pBuffer = Resources.Create<RHIBuffer>(vkBuffer);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to create buffer with alignment VMA!!!")
     }
 
 
-    void VulkanRHI::CopyBuffer(RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
+    void VulkanRHI::CopyBuffer(RHIBuffer srcBuffer, RHIBuffer dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
     {
-        VkBuffer vkSrcBuffer = ((VulkanBuffer*)srcBuffer)->GetResource();
-        VkBuffer vkDstBuffer = ((VulkanBuffer*)dstBuffer)->GetResource();
+        VkBuffer vkSrcBuffer = Resources.Get(srcBuffer);
+        VkBuffer vkDstBuffer = Resources.Get(dstBuffer);
         VulkanUtil::CopyBuffer(this, vkSrcBuffer, vkDstBuffer, srcOffset, dstOffset, size);
     }
 
     void VulkanRHI::CreateImage(uint32_t image_width, uint32_t image_height, RHIFormat format, RHIImageTiling image_tiling, RHIImageUsageFlags image_usage_flags, RHIMemoryPropertyFlags memory_property_flags,
-                                RHIImage* &image, RHIDeviceMemory* &memory, RHIImageCreateFlags image_create_flags, uint32_t array_layers, uint32_t miplevels)
+                                RHIImage& image, RHIDeviceMemory& memory, RHIImageCreateFlags image_create_flags, uint32_t array_layers, uint32_t miplevels)
     {
         VkImage vk_image;
-        VkDeviceMemory vk_device_memory;
+        VmaAllocation vk_allocation;
         VulkanUtil::CreateImage(
-            PhysicalDevice,
-            Device,
+            AssetsAllocator,
             image_width,
             image_height,
             (VkFormat)format,
@@ -2603,51 +2939,60 @@ namespace Galaxy
             (VkImageUsageFlags)image_usage_flags,
             (VkMemoryPropertyFlags)memory_property_flags,
             vk_image,
-            vk_device_memory,
+            vk_allocation,
             (VkImageCreateFlags)image_create_flags,
             array_layers,
             miplevels);
-
-        image = new VulkanImage();
-        memory = new VulkanDeviceMemory();
-        ((VulkanImage*)image)->SetResource(vk_image);
-        ((VulkanDeviceMemory*)memory)->SetResource(vk_device_memory);
-    }
-
-    void VulkanRHI::CreateImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels,
-                                    RHIImageView* &image_view)
-    {
-        image_view = new VulkanImageView();
-        VkImage vk_image = ((VulkanImage*)image)->GetResource();
+        m_MemoryTracker.Track(vk_allocation, VulkanMemoryTracker::GetImageCategory(image_usage_flags));
+
+        image = Resources.Create<RHIImage>(vk_image);
+        memory = Resources.Create<RHIDeviceMemory>(vk_allocation);
+        m_Defragmenter.RegisterImage(vk_allocation,
+                                     image,
+                                     VulkanUtil::GetImageCreateInfo(image_width,
+                                                                    image_height,
+                                                                    (VkFormat)format,
+                                                                    (VkImageTiling)image_tiling,
+                                                                    (VkImageUsageFlags)image_usage_flags,
+                                                                    (VkImageCreateFlags)image_create_flags,
+                                                                    array_layers,
+                                                                    miplevels));
+    }
+
+    void VulkanRHI::CreateImageView(RHIImage image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels,
+                                    RHIImageView& image_view)
+    {
+        VkImage vk_image = Resources.Get(image);
         VkImageView vk_image_view;
-        vk_image_view = VulkanUtil::CreateImageView(Device, vk_image, (VkFormat)format, image_aspect_flags, (VkImageViewType)view_type, layout_count, miplevels);
-        ((VulkanImageView*)image_view)->SetResource(vk_image_view);
+        vk_image_view = VulkanUtil::CreateImageView(DeviceTable, vk_image, (VkFormat)format, image_aspect_flags, (VkImageViewType)view_type, layout_count, miplevels);
+        image_view = Resources.Create<RHIImageView>(vk_image_view);
+
+        // recreated on the new image when the defragmenter moves it
+        m_Defragmenter.RegisterImageView(image_view, image, (VkFormat)format, image_aspect_flags, (VkImageViewType)view_type, layout_count, miplevels);
     }
 
-    void VulkanRHI::CreateGlobalImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, void* texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
+    void VulkanRHI::CreateGlobalImage(RHIImage& image, RHIImageView& image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, void* texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
     {
         VkImage vk_image;
         VkImageView vk_image_view;
 
         VulkanUtil::CreateGlobalImage(this, vk_image, vk_image_view,image_allocation,texture_image_width,texture_image_height,texture_image_pixels,texture_image_format,miplevels);
+        m_MemoryTracker.Track(image_allocation, Memory_Category_Texture);
 
-        image = new VulkanImage();
-        image_view = new VulkanImageView();
-        ((VulkanImage*)image)->SetResource(vk_image);
-        ((VulkanImageView*)image_view)->SetResource(vk_image_view);
+        image = Resources.Create<RHIImage>(vk_image);
+        image_view = Resources.Create<RHIImageView>(vk_image_view);
     }
 
-    void VulkanRHI::CreateCubeMap(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
+    void VulkanRHI::CreateCubeMap(RHIImage& image, RHIImageView& image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
     {
         VkImage vk_image;
         VkImageView vk_image_view;
 
         VulkanUtil::CreateCubeMap(this, vk_image, vk_image_view, image_allocation, texture_image_width, texture_image_height, texture_image_pixels, texture_image_format, miplevels);
+        m_MemoryTracker.Track(image_allocation, Memory_Category_Texture);
 
-        image = new VulkanImage();
-        image_view = new VulkanImageView();
-        ((VulkanImage*)image)->SetResource(vk_image);
-        ((VulkanImageView*)image_view)->SetResource(vk_image_view);
+        image = Resources.Create<RHIImage>(vk_image);
+        image_view = Resources.Create<RHIImageView>(vk_image_view);
     }
 
     void VulkanRHI::CreateSwapchainImageViews()
@@ -2658,15 +3003,14 @@ namespace Galaxy
         for (size_t i = 0; i < SwapchainImages.size(); i++)
         {
             VkImageView vkImageView;
-            vkImageView = VulkanUtil::CreateImageView(Device,
+            vkImageView = VulkanUtil::CreateImageView(DeviceTable,
                                                         SwapchainImages[i],
                                                         (VkFormat)SwapchainImageFormat,
                                                         VK_IMAGE_ASPECT_COLOR_BIT,
                                                         VK_IMAGE_VIEW_TYPE_2D,
                                                         1,
                                                         1);
-            SwapchainImageviews[i] = new VulkanImageView();
-            ((VulkanImageView*)SwapchainImageviews[i])->SetResource(vkImageView);
+            SwapchainImageviews[i] = Resources.Create<RHIImageView>(vkImageView);
         }
     }
 
@@ -2675,6 +3019,7 @@ namespace Galaxy
         VmaVulkanFunctions vulkanFunctions    = {};
         vulkanFunctions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
         vulkanFunctions.vkGetDeviceProcAddr   = &vkGetDeviceProcAddr;
+        DeviceTable.FillVmaFunctions(vulkanFunctions);
 
         VmaAllocatorCreateInfo allocatorCreateInfo = {};
         allocatorCreateInfo.vulkanApiVersion       = m_VulkanApiVersion;
@@ -2682,56 +3027,181 @@ namespace Galaxy
         allocatorCreateInfo.device                 = Device;
         allocatorCreateInfo.instance               = Instance;
         allocatorCreateInfo.pVulkanFunctions       = &vulkanFunctions;
+        if (m_IsMemoryBudgetSupported)
+        {
+            allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
 
         vmaCreateAllocator(&allocatorCreateInfo, &AssetsAllocator);
+
+        m_MemoryTracker.Initialize(AssetsAllocator, m_IsMemoryBudgetSupported);
+    }
+
+    void VulkanRHI::CreateStagingRing()
+    {
+        // large enough for a level's worth of textures in flight without stalling on the oldest batch
+        constexpr VkDeviceSize stagingRingSize = 64 * 1024 * 1024;
+
+        if (!m_StagingRing.Initialize(DeviceTable,
+                                      AssetsAllocator,
+                                      m_MemoryTracker,
+                                      Resources.Get(GraphicsQueue),
+                                      QueueIndices.graphicsFamily.value(),
+                                      stagingRingSize))
+        {
+            GAL_CORE_ERROR("[VulkanRHI] Failed to create the staging ring!");
+        }
+    }
+
+    void VulkanRHI::CreateUploadQueue()
+    {
+        // streaming only, so it can be smaller than the ring the frame's uploads go through
+        constexpr VkDeviceSize transferRingSize = 32 * 1024 * 1024;
+
+        VulkanStagingRing* pTransferRing = nullptr;
+        if (QueueIndices.transferFamily.has_value() && m_TransferRing.Initialize(DeviceTable,
+                                                                                 AssetsAllocator,
+                                                                                 m_MemoryTracker,
+                                                                                 Resources.Get(TransferQueue),
+                                                                                 QueueIndices.transferFamily.value(),
+                                                                                 transferRingSize))
+        {
+            pTransferRing = &m_TransferRing;
+        }
+        m_UploadQueue.Initialize(*this, pTransferRing, QueueIndices.transferFamily.value_or(VK_QUEUE_FAMILY_IGNORED));
+    }
+
+    void VulkanRHI::CreateSamplerCache()
+    {
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(PhysicalDevice, &physicalDeviceProperties);
+
+        m_MaxSamplerAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
+        m_SamplerCache.Initialize(physicalDeviceProperties.limits.maxSamplerAllocationCount);
+
+        // created up front so material loads only ever hit the cache for them
+        GetOrCreateDefaultSampler(Default_Sampler_Linear);
+        GetOrCreateDefaultSampler(Default_Sampler_Nearest);
+    }
+
+    void VulkanRHI::CreateDefragmenter()
+    {
+        m_Defragmenter.Initialize(*this, m_IsBindlessSupported ? &m_BindlessHeap : nullptr);
+    }
+
+    void VulkanRHI::CreatePipelineCache()
+    {
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(PhysicalDevice, &physicalDeviceProperties);
+
+        m_PipelineCache.Initialize(DeviceTable, physicalDeviceProperties, GAL_RELATIVE_PATH("Cache/PipelineCache.bin"));
+    }
+
+    void VulkanRHI::CreatePipelineManifest()
+    {
+        m_PipelineManifest.Initialize(DeviceTable, GAL_RELATIVE_PATH("Cache/PipelineManifest.bin"));
+        m_PipelineManifest.Load();
+
+#ifdef GAL_ENABLE_PIPELINE_MANIFEST_RECORDING
+        m_PipelineManifest.SetRecording(true);
+#endif
     }
 
-    // todo : more descriptorSet
-    bool VulkanRHI::AllocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets)
+    bool VulkanRHI::AllocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* pDescriptorSets)
     {
         //descriptor_set_layout
         int descriptorSetLayoutSize = pAllocateInfo->descriptorSetCount;
-        std::vector<VkDescriptorSetLayout> vkDescriptorSetLayoutList(descriptorSetLayoutSize);
+        ScratchArray<VkDescriptorSetLayout, 8> vkDescriptorSetLayoutList(descriptorSetLayoutSize);
         for (int i = 0; i < descriptorSetLayoutSize; ++i)
         {
             const auto& rhiDescriptorSetLayoutElement = pAllocateInfo->pSetLayouts[i];
             auto& vkDescriptorSetLayoutElement = vkDescriptorSetLayoutList[i];
 
-            vkDescriptorSetLayoutElement = ((VulkanDescriptorSetLayout*)rhiDescriptorSetLayoutElement)->GetResource();
-
-            VulkanDescriptorSetLayout* test = ((VulkanDescriptorSetLayout*)rhiDescriptorSetLayoutElement);
-
-            test = nullptr;
+            vkDescriptorSetLayoutElement = Resources.Get(rhiDescriptorSetLayoutElement);
         };
 
-        VkDescriptorSetAllocateInfo descriptorsetAllocateInfo{};
-        descriptorsetAllocateInfo.sType = (VkStructureType)pAllocateInfo->sType;
-        descriptorsetAllocateInfo.pNext = (const void*)pAllocateInfo->pNext;
-        descriptorsetAllocateInfo.descriptorPool = ((VulkanDescriptorPool*)(pAllocateInfo->descriptorPool))->GetResource();
-        descriptorsetAllocateInfo.descriptorSetCount = pAllocateInfo->descriptorSetCount;
-        descriptorsetAllocateInfo.pSetLayouts = vkDescriptorSetLayoutList.data();
+        ScratchArray<VkDescriptorSet, 8> vkDescriptorSetList(descriptorSetLayoutSize);
+        VkResult result;
+        if (pAllocateInfo->descriptorPool == nullptr)
+        {
+            result = m_DescriptorAllocator.AllocatePersistent(vkDescriptorSetLayoutList.data(),
+                                                              pAllocateInfo->descriptorSetCount,
+                                                              pAllocateInfo->pNext,
+                                                              vkDescriptorSetList.data());
+        }
+        else
+        {
+            VkDescriptorSetAllocateInfo descriptorsetAllocateInfo{};
+            descriptorsetAllocateInfo.sType = (VkStructureType)pAllocateInfo->sType;
+            descriptorsetAllocateInfo.pNext = (const void*)pAllocateInfo->pNext;
+            descriptorsetAllocateInfo.descriptorPool = Resources.Get(pAllocateInfo->descriptorPool);
+            descriptorsetAllocateInfo.descriptorSetCount = pAllocateInfo->descriptorSetCount;
+            descriptorsetAllocateInfo.pSetLayouts = vkDescriptorSetLayoutList.data();
 
-        VkDescriptorSet vkDescriptorSet;
-        pDescriptorSets = new VulkanDescriptorSet;
-        VkResult result = vkAllocateDescriptorSets(Device, &descriptorsetAllocateInfo, &vkDescriptorSet);
-        ((VulkanDescriptorSet*)pDescriptorSets)->SetResource(vkDescriptorSet);
+            result = DeviceTable.vkAllocateDescriptorSets(Device, &descriptorsetAllocateInfo, vkDescriptorSetList.data());
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            for (int i = 0; i < descriptorSetLayoutSize; ++i)
+            {
+                pDescriptorSets[i] = Resources.Create<RHIDescriptorSet>(vkDescriptorSetList[i]);
+            }
+        }
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to allocate descriptor sets!")
     }
 
-    bool VulkanRHI::AllocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers)
+    bool VulkanRHI::AllocateFrameDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* pDescriptorSets)
+    {
+        int descriptorSetCount = pAllocateInfo->descriptorSetCount;
+        ScratchArray<VkDescriptorSetLayout, 8> vkDescriptorSetLayoutList(descriptorSetCount);
+        for (int i = 0; i < descriptorSetCount; ++i)
+        {
+            vkDescriptorSetLayoutList[i] = Resources.Get(pAllocateInfo->pSetLayouts[i]);
+        }
+
+        ScratchArray<VkDescriptorSet, 8> vkDescriptorSetList(descriptorSetCount);
+        VkResult result = m_DescriptorAllocator.AllocateFrame(CurrentFrameIndex,
+                                                              vkDescriptorSetLayoutList.data(),
+                                                              pAllocateInfo->descriptorSetCount,
+                                                              pAllocateInfo->pNext,
+                                                              vkDescriptorSetList.data());
+        if (result == VK_SUCCESS)
+        {
+            for (int i = 0; i < descriptorSetCount; ++i)
+            {
+                pDescriptorSets[i] = Resources.Create<RHIDescriptorSet>(vkDescriptorSetList[i]);
+                m_FrameDescriptorSets[CurrentFrameIndex].push_back(pDescriptorSets[i]);
+            }
+        }
+
+        VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to allocate frame descriptor sets!")
+    }
+
+    void VulkanRHI::RegisterDescriptorSetSizes(const RHIDescriptorPoolSize* pPoolSizes, uint32_t poolSizeCount)
+    {
+        ScratchArray<VkDescriptorPoolSize, 8> vkPoolSizes(poolSizeCount);
+        for (uint32_t i = 0; i < poolSizeCount; ++i)
+        {
+            vkPoolSizes[i].type            = (VkDescriptorType)pPoolSizes[i].type;
+            vkPoolSizes[i].descriptorCount = pPoolSizes[i].descriptorCount;
+        }
+        m_DescriptorAllocator.RegisterSetSizes(vkPoolSizes.data(), poolSizeCount);
+    }
+
+    bool VulkanRHI::AllocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer& pCommandBuffers)
     {
         VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
         commandBufferAllocateInfo.sType = (VkStructureType)pAllocateInfo->sType;
         commandBufferAllocateInfo.pNext = (const void*)pAllocateInfo->pNext;
-        commandBufferAllocateInfo.commandPool = ((VulkanCommandPool*)(pAllocateInfo->commandPool))->GetResource();
+        commandBufferAllocateInfo.commandPool = Resources.Get(pAllocateInfo->commandPool);
         commandBufferAllocateInfo.level = (VkCommandBufferLevel)pAllocateInfo->level;
         commandBufferAllocateInfo.commandBufferCount = pAllocateInfo->commandBufferCount;
 
         VkCommandBuffer vkCommandBuffer;
-        pCommandBuffers = new RHICommandBuffer();
-        VkResult result = vkAllocateCommandBuffers(Device, &commandBufferAllocateInfo, &vkCommandBuffer);
-        ((VulkanCommandBuffer*)pCommandBuffers)->SetResource(vkCommandBuffer);
+        VkResult result = DeviceTable.vkAllocateCommandBuffers(Device, &commandBufferAllocateInfo, &vkCommandBuffer);
+        pCommandBuffers = Resources.Create<RHICommandBuffer>(vkCommandBuffer);
 
         VK_CHECK_RETURN_BOOLEAN(result, "[VulkanRHI] Failed to allocate command buffers!")
     }
@@ -2788,14 +3258,14 @@ namespace Galaxy
 
         createInfo.oldSwapchain = VK_NULL_HANDLE;
 
-        if (vkCreateSwapchainKHR(Device, &createInfo, nullptr, &Swapchain) != VK_SUCCESS)
+        if (DeviceTable.vkCreateSwapchainKHR(Device, &createInfo, nullptr, &Swapchain) != VK_SUCCESS)
         {
             GAL_CORE_ERROR("[VulkanRHI] Failed to create swapchain khr!!!");
         }
 
-        vkGetSwapchainImagesKHR(Device, Swapchain, &imageCount, nullptr);
+        DeviceTable.vkGetSwapchainImagesKHR(Device, Swapchain, &imageCount, nullptr);
         SwapchainImages.resize(imageCount);
-        vkGetSwapchainImagesKHR(Device, Swapchain, &imageCount, SwapchainImages.data());
+        DeviceTable.vkGetSwapchainImagesKHR(Device, Swapchain, &imageCount, SwapchainImages.data());
 
         SwapchainImageFormat = (RHIFormat)chosenSurfaceFormat.format;
         SwapchainExtent.height = chosenExtent.height;
@@ -2808,9 +3278,9 @@ namespace Galaxy
     {
         for (auto imageview : SwapchainImageviews)
         {
-            vkDestroyImageView(Device, ((VulkanImageView*)imageview)->GetResource(), nullptr);
+            DestroyImageViewImmediately(imageview);
         }
-        vkDestroySwapchainKHR(Device, Swapchain, nullptr); // also swapchain images
+        DeviceTable.vkDestroySwapchainKHR(Device, Swapchain, nullptr); // also swapchain images
     }
 
     void VulkanRHI::DestroyDefaultSampler(RHIDefaultSamplerType type)
@@ -2818,12 +3288,18 @@ namespace Galaxy
         switch (type)
         {
             case Galaxy::Default_Sampler_Linear:
-                VulkanUtil::DestroyLinearSampler(Device);
-                delete(m_LinearSampler);
+                if (m_LinearSampler != nullptr)
+                {
+                    DestroySampler(m_LinearSampler);
+                    m_LinearSampler = RHI_NULL_HANDLE;
+                }
                 break;
             case Galaxy::Default_Sampler_Nearest:
-                VulkanUtil::DestroyNearestSampler(Device);
-                delete(m_NearestSampler);
+                if (m_NearestSampler != nullptr)
+                {
+                    DestroySampler(m_NearestSampler);
+                    m_NearestSampler = RHI_NULL_HANDLE;
+                }
                 break;
             default:
                 break;
@@ -2832,126 +3308,247 @@ namespace Galaxy
 
     void VulkanRHI::DestroyMipmappedSampler()
     {
-        VulkanUtil::DestroyMipmappedSampler(Device);
-
-        for (auto sampler : m_MipmapSamplerMap)
+        for (const auto& entry : m_MipmapSamplerMap)
         {
-            delete sampler.second;
+            DestroySampler(entry.second);
         }
         m_MipmapSamplerMap.clear();
     }
 
-    void VulkanRHI::DestroyShaderModule(RHIShader* shaderModule)
+    void VulkanRHI::DestroyShaderModule(RHIShader shaderModule)
     {
-        vkDestroyShaderModule(Device, ((VulkanShader*)shaderModule)->GetResource(), nullptr);
+        VkShaderModule vkShader = Resources.Get(shaderModule);
+        Resources.Destroy(shaderModule);
+
+        auto keyIter = m_ShaderModuleKeys.find(vkShader);
+        if (keyIter != m_ShaderModuleKeys.end())
+        {
+            auto iter = m_ShaderModules.find(keyIter->second);
+            if (--iter->second.RefCount > 0)
+            {
+                return;
+            }
+            m_ShaderModules.erase(iter);
+            m_ShaderModuleKeys.erase(keyIter);
+        }
+
+        // async pipeline batches read the module on a job, only hot reload destroys modules while they run
+        if (!m_PipelineBatches.empty())
+        {
+            WaitForPipelineBatches();
+        }
+        m_PipelineManifest.ForgetShaderModule(vkShader);
+        DeviceTable.vkDestroyShaderModule(Device, vkShader, nullptr);
+    }
 
-        delete(shaderModule);
+    void VulkanRHI::DestroySemaphore(RHISemaphore semaphore)
+    {
+        DeviceTable.vkDestroySemaphore(Device, Resources.Get(semaphore), nullptr);
+        Resources.Destroy(semaphore);
     }
 
-    void VulkanRHI::DestroySemaphore(RHISemaphore* semaphore)
+    void VulkanRHI::FreeDescriptorSets(uint32_t descriptorSetCount, const RHIDescriptorSet* pDescriptorSets)
     {
-        vkDestroySemaphore(Device, ((VulkanSemaphore*)semaphore)->GetResource(), nullptr);
+        for (uint32_t i = 0; i < descriptorSetCount; ++i)
+        {
+            m_DeletionQueue.Enqueue(pDescriptorSets[i]);
+        }
     }
 
-    void VulkanRHI::DestroySampler(RHISampler* sampler)
+    void VulkanRHI::DestroySampler(RHISampler sampler)
     {
-        vkDestroySampler(Device, ((VulkanSampler*)sampler)->GetResource(), nullptr);
+        // shared between every CreateSampler with the same description, only the last reference destroys it
+        if (m_SamplerCache.Release(sampler))
+        {
+            m_DeletionQueue.Enqueue(sampler);
+        }
     }
 
-    void VulkanRHI::DestroyInstance(RHIInstance* instance)
+    void VulkanRHI::DestroyInstance(RHIInstance instance)
     {
-        vkDestroyInstance(((VulkanInstance*)instance)->GetResource(), nullptr);
+        vkDestroyInstance(Resources.Get(instance), nullptr);
+        Resources.Destroy(instance);
     }
 
-    void VulkanRHI::DestroyImageView(RHIImageView* imageView)
+    void VulkanRHI::DestroyImageView(RHIImageView imageView) { m_DeletionQueue.Enqueue(imageView); }
+
+    void VulkanRHI::DestroyImage(RHIImage image) { m_DeletionQueue.Enqueue(image); }
+
+    void VulkanRHI::DestroyFramebuffer(RHIFramebuffer framebuffer) { m_DeletionQueue.Enqueue(framebuffer); }
+
+    void VulkanRHI::DestroyPipeline(RHIPipeline pipeline) { m_DeletionQueue.Enqueue(pipeline); }
+
+    void VulkanRHI::DestroyPipelineLayout(RHIPipelineLayout layout)
     {
-        vkDestroyImageView(Device, ((VulkanImageView*)imageView)->GetResource(), nullptr);
+        DeviceTable.vkDestroyPipelineLayout(Device, Resources.Get(layout), nullptr);
+        Resources.Destroy(layout);
     }
 
-    void VulkanRHI::DestroyImage(RHIImage* image)
+    void VulkanRHI::DestroyDescriptorSetLayout(RHIDescriptorSetLayout layout)
     {
-        vkDestroyImage(Device, ((VulkanImage*)image)->GetResource(), nullptr);
+        DeviceTable.vkDestroyDescriptorSetLayout(Device, Resources.Get(layout), nullptr);
+        Resources.Destroy(layout);
     }
 
-    void VulkanRHI::DestroyFramebuffer(RHIFramebuffer* framebuffer)
+    void VulkanRHI::DestroyDescriptorUpdateTemplate(RHIDescriptorUpdateTemplate updateTemplate)
     {
-        vkDestroyFramebuffer(Device, ((VulkanFramebuffer*)framebuffer)->GetResource(), nullptr);
+        m_DescriptorUpdater.DestroyTemplate(updateTemplate);
     }
 
-    void VulkanRHI::DestroyFence(RHIFence* fence)
+    void VulkanRHI::DestroyFence(RHIFence fence)
     {
-        vkDestroyFence(Device, ((VulkanFence*)fence)->GetResource(), nullptr);
+        DeviceTable.vkDestroyFence(Device, Resources.Get(fence), nullptr);
+        Resources.Destroy(fence);
     }
 
     void VulkanRHI::DestroyDevice()
     {
-        vkDestroyDevice(Device, nullptr);
+        DeviceTable.vkDestroyDevice(Device, nullptr);
+    }
+
+    void VulkanRHI::DestroyCommandPool(RHICommandPool commandPool)
+    {
+        DeviceTable.vkDestroyCommandPool(Device, Resources.Get(commandPool), nullptr);
+        Resources.Destroy(commandPool);
+    }
+
+    void VulkanRHI::DestroyBuffer(RHIBuffer& buffer)
+    {
+        m_DeletionQueue.Enqueue(buffer);
+        buffer = RHI_NULL_HANDLE;
+    }
+
+    void VulkanRHI::FreeCommandBuffers(RHICommandPool commandPool, uint32_t commandBufferCount, RHICommandBuffer pCommandBuffers)
+    {
+        VkCommandBuffer vk_command_buffer = Resources.Get(pCommandBuffers);
+        DeviceTable.vkFreeCommandBuffers(Device, Resources.Get(commandPool), commandBufferCount, &vk_command_buffer);
+        Resources.Destroy(pCommandBuffers);
     }
 
-    void VulkanRHI::DestroyCommandPool(RHICommandPool* commandPool)
+    void VulkanRHI::FreeMemory(RHIDeviceMemory& memory)
     {
-        vkDestroyCommandPool(Device, ((VulkanCommandPool*)commandPool)->GetResource(), nullptr);
+        m_DeletionQueue.Enqueue(memory);
+        memory = RHI_NULL_HANDLE;
     }
 
-    void VulkanRHI::DestroyBuffer(RHIBuffer* &buffer)
+    void VulkanRHI::DestroyImageViewImmediately(RHIImageView imageView)
     {
-        vkDestroyBuffer(Device, ((VulkanBuffer*)buffer)->GetResource(), nullptr);
-        RHI_DELETE_PTR(buffer);
+        m_Defragmenter.UnregisterImageView(imageView);
+        DeviceTable.vkDestroyImageView(Device, Resources.Get(imageView), nullptr);
+        Resources.Destroy(imageView);
     }
 
-    void VulkanRHI::FreeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers)
+    void VulkanRHI::DestroyImageImmediately(RHIImage image)
     {
-        VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)pCommandBuffers)->GetResource();
-        vkFreeCommandBuffers(Device, ((VulkanCommandPool*)commandPool)->GetResource(), commandBufferCount, &vk_command_buffer);
+        DeviceTable.vkDestroyImage(Device, Resources.Get(image), nullptr);
+        Resources.Destroy(image);
     }
 
-    void VulkanRHI::FreeMemory(RHIDeviceMemory* &memory)
+    void VulkanRHI::DestroyRetiredResources(VulkanDeletionQueue::Batch& batch)
     {
-        vkFreeMemory(Device, ((VulkanDeviceMemory*)memory)->GetResource(), nullptr);
-        RHI_DELETE_PTR(memory);
+        if (batch.IsEmpty())
+        {
+            return;
+        }
+
+        if (!batch.DescriptorSets.empty())
+        {
+            ScratchArray<VkDescriptorSet, 16> vkDescriptorSets(batch.DescriptorSets.size());
+            for (size_t i = 0; i < batch.DescriptorSets.size(); ++i)
+            {
+                vkDescriptorSets[i] = Resources.Get(batch.DescriptorSets[i]);
+                Resources.Destroy(batch.DescriptorSets[i]);
+            }
+            m_DescriptorAllocator.FreePersistent(vkDescriptorSets.data(),
+                                                 static_cast<uint32_t>(vkDescriptorSets.size()));
+        }
+        for (RHIFramebuffer framebuffer : batch.Framebuffers)
+        {
+            DeviceTable.vkDestroyFramebuffer(Device, Resources.Get(framebuffer), nullptr);
+            Resources.Destroy(framebuffer);
+        }
+        for (RHIImageView imageView : batch.ImageViews)
+        {
+            DestroyImageViewImmediately(imageView);
+        }
+        for (RHIBuffer buffer : batch.Buffers)
+        {
+            DeviceTable.vkDestroyBuffer(Device, Resources.Get(buffer), nullptr);
+            Resources.Destroy(buffer);
+        }
+        for (RHIImage image : batch.Images)
+        {
+            DestroyImageImmediately(image);
+        }
+        if (!batch.Pipelines.empty())
+        {
+            PollPipelineBatches();
+        }
+        for (RHIPipeline pipeline : batch.Pipelines)
+        {
+            // an async batch fills the VkPipeline in once its job is done, until then the handle goes around again
+            if (FindPipelineBatch(pipeline) != nullptr)
+            {
+                m_DeletionQueue.Enqueue(pipeline);
+                continue;
+            }
+            DeviceTable.vkDestroyPipeline(Device, Resources.Get(pipeline), nullptr);
+            Resources.Destroy(pipeline);
+        }
+        for (RHISampler sampler : batch.Samplers)
+        {
+            m_PipelineManifest.ForgetSampler(Resources.Get(sampler));
+            DeviceTable.vkDestroySampler(Device, Resources.Get(sampler), nullptr);
+            Resources.Destroy(sampler);
+        }
+        for (RHIDeviceMemory memory : batch.Memories)
+        {
+            VmaAllocation allocation = Resources.Get(memory);
+            m_MemoryTracker.Untrack(allocation);
+            if (!m_Defragmenter.Unregister(allocation))
+            {
+                vmaFreeMemory(AssetsAllocator, allocation);
+            }
+            Resources.Destroy(memory);
+        }
+        batch.Clear();
     }
 
-    bool VulkanRHI::MapMemory(RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size, RHIMemoryMapFlags flags, void** ppData)
+    bool VulkanRHI::MapMemory(RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size, RHIMemoryMapFlags flags, void** ppData)
     {
-        VkResult result = vkMapMemory(Device, ((VulkanDeviceMemory*)memory)->GetResource(), offset, size, (VkMemoryMapFlags)flags, ppData);
+        // VMA maps the whole block once and counts references, the allocation may share it with others
+        void*    pData  = nullptr;
+        VkResult result = vmaMapMemory(AssetsAllocator, Resources.Get(memory), &pData);
 
         if (result == VK_SUCCESS)
         {
+            *ppData = static_cast<char*>(pData) + offset;
             return true;
         }
         else
         {
-            GAL_CORE_ERROR("vkMapMemory failed!");
+            GAL_CORE_ERROR("vmaMapMemory failed!");
             return false;
         }
     }
 
-    void VulkanRHI::UnmapMemory(RHIDeviceMemory* memory)
+    void VulkanRHI::UnmapMemory(RHIDeviceMemory memory)
     {
-        vkUnmapMemory(Device, ((VulkanDeviceMemory*)memory)->GetResource());
+        vmaUnmapMemory(AssetsAllocator, Resources.Get(memory));
     }
 
-    void VulkanRHI::InvalidateMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size)
+    void VulkanRHI::InvalidateMappedMemoryRanges(void* pNext, RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size)
     {
-        VkMappedMemoryRange mappedRange{};
-        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mappedRange.memory = ((VulkanDeviceMemory*)memory)->GetResource();
-        mappedRange.offset = offset;
-        mappedRange.size = size;
-        vkInvalidateMappedMemoryRanges(Device, 1, &mappedRange);
+        // offsets are relative to the allocation, VMA translates them and rounds to nonCoherentAtomSize
+        vmaInvalidateAllocation(AssetsAllocator, Resources.Get(memory), offset, size);
     }
 
-    void VulkanRHI::FlushMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size)
+    void VulkanRHI::FlushMappedMemoryRanges(void* pNext, RHIDeviceMemory memory, RHIDeviceSize offset, RHIDeviceSize size)
     {
-        VkMappedMemoryRange mappedRange{};
-        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mappedRange.memory = ((VulkanDeviceMemory*)memory)->GetResource();
-        mappedRange.offset = offset;
-        mappedRange.size = size;
-        vkFlushMappedMemoryRanges(Device, 1, &mappedRange);
+        vmaFlushAllocation(AssetsAllocator, Resources.Get(memory), offset, size);
     }
 
-    RHISemaphore* &VulkanRHI::GetTextureCopySemaphore(uint32_t index)
+    RHISemaphore& VulkanRHI::GetTextureCopySemaphore(uint32_t index)
     {
         return ImageAvailableForTexturescopySemaphores[index];
     }
@@ -2968,22 +3565,24 @@ namespace Galaxy
         }
 
         VkResult resWaitForFences =
-            _vkWaitForFences(Device, MaxFramesInFlight, IsFrameInFlightFences, VK_TRUE, UINT64_MAX);
+            DeviceTable.vkWaitForFences(Device, MaxFramesInFlight, IsFrameInFlightFences, VK_TRUE, UINT64_MAX);
         if (VK_SUCCESS != resWaitForFences)
         {
-            GAL_CORE_ERROR("[VulkanRHI] _vkWaitForFences failed");
+            GAL_CORE_ERROR("[VulkanRHI] vkWaitForFences failed");
             return;
         }
 
-        DestroyImageView(DepthImageView);
-        vkDestroyImage(Device, ((VulkanImage*)DepthImage)->GetResource(), nullptr);
-        vkFreeMemory(Device, DepthImageMemory, nullptr);
+        // every frame is done, nothing to defer. The swapchain views must go before the swapchain does.
+        DestroyImageViewImmediately(DepthImageView);
+        DestroyImageImmediately(DepthImage);
+        m_MemoryTracker.Untrack(DepthImageAllocation);
+        vmaFreeMemory(AssetsAllocator, DepthImageAllocation);
 
         for (auto imageview : SwapchainImageviews)
         {
-            vkDestroyImageView(Device, ((VulkanImageView*)imageview)->GetResource(), nullptr);
+            DestroyImageViewImmediately(imageview);
         }
-        vkDestroySwapchainKHR(Device, Swapchain, nullptr);
+        DeviceTable.vkDestroySwapchainKHR(Device, Swapchain, nullptr);
 
         CreateSwapchain();
         CreateSwapchainImageViews();
@@ -3057,6 +3656,29 @@ namespace Galaxy
             }
             i++;
         }
+
+        // Streaming gets a family of its own when there is one, copy engines run next to the graphics work.
+        // Families without graphics and compute are the pure DMA ones, preferred over async compute.
+        std::optional<uint32_t> asyncComputeFamily;
+        for (uint32_t family = 0; family < queueFamilyCount; family++)
+        {
+            VkQueueFlags flags = queueFamilies[family].queueFlags;
+            if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                continue;
+            }
+            if (flags & VK_QUEUE_COMPUTE_BIT)
+            {
+                asyncComputeFamily = asyncComputeFamily.value_or(family);
+                continue;
+            }
+            indices.transferFamily = family;
+            break;
+        }
+        if (!indices.transferFamily.has_value())
+        {
+            indices.transferFamily = asyncComputeFamily;
+        }
         return indices;
     }
 
@@ -3086,6 +3708,62 @@ namespace Galaxy
         return requiredExtensions.empty();
     }
 
+    bool VulkanRHI::IsDeviceExtensionAvailable(const char* extensionName)
+    {
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+        return std::any_of(availableExtensions.begin(), availableExtensions.end(), [&](const auto& extension) {
+            return strcmp(extension.extensionName, extensionName) == 0;
+        });
+    }
+
+    bool VulkanRHI::CheckBindlessSupport(VkPhysicalDeviceDescriptorIndexingFeatures& outFeatures)
+    {
+        bool isCore = m_VulkanApiVersion >= VK_API_VERSION_1_2;
+        if (!isCore && !IsDeviceExtensionAvailable(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeatures supportedFeatures {};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+        VkPhysicalDeviceFeatures2 physicalDeviceFeatures {};
+        physicalDeviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        physicalDeviceFeatures.pNext = &supportedFeatures;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &physicalDeviceFeatures);
+
+        // unbounded arrays indexed per material, written while the set is bound and only partially filled
+        if (!supportedFeatures.runtimeDescriptorArray || !supportedFeatures.descriptorBindingPartiallyBound ||
+            !supportedFeatures.descriptorBindingUpdateUnusedWhilePending ||
+            !supportedFeatures.descriptorBindingSampledImageUpdateAfterBind ||
+            !supportedFeatures.descriptorBindingStorageBufferUpdateAfterBind ||
+            !supportedFeatures.shaderSampledImageArrayNonUniformIndexing ||
+            !supportedFeatures.shaderStorageBufferArrayNonUniformIndexing)
+        {
+            GAL_CORE_WARN("[VulkanRHI] Descriptor indexing lacks features bindless resources need");
+            return false;
+        }
+
+        outFeatures.runtimeDescriptorArray                        = VK_TRUE;
+        outFeatures.descriptorBindingPartiallyBound               = VK_TRUE;
+        outFeatures.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+        outFeatures.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+        outFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        outFeatures.shaderSampledImageArrayNonUniformIndexing     = VK_TRUE;
+        outFeatures.shaderStorageBufferArrayNonUniformIndexing    = VK_TRUE;
+
+        if (!isCore)
+        {
+            m_DeviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        }
+        return true;
+    }
+
     bool VulkanRHI::IsDeviceSuitable(VkPhysicalDevice physicalDevice)
     {
         auto queueFamilyIndices           = FindQueueFamilies(physicalDevice);
@@ -3101,6 +3779,18 @@ namespace Galaxy
         VkPhysicalDeviceFeatures physicalDeviceFeatures;
         vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures);
 
+        // properties2, features2 and VMA are used at 1.1
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+        if (physicalDeviceProperties.apiVersion < VK_API_VERSION_1_1)
+        {
+            GAL_CORE_WARN("[VulkanRHI] Skipping {0}, it only supports Vulkan {1}.{2}",
+                          physicalDeviceProperties.deviceName,
+                          VK_API_VERSION_MAJOR(physicalDeviceProperties.apiVersion),
+                          VK_API_VERSION_MINOR(physicalDeviceProperties.apiVersion));
+            return false;
+        }
+
         if (!queueFamilyIndices.isComplete() || !isSwapchainAdequate || !physicalDeviceFeatures.samplerAnisotropy)
         {
             return false;
@@ -3221,7 +3911,7 @@ namespace Galaxy
         }
     }
 
-    void VulkanRHI::PushEvent(RHICommandBuffer* commondBuffer, const char* name, const float* color)
+    void VulkanRHI::PushEvent(RHICommandBuffer commondBuffer, const char* name, const float* color)
     {
         if (m_EnableDebugUtilsLabel)
         {
@@ -3231,36 +3921,37 @@ namespace Galaxy
             labelInfo.pLabelName = name;
             for (int i = 0; i < 4; ++i)
                 labelInfo.color[i] = color[i];
-            _vkCmdBeginDebugUtilsLabelEXT(((VulkanCommandBuffer*)commondBuffer)->GetResource(), &labelInfo);
+            _vkCmdBeginDebugUtilsLabelEXT(Resources.Get(commondBuffer), &labelInfo);
         }
     }
 
-    void VulkanRHI::PopEvent(RHICommandBuffer* commondBuffer)
+    void VulkanRHI::PopEvent(RHICommandBuffer commondBuffer)
     {
         if (m_EnableDebugUtilsLabel)
         {
-            _vkCmdEndDebugUtilsLabelEXT(((VulkanCommandBuffer*)commondBuffer)->GetResource());
+            _vkCmdEndDebugUtilsLabelEXT(Resources.Get(commondBuffer));
         }
     }
     bool VulkanRHI::IsPointLightShadowEnabled(){ return m_EnablePointLightShadow; }
 
-    RHICommandBuffer* VulkanRHI::GetCurrentCommandBuffer() const
+    RHICommandBuffer VulkanRHI::GetCurrentCommandBuffer() const
     {
         return CurrentCommandBuffer;
     }
-    RHICommandBuffer* const* VulkanRHI::GetCommandBufferList() const
+    const RHICommandBuffer* VulkanRHI::GetCommandBufferList() const
     {
         return CommandBuffers;
     }
-    RHICommandPool* VulkanRHI::GetCommandPool() const
+    RHICommandPool VulkanRHI::GetCommandPool() const
     {
         return RhiCommandPool;
     }
-    RHIDescriptorPool* VulkanRHI::GetDescriptorPool() const
+    RHIDescriptorPool VulkanRHI::GetDescriptorPool() const
     {
-        return DescriptorPool;
+        // sets allocated without a pool come from m_DescriptorAllocator
+        return nullptr;
     }
-    RHIFence* const* VulkanRHI::GetFenceList() const
+    const RHIFence* VulkanRHI::GetFenceList() const
     {
         return RhiIsFrameInFlightFences;
     }
@@ -3268,14 +3959,18 @@ namespace Galaxy
     {
         return QueueIndices;
     }
-    RHIQueue* VulkanRHI::GetGraphicsQueue() const
+    RHIQueue VulkanRHI::GetGraphicsQueue() const
     {
         return GraphicsQueue;
     }
-    RHIQueue* VulkanRHI::GetComputeQueue() const
+    RHIQueue VulkanRHI::GetComputeQueue() const
     {
         return ComputeQueue;
     }
+    RHIQueue VulkanRHI::GetTransferQueue() const
+    {
+        return TransferQueue;
+    }
     RHISwapChainDesc VulkanRHI::GetSwapchainInfo()
     {
         RHISwapChainDesc desc;
@@ -0,0 +1,159 @@
+//
+// VulkanSamplerCache.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/11/04 14:30.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanSamplerCache.h"
+#include "GalaxyEngine/Core/Hash.h"
+
+namespace Galaxy
+{
+    void VulkanSamplerCache::Initialize(uint32_t maxSamplerCount) { m_MaxSamplerCount = maxSamplerCount; }
+
+    void VulkanSamplerCache::Destroy()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Samplers.clear();
+        m_SharedSamplers.clear();
+    }
+
+    VkSamplerCreateInfo VulkanSamplerCache::Normalize(const VkSamplerCreateInfo& createInfo)
+    {
+        VkSamplerCreateInfo normalized = createInfo;
+        if (!normalized.anisotropyEnable)
+        {
+            normalized.maxAnisotropy = 1.0f;
+        }
+        if (!normalized.compareEnable)
+        {
+            normalized.compareOp = VK_COMPARE_OP_NEVER;
+        }
+
+        // the border color is only read by clamp to border
+        bool usesBorder = normalized.addressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+                          normalized.addressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+                          normalized.addressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        if (!usesBorder)
+        {
+            normalized.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+        }
+        return normalized;
+    }
+
+    RHISampler VulkanSamplerCache::Acquire(const VkSamplerCreateInfo& createInfo)
+    {
+        if (createInfo.pNext != nullptr)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto [begin, end] = m_SharedSamplers.equal_range(Hash(createInfo));
+        for (auto it = begin; it != end; ++it)
+        {
+            Entry& entry = m_Samplers[it->second];
+            if (IsEqual(entry.CreateInfo, createInfo))
+            {
+                ++entry.RefCount;
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    bool VulkanSamplerCache::CanCreate() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Samplers.size() < m_MaxSamplerCount;
+    }
+
+    void VulkanSamplerCache::Insert(const VkSamplerCreateInfo& createInfo, RHISampler sampler)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Entry& entry     = m_Samplers[sampler];
+        entry.CreateInfo = createInfo;
+        entry.RefCount   = 1;
+        entry.IsShared   = createInfo.pNext == nullptr;
+        if (entry.IsShared)
+        {
+            entry.Key = Hash(createInfo);
+            m_SharedSamplers.emplace(entry.Key, sampler);
+        }
+    }
+
+    bool VulkanSamplerCache::Release(RHISampler sampler)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto entryIt = m_Samplers.find(sampler);
+        if (entryIt == m_Samplers.end())
+        {
+            return true;
+        }
+
+        Entry& entry = entryIt->second;
+        if (--entry.RefCount > 0)
+        {
+            return false;
+        }
+
+        if (entry.IsShared)
+        {
+            auto [begin, end] = m_SharedSamplers.equal_range(entry.Key);
+            for (auto it = begin; it != end; ++it)
+            {
+                if (it->second == sampler)
+                {
+                    m_SharedSamplers.erase(it);
+                    break;
+                }
+            }
+        }
+        m_Samplers.erase(entryIt);
+        return true;
+    }
+
+    size_t VulkanSamplerCache::Hash(const VkSamplerCreateInfo& createInfo)
+    {
+        size_t seed = 0;
+        hash_combine(seed,
+                     createInfo.flags,
+                     createInfo.magFilter,
+                     createInfo.minFilter,
+                     createInfo.mipmapMode,
+                     createInfo.addressModeU,
+                     createInfo.addressModeV,
+                     createInfo.addressModeW,
+                     createInfo.mipLodBias);
+        hash_combine(seed,
+                     createInfo.anisotropyEnable,
+                     createInfo.maxAnisotropy,
+                     createInfo.compareEnable,
+                     createInfo.compareOp,
+                     createInfo.minLod,
+                     createInfo.maxLod,
+                     createInfo.borderColor,
+                     createInfo.unnormalizedCoordinates);
+        return seed;
+    }
+
+    size_t VulkanSamplerCache::GetSamplerCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Samplers.size();
+    }
+
+    bool VulkanSamplerCache::IsEqual(const VkSamplerCreateInfo& lhs, const VkSamplerCreateInfo& rhs)
+    {
+        return lhs.flags == rhs.flags && lhs.magFilter == rhs.magFilter && lhs.minFilter == rhs.minFilter &&
+               lhs.mipmapMode == rhs.mipmapMode && lhs.addressModeU == rhs.addressModeU &&
+               lhs.addressModeV == rhs.addressModeV && lhs.addressModeW == rhs.addressModeW &&
+               lhs.mipLodBias == rhs.mipLodBias && lhs.anisotropyEnable == rhs.anisotropyEnable &&
+               lhs.maxAnisotropy == rhs.maxAnisotropy && lhs.compareEnable == rhs.compareEnable &&
+               lhs.compareOp == rhs.compareOp && lhs.minLod == rhs.minLod && lhs.maxLod == rhs.maxLod &&
+               lhs.borderColor == rhs.borderColor && lhs.unnormalizedCoordinates == rhs.unnormalizedCoordinates;
+    }
+} // namespace Galaxy
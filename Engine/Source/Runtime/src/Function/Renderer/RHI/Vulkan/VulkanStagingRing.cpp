@@ -0,0 +1,368 @@
+//
+// VulkanStagingRing.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/11/01 10:15.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanStagingRing.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+namespace Galaxy
+{
+    namespace
+    {
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    bool VulkanStagingRing::Initialize(const VulkanDeviceTable& device,
+                                       VmaAllocator             allocator,
+                                       VulkanMemoryTracker&     tracker,
+                                       VkQueue                  queue,
+                                       uint32_t                 queueFamilyIndex,
+                                       VkDeviceSize             capacity)
+    {
+        m_Device    = &device;
+        m_Allocator = allocator;
+        m_Tracker   = &tracker;
+        m_Queue     = queue;
+        m_Capacity  = capacity;
+
+        VkCommandPoolCreateInfo poolCreateInfo {};
+        poolCreateInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+        poolCreateInfo.flags =
+            VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        if (m_Device->vkCreateCommandPool(m_Device->Device, &poolCreateInfo, nullptr, &m_CommandPool) != VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanStagingRing] Failed to create the upload command pool");
+            m_Device = nullptr;
+            return false;
+        }
+
+        VkBufferCreateInfo bufferCreateInfo {};
+        bufferCreateInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.size        = capacity;
+        bufferCreateInfo.usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        // written front to back with memcpy only, so write combined memory is fine and mapped for good
+        VmaAllocationCreateInfo allocationCreateInfo {};
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationCreateInfo.flags =
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocationInfo {};
+        if (vmaCreateBuffer(
+                m_Allocator, &bufferCreateInfo, &allocationCreateInfo, &m_Buffer, &m_Allocation, &allocationInfo) !=
+            VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanStagingRing] Failed to create a staging ring of {0} bytes", capacity);
+            Destroy();
+            return false;
+        }
+        m_pMapped = static_cast<unsigned char*>(allocationInfo.pMappedData);
+        m_Tracker->Track(m_Allocation, Memory_Category_Staging);
+
+        GAL_CORE_INFO("[VulkanStagingRing] Created with {0} MiB", capacity >> 20);
+        return true;
+    }
+
+    void VulkanStagingRing::Destroy()
+    {
+        if (m_Device == nullptr)
+        {
+            return;
+        }
+
+        if (m_Buffer != VK_NULL_HANDLE)
+        {
+            WaitIdle();
+            m_Tracker->Untrack(m_Allocation);
+            vmaDestroyBuffer(m_Allocator, m_Buffer, m_Allocation);
+        }
+
+        // command buffers go with their pool
+        for (const Batch& batch : m_FreeBatches)
+        {
+            m_Device->vkDestroyFence(m_Device->Device, batch.Fence, nullptr);
+        }
+        if (m_Open.Fence != VK_NULL_HANDLE)
+        {
+            m_Device->vkDestroyFence(m_Device->Device, m_Open.Fence, nullptr);
+        }
+        m_Device->vkDestroyCommandPool(m_Device->Device, m_CommandPool, nullptr);
+
+        m_FreeBatches.clear();
+        m_Open        = {};
+        m_Buffer      = VK_NULL_HANDLE;
+        m_Allocation  = VK_NULL_HANDLE;
+        m_pMapped     = nullptr;
+        m_CommandPool = VK_NULL_HANDLE;
+        m_Head        = 0;
+        m_Tail        = 0;
+        m_Device      = nullptr;
+    }
+
+    bool VulkanStagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, VulkanStagingAllocation& outAllocation)
+    {
+        GAL_CORE_ASSERT(size > 0, "[VulkanStagingRing] Empty upload");
+
+        // one upload taking most of the ring would drain it every time
+        if (size > m_Capacity / 2)
+        {
+            return AllocateDedicated(size, outAllocation);
+        }
+
+        VkDeviceSize offset = 0;
+        while (!TryAllocate(size, alignment, offset))
+        {
+            // everything left is held by the open batch, it has to be submitted before it can be waited for
+            if (m_InFlight.empty())
+            {
+                Submit();
+            }
+
+            m_Stalls++;
+            m_Device->vkWaitForFences(m_Device->Device, 1, &m_InFlight.front().Fence, VK_TRUE, UINT64_MAX);
+            Retire();
+        }
+
+        if (!m_Open.HasAllocations)
+        {
+            m_Open.Begin          = offset;
+            m_Open.HasAllocations = true;
+        }
+        m_Open.End = offset + size;
+        m_Head     = offset + size;
+
+        outAllocation.Buffer  = m_Buffer;
+        outAllocation.Offset  = offset;
+        outAllocation.pMapped = m_pMapped + offset;
+        return true;
+    }
+
+    VkCommandBuffer VulkanStagingRing::GetCommandBuffer()
+    {
+        if (m_Open.IsRecording)
+        {
+            return m_Open.CommandBuffer;
+        }
+
+        if (m_Open.CommandBuffer == VK_NULL_HANDLE)
+        {
+            if (!m_FreeBatches.empty())
+            {
+                m_Open.CommandBuffer = m_FreeBatches.back().CommandBuffer;
+                m_Open.Fence         = m_FreeBatches.back().Fence;
+                m_FreeBatches.pop_back();
+            }
+            else
+            {
+                VkCommandBufferAllocateInfo allocateInfo {};
+                allocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocateInfo.commandPool        = m_CommandPool;
+                allocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                allocateInfo.commandBufferCount = 1;
+                m_Device->vkAllocateCommandBuffers(m_Device->Device, &allocateInfo, &m_Open.CommandBuffer);
+
+                VkFenceCreateInfo fenceCreateInfo {};
+                fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                m_Device->vkCreateFence(m_Device->Device, &fenceCreateInfo, nullptr, &m_Open.Fence);
+            }
+        }
+
+        VkCommandBufferBeginInfo beginInfo {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        m_Device->vkBeginCommandBuffer(m_Open.CommandBuffer, &beginInfo);
+
+        m_Open.IsRecording = true;
+        return m_Open.CommandBuffer;
+    }
+
+    void VulkanStagingRing::Submit()
+    {
+        if (!m_Open.IsRecording && !m_Open.HasAllocations && m_Open.DedicatedBuffers.empty())
+        {
+            return;
+        }
+
+        // space written without any copy recorded still has to retire in order
+        VkCommandBuffer commandBuffer = GetCommandBuffer();
+        m_Device->vkEndCommandBuffer(commandBuffer);
+        FlushBatchRange(m_Open);
+
+        VkSubmitInfo submitInfo {};
+        submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers    = &commandBuffer;
+
+        m_Device->vkResetFences(m_Device->Device, 1, &m_Open.Fence);
+        if (m_Device->vkQueueSubmit(m_Queue, 1, &submitInfo, m_Open.Fence) != VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanStagingRing] Failed to submit uploads");
+        }
+
+        m_Open.IsRecording = false;
+        m_InFlight.push_back(std::move(m_Open));
+        m_Open = {};
+        m_Submits++;
+    }
+
+    void VulkanStagingRing::Retire()
+    {
+        size_t retired = 0;
+        while (retired < m_InFlight.size() &&
+               m_Device->vkGetFenceStatus(m_Device->Device, m_InFlight[retired].Fence) == VK_SUCCESS)
+        {
+            RetireBatch(m_InFlight[retired]);
+            retired++;
+        }
+        m_InFlight.erase(m_InFlight.begin(), m_InFlight.begin() + retired);
+    }
+
+    void VulkanStagingRing::WaitIdle()
+    {
+        Submit();
+
+        std::vector<VkFence> fences;
+        for (const Batch& batch : m_InFlight)
+        {
+            fences.push_back(batch.Fence);
+        }
+        if (!fences.empty())
+        {
+            m_Device->vkWaitForFences(
+                m_Device->Device, static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, UINT64_MAX);
+        }
+        Retire();
+    }
+
+    VulkanStagingRingStats VulkanStagingRing::GetStats() const
+    {
+        VulkanStagingRingStats stats;
+        stats.Capacity         = m_Capacity;
+        stats.BatchesInFlight  = static_cast<uint32_t>(m_InFlight.size());
+        stats.Submits          = m_Submits;
+        stats.Stalls           = m_Stalls;
+        stats.DedicatedBuffers = m_DedicatedBuffers;
+        if (!IsEmpty())
+        {
+            stats.UsedSize = m_Head > m_Tail ? m_Head - m_Tail : m_Capacity - m_Tail + m_Head;
+        }
+        return stats;
+    }
+
+    bool VulkanStagingRing::TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset)
+    {
+        if (IsEmpty())
+        {
+            m_Head = 0;
+            m_Tail = 0;
+        }
+
+        VkDeviceSize offset = AlignUp(m_Head, alignment);
+        if (m_Head >= m_Tail)
+        {
+            // free space is [m_Head, m_Capacity) and [0, m_Tail), the end of the ring is skipped when wrapping
+            if (offset + size <= m_Capacity)
+            {
+                outOffset = offset;
+                return true;
+            }
+            if (size < m_Tail)
+            {
+                outOffset = 0;
+                return true;
+            }
+            return false;
+        }
+
+        // wrapped, stop short of m_Tail so a full ring never looks empty
+        if (offset + size < m_Tail)
+        {
+            outOffset = offset;
+            return true;
+        }
+        return false;
+    }
+
+    bool VulkanStagingRing::AllocateDedicated(VkDeviceSize size, VulkanStagingAllocation& outAllocation)
+    {
+        VkBufferCreateInfo bufferCreateInfo {};
+        bufferCreateInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.size        = size;
+        bufferCreateInfo.usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocationCreateInfo {};
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                                     VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+        VkBuffer          buffer     = VK_NULL_HANDLE;
+        VmaAllocation     allocation = VK_NULL_HANDLE;
+        VmaAllocationInfo allocationInfo {};
+        if (vmaCreateBuffer(
+                m_Allocator, &bufferCreateInfo, &allocationCreateInfo, &buffer, &allocation, &allocationInfo) !=
+            VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanStagingRing] Failed to create a staging buffer of {0} bytes", size);
+            return false;
+        }
+
+        m_Tracker->Track(allocation, Memory_Category_Staging);
+        m_Open.DedicatedBuffers.emplace_back(buffer, allocation);
+        m_DedicatedBuffers++;
+
+        outAllocation.Buffer  = buffer;
+        outAllocation.Offset  = 0;
+        outAllocation.pMapped = allocationInfo.pMappedData;
+        return true;
+    }
+
+    void VulkanStagingRing::FlushBatchRange(const Batch& batch)
+    {
+        // no-ops on coherent memory
+        if (batch.HasAllocations)
+        {
+            if (batch.Begin < batch.End)
+            {
+                vmaFlushAllocation(m_Allocator, m_Allocation, batch.Begin, batch.End - batch.Begin);
+            }
+            else
+            {
+                vmaFlushAllocation(m_Allocator, m_Allocation, batch.Begin, m_Capacity - batch.Begin);
+                vmaFlushAllocation(m_Allocator, m_Allocation, 0, batch.End);
+            }
+        }
+        for (const auto& [buffer, allocation] : batch.DedicatedBuffers)
+        {
+            vmaFlushAllocation(m_Allocator, allocation, 0, VK_WHOLE_SIZE);
+        }
+    }
+
+    void VulkanStagingRing::RetireBatch(Batch& batch)
+    {
+        if (batch.HasAllocations)
+        {
+            m_Tail = batch.End;
+        }
+        for (const auto& [buffer, allocation] : batch.DedicatedBuffers)
+        {
+            m_Tracker->Untrack(allocation);
+            vmaDestroyBuffer(m_Allocator, buffer, allocation);
+        }
+
+        m_RetiredBatches++;
+
+        Batch freeBatch;
+        freeBatch.CommandBuffer = batch.CommandBuffer;
+        freeBatch.Fence         = batch.Fence;
+        m_FreeBatches.push_back(std::move(freeBatch));
+    }
+} // namespace Galaxy
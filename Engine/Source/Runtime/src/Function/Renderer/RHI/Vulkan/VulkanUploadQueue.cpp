@@ -0,0 +1,256 @@
+//
+// VulkanUploadQueue.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/11/02 14:20.
+//
+
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanUploadQueue.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanRHI.h"
+#include "GalaxyEngine/Function/Renderer/RHI/Vulkan/VulkanUtil.h"
+
+#include <cstring>
+
+namespace Galaxy
+{
+    void VulkanUploadQueue::Initialize(VulkanRHI& rhi, VulkanStagingRing* pTransferRing, uint32_t transferFamily)
+    {
+        m_RHI           = &rhi;
+        m_pTransferRing = pTransferRing;
+
+        if (IsDedicated())
+        {
+            m_SrcQueueFamily = transferFamily;
+            m_DstQueueFamily = rhi.QueueIndices.graphicsFamily.value();
+            GAL_CORE_INFO("[VulkanUploadQueue] Streaming through transfer queue family {0}", transferFamily);
+        }
+        else
+        {
+            GAL_CORE_INFO("[VulkanUploadQueue] No dedicated transfer queue, streaming through the graphics queue");
+        }
+    }
+
+    void VulkanUploadQueue::Destroy()
+    {
+        m_Pending.clear();
+        m_CompletedTicket = m_LastTicket;
+        m_pTransferRing   = nullptr;
+        m_RHI             = nullptr;
+    }
+
+    RHIUploadTicket
+    VulkanUploadQueue::UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size)
+    {
+        VulkanStagingRing& ring = IsDedicated() ? *m_pTransferRing : m_RHI->GetStagingRing();
+
+        VulkanStagingAllocation staging;
+        if (!ring.Allocate(size, 16, staging))
+        {
+            return RHI_INVALID_UPLOAD_TICKET;
+        }
+        memcpy(staging.pMapped, pData, static_cast<size_t>(size));
+
+        VkCommandBuffer commandBuffer = ring.GetCommandBuffer();
+
+        VkBufferCopy copyRegion = {staging.Offset, dstOffset, size};
+        m_RHI->DeviceTable.vkCmdCopyBuffer(commandBuffer, staging.Buffer, dstBuffer, 1, &copyRegion);
+
+        PendingUpload upload;
+        upload.Buffer = dstBuffer;
+        upload.Offset = dstOffset;
+        upload.Size   = size;
+        return Track(commandBuffer, upload);
+    }
+
+    RHIUploadTicket VulkanUploadQueue::UploadImage(VkImage      dstImage,
+                                                   VkFormat     format,
+                                                   uint32_t     width,
+                                                   uint32_t     height,
+                                                   uint32_t     layerCount,
+                                                   uint32_t     mipLevels,
+                                                   const void*  pData,
+                                                   VkDeviceSize size)
+    {
+        VulkanStagingRing& ring = IsDedicated() ? *m_pTransferRing : m_RHI->GetStagingRing();
+
+        VkDeviceSize            texelSize = size / (static_cast<VkDeviceSize>(width) * height * layerCount);
+        VulkanStagingAllocation staging;
+        if (!ring.Allocate(size, VulkanUtil::GetCopyOffsetAlignment(texelSize), staging))
+        {
+            return RHI_INVALID_UPLOAD_TICKET;
+        }
+        memcpy(staging.pMapped, pData, static_cast<size_t>(size));
+
+        VkCommandBuffer commandBuffer = ring.GetCommandBuffer();
+
+        // every level goes to transfer dst, mip 0 is copied now and the others are blitted on the graphics queue
+        VulkanUtil::TransitionImageLayout(m_RHI,
+                                          commandBuffer,
+                                          dstImage,
+                                          VK_IMAGE_LAYOUT_UNDEFINED,
+                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          layerCount,
+                                          mipLevels,
+                                          VK_IMAGE_ASPECT_COLOR_BIT);
+        VulkanUtil::CopyBufferToImage(
+            m_RHI, commandBuffer, staging.Buffer, staging.Offset, dstImage, width, height, layerCount);
+
+        PendingUpload upload;
+        upload.Image      = dstImage;
+        upload.Format     = format;
+        upload.Width      = width;
+        upload.Height     = height;
+        upload.LayerCount = layerCount;
+        upload.MipLevels  = mipLevels;
+        return Track(commandBuffer, upload);
+    }
+
+    void VulkanUploadQueue::Submit()
+    {
+        if (IsDedicated())
+        {
+            m_pTransferRing->Submit();
+        }
+    }
+
+    void VulkanUploadQueue::Poll()
+    {
+        if (!IsDedicated())
+        {
+            return;
+        }
+
+        m_pTransferRing->Retire();
+        uint64_t retiredSerial = m_pTransferRing->GetRetiredBatchSerial();
+        if (m_Pending.empty() || m_Pending.front().BatchSerial > retiredSerial)
+        {
+            return;
+        }
+
+        // the transfer fence was waited for on the host already, no semaphore needed between the queues
+        VkCommandBuffer commandBuffer = m_RHI->GetStagingRing().GetCommandBuffer();
+        while (!m_Pending.empty() && m_Pending.front().BatchSerial <= retiredSerial)
+        {
+            RecordAcquire(commandBuffer, m_Pending.front());
+            m_CompletedTicket = m_Pending.front().Ticket;
+            m_Pending.pop_front();
+        }
+    }
+
+    void VulkanUploadQueue::Wait(RHIUploadTicket ticket)
+    {
+        if (ticket == RHI_INVALID_UPLOAD_TICKET || IsComplete(ticket))
+        {
+            return;
+        }
+
+        m_pTransferRing->WaitIdle();
+        Poll();
+    }
+
+    RHIUploadTicket VulkanUploadQueue::Track(VkCommandBuffer commandBuffer, PendingUpload& upload)
+    {
+        upload.Ticket = ++m_LastTicket;
+
+        if (!IsDedicated())
+        {
+            RecordAcquire(commandBuffer, upload);
+            m_CompletedTicket = upload.Ticket;
+            return upload.Ticket;
+        }
+
+        RecordBarrier(commandBuffer, upload, true);
+        upload.BatchSerial = m_pTransferRing->GetOpenBatchSerial();
+        m_Pending.push_back(upload);
+        return upload.Ticket;
+    }
+
+    void VulkanUploadQueue::RecordBarrier(VkCommandBuffer commandBuffer, const PendingUpload& upload, bool isRelease)
+    {
+        bool isImage       = upload.Image != VK_NULL_HANDLE;
+        bool needsMipChain = isImage && upload.MipLevels > 1;
+
+        // what the graphics queue does with the data next
+        VkAccessFlags        dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        VkPipelineStageFlags dstStageMask  = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkImageLayout        newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        if (needsMipChain)
+        {
+            dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            dstStageMask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            newLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        }
+        else if (isImage)
+        {
+            dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            dstStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        }
+
+        VkAccessFlags        srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        VkPipelineStageFlags srcStageMask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        if (isRelease)
+        {
+            dstAccessMask = 0;
+            dstStageMask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        }
+        else if (IsDedicated())
+        {
+            srcAccessMask = 0;
+            srcStageMask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+
+        const VulkanDeviceTable& device = m_RHI->DeviceTable;
+        if (isImage)
+        {
+            VkImageMemoryBarrier barrier {};
+            barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask                   = srcAccessMask;
+            barrier.dstAccessMask                   = dstAccessMask;
+            barrier.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout                       = newLayout;
+            barrier.srcQueueFamilyIndex             = m_SrcQueueFamily;
+            barrier.dstQueueFamilyIndex             = m_DstQueueFamily;
+            barrier.image                           = upload.Image;
+            barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel   = 0;
+            barrier.subresourceRange.levelCount     = upload.MipLevels;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount     = upload.LayerCount;
+
+            device.vkCmdPipelineBarrier(
+                commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+        else
+        {
+            VkBufferMemoryBarrier barrier {};
+            barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask       = srcAccessMask;
+            barrier.dstAccessMask       = dstAccessMask;
+            barrier.srcQueueFamilyIndex = m_SrcQueueFamily;
+            barrier.dstQueueFamilyIndex = m_DstQueueFamily;
+            barrier.buffer              = upload.Buffer;
+            barrier.offset              = upload.Offset;
+            barrier.size                = upload.Size;
+
+            device.vkCmdPipelineBarrier(
+                commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+    }
+
+    void VulkanUploadQueue::RecordAcquire(VkCommandBuffer commandBuffer, const PendingUpload& upload)
+    {
+        RecordBarrier(commandBuffer, upload, false);
+
+        if (upload.Image != VK_NULL_HANDLE && upload.MipLevels > 1)
+        {
+            VulkanUtil::GenerateTextureMipMaps(m_RHI,
+                                               commandBuffer,
+                                               upload.Image,
+                                               upload.Format,
+                                               upload.Width,
+                                               upload.Height,
+                                               upload.LayerCount,
+                                               upload.MipLevels);
+        }
+    }
+} // namespace Galaxy
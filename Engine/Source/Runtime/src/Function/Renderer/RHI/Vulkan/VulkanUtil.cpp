@@ -5,13 +5,10 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <numeric>
 
 namespace Galaxy
 {
-    std::unordered_map<uint32_t, VkSampler> VulkanUtil::s_mipmap_sampler_map;
-    VkSampler                               VulkanUtil::s_nearest_sampler = VK_NULL_HANDLE;
-    VkSampler                               VulkanUtil::s_linear_sampler  = VK_NULL_HANDLE;
-
     uint32_t VulkanUtil::FindMemoryType(VkPhysicalDevice      physicalDevice,
                                         uint32_t              typeFilter,
                                         VkMemoryPropertyFlags propertiesFlag)
@@ -30,7 +27,8 @@ namespace Galaxy
         return 0;
     }
 
-    VkShaderModule VulkanUtil::CreateShaderModule(VkDevice device, const std::vector<unsigned char>& shaderCode)
+    VkShaderModule VulkanUtil::CreateShaderModule(const VulkanDeviceTable&          device,
+                                                  const std::vector<unsigned char>& shaderCode)
     {
         VkShaderModuleCreateInfo shaderModuleCreateInfo {};
         shaderModuleCreateInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -38,95 +36,68 @@ namespace Galaxy
         shaderModuleCreateInfo.pCode    = reinterpret_cast<const uint32_t*>(shaderCode.data());
 
         VkShaderModule shaderModule;
-        if (vkCreateShaderModule(device, &shaderModuleCreateInfo, nullptr, &shaderModule) != VK_SUCCESS)
+        if (device.vkCreateShaderModule(device.Device, &shaderModuleCreateInfo, nullptr, &shaderModule) != VK_SUCCESS)
         {
             return VK_NULL_HANDLE;
         }
         return shaderModule;
     }
 
-    void VulkanUtil::CreateBufferAndInitialize(VkDevice              device,
-                                               VkPhysicalDevice      physicalDevice,
+    VmaAllocationCreateInfo VulkanUtil::GetAllocationCreateInfo(VkMemoryPropertyFlags properties)
+    {
+        VmaAllocationCreateInfo allocationCreateInfo {};
+        allocationCreateInfo.requiredFlags = properties;
+
+        if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            // cached memory is asked for to read results back, everything else is only written by the CPU
+            allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+            allocationCreateInfo.flags = (properties & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) ?
+                                             VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT :
+                                             VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        }
+        else
+        {
+            allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        }
+        return allocationCreateInfo;
+    }
+
+    void VulkanUtil::CreateBufferAndInitialize(VmaAllocator          allocator,
                                                VkBufferUsageFlags    usageFlags,
                                                VkMemoryPropertyFlags memoryPropertyFlags,
                                                VkBuffer*             buffer,
-                                               VkDeviceMemory*       memory,
+                                               VmaAllocation*        allocation,
                                                VkDeviceSize          size,
                                                void*                 data,
                                                int                   datasize)
     {
-        // Create the buffer handle
-        VkBufferCreateInfo bufferCreateInfo {};
-        bufferCreateInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferCreateInfo.usage       = usageFlags;
-        bufferCreateInfo.size        = size;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        if (VK_SUCCESS != vkCreateBuffer(device, &bufferCreateInfo, nullptr, buffer))
-        {
-            GAL_CORE_ERROR("[VulkanUtil] create buffer buffer failed!");
-            return;
-        }
-
-        // Create the memory backing up the buffer handle
-        VkPhysicalDeviceMemoryProperties deviceMemoryProperties;
-        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &deviceMemoryProperties);
-        VkMemoryRequirements memReqs;
-        VkMemoryAllocateInfo memAlloc {};
-        memAlloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        vkGetBufferMemoryRequirements(device, *buffer, &memReqs);
-        memAlloc.allocationSize = memReqs.size;
-
-        // Find a memory type index that fits the properties of the buffer
-        bool memTypeFound = false;
-        for (uint32_t i = 0; i < deviceMemoryProperties.memoryTypeCount; i++)
+        CreateBuffer(allocator, size, usageFlags, memoryPropertyFlags, *buffer, *allocation);
+        if (*allocation == VK_NULL_HANDLE)
         {
-            if ((memReqs.memoryTypeBits & 1) == 1)
-            {
-                if ((deviceMemoryProperties.memoryTypes[i].propertyFlags & memoryPropertyFlags) == memoryPropertyFlags)
-                {
-                    memAlloc.memoryTypeIndex = i;
-                    memTypeFound             = true;
-                }
-            }
-            memReqs.memoryTypeBits >>= 1;
-        }
-        if (!memTypeFound)
-        {
-            GAL_CORE_ERROR("[VulkanUtil] memTypeFound is nullptr");
-            return;
-        }
-        if (VK_SUCCESS != vkAllocateMemory(device, &memAlloc, nullptr, memory))
-        {
-            GAL_CORE_ERROR("[VulkanUtil] alloc memory failed!");
             return;
         }
 
         if (data != nullptr && datasize != 0)
         {
             void* mapped;
-            if (VK_SUCCESS != vkMapMemory(device, *memory, 0, size, 0, &mapped))
+            if (VK_SUCCESS != vmaMapMemory(allocator, *allocation, &mapped))
             {
                 GAL_CORE_ERROR("[VulkanUtil] map memory failed!");
                 return;
             }
             memcpy(mapped, data, datasize);
-            vkUnmapMemory(device, *memory);
-        }
-
-        if (VK_SUCCESS != vkBindBufferMemory(device, *buffer, *memory, 0))
-        {
-            GAL_CORE_ERROR("[VulkanUtil] bind memory failed!");
-            return;
+            vmaFlushAllocation(allocator, *allocation, 0, datasize);
+            vmaUnmapMemory(allocator, *allocation);
         }
     }
 
-    void VulkanUtil::CreateBuffer(VkPhysicalDevice      physicalDevice,
-                                  VkDevice              device,
+    void VulkanUtil::CreateBuffer(VmaAllocator          allocator,
                                   VkDeviceSize          size,
                                   VkBufferUsageFlags    usage,
                                   VkMemoryPropertyFlags properties,
                                   VkBuffer&             buffer,
-                                  VkDeviceMemory&       bufferMemory)
+                                  VmaAllocation&        allocation)
     {
         VkBufferCreateInfo bufferCreateInfo {};
         bufferCreateInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -134,30 +105,16 @@ namespace Galaxy
         bufferCreateInfo.usage       = usage;                     // use as a vertex/staging/index buffer
         bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // not sharing among queue families
 
-        if (vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer) != VK_SUCCESS)
-        {
-            GAL_CORE_ERROR("[VulkanUtil] vkCreateBuffer failed!");
-            return;
-        }
-
-        VkMemoryRequirements bufferMemoryRequirements; // for allocate_info.allocationSize and
-                                                         // allocate_info.memoryTypeIndex
-        vkGetBufferMemoryRequirements(device, buffer, &bufferMemoryRequirements);
+        // sub-allocated from a larger block, VMA picks a dedicated allocation where the driver prefers one
+        VmaAllocationCreateInfo allocationCreateInfo = GetAllocationCreateInfo(properties);
 
-        VkMemoryAllocateInfo bufferMemoryAllocateInfo {};
-        bufferMemoryAllocateInfo.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        bufferMemoryAllocateInfo.allocationSize = bufferMemoryRequirements.size;
-        bufferMemoryAllocateInfo.memoryTypeIndex =
-            VulkanUtil::FindMemoryType(physicalDevice, bufferMemoryRequirements.memoryTypeBits, properties);
-
-        if (vkAllocateMemory(device, &bufferMemoryAllocateInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+        if (vmaCreateBuffer(allocator, &bufferCreateInfo, &allocationCreateInfo, &buffer, &allocation, nullptr) !=
+            VK_SUCCESS)
         {
-            GAL_CORE_ERROR("[VulkanUtil] vkAllocateMemory failed!");
-            return;
+            GAL_CORE_ERROR("[VulkanUtil] vmaCreateBuffer failed!");
+            buffer     = VK_NULL_HANDLE;
+            allocation = VK_NULL_HANDLE;
         }
-
-        // bind buffer with buffer memory
-        vkBindBufferMemory(device, buffer, bufferMemory, 0); // offset = 0
     }
 
     void VulkanUtil::CopyBuffer(RHI*         rhi,
@@ -173,28 +130,47 @@ namespace Galaxy
             return;
         }
 
-        RHICommandBuffer* rhiCommandBuffer = static_cast<VulkanRHI*>(rhi)->BeginSingleTimeCommands();
-        VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)rhiCommandBuffer)->GetResource();
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
 
-        VkBufferCopy copyRegion = {srcOffset, dstOffset, size};
-        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+        // goes out with the next upload batch instead of waiting for the queue
+        VkCommandBuffer commandBuffer = static_cast<VulkanRHI*>(rhi)->GetStagingRing().GetCommandBuffer();
 
-        static_cast<VulkanRHI*>(rhi)->EndSingleTimeCommands(rhiCommandBuffer);
+        VkBufferCopy copyRegion = {srcOffset, dstOffset, size};
+        device.vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+
+        // the frame's draws run after the batch on the same queue, whatever they read the buffer as
+        VkBufferMemoryBarrier barrier {};
+        barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask       = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                      VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer              = dstBuffer;
+        barrier.offset              = dstOffset;
+        barrier.size                = size;
+
+        device.vkCmdPipelineBarrier(commandBuffer,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                    0,
+                                    0,
+                                    nullptr,
+                                    1,
+                                    &barrier,
+                                    0,
+                                    nullptr);
     }
 
-    void VulkanUtil::CreateImage(VkPhysicalDevice      physicalDevice,
-                                 VkDevice              device,
-                                 uint32_t              imageWidth,
-                                 uint32_t              imageHeight,
-                                 VkFormat              format,
-                                 VkImageTiling         imageTiling,
-                                 VkImageUsageFlags     imageUsageFlags,
-                                 VkMemoryPropertyFlags memoryPropertyFlags,
-                                 VkImage&              image,
-                                 VkDeviceMemory&       memory,
-                                 VkImageCreateFlags    imageCreateFlags,
-                                 uint32_t              arrayLayers,
-                                 uint32_t              miplevels)
+    VkImageCreateInfo VulkanUtil::GetImageCreateInfo(uint32_t           imageWidth,
+                                                     uint32_t           imageHeight,
+                                                     VkFormat           format,
+                                                     VkImageTiling      imageTiling,
+                                                     VkImageUsageFlags  imageUsageFlags,
+                                                     VkImageCreateFlags imageCreateFlags,
+                                                     uint32_t           arrayLayers,
+                                                     uint32_t           miplevels)
     {
         VkImageCreateInfo imageCreateInfo {};
         imageCreateInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -211,38 +187,50 @@ namespace Galaxy
         imageCreateInfo.usage         = imageUsageFlags;
         imageCreateInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
         imageCreateInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        return imageCreateInfo;
+    }
 
-        if (vkCreateImage(device, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
-        {
-            GAL_CORE_ERROR("[VulkanUtil] failed to create image!");
-            return;
-        }
-
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(device, image, &memRequirements);
+    void VulkanUtil::CreateImage(VmaAllocator          allocator,
+                                 uint32_t              imageWidth,
+                                 uint32_t              imageHeight,
+                                 VkFormat              format,
+                                 VkImageTiling         imageTiling,
+                                 VkImageUsageFlags     imageUsageFlags,
+                                 VkMemoryPropertyFlags memoryPropertyFlags,
+                                 VkImage&              image,
+                                 VmaAllocation&        allocation,
+                                 VkImageCreateFlags    imageCreateFlags,
+                                 uint32_t              arrayLayers,
+                                 uint32_t              miplevels)
+    {
+        VkImageCreateInfo imageCreateInfo = GetImageCreateInfo(
+            imageWidth, imageHeight, format, imageTiling, imageUsageFlags, imageCreateFlags, arrayLayers, miplevels);
 
-        VkMemoryAllocateInfo allocInfo {};
-        allocInfo.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex =
-            FindMemoryType(physicalDevice, memRequirements.memoryTypeBits, memoryPropertyFlags);
+        VmaAllocationCreateInfo allocationCreateInfo = GetAllocationCreateInfo(memoryPropertyFlags);
 
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+        // render targets are large, live as long as the swapchain and some drivers compress them only when they own
+        // their memory
+        if (imageUsageFlags & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
         {
-            GAL_CORE_ERROR("[VulkanUtil] failed to allocate image memory!");
-            return;
+            allocationCreateInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
         }
 
-        vkBindImageMemory(device, image, memory, 0);
+        if (vmaCreateImage(allocator, &imageCreateInfo, &allocationCreateInfo, &image, &allocation, nullptr) !=
+            VK_SUCCESS)
+        {
+            GAL_CORE_ERROR("[VulkanUtil] failed to create image!");
+            image      = VK_NULL_HANDLE;
+            allocation = VK_NULL_HANDLE;
+        }
     }
 
-    VkImageView VulkanUtil::CreateImageView(VkDevice           device,
-                                            VkImage&           image,
-                                            VkFormat           format,
-                                            VkImageAspectFlags imageAspectFlags,
-                                            VkImageViewType    viewType,
-                                            uint32_t           layoutCount,
-                                            uint32_t           miplevels)
+    VkImageView VulkanUtil::CreateImageView(const VulkanDeviceTable& device,
+                                            VkImage&                 image,
+                                            VkFormat                 format,
+                                            VkImageAspectFlags       imageAspectFlags,
+                                            VkImageViewType          viewType,
+                                            uint32_t                 layoutCount,
+                                            uint32_t                 miplevels)
     {
         VkImageViewCreateInfo imageViewCreateInfo {};
         imageViewCreateInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -256,7 +244,7 @@ namespace Galaxy
         imageViewCreateInfo.subresourceRange.layerCount     = layoutCount;
 
         VkImageView imageView;
-        if (vkCreateImageView(device, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
+        if (device.vkCreateImageView(device.Device, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
         {
             return imageView;
             // todo
@@ -275,6 +263,8 @@ namespace Galaxy
                                        RHIFormat textureImageFormat,
                                        uint32_t           miplevels)
     {
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
+
         if (!textureImagePixels)
         {
             return;
@@ -321,22 +311,15 @@ namespace Galaxy
                 break;
         }
 
-        // use staging buffer
-        VkBuffer       inefficientStagingBuffer;
-        VkDeviceMemory inefficientStagingBufferMemory;
-        VulkanUtil::CreateBuffer(static_cast<VulkanRHI*>(rhi)->PhysicalDevice,
-                                 static_cast<VulkanRHI*>(rhi)->Device,
-                                 textureByteSize,
-                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                 inefficientStagingBuffer,
-                                 inefficientStagingBufferMemory);
-
-        void* data;
-        vkMapMemory(
-            static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBufferMemory, 0, textureByteSize, 0, &data);
-        memcpy(data, textureImagePixels, static_cast<size_t>(textureByteSize));
-        vkUnmapMemory(static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBufferMemory);
+        // stage the pixels in the upload ring, everything below is recorded into its open batch
+        VulkanStagingRing&      stagingRing = static_cast<VulkanRHI*>(rhi)->GetStagingRing();
+        VulkanStagingAllocation staging;
+        VkDeviceSize            texelSize = textureByteSize / (textureImageWidth * textureImageHeight);
+        if (!stagingRing.Allocate(textureByteSize, GetCopyOffsetAlignment(texelSize), staging))
+        {
+            return;
+        }
+        memcpy(staging.pMapped, textureImagePixels, static_cast<size_t>(textureByteSize));
 
         // generate mipmapped image
         uint32_t mipLevels =
@@ -361,7 +344,7 @@ namespace Galaxy
         imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         VmaAllocationCreateInfo allocInfo = {};
-        allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+        allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
         vmaCreateImage(static_cast<VulkanRHI*>(rhi)->AssetsAllocator,
                        &imageCreateInfo,
@@ -370,8 +353,11 @@ namespace Galaxy
                        &imageAllocation,
                        nullptr);
 
+        VkCommandBuffer commandBuffer = stagingRing.GetCommandBuffer();
+
         // layout transitions -- image layout is set from none to destination
         TransitionImageLayout(rhi,
+                              commandBuffer,
                               image,
                               VK_IMAGE_LAYOUT_UNDEFINED,
                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -379,9 +365,11 @@ namespace Galaxy
                               1,
                               VK_IMAGE_ASPECT_COLOR_BIT);
         // copy from staging buffer as destination
-        CopyBufferToImage(rhi, inefficientStagingBuffer, image, textureImageWidth, textureImageHeight, 1);
+        CopyBufferToImage(
+            rhi, commandBuffer, staging.Buffer, staging.Offset, image, textureImageWidth, textureImageHeight, 1);
         // layout transitions -- image layout is set from destination to shader_read
         TransitionImageLayout(rhi,
+                              commandBuffer,
                               image,
                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -389,13 +377,10 @@ namespace Galaxy
                               1,
                               VK_IMAGE_ASPECT_COLOR_BIT);
 
-        vkDestroyBuffer(static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBuffer, nullptr);
-        vkFreeMemory(static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBufferMemory, nullptr);
-
         // generate mipmapped image
-        GenMipmappedImage(rhi, image, textureImageWidth, textureImageHeight, mipLevels);
+        GenMipmappedImage(rhi, commandBuffer, image, textureImageWidth, textureImageHeight, mipLevels);
 
-        imageView = CreateImageView(static_cast<VulkanRHI*>(rhi)->Device,
+        imageView = CreateImageView(device,
                                      image,
                                      vulkanImageFormat,
                                      VK_IMAGE_ASPECT_COLOR_BIT,
@@ -414,6 +399,8 @@ namespace Galaxy
                                    RHIFormat   textureImageFormat,
                                    uint32_t             miplevels)
     {
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
+
         VkDeviceSize textureLayerByteSize;
         VkDeviceSize cubeByteSize;
         VkFormat     vulkanImageFormat;
@@ -456,6 +443,21 @@ namespace Galaxy
 
         cubeByteSize = textureLayerByteSize * 6;
 
+        // stage all six faces in the upload ring, everything below is recorded into its open batch
+        VulkanStagingRing&      stagingRing = static_cast<VulkanRHI*>(rhi)->GetStagingRing();
+        VulkanStagingAllocation staging;
+        VkDeviceSize            texelSize = textureLayerByteSize / (textureImageWidth * textureImageHeight);
+        if (!stagingRing.Allocate(cubeByteSize, GetCopyOffsetAlignment(texelSize), staging))
+        {
+            return;
+        }
+        for (int i = 0; i < 6; i++)
+        {
+            memcpy(static_cast<char*>(staging.pMapped) + textureLayerByteSize * i,
+                   textureImagePixels[i],
+                   static_cast<size_t>(textureLayerByteSize));
+        }
+
         // create cubemap texture image
         // use the vmaAllocator to allocate asset texture image
         VkImageCreateInfo imageCreateInfo {};
@@ -476,7 +478,7 @@ namespace Galaxy
         imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         VmaAllocationCreateInfo allocInfo = {};
-        allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+        allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
         vmaCreateImage(static_cast<VulkanRHI*>(rhi)->AssetsAllocator,
                        &imageCreateInfo,
@@ -485,29 +487,11 @@ namespace Galaxy
                        &imageAllocation,
                        nullptr);
 
-        VkBuffer       inefficientStagingBuffer;
-        VkDeviceMemory inefficientStagingBufferMemory;
-        CreateBuffer(static_cast<VulkanRHI*>(rhi)->PhysicalDevice,
-                     static_cast<VulkanRHI*>(rhi)->Device,
-                     cubeByteSize,
-                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                     inefficientStagingBuffer,
-                     inefficientStagingBufferMemory);
-
-        void* data = nullptr;
-        vkMapMemory(
-            static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBufferMemory, 0, cubeByteSize, 0, &data);
-        for (int i = 0; i < 6; i++)
-        {
-            memcpy((void*)(static_cast<char*>(data) + textureLayerByteSize * i),
-                   textureImagePixels[i],
-                   static_cast<size_t>(textureLayerByteSize));
-        }
-        vkUnmapMemory(static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBufferMemory);
+        VkCommandBuffer commandBuffer = stagingRing.GetCommandBuffer();
 
         // layout transitions -- image layout is set from none to destination
         TransitionImageLayout(rhi,
+                              commandBuffer,
                               image,
                               VK_IMAGE_LAYOUT_UNDEFINED,
                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -516,19 +500,18 @@ namespace Galaxy
                               VK_IMAGE_ASPECT_COLOR_BIT);
         // copy from staging buffer as destination
         CopyBufferToImage(rhi,
-                          inefficientStagingBuffer,
+                          commandBuffer,
+                          staging.Buffer,
+                          staging.Offset,
                           image,
                           static_cast<uint32_t>(textureImageWidth),
                           static_cast<uint32_t>(textureImageHeight),
                           6);
 
-        vkDestroyBuffer(static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBuffer, nullptr);
-        vkFreeMemory(static_cast<VulkanRHI*>(rhi)->Device, inefficientStagingBufferMemory, nullptr);
-
         GenerateTextureMipMaps(
-            rhi, image, vulkanImageFormat, textureImageWidth, textureImageHeight, 6, miplevels);
+            rhi, commandBuffer, image, vulkanImageFormat, textureImageWidth, textureImageHeight, 6, miplevels);
 
-        imageView = CreateImageView(static_cast<VulkanRHI*>(rhi)->Device,
+        imageView = CreateImageView(device,
                                      image,
                                      vulkanImageFormat,
                                      VK_IMAGE_ASPECT_COLOR_BIT,
@@ -537,14 +520,17 @@ namespace Galaxy
                                      miplevels);
     }
 
-    void VulkanUtil::GenerateTextureMipMaps(RHI*     rhi,
-                                            VkImage  image,
-                                            VkFormat imageFormat,
-                                            uint32_t textureWidth,
-                                            uint32_t textureHeight,
-                                            uint32_t layers,
-                                            uint32_t miplevels)
+    void VulkanUtil::GenerateTextureMipMaps(RHI*            rhi,
+                                            VkCommandBuffer commandBuffer,
+                                            VkImage         image,
+                                            VkFormat        imageFormat,
+                                            uint32_t        textureWidth,
+                                            uint32_t        textureHeight,
+                                            uint32_t        layers,
+                                            uint32_t        miplevels)
     {
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
+
         VkFormatProperties formatProperties;
         vkGetPhysicalDeviceFormatProperties(
             static_cast<VulkanRHI*>(rhi)->PhysicalDevice, imageFormat, &formatProperties);
@@ -554,9 +540,6 @@ namespace Galaxy
             return;
         }
 
-        RHICommandBuffer* rhiCommandBuffer = static_cast<VulkanRHI*>(rhi)->BeginSingleTimeCommands();
-        VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)rhiCommandBuffer)->GetResource();
-
         VkImageMemoryBarrier barrier {};
         barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.image                           = image;
@@ -579,16 +562,16 @@ namespace Galaxy
             barrier.srcAccessMask                 = VK_ACCESS_TRANSFER_WRITE_BIT;
             barrier.dstAccessMask                 = VK_ACCESS_TRANSFER_READ_BIT;
 
-            vkCmdPipelineBarrier(commandBuffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &barrier);
+            device.vkCmdPipelineBarrier(commandBuffer,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        0,
+                                        0,
+                                        nullptr,
+                                        0,
+                                        nullptr,
+                                        1,
+                                        &barrier);
 
             VkImageBlit blit {};
             blit.srcOffsets[0]                 = {0, 0, 0};
@@ -605,29 +588,29 @@ namespace Galaxy
             blit.dstSubresource.baseArrayLayer = 0;
             blit.dstSubresource.layerCount     = layers;
 
-            vkCmdBlitImage(commandBuffer,
-                           image,
-                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           image,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1,
-                           &blit,
-                           VK_FILTER_LINEAR);
+            device.vkCmdBlitImage(commandBuffer,
+                                  image,
+                                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                  image,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  1,
+                                  &blit,
+                                  VK_FILTER_LINEAR);
 
             barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             barrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
             barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            vkCmdPipelineBarrier(commandBuffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &barrier); // for completed miplevel, change to shader_read
+            device.vkCmdPipelineBarrier(commandBuffer,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                        0,
+                                        0,
+                                        nullptr,
+                                        0,
+                                        nullptr,
+                                        1,
+                                        &barrier); // for completed miplevel, change to shader_read
 
             if (mipwidth > 1)
                 mipwidth /= 2;
@@ -641,21 +624,20 @@ namespace Galaxy
         barrier.newLayout                     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         barrier.srcAccessMask                 = VK_ACCESS_TRANSFER_WRITE_BIT;
         barrier.dstAccessMask                 = VK_ACCESS_SHADER_READ_BIT;
-        vkCmdPipelineBarrier(commandBuffer,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                             0,
-                             0,
-                             nullptr,
-                             0,
-                             nullptr,
-                             1,
-                             &barrier);
-
-        static_cast<VulkanRHI*>(rhi)->EndSingleTimeCommands(rhiCommandBuffer);
+        device.vkCmdPipelineBarrier(commandBuffer,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                    0,
+                                    0,
+                                    nullptr,
+                                    0,
+                                    nullptr,
+                                    1,
+                                    &barrier);
     }
 
     void VulkanUtil::TransitionImageLayout(RHI*               rhi,
+                                           VkCommandBuffer    commandBuffer,
                                            VkImage            image,
                                            VkImageLayout      oldLayout,
                                            VkImageLayout      newLayout,
@@ -669,8 +651,7 @@ namespace Galaxy
             return;
         }
 
-        RHICommandBuffer* rhiCommandBuffer = static_cast<VulkanRHI*>(rhi)->BeginSingleTimeCommands();
-        VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)rhiCommandBuffer)->GetResource();
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
 
         VkImageMemoryBarrier barrier {};
         barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -740,17 +721,18 @@ namespace Galaxy
             return;
         }
 
-        vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-        static_cast<VulkanRHI*>(rhi)->EndSingleTimeCommands(rhiCommandBuffer);
+        device.vkCmdPipelineBarrier(
+            commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
     }
 
-    void VulkanUtil::CopyBufferToImage(RHI*     rhi,
-                                       VkBuffer buffer,
-                                       VkImage  image,
-                                       uint32_t width,
-                                       uint32_t height,
-                                       uint32_t layerCount)
+    void VulkanUtil::CopyBufferToImage(RHI*            rhi,
+                                       VkCommandBuffer commandBuffer,
+                                       VkBuffer        buffer,
+                                       VkDeviceSize    bufferOffset,
+                                       VkImage         image,
+                                       uint32_t        width,
+                                       uint32_t        height,
+                                       uint32_t        layerCount)
     {
         if (rhi == nullptr)
         {
@@ -758,11 +740,10 @@ namespace Galaxy
             return;
         }
 
-        RHICommandBuffer* rhiCommandBuffer = static_cast<VulkanRHI*>(rhi)->BeginSingleTimeCommands();
-        VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)rhiCommandBuffer)->GetResource();
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
 
         VkBufferImageCopy region {};
-        region.bufferOffset                    = 0;
+        region.bufferOffset                    = bufferOffset;
         region.bufferRowLength                 = 0;
         region.bufferImageHeight               = 0;
         region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -772,12 +753,11 @@ namespace Galaxy
         region.imageOffset                     = {0, 0, 0};
         region.imageExtent                     = {width, height, 1};
 
-        vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        static_cast<VulkanRHI*>(rhi)->EndSingleTimeCommands(rhiCommandBuffer);
+        device.vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
     }
 
-    void VulkanUtil::GenMipmappedImage(RHI* rhi, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels)
+    void VulkanUtil::GenMipmappedImage(
+        RHI* rhi, VkCommandBuffer commandBuffer, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels)
     {
         if (rhi == nullptr)
         {
@@ -785,8 +765,7 @@ namespace Galaxy
             return;
         }
 
-        RHICommandBuffer* rhiCommandBuffer = static_cast<VulkanRHI*>(rhi)->BeginSingleTimeCommands();
-        VkCommandBuffer commandBuffer = ((VulkanCommandBuffer*)rhiCommandBuffer)->GetResource();
+        const VulkanDeviceTable& device = static_cast<VulkanRHI*>(rhi)->DeviceTable;
 
         for (uint32_t i = 1; i < mipLevels; i++)
         {
@@ -822,41 +801,41 @@ namespace Galaxy
             barrier.image               = image;
             barrier.subresourceRange    = mipSubRange;
 
-            vkCmdPipelineBarrier(commandBuffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &barrier);
-
-            vkCmdBlitImage(commandBuffer,
-                           image,
-                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           image,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1,
-                           &imageBlit,
-                           VK_FILTER_LINEAR);
+            device.vkCmdPipelineBarrier(commandBuffer,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        0,
+                                        0,
+                                        nullptr,
+                                        0,
+                                        nullptr,
+                                        1,
+                                        &barrier);
+
+            device.vkCmdBlitImage(commandBuffer,
+                                  image,
+                                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                  image,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  1,
+                                  &imageBlit,
+                                  VK_FILTER_LINEAR);
 
             barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
             barrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
             barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-            vkCmdPipelineBarrier(commandBuffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &barrier);
+            device.vkCmdPipelineBarrier(commandBuffer,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        0,
+                                        0,
+                                        nullptr,
+                                        0,
+                                        nullptr,
+                                        1,
+                                        &barrier);
         }
 
         VkImageSubresourceRange mipSubRange {};
@@ -876,160 +855,66 @@ namespace Galaxy
         barrier.image               = image;
         barrier.subresourceRange    = mipSubRange;
 
-        vkCmdPipelineBarrier(commandBuffer,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                             0,
-                             0,
-                             nullptr,
-                             0,
-                             nullptr,
-                             1,
-                             &barrier);
-
-        static_cast<VulkanRHI*>(rhi)->EndSingleTimeCommands(rhiCommandBuffer);
+        device.vkCmdPipelineBarrier(commandBuffer,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                    0,
+                                    0,
+                                    nullptr,
+                                    0,
+                                    nullptr,
+                                    1,
+                                    &barrier);
     }
 
-    VkSampler VulkanUtil::GetOrCreateMipmapSampler(VkPhysicalDevice physicalDevice,
-                                                   VkDevice         device,
-                                                   uint32_t         width,
-                                                   uint32_t         height)
+    VkDeviceSize VulkanUtil::GetCopyOffsetAlignment(VkDeviceSize texelSize)
     {
-        if (width <= 0 || height <= 0)
-        {
-            GAL_CORE_ERROR("[VulkanUtil] width <= 0 || height <= 0");
-        }
-
-        VkSampler sampler;
-        uint32_t  mipLevels   = floor(log2(std::max(width, height))) + 1;
-        auto      findSampler = s_mipmap_sampler_map.find(mipLevels);
-        if (findSampler != s_mipmap_sampler_map.end())
-        {
-            return findSampler->second;
-        }
-        else
-        {
-            VkPhysicalDeviceProperties physicalDeviceProperties {};
-            vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
-
-            VkSamplerCreateInfo samplerInfo {};
-            samplerInfo.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-            samplerInfo.magFilter    = VK_FILTER_LINEAR;
-            samplerInfo.minFilter    = VK_FILTER_LINEAR;
-            samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-            samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-            samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-
-            samplerInfo.anisotropyEnable = VK_TRUE;
-            samplerInfo.maxAnisotropy    = physicalDeviceProperties.limits.maxSamplerAnisotropy;
-
-            samplerInfo.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-            samplerInfo.unnormalizedCoordinates = VK_FALSE;
-            samplerInfo.compareEnable           = VK_FALSE;
-            samplerInfo.compareOp               = VK_COMPARE_OP_ALWAYS;
-            samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-
-            samplerInfo.maxLod = mipLevels - 1;
-
-            if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
-            {
-                GAL_CORE_ERROR("[VulkanUtil] vkCreateSampler failed!");
-            }
-        }
-
-        s_mipmap_sampler_map.insert(std::make_pair(mipLevels, sampler));
-
-        return sampler;
-    }
-
-    void VulkanUtil::DestroyMipmappedSampler(VkDevice device)
-    {
-        for (auto sampler : s_mipmap_sampler_map)
-        {
-            vkDestroySampler(device, sampler.second, nullptr);
-        }
-        s_mipmap_sampler_map.clear();
-    }
-
-    VkSampler VulkanUtil::GetOrCreateNearestSampler(VkPhysicalDevice physicalDevice, VkDevice device)
-    {
-        if (s_nearest_sampler == VK_NULL_HANDLE)
-        {
-            VkPhysicalDeviceProperties physicalDeviceProperties {};
-            vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
-
-            VkSamplerCreateInfo samplerInfo {};
-
-            samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-            samplerInfo.magFilter               = VK_FILTER_NEAREST;
-            samplerInfo.minFilter               = VK_FILTER_NEAREST;
-            samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-            samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-            samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-            samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-            samplerInfo.mipLodBias              = 0.0f;
-            samplerInfo.anisotropyEnable        = VK_FALSE;
-            samplerInfo.maxAnisotropy           = physicalDeviceProperties.limits.maxSamplerAnisotropy; // close :1.0f
-            samplerInfo.compareEnable           = VK_FALSE;
-            samplerInfo.compareOp               = VK_COMPARE_OP_ALWAYS;
-            samplerInfo.minLod                  = 0.0f;
-            samplerInfo.maxLod                  = 8.0f; // todo: s_irradiance_texture_miplevels
-            samplerInfo.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-            samplerInfo.unnormalizedCoordinates = VK_FALSE;
-
-            if (vkCreateSampler(device, &samplerInfo, nullptr, &s_nearest_sampler) != VK_SUCCESS)
-            {
-                GAL_CORE_ERROR("[VulkanUtil] vk create sampler");
-            }
-        }
-
-        return s_nearest_sampler;
-    }
-
-    VkSampler VulkanUtil::GetOrCreateLinearSampler(VkPhysicalDevice physicalDevice, VkDevice device)
-    {
-        if (s_linear_sampler == VK_NULL_HANDLE)
-        {
-            VkPhysicalDeviceProperties physicalDeviceProperties {};
-            vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
-
-            VkSamplerCreateInfo samplerInfo {};
-
-            samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-            samplerInfo.magFilter               = VK_FILTER_LINEAR;
-            samplerInfo.minFilter               = VK_FILTER_LINEAR;
-            samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-            samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-            samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-            samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-            samplerInfo.mipLodBias              = 0.0f;
-            samplerInfo.anisotropyEnable        = VK_FALSE;
-            samplerInfo.maxAnisotropy           = physicalDeviceProperties.limits.maxSamplerAnisotropy; // close :1.0f
-            samplerInfo.compareEnable           = VK_FALSE;
-            samplerInfo.compareOp               = VK_COMPARE_OP_ALWAYS;
-            samplerInfo.minLod                  = 0.0f;
-            samplerInfo.maxLod                  = 8.0f; // todo: s_irradiance_texture_miplevels
-            samplerInfo.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-            samplerInfo.unnormalizedCoordinates = VK_FALSE;
-
-            if (vkCreateSampler(device, &samplerInfo, nullptr, &s_linear_sampler) != VK_SUCCESS)
-            {
-                GAL_CORE_ERROR("[VulkanUtil] vk create sampler");
-            }
-        }
-
-        return s_linear_sampler;
+        return std::lcm(texelSize, VkDeviceSize {4});
     }
 
-    void VulkanUtil::DestroyNearestSampler(VkDevice device)
+    VkSamplerCreateInfo VulkanUtil::GetDefaultSamplerCreateInfo(RHIDefaultSamplerType type)
     {
-        vkDestroySampler(device, s_nearest_sampler, nullptr);
-        s_nearest_sampler = VK_NULL_HANDLE;
+        VkFilter filter = type == Default_Sampler_Nearest ? VK_FILTER_NEAREST : VK_FILTER_LINEAR;
+
+        VkSamplerCreateInfo samplerInfo {};
+        samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter               = filter;
+        samplerInfo.minFilter               = filter;
+        samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.mipLodBias              = 0.0f;
+        samplerInfo.anisotropyEnable        = VK_FALSE;
+        samplerInfo.maxAnisotropy           = 1.0f;
+        samplerInfo.compareEnable           = VK_FALSE;
+        samplerInfo.compareOp               = VK_COMPARE_OP_NEVER;
+        samplerInfo.minLod                  = 0.0f;
+        samplerInfo.maxLod                  = 8.0f; // todo: s_irradiance_texture_miplevels
+        samplerInfo.borderColor             = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        return samplerInfo;
     }
 
-    void VulkanUtil::DestroyLinearSampler(VkDevice device)
+    VkSamplerCreateInfo VulkanUtil::GetMipmapSamplerCreateInfo(float maxAnisotropy, uint32_t mipLevels)
     {
-        vkDestroySampler(device, s_linear_sampler, nullptr);
-        s_linear_sampler = VK_NULL_HANDLE;
+        VkSamplerCreateInfo samplerInfo {};
+        samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter               = VK_FILTER_LINEAR;
+        samplerInfo.minFilter               = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.mipLodBias              = 0.0f;
+        samplerInfo.anisotropyEnable        = VK_TRUE;
+        samplerInfo.maxAnisotropy           = maxAnisotropy;
+        samplerInfo.compareEnable           = VK_FALSE;
+        samplerInfo.compareOp               = VK_COMPARE_OP_NEVER;
+        samplerInfo.minLod                  = 0.0f;
+        samplerInfo.maxLod                  = static_cast<float>(mipLevels - 1);
+        samplerInfo.borderColor             = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        return samplerInfo;
     }
 } // namespace Galaxy
\ No newline at end of file
@@ -0,0 +1,444 @@
+//
+// ShaderCompiler.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/28 15:20.
+//
+
+#include "GalaxyEngine/Function/Renderer/ShaderCompiler.h"
+#include "GalaxyEngine/Core/FileSystem.h"
+#include "GalaxyEngine/Core/Hash.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Core/Time/Timer.h"
+#include "GalaxyEngine/Function/Global/GlobalContext.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef GAL_ENABLE_RUNTIME_SHADER_COMPILER
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/Public/ShaderLang.h>
+#include <glslang/SPIRV/GlslangToSpv.h>
+#include <glslang/build_info.h>
+#endif
+
+namespace Galaxy
+{
+    // bump when anything about how SPIR-V is produced changes without the compiler version changing
+    static constexpr uint32_t s_CacheVersion = 1;
+
+    static constexpr uint32_t s_SpirVMagic = 0x07230203;
+
+    static RHIShaderStageFlagBits GetStageFromExtension(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        if (extension == ".vert")
+            return RHI_SHADER_STAGE_VERTEX_BIT;
+        if (extension == ".tesc")
+            return RHI_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        if (extension == ".tese")
+            return RHI_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        if (extension == ".geom")
+            return RHI_SHADER_STAGE_GEOMETRY_BIT;
+        if (extension == ".frag")
+            return RHI_SHADER_STAGE_FRAGMENT_BIT;
+        if (extension == ".comp")
+            return RHI_SHADER_STAGE_COMPUTE_BIT;
+        return static_cast<RHIShaderStageFlagBits>(0);
+    }
+
+    static bool ResolveInclude(const std::vector<std::filesystem::path>& includeDirectories,
+                               const std::string&                        headerName,
+                               const std::filesystem::path&              includerPath,
+                               bool                                      isLocal,
+                               std::filesystem::path&                    outPath)
+    {
+        std::error_code error;
+        if (isLocal)
+        {
+            std::filesystem::path candidate = includerPath.parent_path() / headerName;
+            if (std::filesystem::is_regular_file(candidate, error))
+            {
+                outPath = candidate.lexically_normal();
+                return true;
+            }
+        }
+
+        for (const std::filesystem::path& directory : includeDirectories)
+        {
+            std::filesystem::path candidate = directory / headerName;
+            if (std::filesystem::is_regular_file(candidate, error))
+            {
+                outPath = candidate.lexically_normal();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // #include lines of a source, conditionals are ignored so the result may contain includes that are compiled out.
+    // Hashing a few files too many only costs a cache miss when they change.
+    static void FindIncludes(const std::vector<char>& content, std::vector<std::pair<std::string, bool>>& outIncludes)
+    {
+        std::string_view text(content.data(), content.size());
+        size_t           lineStart = 0;
+        while (lineStart < text.size())
+        {
+            size_t           lineEnd = std::min(text.find('\n', lineStart), text.size());
+            std::string_view line    = text.substr(lineStart, lineEnd - lineStart);
+            lineStart                = lineEnd + 1;
+
+            size_t hash = line.find_first_not_of(" \t");
+            if (hash == std::string_view::npos || line[hash] != '#')
+            {
+                continue;
+            }
+
+            size_t directive = line.find_first_not_of(" \t", hash + 1);
+            if (directive == std::string_view::npos || line.compare(directive, 7, "include") != 0)
+            {
+                continue;
+            }
+
+            size_t open = line.find_first_of("\"<", directive + 7);
+            if (open == std::string_view::npos)
+            {
+                continue;
+            }
+
+            size_t close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+            if (close != std::string_view::npos)
+            {
+                outIncludes.emplace_back(std::string(line.substr(open + 1, close - open - 1)), line[open] == '"');
+            }
+        }
+    }
+
+    static std::string GetCacheFileName(uint64_t key)
+    {
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "%016llx.spv", static_cast<unsigned long long>(key));
+        return fileName;
+    }
+
+#ifdef GAL_ENABLE_RUNTIME_SHADER_COMPILER
+    static EShLanguage GetGlslangStage(RHIShaderStageFlagBits stage)
+    {
+        switch (stage)
+        {
+            case RHI_SHADER_STAGE_VERTEX_BIT:
+                return EShLangVertex;
+            case RHI_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+                return EShLangTessControl;
+            case RHI_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+                return EShLangTessEvaluation;
+            case RHI_SHADER_STAGE_GEOMETRY_BIT:
+                return EShLangGeometry;
+            case RHI_SHADER_STAGE_FRAGMENT_BIT:
+                return EShLangFragment;
+            default:
+                return EShLangCompute;
+        }
+    }
+
+    // Resolves includes the same way CollectSources does, so the cache key covers exactly what glslang reads
+    class GlslangIncluder : public glslang::TShader::Includer
+    {
+    public:
+        explicit GlslangIncluder(const std::vector<std::filesystem::path>& includeDirectories) :
+            m_IncludeDirectories(includeDirectories)
+        {}
+
+        IncludeResult* includeLocal(const char* headerName, const char* includerName, size_t) override
+        {
+            return Include(headerName, includerName, true);
+        }
+
+        IncludeResult* includeSystem(const char* headerName, const char* includerName, size_t) override
+        {
+            return Include(headerName, includerName, false);
+        }
+
+        void releaseInclude(IncludeResult* result) override
+        {
+            if (result != nullptr)
+            {
+                delete static_cast<std::vector<char>*>(result->userData);
+                delete result;
+            }
+        }
+
+    private:
+        IncludeResult* Include(const char* headerName, const char* includerName, bool isLocal)
+        {
+            std::filesystem::path path;
+            if (!ResolveInclude(m_IncludeDirectories, headerName, includerName, isLocal, path))
+            {
+                return nullptr;
+            }
+
+            auto* content = new std::vector<char>(g_RuntimeGlobalContext.FileSys->ReadFileAllText(path.string()));
+            return new IncludeResult(path.string(), content->data(), content->size(), content);
+        }
+
+        const std::vector<std::filesystem::path>& m_IncludeDirectories;
+    };
+
+    static bool CompileGlsl(const ShaderCompileRequest&               request,
+                            RHIShaderStageFlagBits                    stage,
+                            const std::vector<char>&                  source,
+                            const std::vector<std::filesystem::path>& includeDirectories,
+                            std::vector<unsigned char>&               outSpirV,
+                            std::string&                              outLog)
+    {
+        std::string preamble;
+        for (const ShaderDefine& define : request.Defines)
+        {
+            preamble += "#define " + define.Name + " " + define.Value + "\n";
+        }
+
+        std::string sourceName     = request.SourcePath.string();
+        const char* sourceData     = source.data();
+        const char* sourceNameData = sourceName.c_str();
+        int         sourceLength   = static_cast<int>(source.size());
+
+        EShLanguage      glslangStage = GetGlslangStage(stage);
+        glslang::TShader shader(glslangStage);
+        shader.setStringsWithLengthsAndNames(&sourceData, &sourceLength, &sourceNameData, 1);
+        shader.setPreamble(preamble.c_str());
+        shader.setEntryPoint(request.EntryPoint.c_str());
+        shader.setSourceEntryPoint(request.EntryPoint.c_str());
+        shader.setEnvInput(glslang::EShSourceGlsl, glslangStage, glslang::EShClientVulkan, 100);
+        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_0);
+        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+
+        auto            messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+        GlslangIncluder includer(includeDirectories);
+        if (!shader.parse(GetDefaultResources(), 100, false, messages, includer))
+        {
+            outLog = shader.getInfoLog();
+            return false;
+        }
+
+        glslang::TProgram program;
+        program.addShader(&shader);
+        if (!program.link(messages))
+        {
+            outLog = program.getInfoLog();
+            return false;
+        }
+
+        std::vector<uint32_t> spirV;
+        spv::SpvBuildLogger   logger;
+        glslang::GlslangToSpv(*program.getIntermediate(glslangStage), spirV, &logger);
+        outLog = logger.getAllMessages();
+
+        outSpirV.resize(spirV.size() * sizeof(uint32_t));
+        std::memcpy(outSpirV.data(), spirV.data(), outSpirV.size());
+        return true;
+    }
+#endif
+
+    void ShaderCompiler::Init(ShaderCompilerInitInfo initInfo)
+    {
+        m_CacheDirectory     = initInfo.CacheDirectory;
+        m_IncludeDirectories = initInfo.IncludeDirectories;
+
+#ifdef GAL_ENABLE_RUNTIME_SHADER_COMPILER
+        glslang::InitializeProcess();
+#endif
+
+        GAL_CORE_INFO("[ShaderCompiler] Using {0}, cache in {1}", GetCompilerVersion(), m_CacheDirectory.string());
+    }
+
+    void ShaderCompiler::Shutdown()
+    {
+#ifdef GAL_ENABLE_RUNTIME_SHADER_COMPILER
+        glslang::FinalizeProcess();
+#endif
+    }
+
+    ShaderCompileResult ShaderCompiler::Compile(const ShaderCompileRequest& request) const
+    {
+        ShaderCompileResult result;
+
+        RHIShaderStageFlagBits stage = request.Stage != 0 ? request.Stage : GetStageFromExtension(request.SourcePath);
+        if (stage == 0)
+        {
+            result.Log = "Unknown shader stage";
+            GAL_CORE_ERROR("[ShaderCompiler] Cannot tell the stage of {0}", request.SourcePath.string());
+            return result;
+        }
+
+        std::vector<SourceFile> sources;
+        if (!CollectSources(request.SourcePath, sources))
+        {
+            result.Log = "Cannot read source";
+            GAL_CORE_ERROR("[ShaderCompiler] Cannot read {0}", request.SourcePath.string());
+            return result;
+        }
+
+        result.Key = HashSources(request, stage, sources);
+        for (const SourceFile& source : sources)
+        {
+            result.Dependencies.push_back(source.Path);
+        }
+
+        std::filesystem::path cachePath = m_CacheDirectory / GetCacheFileName(result.Key);
+        if (LoadCachedSpirV(cachePath, result.SpirV))
+        {
+            result.Success   = true;
+            result.FromCache = true;
+            return result;
+        }
+
+#ifdef GAL_ENABLE_RUNTIME_SHADER_COMPILER
+        Timer timer;
+        result.Success =
+            CompileGlsl(request, stage, sources[0].Content, m_IncludeDirectories, result.SpirV, result.Log);
+        if (!result.Success)
+        {
+            GAL_CORE_ERROR("[ShaderCompiler] Failed to compile {0}:\n{1}", request.SourcePath.string(), result.Log);
+            return result;
+        }
+
+        std::vector<char> cacheData(result.SpirV.begin(), result.SpirV.end());
+        g_RuntimeGlobalContext.FileSys->WriteFileAtomically(cachePath.string(), cacheData);
+
+        GAL_CORE_INFO(
+            "[ShaderCompiler] Compiled {0} in {1} ms", request.SourcePath.string(), timer.ElapsedMilliseconds());
+#else
+        // whatever CMake built at configure time, it knows nothing about defines
+        std::filesystem::path prebuiltPath =
+            request.SourcePath.parent_path() / "spv" / (request.SourcePath.filename().string() + ".spv");
+        result.Success = request.Defines.empty() && LoadCachedSpirV(prebuiltPath, result.SpirV);
+        if (!result.Success)
+        {
+            result.Log = "Runtime shader compilation is not available";
+            GAL_CORE_ERROR("[ShaderCompiler] No up to date SPIR-V for {0} and no compiler to build it",
+                           request.SourcePath.string());
+        }
+#endif
+        return result;
+    }
+
+    Ref<ShaderCompileTask> ShaderCompiler::CompileAsync(ShaderCompileRequest request) const
+    {
+        auto task     = CreateRef<ShaderCompileTask>();
+        task->Counter = CreateRef<JobCounter>();
+
+        g_RuntimeGlobalContext.JobSys->Run(
+            [this, task, request = std::move(request)]() { task->Result = Compile(request); }, task->Counter);
+        return task;
+    }
+
+    uint64_t ShaderCompiler::ComputeKey(const ShaderCompileRequest& request) const
+    {
+        RHIShaderStageFlagBits stage = request.Stage != 0 ? request.Stage : GetStageFromExtension(request.SourcePath);
+
+        std::vector<SourceFile> sources;
+        if (!CollectSources(request.SourcePath, sources))
+        {
+            return 0;
+        }
+        return HashSources(request, stage, sources);
+    }
+
+    const char* ShaderCompiler::GetCompilerVersion()
+    {
+#ifdef GAL_ENABLE_RUNTIME_SHADER_COMPILER
+#define GAL_STRINGIFY_VERSION(major, minor, patch) "glslang " #major "." #minor "." #patch
+#define GAL_GLSLANG_VERSION(major, minor, patch) GAL_STRINGIFY_VERSION(major, minor, patch)
+        return GAL_GLSLANG_VERSION(GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH);
+#undef GAL_GLSLANG_VERSION
+#undef GAL_STRINGIFY_VERSION
+#else
+        return "prebuilt SPIR-V";
+#endif
+    }
+
+    bool ShaderCompiler::CollectSources(const std::filesystem::path& path, std::vector<SourceFile>& sources) const
+    {
+        std::filesystem::path normalPath = path.lexically_normal();
+        for (const SourceFile& source : sources)
+        {
+            if (source.Path == normalPath)
+            {
+                return true;
+            }
+        }
+
+        std::vector<char> content = g_RuntimeGlobalContext.FileSys->ReadFileAllText(normalPath.string());
+        if (content.empty())
+        {
+            return false;
+        }
+
+        std::vector<std::pair<std::string, bool>> includes;
+        FindIncludes(content, includes);
+        sources.push_back({normalPath, std::move(content)});
+
+        for (const auto& [headerName, isLocal] : includes)
+        {
+            // unresolved includes are left for the compiler to report
+            std::filesystem::path includePath;
+            if (ResolveInclude(m_IncludeDirectories, headerName, normalPath, isLocal, includePath))
+            {
+                CollectSources(includePath, sources);
+            }
+        }
+        return true;
+    }
+
+    uint64_t ShaderCompiler::HashSources(const ShaderCompileRequest&    request,
+                                         RHIShaderStageFlagBits         stage,
+                                         const std::vector<SourceFile>& sources) const
+    {
+        std::string_view compilerVersion = GetCompilerVersion();
+
+        uint64_t key = hash_fnv1a(&s_CacheVersion, sizeof(s_CacheVersion));
+        key          = hash_fnv1a(compilerVersion.data(), compilerVersion.size(), key);
+        key          = hash_fnv1a(&stage, sizeof(stage), key);
+        key          = hash_fnv1a(request.EntryPoint.data(), request.EntryPoint.size() + 1, key);
+
+        // the preamble is built in request order, so the order of defines is part of the key as well
+        for (const ShaderDefine& define : request.Defines)
+        {
+            key = hash_fnv1a(define.Name.c_str(), define.Name.size() + 1, key);
+            key = hash_fnv1a(define.Value.c_str(), define.Value.size() + 1, key);
+        }
+
+        for (const SourceFile& source : sources)
+        {
+            uint64_t size = source.Content.size();
+            key           = hash_fnv1a(&size, sizeof(size), key);
+            key           = hash_fnv1a(source.Content.data(), source.Content.size(), key);
+        }
+        return key;
+    }
+
+    bool ShaderCompiler::LoadCachedSpirV(const std::filesystem::path& path, std::vector<unsigned char>& outSpirV) const
+    {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            return false;
+        }
+
+        std::vector<char> data = g_RuntimeGlobalContext.FileSys->ReadFileAllText(path.string());
+
+        uint32_t magic = 0;
+        if (data.size() < sizeof(magic) || data.size() % sizeof(uint32_t) != 0)
+        {
+            return false;
+        }
+        std::memcpy(&magic, data.data(), sizeof(magic));
+        if (magic != s_SpirVMagic)
+        {
+            return false;
+        }
+
+        outSpirV.assign(data.begin(), data.end());
+        return true;
+    }
+} // namespace Galaxy
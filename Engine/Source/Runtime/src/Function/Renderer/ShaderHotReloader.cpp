@@ -0,0 +1,239 @@
+//
+// ShaderHotReloader.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 14:18.
+//
+
+#include "GalaxyEngine/Function/Renderer/ShaderHotReloader.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#include <algorithm>
+
+namespace Galaxy
+{
+    void ShaderHotReloader::Init(ShaderHotReloaderInitInfo initInfo)
+    {
+        m_RHI            = initInfo.Rhi;
+        m_PipelineCache  = initInfo.PipelineCache;
+        m_LayoutCache    = initInfo.LayoutCache;
+        m_VariantLibrary = initInfo.VariantLibrary;
+        m_Watcher        = initInfo.Watcher;
+    }
+
+    void ShaderHotReloader::Shutdown()
+    {
+        for (FileWatchId watchId : m_WatchIds)
+        {
+            m_Watcher->Unwatch(watchId);
+        }
+        m_WatchIds.clear();
+        m_WatchedDirectories.clear();
+        m_ChangedFiles.clear();
+
+        for (auto& [pipelineId, entry] : m_Pipelines)
+        {
+            if (entry.Current != nullptr)
+            {
+                m_PipelineCache->Release(entry.Current);
+            }
+            if (entry.Pending != nullptr)
+            {
+                m_PipelineCache->Release(entry.Pending);
+            }
+        }
+        m_Pipelines.clear();
+
+        m_Watcher.reset();
+        m_VariantLibrary.reset();
+        m_LayoutCache.reset();
+        m_PipelineCache.reset();
+        m_RHI.reset();
+    }
+
+    uint32_t ShaderHotReloader::AddPipeline(std::vector<HotReloadStage> stages, HotReloadPipelineBuilder builder)
+    {
+        uint32_t pipelineId = m_NextPipelineId++;
+
+        PipelineEntry& entry = m_Pipelines[pipelineId];
+        entry.Stages         = std::move(stages);
+        entry.Builder        = std::move(builder);
+        entry.Current        = BuildPipeline(entry);
+
+        // building compiled the shaders, which is when their includes become known
+        m_DependenciesChanged = true;
+        return pipelineId;
+    }
+
+    void ShaderHotReloader::RemovePipeline(uint32_t pipelineId)
+    {
+        auto iter = m_Pipelines.find(pipelineId);
+        if (iter == m_Pipelines.end())
+        {
+            return;
+        }
+
+        if (iter->second.Current != nullptr)
+        {
+            m_PipelineCache->Release(iter->second.Current);
+        }
+        if (iter->second.Pending != nullptr)
+        {
+            m_PipelineCache->Release(iter->second.Pending);
+        }
+        m_Pipelines.erase(iter);
+    }
+
+    RHIPipeline ShaderHotReloader::GetPipeline(uint32_t pipelineId) const
+    {
+        auto iter = m_Pipelines.find(pipelineId);
+        return iter != m_Pipelines.end() ? iter->second.Current : nullptr;
+    }
+
+    void ShaderHotReloader::BeginFrame()
+    {
+        if (m_DependenciesChanged)
+        {
+            WatchShaderDirectories();
+            m_DependenciesChanged = false;
+        }
+
+        // 1. Recompile what the saved files affect, on the job system
+        for (const std::filesystem::path& filePath : m_ChangedFiles)
+        {
+            uint32_t dependentCount = m_VariantLibrary->ReloadDependents(filePath);
+            if (dependentCount > 0)
+            {
+                GAL_CORE_INFO("[ShaderHotReloader] {0} changed, recompiling {1} shaders",
+                              filePath.string(),
+                              dependentCount);
+            }
+        }
+        m_ChangedFiles.clear();
+
+        // 2. Rebuild only the pipelines using a shader whose recompile finished
+        std::vector<uint32_t> reloadedShaders;
+        m_VariantLibrary->Update(reloadedShaders);
+        if (!reloadedShaders.empty())
+        {
+            m_DependenciesChanged = true;
+        }
+
+        for (auto& [pipelineId, entry] : m_Pipelines)
+        {
+            bool usesReloadedShader = false;
+            for (const HotReloadStage& stage : entry.Stages)
+            {
+                usesReloadedShader |= std::find(reloadedShaders.begin(), reloadedShaders.end(), stage.Shader) !=
+                                      reloadedShaders.end();
+            }
+            if (!usesReloadedShader)
+            {
+                continue;
+            }
+
+            // a rebuild from an earlier save that is still compiling is outdated
+            if (entry.Pending != nullptr)
+            {
+                m_PipelineCache->Release(entry.Pending);
+            }
+            entry.Pending = BuildPipeline(entry);
+        }
+
+        // 3. Swap in the rebuilt pipelines that are ready. The replaced ones may still be used by frames in flight,
+        // the PipelineStateCache holds on to them until those are done.
+        for (auto& [pipelineId, entry] : m_Pipelines)
+        {
+            if (entry.Pending == nullptr)
+            {
+                continue;
+            }
+
+            RHIPipelineStatus status = m_RHI->GetPipelineStatus(entry.Pending);
+            if (status == Pipeline_Status_Pending)
+            {
+                continue;
+            }
+
+            if (status == Pipeline_Status_Ready)
+            {
+                if (entry.Current != nullptr)
+                {
+                    m_PipelineCache->Release(entry.Current);
+                }
+                entry.Current = entry.Pending;
+                m_ReloadCount++;
+            }
+            else
+            {
+                GAL_CORE_ERROR("[ShaderHotReloader] Rebuilding pipeline {0} failed, keeping the previous one",
+                               pipelineId);
+                m_PipelineCache->Release(entry.Pending);
+            }
+            entry.Pending = nullptr;
+        }
+    }
+
+    RHIPipeline ShaderHotReloader::BuildPipeline(const PipelineEntry& entry)
+    {
+        HotReloadPipelineInputs inputs;
+        ShaderReflection        reflection;
+        for (const HotReloadStage& stage : entry.Stages)
+        {
+            const ShaderVariant* variant = m_VariantLibrary->GetVariant(stage.Shader, stage.Key);
+            if (variant == nullptr || !reflection.Merge(*variant->Reflection))
+            {
+                return nullptr;
+            }
+            inputs.Stages.push_back(variant);
+        }
+
+        // layouts are deduplicated, a reload that keeps the bindings gets the very same ones back
+        if (!m_LayoutCache->GetLayouts(reflection, inputs.Layout))
+        {
+            GAL_CORE_ERROR("[ShaderHotReloader] Failed to build the layouts of a pipeline");
+            return nullptr;
+        }
+        inputs.VertexStride = reflection.GetVertexAttributes(0, inputs.VertexAttributes);
+
+        RHIPipeline pipeline = entry.Builder(inputs);
+        if (pipeline == nullptr)
+        {
+            GAL_CORE_ERROR("[ShaderHotReloader] Failed to build a pipeline");
+        }
+        return pipeline;
+    }
+
+    void ShaderHotReloader::WatchShaderDirectories()
+    {
+        if (m_Watcher == nullptr)
+        {
+            return;
+        }
+
+        for (uint32_t shader = 0; shader < m_VariantLibrary->GetShaderCount(); ++shader)
+        {
+            for (const std::filesystem::path& dependency : m_VariantLibrary->GetDependencies(shader))
+            {
+                std::filesystem::path directory = dependency.parent_path();
+                if (directory.empty())
+                {
+                    directory = ".";
+                }
+                if (!m_WatchedDirectories.insert(directory.string()).second)
+                {
+                    continue;
+                }
+
+                FileWatchId watchId = m_Watcher->WatchDirectory(
+                    directory, [this](const std::filesystem::path& filePath) { m_ChangedFiles.push_back(filePath); });
+                if (watchId == 0)
+                {
+                    GAL_CORE_WARN("[ShaderHotReloader] Cannot watch {0}, its shaders will not reload",
+                                  directory.string());
+                    continue;
+                }
+                m_WatchIds.push_back(watchId);
+            }
+        }
+    }
+} // namespace Galaxy
@@ -0,0 +1,738 @@
+//
+// ShaderReflection.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/29 10:12.
+//
+
+#include "GalaxyEngine/Function/Renderer/ShaderReflection.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Galaxy
+{
+    // The subset of the SPIR-V specification needed to find resources, see the unified specification for the rest
+    namespace SpirV
+    {
+        static constexpr uint32_t Magic      = 0x07230203;
+        static constexpr uint32_t HeaderSize = 5;
+
+        enum Op : uint32_t
+        {
+            Op_Name                      = 5,
+            Op_EntryPoint                = 15,
+            Op_ExecutionMode             = 16,
+            Op_TypeBool                  = 20,
+            Op_TypeInt                   = 21,
+            Op_TypeFloat                 = 22,
+            Op_TypeVector                = 23,
+            Op_TypeMatrix                = 24,
+            Op_TypeImage                 = 25,
+            Op_TypeSampler               = 26,
+            Op_TypeSampledImage          = 27,
+            Op_TypeArray                 = 28,
+            Op_TypeRuntimeArray          = 29,
+            Op_TypeStruct                = 30,
+            Op_TypePointer               = 32,
+            Op_Constant                  = 43,
+            Op_SpecConstantTrue          = 48,
+            Op_SpecConstantFalse         = 49,
+            Op_SpecConstant              = 50,
+            Op_Variable                  = 59,
+            Op_Decorate                  = 71,
+            Op_MemberDecorate            = 72,
+            Op_TypeAccelerationStructure = 5341,
+        };
+
+        enum Decoration : uint32_t
+        {
+            Decoration_SpecId        = 1,
+            Decoration_Block         = 2,
+            Decoration_BufferBlock   = 3,
+            Decoration_RowMajor      = 4,
+            Decoration_ArrayStride   = 6,
+            Decoration_MatrixStride  = 7,
+            Decoration_BuiltIn       = 11,
+            Decoration_Location      = 30,
+            Decoration_Binding       = 33,
+            Decoration_DescriptorSet = 34,
+            Decoration_Offset        = 35,
+        };
+
+        enum StorageClass : uint32_t
+        {
+            Storage_Class_Uniform_Constant = 0,
+            Storage_Class_Input            = 1,
+            Storage_Class_Uniform          = 2,
+            Storage_Class_Push_Constant    = 9,
+            Storage_Class_Storage_Buffer   = 12,
+        };
+
+        enum Dim : uint32_t
+        {
+            Dim_Buffer       = 5,
+            Dim_Subpass_Data = 6,
+        };
+
+        static constexpr uint32_t ExecutionModeLocalSize = 17;
+    } // namespace SpirV
+
+    static constexpr uint32_t s_Unset = ~0u;
+
+    struct SpirVMember
+    {
+        uint32_t Offset       = 0;
+        uint32_t MatrixStride = 0;
+        bool     RowMajor     = false;
+    };
+
+    // Everything known about one result id
+    struct SpirVId
+    {
+        uint32_t              Opcode = 0;
+        std::vector<uint32_t> Operands; // words after the result id
+        std::string           Name;
+
+        uint32_t Set         = s_Unset;
+        uint32_t Binding     = s_Unset;
+        uint32_t Location    = s_Unset;
+        uint32_t SpecId      = s_Unset;
+        uint32_t ArrayStride = 0;
+        bool     BuiltIn     = false;
+        bool     Block       = false;
+        bool     BufferBlock = false;
+
+        std::vector<SpirVMember> Members;
+    };
+
+    class SpirVModule
+    {
+    public:
+        bool Parse(const std::vector<unsigned char>& spirV)
+        {
+            if (spirV.size() % sizeof(uint32_t) != 0 || spirV.size() < SpirV::HeaderSize * sizeof(uint32_t))
+            {
+                return false;
+            }
+
+            m_Words.resize(spirV.size() / sizeof(uint32_t));
+            std::memcpy(m_Words.data(), spirV.data(), spirV.size());
+            if (m_Words[0] != SpirV::Magic)
+            {
+                return false;
+            }
+            Ids.resize(m_Words[3]);
+
+            size_t offset = SpirV::HeaderSize;
+            while (offset < m_Words.size())
+            {
+                uint32_t opcode    = m_Words[offset] & 0xFFFF;
+                uint32_t wordCount = m_Words[offset] >> 16;
+                if (wordCount == 0 || offset + wordCount > m_Words.size())
+                {
+                    return false;
+                }
+                if (!ParseInstruction(opcode, &m_Words[offset + 1], wordCount - 1))
+                {
+                    return false;
+                }
+                offset += wordCount;
+            }
+            return EntryPointCount == 1;
+        }
+
+        // Pointer types and arrays are peeled off, the array sizes multiply into count, 0 for a runtime array
+        uint32_t StripArrays(uint32_t typeId, uint32_t& count) const
+        {
+            count = 1;
+            while (true)
+            {
+                const SpirVId& type = Ids[typeId];
+                if (type.Opcode == SpirV::Op_TypePointer)
+                {
+                    typeId = type.Operands[1];
+                }
+                else if (type.Opcode == SpirV::Op_TypeArray)
+                {
+                    count *= GetConstant(type.Operands[1]);
+                    typeId = type.Operands[0];
+                }
+                else if (type.Opcode == SpirV::Op_TypeRuntimeArray)
+                {
+                    count  = 0;
+                    typeId = type.Operands[0];
+                }
+                else
+                {
+                    return typeId;
+                }
+            }
+        }
+
+        uint32_t GetConstant(uint32_t id) const
+        {
+            const SpirVId& constant = Ids[id];
+            bool isConstant = constant.Opcode == SpirV::Op_Constant || constant.Opcode == SpirV::Op_SpecConstant;
+            return isConstant && constant.Operands.size() >= 2 ? constant.Operands[1] : 1;
+        }
+
+        // Size in bytes following the explicit layout decorations, runtime arrays count as 0
+        uint32_t GetTypeSize(uint32_t typeId, const SpirVMember* member = nullptr) const
+        {
+            const SpirVId& type = Ids[typeId];
+            switch (type.Opcode)
+            {
+                case SpirV::Op_TypeBool:
+                    return 4;
+                case SpirV::Op_TypeInt:
+                case SpirV::Op_TypeFloat:
+                    return type.Operands[0] / 8;
+                case SpirV::Op_TypeVector:
+                    return GetTypeSize(type.Operands[0]) * type.Operands[1];
+                case SpirV::Op_TypeMatrix: {
+                    uint32_t columnCount = type.Operands[1];
+                    if (member == nullptr || member->MatrixStride == 0)
+                    {
+                        return GetTypeSize(type.Operands[0]) * columnCount;
+                    }
+                    uint32_t rowCount = Ids[type.Operands[0]].Operands[1];
+                    return member->MatrixStride * (member->RowMajor ? rowCount : columnCount);
+                }
+                case SpirV::Op_TypeArray: {
+                    uint32_t length = GetConstant(type.Operands[1]);
+                    uint32_t stride = type.ArrayStride != 0 ? type.ArrayStride : GetTypeSize(type.Operands[0], member);
+                    return length * stride;
+                }
+                case SpirV::Op_TypeStruct: {
+                    uint32_t size = 0;
+                    for (size_t i = 0; i < type.Operands.size(); ++i)
+                    {
+                        const SpirVMember& structMember = type.Members[i];
+                        size = std::max(size, structMember.Offset + GetTypeSize(type.Operands[i], &structMember));
+                    }
+                    return size;
+                }
+                case SpirV::Op_TypePointer:
+                    return 8; // physical storage buffer address
+                default:
+                    return 0;
+            }
+        }
+
+    public:
+        std::vector<SpirVId> Ids;
+        std::vector<uint32_t> Variables;
+
+        uint32_t    EntryPointCount = 0;
+        uint32_t    ExecutionModel  = 0;
+        std::string EntryPoint;
+        uint32_t    LocalSize[3] {1, 1, 1};
+
+    private:
+        static std::string ReadString(const uint32_t* operands, uint32_t operandCount)
+        {
+            const char* text = reinterpret_cast<const char*>(operands);
+            return std::string(text, strnlen(text, operandCount * sizeof(uint32_t)));
+        }
+
+        SpirVId* GetId(uint32_t id) { return id < Ids.size() ? &Ids[id] : nullptr; }
+
+        bool ParseInstruction(uint32_t opcode, const uint32_t* operands, uint32_t operandCount)
+        {
+            switch (opcode)
+            {
+                case SpirV::Op_Name:
+                    if (SpirVId* id = operandCount >= 1 ? GetId(operands[0]) : nullptr)
+                    {
+                        id->Name = ReadString(operands + 1, operandCount - 1);
+                    }
+                    return true;
+
+                case SpirV::Op_EntryPoint:
+                    if (operandCount < 3)
+                    {
+                        return false;
+                    }
+                    EntryPointCount++;
+                    ExecutionModel = operands[0];
+                    EntryPoint     = ReadString(operands + 2, operandCount - 2);
+                    return true;
+
+                case SpirV::Op_ExecutionMode:
+                    if (operandCount >= 5 && operands[1] == SpirV::ExecutionModeLocalSize)
+                    {
+                        std::copy(operands + 2, operands + 5, LocalSize);
+                    }
+                    return true;
+
+                case SpirV::Op_Decorate:
+                    return operandCount < 2 || Decorate(operands[0], operands[1], operands + 2, operandCount - 2);
+
+                case SpirV::Op_MemberDecorate:
+                    return operandCount < 3 ||
+                           DecorateMember(operands[0], operands[1], operands[2], operands + 3, operandCount - 3);
+
+                case SpirV::Op_TypeBool:
+                case SpirV::Op_TypeInt:
+                case SpirV::Op_TypeFloat:
+                case SpirV::Op_TypeVector:
+                case SpirV::Op_TypeMatrix:
+                case SpirV::Op_TypeImage:
+                case SpirV::Op_TypeSampler:
+                case SpirV::Op_TypeSampledImage:
+                case SpirV::Op_TypeArray:
+                case SpirV::Op_TypeRuntimeArray:
+                case SpirV::Op_TypeStruct:
+                case SpirV::Op_TypePointer:
+                case SpirV::Op_TypeAccelerationStructure:
+                    return AddResult(opcode, operands[0], operands + 1, operandCount - 1);
+
+                // result type comes first for these
+                case SpirV::Op_Constant:
+                case SpirV::Op_SpecConstantTrue:
+                case SpirV::Op_SpecConstantFalse:
+                case SpirV::Op_SpecConstant:
+                case SpirV::Op_Variable: {
+                    if (operandCount < 2 || !AddResult(opcode, operands[1], operands, operandCount))
+                    {
+                        return false;
+                    }
+                    if (opcode == SpirV::Op_Variable)
+                    {
+                        Variables.push_back(operands[1]);
+                    }
+                    // keep [result type, value] / [result type, storage class] as operands
+                    std::vector<uint32_t>& stored = Ids[operands[1]].Operands;
+                    stored.erase(stored.begin() + 1);
+                    return true;
+                }
+
+                default:
+                    return true;
+            }
+        }
+
+        bool AddResult(uint32_t opcode, uint32_t resultId, const uint32_t* operands, uint32_t operandCount)
+        {
+            SpirVId* id = GetId(resultId);
+            if (id == nullptr)
+            {
+                return false;
+            }
+            id->Opcode = opcode;
+            id->Operands.assign(operands, operands + operandCount);
+            if (opcode == SpirV::Op_TypeStruct)
+            {
+                id->Members.resize(std::max(id->Members.size(), static_cast<size_t>(operandCount)));
+            }
+            return true;
+        }
+
+        bool Decorate(uint32_t targetId, uint32_t decoration, const uint32_t* literals, uint32_t literalCount)
+        {
+            SpirVId* id = GetId(targetId);
+            if (id == nullptr)
+            {
+                return false;
+            }
+
+            uint32_t literal = literalCount > 0 ? literals[0] : 0;
+            switch (decoration)
+            {
+                case SpirV::Decoration_SpecId:
+                    id->SpecId = literal;
+                    break;
+                case SpirV::Decoration_Block:
+                    id->Block = true;
+                    break;
+                case SpirV::Decoration_BufferBlock:
+                    id->BufferBlock = true;
+                    break;
+                case SpirV::Decoration_ArrayStride:
+                    id->ArrayStride = literal;
+                    break;
+                case SpirV::Decoration_BuiltIn:
+                    id->BuiltIn = true;
+                    break;
+                case SpirV::Decoration_Location:
+                    id->Location = literal;
+                    break;
+                case SpirV::Decoration_Binding:
+                    id->Binding = literal;
+                    break;
+                case SpirV::Decoration_DescriptorSet:
+                    id->Set = literal;
+                    break;
+                default:
+                    break;
+            }
+            return true;
+        }
+
+        bool DecorateMember(uint32_t        structId,
+                            uint32_t        memberIndex,
+                            uint32_t        decoration,
+                            const uint32_t* literals,
+                            uint32_t        literalCount)
+        {
+            SpirVId* id = GetId(structId);
+            if (id == nullptr)
+            {
+                return false;
+            }
+
+            // decorations come before the type declaration, so members may not be sized yet
+            if (memberIndex >= id->Members.size())
+            {
+                id->Members.resize(memberIndex + 1);
+            }
+
+            SpirVMember& member  = id->Members[memberIndex];
+            uint32_t     literal = literalCount > 0 ? literals[0] : 0;
+            switch (decoration)
+            {
+                case SpirV::Decoration_RowMajor:
+                    member.RowMajor = true;
+                    break;
+                case SpirV::Decoration_MatrixStride:
+                    member.MatrixStride = literal;
+                    break;
+                case SpirV::Decoration_Offset:
+                    member.Offset = literal;
+                    break;
+                case SpirV::Decoration_BuiltIn:
+                    id->BuiltIn = true;
+                    break;
+                default:
+                    break;
+            }
+            return true;
+        }
+
+    private:
+        std::vector<uint32_t> m_Words;
+    };
+
+    static RHIShaderStageFlags GetStageFromExecutionModel(uint32_t executionModel)
+    {
+        switch (executionModel)
+        {
+            case 0:
+                return RHI_SHADER_STAGE_VERTEX_BIT;
+            case 1:
+                return RHI_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2:
+                return RHI_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3:
+                return RHI_SHADER_STAGE_GEOMETRY_BIT;
+            case 4:
+                return RHI_SHADER_STAGE_FRAGMENT_BIT;
+            case 5:
+                return RHI_SHADER_STAGE_COMPUTE_BIT;
+            default:
+                return 0;
+        }
+    }
+
+    static bool GetDescriptorType(const SpirVModule& module,
+                                  uint32_t           storageClass,
+                                  uint32_t           typeId,
+                                  RHIDescriptorType& outType)
+    {
+        const SpirVId& type = module.Ids[typeId];
+        if (storageClass == SpirV::Storage_Class_Storage_Buffer)
+        {
+            outType = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            return true;
+        }
+        if (storageClass == SpirV::Storage_Class_Uniform)
+        {
+            outType = type.BufferBlock ? RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER : RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            return true;
+        }
+
+        switch (type.Opcode)
+        {
+            case SpirV::Op_TypeSampler:
+                outType = RHI_DESCRIPTOR_TYPE_SAMPLER;
+                return true;
+            case SpirV::Op_TypeSampledImage:
+                outType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                return true;
+            case SpirV::Op_TypeAccelerationStructure:
+                outType = RHI_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                return true;
+            case SpirV::Op_TypeImage: {
+                uint32_t dim     = type.Operands[1];
+                uint32_t sampled = type.Operands[5]; // 1 sampled, 2 storage
+                if (dim == SpirV::Dim_Subpass_Data)
+                    outType = RHI_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                else if (dim == SpirV::Dim_Buffer)
+                    outType = sampled == 2 ? RHI_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER :
+                                             RHI_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                else
+                    outType = sampled == 2 ? RHI_DESCRIPTOR_TYPE_STORAGE_IMAGE : RHI_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // 32 bit scalars and vectors, everything else is rare enough as a vertex input to not be worth supporting
+    static RHIFormat GetVertexFormat(const SpirVModule& module, uint32_t typeId)
+    {
+        static const RHIFormat s_Formats[3][4] = {
+            {RHI_FORMAT_R32_SFLOAT,
+             RHI_FORMAT_R32G32_SFLOAT,
+             RHI_FORMAT_R32G32B32_SFLOAT,
+             RHI_FORMAT_R32G32B32A32_SFLOAT},
+            {RHI_FORMAT_R32_SINT, RHI_FORMAT_R32G32_SINT, RHI_FORMAT_R32G32B32_SINT, RHI_FORMAT_R32G32B32A32_SINT},
+            {RHI_FORMAT_R32_UINT, RHI_FORMAT_R32G32_UINT, RHI_FORMAT_R32G32B32_UINT, RHI_FORMAT_R32G32B32A32_UINT},
+        };
+
+        const SpirVId* type           = &module.Ids[typeId];
+        uint32_t       componentCount = 1;
+        if (type->Opcode == SpirV::Op_TypeVector)
+        {
+            componentCount = type->Operands[1];
+            type           = &module.Ids[type->Operands[0]];
+        }
+
+        if (componentCount > 4 || type->Operands.empty() || type->Operands[0] != 32)
+        {
+            return RHI_FORMAT_UNDEFINED;
+        }
+        if (type->Opcode == SpirV::Op_TypeFloat)
+        {
+            return s_Formats[0][componentCount - 1];
+        }
+        if (type->Opcode == SpirV::Op_TypeInt)
+        {
+            return s_Formats[type->Operands[1] != 0 ? 1 : 2][componentCount - 1];
+        }
+        return RHI_FORMAT_UNDEFINED;
+    }
+
+    bool ShaderReflection::Reflect(const std::vector<unsigned char>& spirV)
+    {
+        *this = ShaderReflection();
+
+        SpirVModule module;
+        if (!module.Parse(spirV))
+        {
+            GAL_CORE_ERROR("[ShaderReflection] Not a SPIR-V module with a single entry point");
+            return false;
+        }
+
+        m_StageFlags = GetStageFromExecutionModel(module.ExecutionModel);
+        m_EntryPoint = module.EntryPoint;
+        std::copy(module.LocalSize, module.LocalSize + 3, m_LocalSize);
+        if (m_StageFlags == 0)
+        {
+            GAL_CORE_ERROR("[ShaderReflection] Unsupported execution model {0}", module.ExecutionModel);
+            return false;
+        }
+
+        for (uint32_t variableId : module.Variables)
+        {
+            const SpirVId& variable     = module.Ids[variableId];
+            uint32_t       storageClass = variable.Operands[1];
+
+            uint32_t count  = 1;
+            uint32_t typeId = module.StripArrays(variable.Operands[0], count);
+
+            if (storageClass == SpirV::Storage_Class_Push_Constant)
+            {
+                const SpirVId& type = module.Ids[typeId];
+
+                uint32_t offset = ~0u;
+                for (const SpirVMember& member : type.Members)
+                {
+                    offset = std::min(offset, member.Offset);
+                }
+                uint32_t size = module.GetTypeSize(typeId);
+                if (size > 0 && offset < size)
+                {
+                    m_PushConstantRanges.push_back({m_StageFlags, offset, size - offset});
+                }
+            }
+            else if (variable.Set != s_Unset && variable.Binding != s_Unset)
+            {
+                ShaderResourceBinding binding {};
+                binding.Set             = variable.Set;
+                binding.Binding         = variable.Binding;
+                binding.DescriptorCount = count;
+                binding.StageFlags      = m_StageFlags;
+                binding.Name            = variable.Name.empty() ? module.Ids[typeId].Name : variable.Name;
+                if (!GetDescriptorType(module, storageClass, typeId, binding.DescriptorType))
+                {
+                    GAL_CORE_WARN("[ShaderReflection] Skipping {0}, unknown descriptor type", binding.Name);
+                    continue;
+                }
+                if (binding.DescriptorType == RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                    binding.DescriptorType == RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                {
+                    binding.BlockSize = module.GetTypeSize(typeId);
+                }
+                m_Bindings.push_back(std::move(binding));
+            }
+            else if (storageClass == SpirV::Storage_Class_Input && m_StageFlags == RHI_SHADER_STAGE_VERTEX_BIT &&
+                     variable.Location != s_Unset && !variable.BuiltIn && !module.Ids[typeId].BuiltIn)
+            {
+                // a matrix takes one location per column
+                const SpirVId& type        = module.Ids[typeId];
+                bool           isMatrix    = type.Opcode == SpirV::Op_TypeMatrix;
+                uint32_t       columnType  = isMatrix ? type.Operands[0] : typeId;
+                uint32_t       columnCount = isMatrix ? type.Operands[1] : 1;
+
+                RHIFormat format = GetVertexFormat(module, columnType);
+                if (format == RHI_FORMAT_UNDEFINED)
+                {
+                    GAL_CORE_WARN("[ShaderReflection] Skipping vertex input {0}, unsupported format", variable.Name);
+                    continue;
+                }
+
+                uint32_t location = variable.Location;
+                for (uint32_t i = 0; i < count * columnCount; ++i)
+                {
+                    m_VertexInputs.push_back({location++, format, module.GetTypeSize(columnType), variable.Name});
+                }
+            }
+        }
+
+        for (uint32_t id = 0; id < module.Ids.size(); ++id)
+        {
+            const SpirVId& constant = module.Ids[id];
+            if (constant.SpecId == s_Unset || (constant.Opcode != SpirV::Op_SpecConstantTrue &&
+                                               constant.Opcode != SpirV::Op_SpecConstantFalse &&
+                                               constant.Opcode != SpirV::Op_SpecConstant))
+            {
+                continue;
+            }
+
+            uint32_t size = module.GetTypeSize(constant.Operands[0]);
+            m_SpecializationConstants.push_back({constant.SpecId, size, constant.Name});
+        }
+
+        std::sort(m_Bindings.begin(), m_Bindings.end(), [](const auto& a, const auto& b) {
+            return a.Set != b.Set ? a.Set < b.Set : a.Binding < b.Binding;
+        });
+        std::sort(m_VertexInputs.begin(), m_VertexInputs.end(), [](const auto& a, const auto& b) {
+            return a.Location < b.Location;
+        });
+        return true;
+    }
+
+    bool ShaderReflection::Merge(const ShaderReflection& other)
+    {
+        for (const ShaderResourceBinding& otherBinding : other.m_Bindings)
+        {
+            auto iter = std::find_if(m_Bindings.begin(), m_Bindings.end(), [&](const ShaderResourceBinding& binding) {
+                return binding.Set == otherBinding.Set && binding.Binding == otherBinding.Binding;
+            });
+            if (iter == m_Bindings.end())
+            {
+                m_Bindings.push_back(otherBinding);
+                continue;
+            }
+
+            if (iter->DescriptorType != otherBinding.DescriptorType ||
+                iter->DescriptorCount != otherBinding.DescriptorCount)
+            {
+                GAL_CORE_ERROR("[ShaderReflection] Stages disagree on set {0} binding {1}",
+                               otherBinding.Set,
+                               otherBinding.Binding);
+                return false;
+            }
+            iter->StageFlags |= otherBinding.StageFlags;
+            iter->BlockSize = std::max(iter->BlockSize, otherBinding.BlockSize);
+        }
+
+        for (const RHIPushConstantRange& otherRange : other.m_PushConstantRanges)
+        {
+            auto iter = std::find_if(
+                m_PushConstantRanges.begin(), m_PushConstantRanges.end(), [&](const RHIPushConstantRange& range) {
+                    return range.offset == otherRange.offset && range.size == otherRange.size;
+                });
+            if (iter != m_PushConstantRanges.end())
+                iter->stageFlags |= otherRange.stageFlags;
+            else
+                m_PushConstantRanges.push_back(otherRange);
+        }
+
+        for (const ShaderSpecializationConstant& otherConstant : other.m_SpecializationConstants)
+        {
+            auto iter = std::find_if(m_SpecializationConstants.begin(),
+                                     m_SpecializationConstants.end(),
+                                     [&](const ShaderSpecializationConstant& constant) {
+                                         return constant.ConstantId == otherConstant.ConstantId;
+                                     });
+            if (iter == m_SpecializationConstants.end())
+            {
+                m_SpecializationConstants.push_back(otherConstant);
+            }
+        }
+
+        if (m_VertexInputs.empty())
+        {
+            m_VertexInputs = other.m_VertexInputs;
+        }
+        m_StageFlags |= other.m_StageFlags;
+
+        std::sort(m_Bindings.begin(), m_Bindings.end(), [](const auto& a, const auto& b) {
+            return a.Set != b.Set ? a.Set < b.Set : a.Binding < b.Binding;
+        });
+        return true;
+    }
+
+    void ShaderReflection::AccumulatePoolSizes(uint32_t                            set,
+                                               uint32_t                            setCount,
+                                               std::vector<RHIDescriptorPoolSize>& poolSizes) const
+    {
+        for (const ShaderResourceBinding& binding : m_Bindings)
+        {
+            // runtime sized arrays are allocated with an explicit count, the caller has to add those
+            if (binding.Set != set || binding.DescriptorCount == 0)
+            {
+                continue;
+            }
+
+            auto iter = std::find_if(poolSizes.begin(), poolSizes.end(), [&](const RHIDescriptorPoolSize& poolSize) {
+                return poolSize.type == binding.DescriptorType;
+            });
+            if (iter == poolSizes.end())
+            {
+                iter = poolSizes.insert(poolSizes.end(), RHIDescriptorPoolSize {binding.DescriptorType, 0});
+            }
+            iter->descriptorCount += binding.DescriptorCount * setCount;
+        }
+    }
+
+    uint32_t ShaderReflection::GetVertexAttributes(uint32_t                                         binding,
+                                                   std::vector<RHIVertexInputAttributeDescription>& attributes) const
+    {
+        uint32_t stride = 0;
+        for (const ShaderVertexInput& input : m_VertexInputs)
+        {
+            attributes.push_back({input.Location, binding, input.Format, stride});
+            stride += input.Size;
+        }
+        return stride;
+    }
+
+    const ShaderSpecializationConstant* ShaderReflection::FindSpecializationConstant(const std::string& name) const
+    {
+        for (const ShaderSpecializationConstant& constant : m_SpecializationConstants)
+        {
+            if (constant.Name == name)
+            {
+                return &constant;
+            }
+        }
+        return nullptr;
+    }
+
+    uint32_t ShaderReflection::GetSetCount() const { return m_Bindings.empty() ? 0 : m_Bindings.back().Set + 1; }
+} // namespace Galaxy
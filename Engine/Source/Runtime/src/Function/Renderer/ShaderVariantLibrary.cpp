@@ -0,0 +1,504 @@
+//
+// ShaderVariantLibrary.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/29 17:32.
+//
+
+#include "GalaxyEngine/Function/Renderer/ShaderVariantLibrary.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Function/Global/GlobalContext.h"
+
+#include <algorithm>
+
+namespace Galaxy
+{
+    void ShaderVariantLibrary::Init(ShaderVariantLibraryInitInfo initInfo)
+    {
+        m_RHI      = initInfo.Rhi;
+        m_Compiler = initInfo.Compiler;
+    }
+
+    void ShaderVariantLibrary::Shutdown()
+    {
+        LogStats();
+
+        for (ShaderEntry& shader : m_Shaders)
+        {
+            // the compile jobs reference the compiler
+            for (auto& [moduleKey, task] : shader.PendingReloads)
+            {
+                g_RuntimeGlobalContext.JobSys->Wait(task->Counter);
+            }
+            for (auto& [moduleKey, module] : shader.Modules)
+            {
+                if (module.Module != nullptr)
+                {
+                    m_RHI->DestroyShaderModule(module.Module);
+                }
+            }
+        }
+        m_Shaders.clear();
+        m_Compiler.reset();
+        m_RHI.reset();
+    }
+
+    uint32_t ShaderVariantLibrary::RegisterShader(const std::filesystem::path& sourcePath,
+                                                  std::vector<ShaderFeature>   features)
+    {
+        GAL_CORE_ASSERT(features.size() <= 64, "[ShaderVariantLibrary] At most 64 features per shader");
+
+        ShaderEntry& shader = m_Shaders.emplace_back();
+        shader.SourcePath   = sourcePath;
+        shader.Features     = std::move(features);
+        return static_cast<uint32_t>(m_Shaders.size() - 1);
+    }
+
+    ShaderVariantKey ShaderVariantLibrary::GetFeatureBit(uint32_t shader, const std::string& featureName) const
+    {
+        const std::vector<ShaderFeature>& features = m_Shaders[shader].Features;
+        for (size_t i = 0; i < features.size(); ++i)
+        {
+            if (features[i].Name == featureName)
+            {
+                return ShaderVariantKey(1) << i;
+            }
+        }
+        return 0;
+    }
+
+    void ShaderVariantLibrary::AddVariantReference(uint32_t shader, ShaderVariantKey key)
+    {
+        m_Shaders[shader].References[key]++;
+    }
+
+    void ShaderVariantLibrary::ReleaseVariant(uint32_t shader, ShaderVariantKey key)
+    {
+        auto& references = m_Shaders[shader].References;
+        auto  iter       = references.find(key);
+        GAL_CORE_ASSERT(iter != references.end(), "[ShaderVariantLibrary] Releasing a variant that is not referenced");
+
+        if (--iter->second == 0)
+        {
+            references.erase(iter);
+        }
+    }
+
+    void ShaderVariantLibrary::BuildReferencedVariants()
+    {
+        struct PendingCompile
+        {
+            ShaderEntry*           Shader;
+            ShaderVariantKey       ModuleKey;
+            Ref<ShaderCompileTask> Task;
+        };
+        std::vector<PendingCompile> pendingCompiles;
+
+        // 1. The base module tells which features have a specialization constant, every other module depends on it
+        for (ShaderEntry& shader : m_Shaders)
+        {
+            if (!shader.ModesResolved && !shader.References.empty())
+            {
+                pendingCompiles.push_back({&shader, 0, m_Compiler->CompileAsync(MakeRequest(shader, 0))});
+            }
+        }
+        for (PendingCompile& pending : pendingCompiles)
+        {
+            g_RuntimeGlobalContext.JobSys->Wait(pending.Task->Counter);
+            AddModule(*pending.Shader, 0, pending.Task->Result);
+            ResolveFeatureModes(*pending.Shader);
+        }
+        pendingCompiles.clear();
+
+        // 2. Every module a referenced variant needs
+        for (ShaderEntry& shader : m_Shaders)
+        {
+            for (auto& [key, referenceCount] : shader.References)
+            {
+                ShaderVariantKey moduleKey = key & ~shader.SpecializationMask;
+                if (shader.Modules.count(moduleKey) > 0)
+                {
+                    continue;
+                }
+
+                // several variants may share the module, only compile it once
+                bool isPending = false;
+                for (const PendingCompile& pending : pendingCompiles)
+                {
+                    isPending |= pending.Shader == &shader && pending.ModuleKey == moduleKey;
+                }
+                if (!isPending)
+                {
+                    pendingCompiles.push_back(
+                        {&shader, moduleKey, m_Compiler->CompileAsync(MakeRequest(shader, moduleKey))});
+                }
+            }
+        }
+        for (PendingCompile& pending : pendingCompiles)
+        {
+            g_RuntimeGlobalContext.JobSys->Wait(pending.Task->Counter);
+            AddModule(*pending.Shader, pending.ModuleKey, pending.Task->Result);
+        }
+
+        // 3. Specialization data, cheap
+        for (ShaderEntry& shader : m_Shaders)
+        {
+            for (auto& [key, referenceCount] : shader.References)
+            {
+                if (shader.Variants.count(key) == 0)
+                {
+                    BuildVariant(shader, key);
+                }
+            }
+        }
+    }
+
+    const ShaderVariant* ShaderVariantLibrary::GetVariant(uint32_t shader, ShaderVariantKey key)
+    {
+        ShaderEntry& entry = m_Shaders[shader];
+
+        auto iter = entry.Variants.find(key);
+        if (iter != entry.Variants.end())
+        {
+            return iter->second.get();
+        }
+
+        if (!entry.ModesResolved)
+        {
+            AddModule(entry, 0, m_Compiler->Compile(MakeRequest(entry, 0)));
+            ResolveFeatureModes(entry);
+        }
+
+        ShaderVariantKey moduleKey = key & ~entry.SpecializationMask;
+        if (entry.Modules.count(moduleKey) == 0)
+        {
+            AddModule(entry, moduleKey, m_Compiler->Compile(MakeRequest(entry, moduleKey)));
+        }
+        return BuildVariant(entry, key);
+    }
+
+    uint32_t ShaderVariantLibrary::PruneUnreferenced()
+    {
+        uint32_t prunedCount = 0;
+        for (ShaderEntry& shader : m_Shaders)
+        {
+            for (auto iter = shader.Variants.begin(); iter != shader.Variants.end();)
+            {
+                if (shader.References.count(iter->first) > 0)
+                {
+                    ++iter;
+                    continue;
+                }
+
+                shader.Modules[iter->first & ~shader.SpecializationMask].VariantCount--;
+                iter = shader.Variants.erase(iter);
+                prunedCount++;
+            }
+
+            // the base module is kept, it is what the feature modes were resolved from
+            for (auto iter = shader.Modules.begin(); iter != shader.Modules.end();)
+            {
+                if (iter->first == 0 || iter->second.VariantCount > 0)
+                {
+                    ++iter;
+                    continue;
+                }
+
+                if (iter->second.Module != nullptr)
+                {
+                    m_RHI->DestroyShaderModule(iter->second.Module);
+                }
+                iter = shader.Modules.erase(iter);
+            }
+        }
+
+        if (prunedCount > 0)
+        {
+            GAL_CORE_INFO("[ShaderVariantLibrary] Pruned {0} unreferenced variants", prunedCount);
+        }
+        return prunedCount;
+    }
+
+    uint32_t ShaderVariantLibrary::ReloadDependents(const std::filesystem::path& filePath)
+    {
+        std::filesystem::path normalPath = filePath.lexically_normal();
+
+        uint32_t dependentCount = 0;
+        for (ShaderEntry& shader : m_Shaders)
+        {
+            if (std::find(shader.Dependencies.begin(), shader.Dependencies.end(), normalPath) ==
+                shader.Dependencies.end())
+            {
+                continue;
+            }
+
+            dependentCount++;
+            if (shader.PendingReloads.empty())
+            {
+                StartReload(shader);
+            }
+            else
+            {
+                // the running compiles may have read the old source, start over once they are done
+                shader.ReloadAgain = true;
+            }
+        }
+        return dependentCount;
+    }
+
+    void ShaderVariantLibrary::Update(std::vector<uint32_t>& outReloadedShaders)
+    {
+        for (uint32_t i = 0; i < m_Shaders.size(); ++i)
+        {
+            ShaderEntry& shader = m_Shaders[i];
+            if (shader.PendingReloads.empty())
+            {
+                continue;
+            }
+
+            bool isDone = true;
+            for (auto& [moduleKey, task] : shader.PendingReloads)
+            {
+                isDone &= task->IsDone();
+            }
+            if (!isDone)
+            {
+                continue;
+            }
+
+            if (shader.ReloadAgain)
+            {
+                StartReload(shader);
+                continue;
+            }
+
+            if (SwapReloadedModules(shader))
+            {
+                GAL_CORE_INFO("[ShaderVariantLibrary] Reloaded {0}, {1} modules and {2} variants",
+                              shader.SourcePath.string(),
+                              shader.PendingReloads.size(),
+                              shader.Variants.size());
+                outReloadedShaders.push_back(i);
+            }
+            shader.PendingReloads.clear();
+        }
+    }
+
+    ShaderVariantStats ShaderVariantLibrary::GetStats() const
+    {
+        ShaderVariantStats stats;
+        for (const ShaderEntry& shader : m_Shaders)
+        {
+            size_t featureCount = shader.Features.size();
+            stats.PossibleVariants   += featureCount >= 64 ? ~0ull : (1ull << featureCount);
+            stats.ReferencedVariants += static_cast<uint32_t>(shader.References.size());
+            stats.BuiltVariants      += static_cast<uint32_t>(shader.Variants.size());
+            for (const auto& [moduleKey, module] : shader.Modules)
+            {
+                if (module.Module != nullptr)
+                {
+                    stats.CompiledModules++;
+                    stats.SpirVBytes += module.SpirVSize;
+                }
+            }
+        }
+        return stats;
+    }
+
+    void ShaderVariantLibrary::LogStats() const
+    {
+        ShaderVariantStats stats = GetStats();
+        GAL_CORE_INFO("[ShaderVariantLibrary] {0} shaders, {1} variants built of {2} referenced and {3} possible, "
+                      "{4} SPIR-V modules using {5} KB",
+                      m_Shaders.size(),
+                      stats.BuiltVariants,
+                      stats.ReferencedVariants,
+                      stats.PossibleVariants,
+                      stats.CompiledModules,
+                      stats.SpirVBytes / 1024);
+    }
+
+    ShaderCompileRequest ShaderVariantLibrary::MakeRequest(const ShaderEntry& shader, ShaderVariantKey moduleKey) const
+    {
+        ShaderCompileRequest request;
+        request.SourcePath = shader.SourcePath;
+
+        // disabled features are left undefined, so the base module is the plain source and can come prebuilt
+        for (size_t i = 0; i < shader.Features.size(); ++i)
+        {
+            if ((moduleKey >> i) & 1)
+            {
+                request.Defines.push_back({shader.Features[i].Name, "1"});
+            }
+        }
+        return request;
+    }
+
+    bool ShaderVariantLibrary::AddModule(ShaderEntry&               shader,
+                                         ShaderVariantKey           moduleKey,
+                                         const ShaderCompileResult& result)
+    {
+        if (moduleKey == 0)
+        {
+            shader.Dependencies = result.Dependencies;
+        }
+
+        ModuleEntry& module = shader.Modules[moduleKey];
+        if (!result.Success || !module.Reflection.Reflect(result.SpirV))
+        {
+            GAL_CORE_ERROR("[ShaderVariantLibrary] No module for {0} with features {1:#x}",
+                           shader.SourcePath.string(),
+                           moduleKey);
+            return false;
+        }
+
+        module.Module    = m_RHI->CreateShaderModule(result.SpirV);
+        module.SpirVSize = result.SpirV.size();
+        return true;
+    }
+
+    void ShaderVariantLibrary::ResolveFeatureModes(ShaderEntry& shader)
+    {
+        shader.ModesResolved      = true;
+        shader.SpecializationMask = 0;
+
+        const ModuleEntry& baseModule = shader.Modules[0];
+        for (size_t i = 0; i < shader.Features.size(); ++i)
+        {
+            ShaderFeature& feature = shader.Features[i];
+            if (feature.Mode == Shader_Feature_Mode_Preprocessor)
+            {
+                continue;
+            }
+
+            bool hasConstant = baseModule.Reflection.FindSpecializationConstant(feature.Name) != nullptr;
+            if (!hasConstant && feature.Mode == Shader_Feature_Mode_Specialization)
+            {
+                GAL_CORE_WARN("[ShaderVariantLibrary] {0} has no specialization constant {1}, using a #define",
+                              shader.SourcePath.string(),
+                              feature.Name);
+            }
+
+            feature.Mode = hasConstant ? Shader_Feature_Mode_Specialization : Shader_Feature_Mode_Preprocessor;
+            if (hasConstant)
+            {
+                shader.SpecializationMask |= ShaderVariantKey(1) << i;
+            }
+        }
+    }
+
+    ShaderVariant* ShaderVariantLibrary::BuildVariant(ShaderEntry& shader, ShaderVariantKey key)
+    {
+        ModuleEntry& module = shader.Modules[key & ~shader.SpecializationMask];
+        if (module.Module == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto variant = CreateScope<ShaderVariant>();
+        variant->Key = key;
+        FillVariant(shader, module, *variant);
+
+        module.VariantCount++;
+        return shader.Variants.emplace(key, std::move(variant)).first->second.get();
+    }
+
+    void ShaderVariantLibrary::FillVariant(const ShaderEntry& shader,
+                                           const ModuleEntry& module,
+                                           ShaderVariant&     variant) const
+    {
+        variant.Module     = module.Module;
+        variant.Reflection = &module.Reflection;
+        variant.MapEntries.clear();
+        variant.MapEntryPointers.clear();
+        variant.SpecializationData.clear();
+
+        for (size_t i = 0; i < shader.Features.size(); ++i)
+        {
+            if (((shader.SpecializationMask >> i) & 1) == 0)
+            {
+                continue;
+            }
+
+            // a reloaded module may have dropped the constant, the feature then has no effect
+            const ShaderSpecializationConstant* constant =
+                module.Reflection.FindSpecializationConstant(shader.Features[i].Name);
+            if (constant == nullptr)
+            {
+                continue;
+            }
+
+            uint32_t offset = static_cast<uint32_t>(variant.SpecializationData.size() * sizeof(uint32_t));
+            variant.MapEntries.push_back({constant->ConstantId, offset, sizeof(uint32_t)});
+            variant.SpecializationData.push_back(static_cast<uint32_t>((variant.Key >> i) & 1));
+        }
+
+        for (const RHISpecializationMapEntry& mapEntry : variant.MapEntries)
+        {
+            variant.MapEntryPointers.push_back(&mapEntry);
+        }
+        variant.SpecializationInfo.mapEntryCount = static_cast<uint32_t>(variant.MapEntries.size());
+        variant.SpecializationInfo.pMapEntries   = variant.MapEntryPointers.data();
+        variant.SpecializationInfo.dataSize      = variant.SpecializationData.size() * sizeof(uint32_t);
+        variant.SpecializationInfo.pData         = variant.SpecializationData.data();
+
+        RHIPipelineShaderStageCreateInfo& stage = variant.StageCreateInfo;
+        stage                                   = {};
+        stage.sType               = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage.stage               = static_cast<RHIShaderStageFlagBits>(module.Reflection.GetStageFlags());
+        stage.module              = module.Module;
+        stage.pName               = module.Reflection.GetEntryPoint().c_str();
+        stage.pSpecializationInfo = variant.MapEntries.empty() ? nullptr : &variant.SpecializationInfo;
+    }
+
+    void ShaderVariantLibrary::StartReload(ShaderEntry& shader)
+    {
+        shader.ReloadAgain = false;
+        shader.PendingReloads.clear();
+        for (auto& [moduleKey, module] : shader.Modules)
+        {
+            shader.PendingReloads.emplace_back(moduleKey, m_Compiler->CompileAsync(MakeRequest(shader, moduleKey)));
+        }
+    }
+
+    bool ShaderVariantLibrary::SwapReloadedModules(ShaderEntry& shader)
+    {
+        // everything is reflected before anything is swapped, so a shader never mixes old and new modules
+        std::vector<ShaderReflection> reflections(shader.PendingReloads.size());
+        for (size_t i = 0; i < shader.PendingReloads.size(); ++i)
+        {
+            const auto& [moduleKey, task] = shader.PendingReloads[i];
+            if (moduleKey == 0)
+            {
+                // an edit may have added or removed includes
+                shader.Dependencies = task->Result.Dependencies;
+            }
+            if (!task->Result.Success || !reflections[i].Reflect(task->Result.SpirV))
+            {
+                GAL_CORE_ERROR("[ShaderVariantLibrary] Reloading {0} failed, keeping the previous version\n{1}",
+                               shader.SourcePath.string(),
+                               task->Result.Log);
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < shader.PendingReloads.size(); ++i)
+        {
+            const auto& [moduleKey, task] = shader.PendingReloads[i];
+
+            ModuleEntry& module = shader.Modules[moduleKey];
+            if (module.Module != nullptr)
+            {
+                m_RHI->DestroyShaderModule(module.Module);
+            }
+            module.Module     = m_RHI->CreateShaderModule(task->Result.SpirV);
+            module.Reflection = std::move(reflections[i]);
+            module.SpirVSize  = task->Result.SpirV.size();
+        }
+
+        for (auto& [key, variant] : shader.Variants)
+        {
+            FillVariant(shader, shader.Modules[key & ~shader.SpecializationMask], *variant);
+        }
+        return true;
+    }
+} // namespace Galaxy
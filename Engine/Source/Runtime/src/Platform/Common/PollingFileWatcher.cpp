@@ -0,0 +1,80 @@
+//
+// PollingFileWatcher.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 10:41.
+//
+
+#include "GalaxyEngine/Platform/Common/PollingFileWatcher.h"
+#include "GalaxyEngine/Core/Macro.h"
+
+namespace Galaxy
+{
+    static constexpr float s_PollInterval = 0.5f;
+
+    void PollingFileWatcher::Init() { m_Timer.Reset(); }
+
+    void PollingFileWatcher::Shutdown() { m_Watches.clear(); }
+
+    FileWatchId PollingFileWatcher::WatchDirectory(const std::filesystem::path& directory, FileChangedCallback callback)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error))
+        {
+            GAL_CORE_ERROR("[FileWatcher] Cannot watch {0}: not a directory", directory.string());
+            return 0;
+        }
+
+        Watch watch {directory, std::move(callback), {}};
+        Scan(directory, watch.WriteTimes);
+
+        FileWatchId watchId = m_NextWatchId++;
+        m_Watches.emplace(watchId, std::move(watch));
+        return watchId;
+    }
+
+    void PollingFileWatcher::Unwatch(FileWatchId watchId) { m_Watches.erase(watchId); }
+
+    void PollingFileWatcher::Poll()
+    {
+        if (m_Timer.Elapsed() < s_PollInterval)
+        {
+            return;
+        }
+        m_Timer.Reset();
+
+        // collected first, callbacks may add or remove watches
+        std::vector<std::pair<FileChangedCallback, std::filesystem::path>> callbacks;
+        for (auto& [id, watch] : m_Watches)
+        {
+            FileTimes writeTimes;
+            Scan(watch.Directory, writeTimes);
+
+            for (const auto& [fileName, writeTime] : writeTimes)
+            {
+                auto iter = watch.WriteTimes.find(fileName);
+                if (iter == watch.WriteTimes.end() || iter->second != writeTime)
+                {
+                    callbacks.emplace_back(watch.Callback, watch.Directory / fileName);
+                }
+            }
+            watch.WriteTimes = std::move(writeTimes);
+        }
+
+        for (const auto& [callback, filePath] : callbacks)
+        {
+            callback(filePath);
+        }
+    }
+
+    void PollingFileWatcher::Scan(const std::filesystem::path& directory, FileTimes& outWriteTimes)
+    {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (entry.is_regular_file(error))
+            {
+                outWriteTimes[entry.path().filename().string()] = entry.last_write_time(error);
+            }
+        }
+    }
+} // namespace Galaxy
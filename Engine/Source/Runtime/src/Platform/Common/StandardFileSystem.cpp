@@ -7,8 +7,25 @@
 #include "GalaxyEngine/Platform/Common/StandardFileSystem.h"
 #include "GalaxyEngine/Core/Macro.h"
 
+#include <atomic>
+#include <random>
+
 namespace Galaxy
 {
+    namespace
+    {
+        // Every write gets a temporary file of its own, concurrent writers of the same file in this or another
+        // process never truncate or rename each other's. The last rename wins.
+        std::string MakeTempSuffix()
+        {
+            static const uint64_t        s_ProcessTag = (static_cast<uint64_t>(std::random_device {}()) << 32) |
+                                                         std::random_device {}();
+            static std::atomic<uint64_t> s_WriteCount {0};
+
+            return "." + std::to_string(s_ProcessTag) + "-" + std::to_string(s_WriteCount.fetch_add(1)) + ".tmp";
+        }
+    } // namespace
+
     std::vector<char> StandardFileSystem::ReadFileAllText(const std::string& fileName)
     {
         std::ifstream file(fileName, std::ios::ate | std::ios::binary);
@@ -16,6 +33,7 @@ namespace Galaxy
         if (!file.is_open())
         {
             GAL_CORE_ERROR("[FileSystem] Failed to open file: {0}", fileName);
+            return {};
         }
 
         size_t            fileSize = (size_t)file.tellg();
@@ -28,4 +46,47 @@ namespace Galaxy
 
         return buffer;
     }
+
+    bool StandardFileSystem::WriteFileAtomically(const std::string& fileName, const std::vector<char>& data)
+    {
+        std::filesystem::path filePath(fileName);
+        std::filesystem::path tempPath = filePath;
+        tempPath += MakeTempSuffix();
+
+        std::error_code error;
+        if (filePath.has_parent_path())
+        {
+            std::filesystem::create_directories(filePath.parent_path(), error);
+        }
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                GAL_CORE_ERROR("[FileSystem] Failed to open file: {0}", tempPath.string());
+                return false;
+            }
+
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            file.flush();
+            if (!file.good())
+            {
+                GAL_CORE_ERROR("[FileSystem] Failed to write file: {0}", tempPath.string());
+                file.close();
+                std::filesystem::remove(tempPath, error);
+                return false;
+            }
+        }
+
+        // rename replaces the destination in one step on every platform we ship
+        std::filesystem::rename(tempPath, filePath, error);
+        if (error)
+        {
+            GAL_CORE_ERROR("[FileSystem] Failed to replace file {0}: {1}", fileName, error.message());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        return true;
+    }
 } // namespace Galaxy
@@ -5,6 +5,9 @@
 //
 
 #include "GalaxyEngine/Platform/Common/VulkanRenderSystem.h"
+#include "GalaxyEngine/Core/FileSystem.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Function/Global/GlobalContext.h"
 
 namespace Galaxy
 {
@@ -15,15 +18,82 @@ namespace Galaxy
         rhiInitInfo.WindowSys = initInfo.WindowSys;
         m_RHI = CreateRef<VulkanRHI>();
         m_RHI->Initialize(rhiInitInfo);
+
+        // 2. Init pipeline state cache
+        PipelineStateCacheInitInfo pipelineStateCacheInitInfo = {};
+        pipelineStateCacheInitInfo.Rhi = m_RHI;
+        m_PipelineStateCache = CreateRef<PipelineStateCache>();
+        m_PipelineStateCache->Init(pipelineStateCacheInitInfo);
+
+        // 3. Init pipeline layout cache
+        PipelineLayoutCacheInitInfo pipelineLayoutCacheInitInfo = {};
+        pipelineLayoutCacheInitInfo.Rhi = m_RHI;
+        m_PipelineLayoutCache = CreateRef<PipelineLayoutCache>();
+        m_PipelineLayoutCache->Init(pipelineLayoutCacheInitInfo);
+
+        // 4. Init shader compiler
+        ShaderCompilerInitInfo shaderCompilerInitInfo = {};
+        shaderCompilerInitInfo.CacheDirectory = GAL_RELATIVE_PATH("Cache/Shaders");
+        shaderCompilerInitInfo.IncludeDirectories = {GAL_RELATIVE_PATH("Resources/Shaders")};
+        m_ShaderCompiler = CreateRef<ShaderCompiler>();
+        m_ShaderCompiler->Init(shaderCompilerInitInfo);
+
+        // 5. Init shader variant library
+        ShaderVariantLibraryInitInfo shaderVariantLibraryInitInfo = {};
+        shaderVariantLibraryInitInfo.Rhi = m_RHI;
+        shaderVariantLibraryInitInfo.Compiler = m_ShaderCompiler;
+        m_ShaderVariantLibrary = CreateRef<ShaderVariantLibrary>();
+        m_ShaderVariantLibrary->Init(shaderVariantLibraryInitInfo);
+
+        // 6. Init shader hot reloader
+        ShaderHotReloaderInitInfo shaderHotReloaderInitInfo = {};
+        shaderHotReloaderInitInfo.Rhi = m_RHI;
+        shaderHotReloaderInitInfo.PipelineCache = m_PipelineStateCache;
+        shaderHotReloaderInitInfo.LayoutCache = m_PipelineLayoutCache;
+        shaderHotReloaderInitInfo.VariantLibrary = m_ShaderVariantLibrary;
+#ifdef GAL_ENABLE_SHADER_HOT_RELOAD
+        shaderHotReloaderInitInfo.Watcher = g_RuntimeGlobalContext.FileWatcherSys;
+#endif
+        m_ShaderHotReloader = CreateRef<ShaderHotReloader>();
+        m_ShaderHotReloader->Init(shaderHotReloaderInitInfo);
+
+        // 7. Warm the pipeline cache with everything earlier runs recorded
+        m_RHI->ReplayPipelineManifest();
     }
 
     void VulkanRenderSystem::Release()
     {
+        m_ShaderHotReloader->Shutdown();
+        m_ShaderHotReloader.reset();
+
+        m_ShaderVariantLibrary->Shutdown();
+        m_ShaderVariantLibrary.reset();
+
+        m_ShaderCompiler->Shutdown();
+        m_ShaderCompiler.reset();
+
+        m_PipelineStateCache->Shutdown();
+        m_PipelineStateCache.reset();
+
+        m_PipelineLayoutCache->Shutdown();
+        m_PipelineLayoutCache.reset();
+
+        m_RHI->Clear();
         m_RHI.reset();
     }
 
     Ref<RHI> VulkanRenderSystem::GetRHI() { return m_RHI; }
 
+    Ref<PipelineStateCache> VulkanRenderSystem::GetPipelineStateCache() { return m_PipelineStateCache; }
+
+    Ref<PipelineLayoutCache> VulkanRenderSystem::GetPipelineLayoutCache() { return m_PipelineLayoutCache; }
+
+    Ref<ShaderCompiler> VulkanRenderSystem::GetShaderCompiler() { return m_ShaderCompiler; }
+
+    Ref<ShaderVariantLibrary> VulkanRenderSystem::GetShaderVariantLibrary() { return m_ShaderVariantLibrary; }
+
+    Ref<ShaderHotReloader> VulkanRenderSystem::GetShaderHotReloader() { return m_ShaderHotReloader; }
+
     void VulkanRenderSystem::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
     {
 
@@ -0,0 +1,139 @@
+//
+// InotifyFileWatcher.cpp
+//
+// Created or modified by Kexuan Zhang on 2023/10/30 10:41.
+//
+
+#include "GalaxyEngine/Platform/Linux/InotifyFileWatcher.h"
+#include "GalaxyEngine/Core/Macro.h"
+#include "GalaxyEngine/Platform/Platform.h"
+
+#ifdef GAL_PLATFORM_LINUX
+
+#include <cerrno>
+#include <cstring>
+#include <set>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace Galaxy
+{
+    // editors either rewrite the file in place or write a temporary one and rename it over the original
+    static constexpr uint32_t s_WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+    void InotifyFileWatcher::Init()
+    {
+        m_InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_InotifyFd < 0)
+        {
+            GAL_CORE_ERROR("[FileWatcher] inotify_init1 failed: {0}", std::strerror(errno));
+        }
+    }
+
+    void InotifyFileWatcher::Shutdown()
+    {
+        if (m_InotifyFd >= 0)
+        {
+            close(m_InotifyFd);
+            m_InotifyFd = -1;
+        }
+        m_Watches.clear();
+    }
+
+    FileWatchId InotifyFileWatcher::WatchDirectory(const std::filesystem::path& directory, FileChangedCallback callback)
+    {
+        if (m_InotifyFd < 0)
+        {
+            return 0;
+        }
+
+        // watching the same directory twice hands back the same descriptor
+        int descriptor = inotify_add_watch(m_InotifyFd, directory.c_str(), s_WatchMask);
+        if (descriptor < 0)
+        {
+            GAL_CORE_ERROR("[FileWatcher] Cannot watch {0}: {1}", directory.string(), std::strerror(errno));
+            return 0;
+        }
+
+        FileWatchId watchId = m_NextWatchId++;
+        m_Watches.emplace(watchId, Watch {descriptor, directory, std::move(callback)});
+        return watchId;
+    }
+
+    void InotifyFileWatcher::Unwatch(FileWatchId watchId)
+    {
+        auto iter = m_Watches.find(watchId);
+        if (iter == m_Watches.end())
+        {
+            return;
+        }
+
+        int descriptor = iter->second.Descriptor;
+        m_Watches.erase(iter);
+
+        for (const auto& [id, watch] : m_Watches)
+        {
+            if (watch.Descriptor == descriptor)
+            {
+                return;
+            }
+        }
+        inotify_rm_watch(m_InotifyFd, descriptor);
+    }
+
+    void InotifyFileWatcher::Poll()
+    {
+        if (m_InotifyFd < 0)
+        {
+            return;
+        }
+
+        std::set<std::pair<int, std::string>> changes;
+
+        alignas(inotify_event) char buffer[4096];
+        while (true)
+        {
+            ssize_t length = read(m_InotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    GAL_CORE_WARN("[FileWatcher] Event queue overflowed, some changes were missed");
+                }
+                else if (event->len > 0 && (event->mask & s_WatchMask))
+                {
+                    changes.emplace(event->wd, event->name);
+                }
+            }
+        }
+
+        // collected first, callbacks may add or remove watches
+        std::vector<std::pair<FileChangedCallback, std::filesystem::path>> callbacks;
+        for (const auto& [descriptor, fileName] : changes)
+        {
+            for (const auto& [id, watch] : m_Watches)
+            {
+                if (watch.Descriptor == descriptor)
+                {
+                    callbacks.emplace_back(watch.Callback, watch.Directory / fileName);
+                }
+            }
+        }
+
+        for (const auto& [callback, filePath] : callbacks)
+        {
+            callback(filePath);
+        }
+    }
+} // namespace Galaxy
+
+#endif